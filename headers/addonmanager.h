@@ -15,6 +15,8 @@ enum ADDON_PROCESS {
 struct AddonBlock {
     GPAddon * ptr;
     ADDON_PROCESS process;
+    uint32_t calls = 0;     // core0 counters, only kept with USB telemetry enabled
+    uint32_t busyUs = 0;
 };
 
 class AddonManager {
@@ -28,6 +30,7 @@ public:
     void ProcessAddons();
     void PostprocessAddons(bool);
     GPAddon * GetAddon(std::string); // hack for NeoPicoLED
+    const std::vector<AddonBlock*>& GetAddonBlocks() const { return addons; }
 private:
     std::vector<AddonBlock*> addons;    // addons currently loaded
 };
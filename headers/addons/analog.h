@@ -99,37 +99,106 @@
 #define ANALOG_ERROR2 1000
 #endif
 
+#ifndef ANALOG_CURVE
+#define ANALOG_CURVE ANALOG_CURVE_LINEAR
+#endif
+
+#ifndef ANALOG_CURVE2
+#define ANALOG_CURVE2 ANALOG_CURVE_LINEAR
+#endif
+
+// ADC samples averaged per read, a power of two up to ANALOG_OVERSAMPLE_MAX
+#ifndef ANALOG_OVERSAMPLE
+#define ANALOG_OVERSAMPLE 1
+#endif
+
+#ifndef ANALOG_OVERSAMPLE2
+#define ANALOG_OVERSAMPLE2 1
+#endif
+
+// Custom curve output % at 25/50/75% deflection, packed low byte first (linear)
+#ifndef ANALOG_CURVE_POINTS
+#define ANALOG_CURVE_POINTS 0x4B3219
+#endif
+
+#ifndef ANALOG_CURVE_POINTS2
+#define ANALOG_CURVE_POINTS2 0x4B3219
+#endif
+
 // Analog Module Name
 #define AnalogName "Analog"
 
 #define ADC_COUNT 2
 
+// The response curve LUT holds the output deflection, 0 to ANALOG_CURVE_ONE, at every
+// 1/ANALOG_CURVE_SEGMENTS of the input deflection
+#define ANALOG_CURVE_ONE (1 << 16)
+#define ANALOG_CURVE_SEGMENTS 16
+
+#define ANALOG_OVERSAMPLE_MAX 16
+#define ANALOG_NOISE_SAMPLES 1024
+#define ANALOG_NOISE_BINS 17
+
+// Raw readings of one axis at rest, in ADC steps
+typedef struct
+{
+    float mean;
+    float deviation;
+    uint16_t minimum;
+    uint16_t maximum;
+    uint32_t histogram[ANALOG_NOISE_BINS]; // -8 to +8 steps from the rounded mean, the end bins take the rest
+} AnalogNoise;
+
+typedef struct
+{
+    uint32_t oversample;
+    uint32_t smoothing_factor;  // 0 when smoothing is not needed
+    uint32_t inner_deadzone;
+} AnalogNoiseSuggestion;
+
+typedef enum
+{
+    ANALOG_RESULT_CENTERED,         // inside the inner deadzone, the stick is left alone
+    ANALOG_RESULT_MOVED,
+    ANALOG_RESULT_UNSURE,           // the float path could round the other way, ask it
+} AnalogResult;
+
 typedef struct
 {
     Pin_t x_pin;
     Pin_t y_pin;
     Pin_t x_pin_adc;
     Pin_t y_pin_adc;
-    float x_value;
-    float y_value;
+    uint32_t x_value;               // fixed point, see analog.cpp
+    uint32_t y_value;
     uint16_t x_center;
     uint16_t y_center;
-    float xy_magnitude;
-    float x_magnitude;
-    float y_magnitude;
+    int32_t x_magnitude;
+    int32_t y_magnitude;
+    uint8_t oversample_shift;
     InvertMode analog_invert;
     DpadMode analog_dpad;
-    float x_ema;
+    float x_ema;                    // smoothing runs in float, see emaCalculation()
     float y_ema;
     bool ema_option;
     float ema_smoothing;
-    float error_rate;
-    float in_deadzone;
-    float out_deadzone;
+    float ema_keep;                 // 1 - ema_smoothing
+    uint32_t error_rate;            // per mille
+    int64_t in_deadzone;            // inner deadzone radius times 1000 * 256, in positions
+    int64_t half_scale;             // distance past the inner deadzone that scales to half the axis
+    uint32_t scale_divisor;         // (outer - inner deadzone) * 4095 * error rate
+    uint32_t tolerance;             // how far off the float path can land, 2^-30 of an LSB per LSB of travel
+    uint64_t deadzone_threshold;    // squared distance from center still clearly inside the inner deadzone
+    bool float_only;                // settings the integer path can't follow
+    float error_rate_float;         // the float path, for results too close to call
+    float in_deadzone_float;
+    float out_deadzone_float;
     bool auto_calibration;
     bool forced_circularity;
     uint32_t joystick_center_x;
     uint32_t joystick_center_y;
+    AnalogResponseCurve curve;
+    int32_t curve_lut[ANALOG_CURVE_SEGMENTS + 1];
 } adc_instance;
 
 class AnalogInput : public GPAddon {
@@ -138,15 +207,23 @@ public:
     virtual void setup();       // Analog Setup
     virtual void process();     // Analog Process
     virtual void preprocess() {}
-    virtual void postprocess(bool sent) {}
+    virtual void postprocess(bool /*sent*/) {}
     virtual void reinit() {}
     virtual std::string name() { return AnalogName; }
+
+    // Back-to-back conversions through the ADC FIFO, returns their sum
+    static uint32_t burstRead(Pin_t pin_adc, uint32_t count, uint16_t * samples = nullptr);
+    static void measureNoise(Pin_t pin_adc, AnalogNoise & noise);
+    static AnalogNoiseSuggestion suggestNoiseSettings(const AnalogNoise & x, const AnalogNoise & y);
 private:
-    float readPin(int stick_num, Pin_t pin, uint16_t center);
+    uint32_t readPin(int stick_num, Pin_t pin, uint16_t center);
     float emaCalculation(int stick_num, float ema_value, float ema_previous);
     uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
-    float magnitudeCalculation(int stick_num, adc_instance & adc_inst);
-    void radialDeadzone(int stick_num, adc_instance & adc_inst);
+    AnalogResult scaleStick(int stick_num, adc_instance & adc_inst, uint32_t joystickMax, uint16_t & x, uint16_t & y);
+    AnalogResult scaleStickFloat(int stick_num, float x_value, float y_value, uint32_t joystickMax, uint16_t & x, uint16_t & y);
+    void buildScaling(int stick_num, float smoothing_factor, uint32_t error_rate, uint32_t inner_deadzone, uint32_t outer_deadzone);
+    void buildCurve(int stick_num, AnalogResponseCurve curve, uint32_t points);
+    uint32_t applyCurve(int stick_num, uint32_t deflection);
     adc_instance adc_pairs[ADC_COUNT];
 };
 
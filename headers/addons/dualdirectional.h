@@ -27,18 +27,11 @@ public:
     virtual std::string name() { return DualDirectionalName; }
 private:
     uint8_t gpadToBinary(DpadMode, GamepadState);
-    uint8_t updateDpadDDI(uint8_t dpad, DpadDirection direction);
-    uint8_t filterToFourWayModeDDI(uint8_t dpad);
-    void SOCDDualClean(SOCDMode);
-    uint8_t SOCDCombine(SOCDMode, uint8_t);
-    uint8_t SOCDGamepadClean(uint8_t, bool isLastWin);
     void OverrideGamepad(Gamepad *, DpadMode, uint8_t);
     const SOCDMode getSOCDMode(const GamepadOptions&);
     uint8_t dualState;          // Dual Directional State
-    DpadDirection lastGPUD; // Gamepad Last Up-Down
-    DpadDirection lastGPLR; // Gamepad Last Left-Right
-    DpadDirection lastDualUD; // Dual Last Up-Down
-    DpadDirection lastDualLR; // Gamepad Last Left-Right
+    DpadFilter dualFilter;      // Dual Directional 4-way and SOCD history
+    DpadFilter mixedFilter;     // SOCD history of the dual and gamepad directions combined
     GamepadButtonMapping *mapDpadUp;
     GamepadButtonMapping *mapDpadDown;
     GamepadButtonMapping *mapDpadLeft;
@@ -0,0 +1,77 @@
+#ifndef _GamepadUSBHostDecoder_H
+#define _GamepadUSBHostDecoder_H
+
+#include <stdint.h>
+
+#include "tusb_option.h"
+#include "gamepad/GamepadState.h"
+
+//
+// Generic HID gamepad decoder for USB host passthrough
+//
+// The report descriptor is parsed once at mount into an extraction plan: the bit
+// offset and size of every button block, hat, d-pad bit and axis in the gamepad's
+// input report. Plans are cached per VID/PID, interface and descriptor CRC so a
+// replug skips the parse, and a report is decoded by walking the plan with no
+// descriptor lookups.
+//
+// Usages are mapped like GP2040's own HID mode:
+//   Buttons 1-16  B3 B1 B2 B4 L1 R1 L2 R2 S1 S2 L3 R3 A1 A2 A3 A4
+//   Buttons 17-28 E1-E12
+//   X/Y -> left stick, Z/Rz -> right stick, Rx/Ry -> L2/R2 analog
+//   Brake/Accelerator -> L2/R2 analog, Hat switch and D-pad usages -> d-pad
+//
+
+#define HID_GAMEPAD_MAX_FIELDS      16
+#define HID_GAMEPAD_MAX_BUTTONS     28
+#define HID_GAMEPAD_PLAN_CACHE_SIZE (CFG_TUH_DEVICE_MAX + 1) // always room for a new device next to every mounted one
+
+typedef enum : uint8_t {
+    HID_GAMEPAD_FIELD_BUTTONS,
+    HID_GAMEPAD_FIELD_HAT,
+    HID_GAMEPAD_FIELD_DPAD,
+    HID_GAMEPAD_FIELD_LX,
+    HID_GAMEPAD_FIELD_LY,
+    HID_GAMEPAD_FIELD_RX,
+    HID_GAMEPAD_FIELD_RY,
+    HID_GAMEPAD_FIELD_LT,
+    HID_GAMEPAD_FIELD_RT,
+} HIDGamepadFieldType;
+
+typedef struct {
+    uint16_t bitOffset;
+    uint8_t bitSize;
+    uint8_t type;           // HIDGamepadFieldType
+    int32_t logicalMin;
+    uint32_t range;         // logical maximum - logical minimum
+    uint32_t scale;         // 16.16 factor from the logical range to the output range
+    uint8_t param;          // first button number - 1, d-pad mask, or 1 for a four way hat
+    bool isSigned;
+} HIDGamepadField;
+
+typedef struct {
+    uint8_t reportID;       // 0 if the device does not use report IDs
+    uint8_t numFields;
+    uint16_t reportBits;    // input report length needed for every field, without the ID
+    bool analog;            // has at least one stick axis
+    HIDGamepadField fields[HID_GAMEPAD_MAX_FIELDS];
+} HIDGamepadPlan;
+
+class GamepadUSBHostDecoder {
+public:
+    // Looks up or builds the plan for this device, false if the descriptor has no gamepad input
+    bool load(uint16_t vid, uint16_t pid, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
+    void release();
+    bool loaded() const { return plan != nullptr; }
+    bool analog() const { return plan != nullptr && plan->analog; }
+
+    // Decodes an input report into state, false if the report is not the gamepad's input report
+    bool decode(uint8_t const* report, uint16_t len, GamepadState & state) const;
+
+    static bool parse(uint8_t const* desc_report, uint16_t desc_len, HIDGamepadPlan & plan);
+private:
+    const HIDGamepadPlan * plan = nullptr;
+    uint8_t cacheIndex = 0;
+};
+
+#endif
@@ -2,16 +2,23 @@
 #define _GamepadUSBHostListener_H
 
 #include "usblistener.h"
+#include "usbhostinput.h"
+#include "addons/gamepad_usb_host_decoder.h"
 #include "gamepad.h"
 #include "host/usbh.h"
 #include "drivers/ps4/PS4Descriptors.h"
 #include "drivers/switchpro/SwitchProDescriptors.h"
+#include "drivers/xinput/XInputDescriptors.h"
+#include "drivers/shared/xinput_host.h"
 
 #define GAMEPAD_HOST_DEBUG false
 #define GAMEPAD_HOST_USE_FEATURES true
 
 const uint32_t GAMEPAD_HOST_POLL_INTERVAL_MS = 3;
 
+// One controller per device behind a hub
+#define GAMEPAD_HOST_MAX_CONTROLLERS CFG_TUH_DEVICE_MAX
+
 // Google Stadia controller report struct
 typedef struct TU_ATTR_PACKED
 {
@@ -121,32 +128,49 @@ typedef struct __attribute__((packed)) {
 } SwitchProHostReport;
 
 // Add other controller structs here
-class GamepadUSBHostListener : public USBListener {
-    public:// USB Listener Features
-        virtual void setup();
-        virtual void mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
-        virtual void xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype);
-        virtual void unmount(uint8_t dev_addr);
-        virtual void report_received(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len);
-        virtual void report_sent(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {}
-        virtual void set_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len);
-        virtual void get_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len);
-        void process();
+
+// A single mounted controller, everything here runs on the USB host core
+class GamepadUSBHostController {
+    public:
+        void mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
+        void xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype);
+        void unmount();
+        void report_received(uint8_t const* report, uint16_t len);
+        void set_report_complete(uint8_t report_id, uint8_t report_type, uint16_t len);
+        void get_report_complete(uint8_t report_id, uint8_t report_type, uint16_t len);
+        void host_task();
+
+        bool enabled() const { return _controller_host_enabled; }
+        bool matches(uint8_t dev_addr, uint8_t instance) const {
+            return _controller_host_enabled && _controller_dev_addr == dev_addr && _controller_instance == instance;
+        }
+        bool is_xinput_on(uint8_t dev_addr) const {
+            return _controller_host_enabled && _controller_dev_addr == dev_addr && _controller_type != xinput_type_t::UNKNOWN;
+        }
+        uint8_t dev_addr() const { return _controller_dev_addr; }
+
+        // Core0 reads parsed input from here
+        USBHostInputSlot inputSlot;
     private:
+        void reset_state();
+        void publish();
+
         bool awaiting_cb = false;
         bool host_get_report(uint8_t report_id, void* report, uint16_t len);
         bool host_set_report(uint8_t report_id, void* report, uint16_t len);
 
         GamepadState _controller_host_state;
         bool _controller_host_analog = true;
-        bool _controller_host_enabled;
+        GamepadUSBHostDecoder hidDecoder;   // generic HID controllers
+        bool _controller_host_enabled = false;
         uint8_t _controller_dev_addr = 0;
         uint8_t _controller_instance = 0;
         uint8_t _controller_type = 0; // 0 = HID, 1 = Xbox 360, 2 = Xbox One (see xinput_type_t)
         uint32_t _next_update = 0;
+        USBHostInput _published = {};
         // reliable update (e.g for rumble) called every GAMEPAD_HOST_POLL_INTERVAL_MS ms
         void update_ctrlr();
-        void process_ctrlr_report(uint8_t dev_addr, uint8_t const* report, uint16_t len);
+        void process_ctrlr_report(uint8_t const* report, uint16_t len);
 
         // Controller report processor functions
         bool isDS4Identified = false;
@@ -161,14 +185,17 @@ class GamepadUSBHostListener : public USBListener {
         void process_ds4(uint8_t const* report, uint16_t len);
         PS4ControllerConfig ds4Config;
         uint8_t report_buffer[PS4_ENDPOINT_SIZE];
+        PS4Report prev_ds4_report = { 0 };
 
         void process_ds(uint8_t const* report, uint16_t len);
+        DSReport prev_ds_report = { 0 };
 
         // switch pro
         bool switchProFinished = false;
         uint8_t switchProState = SwitchOutputSubtypes::IDENTIFY;
         uint8_t switchReportCounter = 0;
         uint8_t lastSwitchLed = 0;
+        SwitchProReport prev_switch_report = { 0 };
         void setup_switch_pro(uint8_t const *report, uint16_t len);
         void update_switch_pro();
         void process_switch_pro(uint8_t const* report, uint16_t len);
@@ -186,6 +213,9 @@ class GamepadUSBHostListener : public USBListener {
         // sync controller rumble and LED states
         void update_xinput(uint8_t dev_addr, uint8_t instance);
         void process_xbox360(uint8_t const* report, uint16_t len);
+        XInputReport prev_xinput_report = { 0 };
+        uint8_t last_left_rumble = 0;
+        uint8_t last_right_rumble = 0;
 
         uint16_t controller_pid, controller_vid;
 
@@ -202,4 +232,24 @@ class GamepadUSBHostListener : public USBListener {
         void process_dfgt(uint8_t const* report, uint16_t len);
 };
 
-#endif
+// Parses controllers on the USB host core (core1), process() merges them into the gamepad on core0
+class GamepadUSBHostListener : public USBListener {
+    public:// USB Listener Features
+        virtual void setup();
+        virtual void mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
+        virtual void xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype);
+        virtual void unmount(uint8_t dev_addr);
+        virtual void report_received(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len);
+        virtual void report_sent(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {}
+        virtual void set_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len);
+        virtual void get_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len);
+        virtual void host_task();
+        void process();
+    private:
+        GamepadUSBHostController * find_controller(uint8_t dev_addr, uint8_t instance);
+        GamepadUSBHostController * free_controller();
+
+        GamepadUSBHostController controllers[GAMEPAD_HOST_MAX_CONTROLLERS];
+};
+
+#endif
\ No newline at end of file
@@ -47,6 +47,16 @@
 #define HETRIGGER_SMOOTHING_FACTOR 5
 #endif
 
+// Time the mux output needs to settle after the select lines change
+#ifndef HETRIGGER_MUX_SETTLE_US
+#define HETRIGGER_MUX_SETTLE_US 10
+#endif
+
+// ADC samples averaged per trigger per scan
+#ifndef HETRIGGER_OVERSAMPLE
+#define HETRIGGER_OVERSAMPLE 4
+#endif
+
 #ifndef HETRIGGER_DEFAULT_IDLE
 #define HETRIGGER_DEFAULT_IDLE 150
 #endif
@@ -859,21 +869,44 @@ public:
     virtual std::string name() { return HETriggerAddonName; }
 private:
     void selectChannel(uint8_t channel);
-    uint16_t emaSmoothing(uint16_t value, uint16_t previous);
+    uint16_t emaSmoothing(uint8_t he, uint16_t value);
+    void storeChannel(uint8_t channel, const uint32_t * sums, uint16_t * frame);
+    void scanPolled();
+    void startScanner();
+    void completeStep(uint8_t buffer);
+    void restartSteps();
+    static void dmaIRQ();
+    uint32_t muxChannels;
     int muxTotal;
     int selectPins;
     Pin_t muxPinArray[4];
     Pin_t selectPinArray[4];
-    Pin_t lastADCSelected;
 
-    uint16_t emaSmoothingReads[32];
+    uint32_t emaSmoothingReads[32]; // 12.4 fixed point
     bool triggerActive[32];
     uint16_t lastIncrement[32];
-    float emaSmoothingFactor;
+    bool emaEnabled;
+    uint16_t emaSmoothingFactor;    // 0.8 fixed point
+
+    // Background scan: the ADC runs round robin over every mux ADC pin and DMA
+    // fills two step buffers in turn, one mux channel per step. The DMA IRQ moves
+    // the select lines on, averages the settled samples and publishes a frame of
+    // every trigger once the last channel is done.
+    bool scannerRunning;
+    uint8_t scanChannels[16];       // mux channels with at least one trigger in use
+    uint8_t scanChannelCount;
+    uint8_t scanChannelIndex;       // position of the channel being sampled into the running buffer
+    uint8_t adcInputCount;          // ADC inputs in the round robin
+    uint8_t slotInputs[4];          // ADC input at each round robin position
+    int8_t muxSlot[4];              // round robin position of each mux ADC, -1 if unused
+    uint8_t settleRounds;           // leading round robin passes discarded in each step
+    uint32_t stepSamples;           // samples per step buffer
+    int dmaChannels[2];
+    uint8_t bufferChannel[2];
+    uint16_t scanFrames[2][HETRIGGER_COUNT];
+    volatile uint8_t scanFront;
 
     // Used during processing
-    uint32_t mux;
-    uint32_t channel;
     uint16_t value;
     uint16_t activationThreshold;
     uint16_t releaseThreshold;
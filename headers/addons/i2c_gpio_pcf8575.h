@@ -20,6 +20,14 @@
 
 #define PCF8575_PIN_COUNT 16
 
+// INT output of the expander, open drain and low while any input differs from the last read
+#ifndef PCF8575_INTERRUPT_PIN
+#define PCF8575_INTERRUPT_PIN -1
+#endif
+
+// With INT connected, the pins are still read this often in case an edge was missed
+#define PCF8575_WATCHDOG_MS 100
+
 // IO pin defaults
 #ifndef PCF8575_PIN00_DIRECTION
 #define PCF8575_PIN00_DIRECTION GpioDirection::GPIO_DIRECTION_INPUT
@@ -150,6 +158,16 @@ public:
 private:
     PCF8575* pcf;
 
+    int32_t interruptPin = -1;
+    uint32_t nextWatchdog = 0;
+    uint16_t inputMask = 0;
+    uint16_t debouncedInputs = 0;               // 1 = pressed
+    uint32_t inputDebounceTime[PCF8575_PIN_COUNT] = {};
+
+    static volatile bool inputChanged;
+    static void interruptIRQ();
+    void readInputs();
+
     bool inputButtonUp = false;
     bool inputButtonDown = false;
     bool inputButtonLeft = false;
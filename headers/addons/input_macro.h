@@ -4,6 +4,10 @@
 #include "gpaddon.h"
 
 #include "GamepadEnums.h"
+#include "macrostore.h"
+#include "usbframeclock.h"
+
+#include "eventmanager.h"
 
 #ifndef INPUT_MACRO_ENABLED
 #define INPUT_MACRO_ENABLED 0
@@ -27,7 +31,47 @@
 
 #define MAX_MACRO_INPUT_LIMIT 30
 #define MAX_MACRO_LIMIT 6
+static_assert(MAX_MACRO_LIMIT == MACRO_STORE_MAX_MACROS, "Macro store and Input Macro disagree on the macro count");
 #define INPUT_HOLD_US 16666
+// Macros shown in frames count INPUT_HOLD_US per frame, they run on exact 60 Hz frames
+#define INPUT_MACRO_FRAME_NS 16666667ULL
+
+// Input changes kept while recording, the oldest are dropped first
+#define INPUT_MACRO_RECORD_EVENTS 256
+// Longer gaps without any input are shortened to this
+#define INPUT_MACRO_RECORD_MAX_IDLE_MS 500
+// A recording is written to flash once all inputs have been released for this long
+#define INPUT_MACRO_RECORD_SAVE_IDLE_MS 1000
+
+typedef enum {
+    MACRO_RECORD_OFF,
+    MACRO_RECORD_ARMED,     // waiting for a macro trigger to pick the slot
+    MACRO_RECORD_RUNNING,
+} MacroRecordState;
+
+typedef struct {
+    uint32_t frame;
+    uint32_t buttonMask;    // macro input mask, D-pad in the upper bits
+} MacroRecordEvent;
+
+// One compiled step, ends are in USB frames (1 ms) from the start of the macro
+typedef struct {
+    uint32_t buttonMask;
+    uint32_t pressEnd;
+    uint32_t stepEnd;
+    uint8_t dpad;
+} MacroStep;
+
+typedef struct {
+    uint16_t firstStep;
+    uint16_t stepCount;
+    uint32_t macroTriggerButton;
+    MacroType macroType;
+    bool enabled;
+    bool useMacroTriggerButton;
+    bool exclusive;
+    bool interruptible;
+} MacroProgram;
 
 // Input Macro Module Name
 #define InputMacroName "Input Macro"
@@ -38,26 +82,42 @@ public:
     virtual void setup();       // Analog Setup
     virtual void process() {};     // Analog Process
     virtual void preprocess();
-    virtual void postprocess(bool sent) {}
+    virtual void postprocess(bool sent);
     virtual void reinit();
     virtual std::string name() { return InputMacroName; }
 private:
-    void checkMacroPress();
+    void compile(const MacroStoreData * store);
+    uint32_t frameClock();
+    void handleMacroRecord(GPEvent* e);
+    void recordInput();
+    void finishRecording();
+    void checkMacroPress(bool includeDisabled = false);
     void checkMacroAction();
     void runCurrentMacro();
     void reset();
-    void restart(Macro& macro);
     bool isMacroRunning;
     bool isMacroTriggerHeld;
     int macroPosition;
     uint32_t macroButtonMask;
     uint32_t macroPinMasks[6];
-    uint64_t macroStartTime;
-    uint64_t currentMicros;
+    MacroProgram macroPrograms[MAX_MACRO_LIMIT];
+    MacroStep macroSteps[MACRO_STORE_MAX_INPUTS];
+    bool useFrameClock;         // SOF count of the USB device, milliseconds while not mounted
+    USBFrameClock usbFrames;
+    uint32_t currentFrame;
+    uint32_t macroStartFrame;
     int pressedMacro;
     int macroInputPosition;
-    uint32_t macroInputHoldTime;
     bool prevMacroInputPressed;
+    MacroRecordState recordState;
+    int recordSlot;
+    bool recordWaitRelease;     // the trigger picking the slot is not part of the recording
+    uint32_t lastRecordMask;
+    MacroRecordEvent recordEvents[INPUT_MACRO_RECORD_EVENTS];
+    uint16_t recordHead;
+    uint16_t recordCount;
+    bool recordSavePending;
+    uint32_t recordIdleSince;
     bool boardLedEnabled;
     MacroOptions * inputMacroOptions;
 };
@@ -2,6 +2,7 @@
 #define _KeyboardHostListener_H
 
 #include "usblistener.h"
+#include "usbhostinput.h"
 #include "gamepad.h"
 #include "class/hid/hid.h"
 
@@ -22,7 +23,25 @@ struct KeyboardButtonMapping
     bool isAssigned() const { return key != 0xff; }
 };
 
+// One keyboard or mouse per HID interface, hubs can carry several of each
+#define KEYBOARD_HOST_MAX_DEVICES CFG_TUH_HID
 
+// A mounted keyboard or mouse, parsed on the USB host core
+struct KeyboardHostDevice
+{
+    bool mounted = false;
+    bool mouse = false;
+    uint8_t dev_addr = 0;
+    uint8_t instance = 0;
+    GamepadState state;
+    int16_t mouseX = 0;
+    int16_t mouseY = 0;
+    int16_t mouseZ = 0;
+    uint32_t mouseResetNextTimer = 0;
+    USBHostInputSlot inputSlot; // Core0 reads parsed input from here
+};
+
+// Parses keyboards and mice on the USB host core (core1), process() merges them into the gamepad on core0
 class KeyboardHostListener : public USBListener {
 public:// USB Listener Features
     virtual void setup();
@@ -33,13 +52,17 @@ public:// USB Listener Features
     virtual void report_sent(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {}
     virtual void set_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {}
     virtual void get_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {}
+    virtual void host_task();
     void process();
 private:
     uint8_t getKeycodeFromModifier(uint8_t modifier);
-    void preprocess_report();
-    void process_kbd_report(uint8_t dev_addr, hid_keyboard_report_t const *report);
-    void process_mouse_report(uint8_t dev_addr, hid_mouse_report_t const *report);
+    void preprocess_report(GamepadState & state);
+    void process_kbd_report(KeyboardHostDevice & device, hid_keyboard_report_t const *report);
+    void process_mouse_report(KeyboardHostDevice & device, hid_mouse_report_t const *report);
+    void publish(KeyboardHostDevice & device);
     uint16_t scaleMouseToJoystick(int8_t mouseVal);
+    uint16_t getJoystickMid();
+    void refreshJoystickMid();
     KeyboardButtonMapping _keyboard_host_mapDpadUp;
     KeyboardButtonMapping _keyboard_host_mapDpadDown;
     KeyboardButtonMapping _keyboard_host_mapDpadLeft;
@@ -60,13 +83,7 @@ private:
     KeyboardButtonMapping _keyboard_host_mapButtonA2;
     KeyboardButtonMapping _keyboard_host_mapButtonA3;
     KeyboardButtonMapping _keyboard_host_mapButtonA4;
-    GamepadState _keyboard_host_state;
-    bool _keyboard_host_mounted;
-    uint8_t _keyboard_dev_addr;
-    uint8_t _keyboard_instance;
-    bool _mouse_host_mounted;
-    uint8_t _mouse_dev_addr;
-    uint8_t _mouse_instance;
+    KeyboardHostDevice devices[KEYBOARD_HOST_MAX_DEVICES];
     uint16_t mouseLeftMapping;
     uint16_t mouseMiddleMapping;
     uint16_t mouseRightMapping;
@@ -74,12 +91,7 @@ private:
     uint8_t mouseMovementMode;
     float mouseSensitivityScale;
     uint32_t mouseResetMS;
-    uint32_t mouseResetNextTimer;
-    int16_t joystickMid;
-    int16_t mouseX;
-    int16_t mouseY;
-    int16_t mouseZ;
-    bool mouseActive;
+    uint16_t joystickMid;       // Core1: center the device states were built around
 };
 
 #endif  // _KeyboardHost_H_
@@ -6,6 +6,8 @@
 #include "GamepadEnums.h"
 #include "types.h"
 
+#include "hardware/pio.h"
+
 #ifndef ROTARY_ENCODER_ENABLED
 #define ROTARY_ENCODER_ENABLED 0
 #endif
@@ -77,6 +79,7 @@
 #define MAX_ENCODERS 2
 #define ENCODER_RADIUS 1440 // 4 phases * 360
 #define ENCODER_PRECISION 16
+#define ENCODER_PIO_SHIFT 1 // the PIO counts all 4 edges per pulse, the encoder value moves on 2
 
 // RotaryEncoderName Module Name
 #define RotaryEncoderName "Rotary"
@@ -103,6 +106,9 @@ public:
         uint32_t resetAfter = 0;
         bool allowWrapAround = false;
         double multiplier = 0;
+        // precomputed from the properties above
+        int32_t increment = 0;          // encoder value per step
+        int32_t totalPositions = 0;     // encoder values over the mapped range
     } EncoderPinMap;
 
     typedef struct {
@@ -113,6 +119,9 @@ public:
         uint32_t updateTime = 0;
         uint32_t changeTime = 0;
         uint8_t delay = 1;
+        int8_t stateMachine = -1;       // PIO state machine counting the encoder, -1 when polled
+        bool swapped = false;           // pin B is the lower pin
+        int32_t count = 0;              // last PIO count
     } EncoderPinState;
 private:
     EncoderPinState encoderState[MAX_ENCODERS];
@@ -123,11 +132,17 @@ private:
         {false, -1, -1, 24, ENCODER_MODE_NONE, -1, -1},
     };
 
+    PIO pio = nullptr;
+
+    bool startPIO(uint8_t index);
+    int32_t readSteps(uint8_t index);
+    int32_t pollSteps(uint8_t index, uint32_t now);
+
     int32_t map(int32_t x, int32_t in_min, int32_t in_max, int32_t out_min, int32_t out_max);
     int32_t bounds(int32_t x, int32_t out_min, int32_t out_max);
-    uint16_t mapEncoderValueStick(int8_t index, int32_t encoderValue, uint16_t ppr);
-    uint16_t mapEncoderValueTrigger(int8_t index, int32_t encoderValue, uint16_t ppr);
-    int8_t mapEncoderValueDPad(int8_t index, int32_t encoderValue, uint16_t ppr);
+    uint16_t mapEncoderValueStick(int8_t index, int32_t encoderValue);
+    uint16_t mapEncoderValueTrigger(int8_t index, int32_t encoderValue);
+    int8_t mapEncoderValueDPad(int8_t index, int32_t encoderValue);
 
     int8_t getEncoderIndexByPin(uint8_t pin);
     
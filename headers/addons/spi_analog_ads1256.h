@@ -42,14 +42,17 @@ public:
     virtual void reinit() {}
     virtual std::string name() { return SPIAnalog1256Name; }
 private:
-    uint8_t convert24to8bit(float voltage);
-    uint16_t convert24to16bit(float voltage);
+    uint8_t convert24to8bit(int32_t raw);
+    uint16_t convert24to16bit(int32_t raw);
 
     ADS1256 * ads;
-    float values[ADS1256_CHANNEL_COUNT]; // Cache for latest read values
+    int32_t values[ADS1256_CHANNEL_COUNT] = {}; // Cache for latest raw codes
     bool enableTriggers;
+    bool acquiring; // ADC is read in the background
     uint8_t readChannelCount; // Number of channels to read from the ADC
-    float analogMax = ADS1256_MAX_3V * 10.0f;
+    int32_t rawMax; // raw code at AVDD
+    uint64_t scale16; // 32.32 factors from 0..rawMax to the output ranges
+    uint64_t scale8;
 };
 
 #endif  // SPI_ANALOG_ADS1256_H_
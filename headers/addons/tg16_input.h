@@ -36,6 +36,19 @@
 #define TG16_PAD_DATA_PIN3 -1
 #endif
 
+// Time for the pad's multiplexer and the cable to settle after OE/SELECT change
+#ifndef TG16_PAD_SETTLE_US
+#define TG16_PAD_SETTLE_US 10
+#endif
+
+// A scan starts this often, a six button pad needs two scans for all of its buttons
+#ifndef TG16_PAD_SCAN_US
+#define TG16_PAD_SCAN_US 500
+#endif
+
+// Extra buttons are dropped if the pad stops answering six button scans for this long
+#define TG16_SIX_BUTTON_TIMEOUT_US 150000
+
 class TG16padInput : public GPAddon {
 public:
     virtual bool available();
@@ -46,9 +59,6 @@ public:
     virtual void reinit() {}
     virtual std::string name() { return TG16padName; }
 private:
-    uint32_t uIntervalMS;
-    uint32_t nextTimer;
-
     bool buttonI = false;
     bool buttonII = false;
     bool buttonSelect = false;
@@ -64,7 +74,6 @@ private:
     uint16_t rightY = 0;
 
     uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
-    uint8_t readController();
     void updateButtons(uint16_t data);
 };
 
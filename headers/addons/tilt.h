@@ -102,19 +102,12 @@ public:
 
     void handleProfileChange(GPEvent* e);
 private:
-    void SOCDTiltClean(SOCDMode);
-    uint8_t SOCDCombine(SOCDMode, uint8_t);
-    uint8_t SOCDGamepadClean(uint8_t);
     void OverrideGamepad(Gamepad*, uint8_t, uint8_t);
     uint16_t getAnalogValue(bool isMin, bool isMax);
     uint8_t tiltLeftState;          // Tilt State
     uint8_t tiltRightState;          // Tilt Right Analog State
-    DpadDirection lastGPUD; // Gamepad Last Up-Down
-    DpadDirection lastGPLR; // Gamepad Last Left-Right
-    DpadDirection leftLastTiltUD; // Tilt Last Up-Down
-    DpadDirection leftLastTiltLR; // Gamepad Last Left-Right
-    DpadDirection rightLastTiltUD; // Tilt Last Up-Down
-    DpadDirection rightLastTiltLR; // Gamepad Last Left-Right
+    DpadFilter leftFilter;  // Tilt Left SOCD history
+    DpadFilter rightFilter; // Tilt Right SOCD history
     uint32_t dpadTime[4];
     uint8_t tilt1FactorLeftX;
     uint8_t tilt1FactorLeftY;
@@ -5,6 +5,7 @@
 #include "storagemanager.h"
 #include "eventmanager.h"
 #include "enums.pb.h"
+#include "usbframeclock.h"
 
 #ifndef TURBO_ENABLED
 #define TURBO_ENABLED 0
@@ -18,6 +19,12 @@
 #define TURBO_BUTTON_MASK (GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2 | GAMEPAD_MASK_B3 | GAMEPAD_MASK_B4 | \
                             GAMEPAD_MASK_L1 | GAMEPAD_MASK_R1 | GAMEPAD_MASK_L2 | GAMEPAD_MASK_R2)
 
+// Buttons with their own shot count, in TurboOptions order
+#define TURBO_RATE_BUTTON_COUNT 8
+
+// Turbo phases count buttons from bit 0 to bit 15
+#define TURBO_PHASE_BUTTON_COUNT 16
+
 // TURBO LED
 #ifndef TURBO_LED_PIN
 #define TURBO_LED_PIN -1
@@ -106,12 +113,14 @@ public:
     virtual void reinit();
     virtual void preprocess() {}
     virtual void process();     // TURBO Setting of buttons (Enable/Disable)
-    virtual void postprocess(bool sent) {}
+    virtual void postprocess(bool sent);
     virtual std::string name() { return TurboName; }
 
     void handleEncoder(GPEvent* e);
 private:
     void updateTurboShotCount(uint8_t turboShotCount, bool save = true);
+    uint32_t frameClock();
+    uint16_t getFlickerMask(uint16_t pressed);
     Mask_t turboPinMask;        // Pin mask for Turbo pin
     bool bDebState;             // Debounce TURBO Button State
     uint32_t uDebTime;          // Debounce TURBO Button Time
@@ -121,12 +130,14 @@ private:
     uint8_t lastDpad;           // Last d-pad pressed (for Turbo Change)
     uint16_t turboButtonsMask;  // Turbo Buttons Enabled
     uint16_t alwaysEnabled;     // Turbo SHMUP Always Enabled
-    uint32_t uIntervalUS;       // Turbo Interval in microseconds
     uint32_t chargeState;       // Turbo Charge Button States
-    bool bTurboFlicker;         // Turbo Enable Buttons Toggle OFF Flag ??
-    uint64_t nextTimer;         // Turbo Timer
+    USBFrameClock usbFrames;    // Turbo phases are counted in USB frames
+    uint16_t lastTurboPressed;  // Turbo buttons held in the previous loop
+    uint32_t turboStart[TURBO_PHASE_BUTTON_COUNT];     // Frame each turbo button was pressed on
+    uint8_t buttonShotCount[TURBO_PHASE_BUTTON_COUNT]; // Per button shot count, 0 follows the global one
     uint8_t adcShmupDial;       // Turbo ADC Dial Input
-    uint64_t nextAdcRead;       // ADC read timer
+    uint32_t nextAdcRead;       // ADC read timer
+    bool adcConverting;         // Dial conversion started in process, collected in postprocess
     bool hasShmupDial;          // Flag for shmup dial presence
     uint16_t dialValue;         // Turbo Dial Value (Raw)
     uint16_t incrementValue;    // Turbo Dial Increment Value
@@ -38,6 +38,9 @@
 #define WII_EXTENSION_I2C_SPEED 400000
 #endif
 
+// Reports are read in the background, setup waits this long for the first one
+#define WII_FIRST_REPORT_TIMEOUT_MS 20
+
 #define WII_SET_MASK(bits, check, val) ((check) ? ((bits) |= (val)) : ((bits) &= ~(val)))
 
 typedef enum {
@@ -120,6 +120,7 @@ class MainMenuScreen : public GPScreen {
         };
         InputMode prevInputMode{};
         InputMode updateInputMode{};
+        bool inputModeUnsaved = false;
 
         std::vector<MenuEntry> dpadModeMenu = {
             DpadMode_VALUELIST(DPAD_MODE_ENTRIES)
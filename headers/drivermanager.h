@@ -3,6 +3,20 @@
 
 #include "enums.pb.h"
 #include "gpdriver.h"
+#include "usbtelemetry.h"
+
+// Time the device stays off the bus during a live input mode switch so the host notices the detach
+#define INPUT_MODE_SWITCH_DETACH_MS 100
+
+// How long a live input mode switch waits for core1 to park before giving up
+#define INPUT_MODE_SWITCH_PAUSE_TIMEOUT_MS 500
+
+// The telemetry driver goes ahead of the gamepad driver, XInput's open() takes any vendor interface
+#if USB_TELEMETRY_ENABLED
+#define DRIVER_MANAGER_CLASS_DRIVERS 2
+#else
+#define DRIVER_MANAGER_CLASS_DRIVERS 1
+#endif
 
 class GPDriver;
 
@@ -15,13 +29,29 @@ public:
         return instance;
     }
     GPDriver * getDriver() { return driver; }
+    const usbd_class_driver_t * getClassDrivers(uint8_t * count) {
+        *count = DRIVER_MANAGER_CLASS_DRIVERS;
+        return classDrivers;
+    }
     void setup(InputMode);
+    bool switchInputMode(InputMode); // Core0: swap drivers and re-enumerate without a reboot
+    void checkAuxPause();            // Core1: parks here while a switch is in progress
     InputMode getInputMode(){ return inputMode; }
     bool isConfigMode(){ return (inputMode == INPUT_MODE_CONFIG); }
 private:
     DriverManager() {}
+    GPDriver * createDriver(InputMode);
     GPDriver * driver = nullptr;
     InputMode inputMode = INPUT_MODE_XINPUT;
+
+    // TinyUSB keeps the pointer and count from usbd_app_driver_get_cb, so it
+    // always points here and the active driver's class driver is copied into
+    // the last slot
+    usbd_class_driver_t classDrivers[DRIVER_MANAGER_CLASS_DRIVERS];
+
+    volatile bool auxPauseRequested = false;
+    volatile bool auxPaused = false;
+    volatile bool auxInitPending = false; // core1 runs the new driver's initializeAux() when it is released
 };
 
-#endif
\ No newline at end of file
+#endif
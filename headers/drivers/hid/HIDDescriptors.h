@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "descriptorbuilder.h"
 
 #define HID_ENDPOINT_SIZE 64
 
@@ -64,12 +65,13 @@ typedef struct __attribute((packed, aligned(1)))
 	uint8_t r_y_axis;
 } HIDReport;
 
-static const uint8_t hid_string_language[]     = { 0x09, 0x04 };
-static const uint8_t hid_string_manufacturer[] = "Open Stick Community";
-static const uint8_t hid_string_product[]      = "GP2040-CE (Generic)";
-static const uint8_t hid_string_version[]      = "1.0";
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto hid_string_language     = USBDescriptor::language(0x0009);
+static constexpr auto hid_string_manufacturer = USBDescriptor::string("Open Stick Community");
+static constexpr auto hid_string_product      = USBDescriptor::string("GP2040-CE (Generic)");
+static constexpr auto hid_string_version      = USBDescriptor::string("1.0");
 
-static const uint8_t *hid_string_descriptors[] __attribute__((unused)) =
+static const uint16_t *hid_string_descriptors[] __attribute__((unused)) =
 {
 	hid_string_language,
 	hid_string_manufacturer,
@@ -77,101 +79,75 @@ static const uint8_t *hid_string_descriptors[] __attribute__((unused)) =
 	hid_string_version
 };
 
-static const uint8_t hid_device_descriptor[] =
-{
-	18,								  // bLength
-	1,								  // bDescriptorType
-	0x00, 0x02,							  // bcdUSB
-	0,								  // bDeviceClass
-	0,								  // bDeviceSubClass
-	0,								  // bDeviceProtocol
-	HID_ENDPOINT_SIZE,						  // bMaxPacketSize0
-	LSB(VENDOR_ID), MSB(VENDOR_ID),					  // idVendor
-	LSB(PRODUCT_ID), MSB(PRODUCT_ID),				  // idProduct
-	0x00, 0x01,							  // bcdDevice
-	1,								  // iManufacturer
-	2,								  // iProduct
-	0,								  // iSerialNumber
-	1								  // bNumConfigurations
-};
-
-static const uint8_t hid_report_descriptor[] =
-{
-	0x05, 0x01,        // USAGE_PAGE (Generic Desktop)
-	0x09, 0x05,        // USAGE (Gamepad)
-	0xa1, 0x01,        // COLLECTION (Application)
-	// 32 buttons
-	0x05, 0x09,        //   USAGE_PAGE (Button)
-	0x19, 0x01,        //   USAGE_MINIMUM (Button 1)
-	0x29, 0x20,        //   USAGE_MAXIMUM (Button 32)
-	0x15, 0x00,        //   LOGICAL_MINIMUM (0)
-	0x25, 0x01,        //   LOGICAL_MAXIMUM (1)
-	0x95, 0x20,        //   REPORT_COUNT (32)
-	0x75, 0x01,        //   REPORT_SIZE (1)
-	0x81, 0x02,        //   INPUT (Data,Var,Abs)
-	// hat (dpad)
-	0x05, 0x01,        //   USAGE_PAGE (Generic Desktop)
-	0x09, 0x39,        //   USAGE (Hat switch)
-	0x25, 0x07,        //   LOGICAL_MAXIMUM (7)
-	0x95, 0x01,        //   REPORT_COUNT (1)
-	0x75, 0x04,        //   REPORT_SIZE (4)
-	0x81, 0x42,        //   INPUT (Data,Var,Abs,Null)
-	// padding the hat
-	0x95, 0x01,        //   REPORT_COUNT (1)
-	0x75, 0x04,        //   REPORT_SIZE (4)
-	0x81, 0x01,        //   INPUT (Cnst,Ary,Abs)
-	// analogs
-	0x05, 0x01,        //   USAGE_PAGE (Generic Desktop)
-	0x26, 0xff, 0x00,  //   LOGICAL_MAXIMUM (255)
-	0x46, 0xff, 0x00,  //   PHYSICAL_MAXIMUM (255)
-	0x09, 0x30,        //   USAGE (X)
-	0x09, 0x31,        //   USAGE (Y)
-	0x09, 0x32,        //   USAGE (Z)
-	0x09, 0x35,        //   USAGE (Rz)
-	0x75, 0x08,        //   REPORT_SIZE (8)
-	0x95, 0x04,        //   REPORT_COUNT (4)
-	0x81, 0x02,        //   INPUT (Data,Var,Abs)
-	// done
-	0xc0               // END_COLLECTION
-};
-
-#define CONFIG1_DESC_SIZE		(9+9+9+7)
-static const uint8_t hid_configuration_descriptor[] =
-{
-	// configuration descriptor, USB spec 9.6.3, page 264-266, Table 9-10
-	9,						       // bLength;
-	2,						       // bDescriptorType;
-	LSB(CONFIG1_DESC_SIZE),				       // wTotalLength
-	MSB(CONFIG1_DESC_SIZE),
-	1,						       // bNumInterfaces
-	1,						       // bConfigurationValue
-	0,						       // iConfiguration
-	0x80,						       // bmAttributes
-	50,						       // bMaxPower
+static constexpr auto hid_device_descriptor = USBDescriptor::device(
+	0x0200,                 // bcdUSB
+	0,                      // bDeviceClass
+	0,                      // bDeviceSubClass
+	0,                      // bDeviceProtocol
+	HID_ENDPOINT_SIZE,      // bMaxPacketSize0
+	VENDOR_ID,              // idVendor
+	PRODUCT_ID,             // idProduct
+	0x0100,                 // bcdDevice
+	1,                      // iManufacturer
+	2,                      // iProduct
+	0,                      // iSerialNumber
+	1                       // bNumConfigurations
+);
+
+static constexpr auto hid_report_descriptor = USBDescriptor::hidReport([] {
+	using namespace USBDescriptor::HIDItem;
+	return items(
+		usagePage(0x01),        // USAGE_PAGE (Generic Desktop)
+		usage(0x05),            // USAGE (Gamepad)
+		collection(0x01),       // COLLECTION (Application)
+		// 32 buttons
+		usagePage(0x09),        //   USAGE_PAGE (Button)
+		usageMinimum(0x01),     //   USAGE_MINIMUM (Button 1)
+		usageMaximum(0x20),     //   USAGE_MAXIMUM (Button 32)
+		logicalMinimum(0),      //   LOGICAL_MINIMUM (0)
+		logicalMaximum(1),      //   LOGICAL_MAXIMUM (1)
+		reportCount(32),        //   REPORT_COUNT (32)
+		reportSize(1),          //   REPORT_SIZE (1)
+		input(0x02),            //   INPUT (Data,Var,Abs)
+		// hat (dpad)
+		usagePage(0x01),        //   USAGE_PAGE (Generic Desktop)
+		usage(0x39),            //   USAGE (Hat switch)
+		logicalMaximum(7),      //   LOGICAL_MAXIMUM (7)
+		reportCount(1),         //   REPORT_COUNT (1)
+		reportSize(4),          //   REPORT_SIZE (4)
+		input(0x42),            //   INPUT (Data,Var,Abs,Null)
+		// padding the hat
+		reportCount(1),         //   REPORT_COUNT (1)
+		reportSize(4),          //   REPORT_SIZE (4)
+		input(0x01),            //   INPUT (Cnst,Ary,Abs)
+		// analogs
+		usagePage(0x01),        //   USAGE_PAGE (Generic Desktop)
+		logicalMaximum(255),    //   LOGICAL_MAXIMUM (255)
+		physicalMaximum(255),   //   PHYSICAL_MAXIMUM (255)
+		usage(0x30),            //   USAGE (X)
+		usage(0x31),            //   USAGE (Y)
+		usage(0x32),            //   USAGE (Z)
+		usage(0x35),            //   USAGE (Rz)
+		reportSize(8),          //   REPORT_SIZE (8)
+		reportCount(4),         //   REPORT_COUNT (4)
+		input(0x02),            //   INPUT (Data,Var,Abs)
+		// done
+		endCollection()         // END_COLLECTION
+	);
+});
+
+static constexpr auto hid_configuration_descriptor = USBDescriptor::configuration(
+	1,                      // bConfigurationValue
+	0,                      // iConfiguration
+	0x80,                   // bmAttributes
+	50,                     // bMaxPower
 	// interface descriptor, USB spec 9.6.5, page 267-269, Table 9-12
-	9,						       // bLength
-	4,						       // bDescriptorType
-	GAMEPAD_INTERFACE,				       // bInterfaceNumber
-	0,						       // bAlternateSetting
-	1,						       // bNumEndpoints
-	0x03,						       // bInterfaceClass (0x03 = HID)
-	0x00,						       // bInterfaceSubClass (0x00 = No Boot)
-	0x00,						       // bInterfaceProtocol (0x00 = No Protocol)
-	0,						       // iInterface
+	USBDescriptor::interface(GAMEPAD_INTERFACE, 0, 1, 0x03, 0x00, 0x00, 0), // HID, no boot, no protocol
 	// HID interface descriptor, HID 1.11 spec, section 6.2.1
-	9,						       // bLength
-	0x21,						       // bDescriptorType
-	0x11, 0x01,					       // bcdHID
-	0,						       // bCountryCode
-	1,						       // bNumDescriptors
-	0x22,						       // bDescriptorType
-	sizeof(hid_report_descriptor),			       // wDescriptorLength
-	0,
+	USBDescriptor::hid(0x0111, 0, sizeof(hid_report_descriptor)),
 	// endpoint descriptor, USB spec 9.6.6, page 269-271, Table 9-13
-	7,						       // bLength
-	5,						       // bDescriptorType
-	GAMEPAD_ENDPOINT | 0x80,			       // bEndpointAddress
-	0x03,						       // bmAttributes (0x03=intr)
-	GAMEPAD_SIZE, 0,				       // wMaxPacketSize
-	1						       // bInterval (1 ms)
-};
+	USBDescriptor::endpoint(GAMEPAD_ENDPOINT | 0x80, 0x03, GAMEPAD_SIZE, 1) // interrupt, 1 ms
+);
+
+#define CONFIG1_DESC_SIZE		(9+9+9+7)
+static_assert(sizeof(hid_configuration_descriptor) == CONFIG1_DESC_SIZE, "unexpected HID configuration descriptor length");
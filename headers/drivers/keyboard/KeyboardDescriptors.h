@@ -2,6 +2,7 @@
 
 #include <stdint.h>
 #include "tusb.h"
+#include "descriptorbuilder.h"
 
 #define KEYBOARD_KEY_REPORT_ID 0x01
 #define KEYBOARD_MULTIMEDIA_REPORT_ID 0x02
@@ -14,20 +15,41 @@
 #define KEYBOARD_MULTIMEDIA_VOLUME_UP   0XF3
 #define KEYBOARD_MULTIMEDIA_VOLUME_DOWN 0XF4
 
-/// Standard HID Boot Protocol Keyboard Report.
+#define KEYBOARD_BOOT_KEYS 6
+
+// Usages in the key bitmap that the boot report carries as modifier bits (0xE0-0xE7)
+#define KEYBOARD_MODIFIER_BYTE (HID_KEY_CONTROL_LEFT / 8)
+
+/// NKRO Keyboard Report, one bit per key usage (report protocol).
 typedef struct
 {
-	uint8_t reportId = KEYBOARD_KEY_REPORT_ID;
-	uint8_t keycode[32]; /**< Key codes of the currently pressed keys. */
-	uint8_t multimedia;
+	uint8_t keycode[32]; /**< Bitmap of the currently pressed key usages. */
+	uint8_t multimedia;  /**< Consumer control bits, see getMultimedia(). */
 } KeyboardReport;
 
-static const uint8_t keyboard_string_language[]    = { 0x09, 0x04 };
-static const uint8_t keyboard_string_manfacturer[] = "Open Stick Community";
-static const uint8_t keyboard_string_product[]     = "GP2040-CE (Keyboard)";
-static const uint8_t keyboard_string_version[]     = "1.1";
+/// Standard HID Boot Protocol Keyboard Report, sent when the host selects boot protocol.
+typedef struct __attribute((packed, aligned(1)))
+{
+	uint8_t modifier;
+	uint8_t reserved;
+	uint8_t keycode[KEYBOARD_BOOT_KEYS];
+} KeyboardBootReport;
+
+/// Precomputed location of a mapped key, so building a report only ORs bits together.
+typedef struct
+{
+	uint8_t index;      /**< Byte in KeyboardReport::keycode. */
+	uint8_t mask;       /**< Bit in that byte, 0 if the input is not mapped to a key. */
+	uint8_t multimedia; /**< Bit in KeyboardReport::multimedia. */
+} KeyboardKeyBit;
+
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto keyboard_string_language    = USBDescriptor::language(0x0009);
+static constexpr auto keyboard_string_manfacturer = USBDescriptor::string("Open Stick Community");
+static constexpr auto keyboard_string_product     = USBDescriptor::string("GP2040-CE (Keyboard)");
+static constexpr auto keyboard_string_version     = USBDescriptor::string("1.1");
 
-static const uint8_t *keyboard_string_descriptors[] __attribute__((unused)) =
+static const uint16_t *keyboard_string_descriptors[] __attribute__((unused)) =
 {
 	keyboard_string_language,
 	keyboard_string_manfacturer,
@@ -35,23 +57,20 @@ static const uint8_t *keyboard_string_descriptors[] __attribute__((unused)) =
 	keyboard_string_version
 };
 
-static const uint8_t keyboard_device_descriptor[] =
-{
-	sizeof(tusb_desc_device_t),	// bLength
-	TUSB_DESC_DEVICE,			// bDescriptorType
-	0x10, 0x01,					// bcdUSB
+static constexpr auto keyboard_device_descriptor = USBDescriptor::device(
+	0x0110,						// bcdUSB
 	0x00,						// bDeviceClass
 	0x00,						// bDeviceSubClass
 	0x00,						// bDeviceProtocol
 	64,							// bMaxPacketSize0
-	0xfe, 0xca,					// idVendor
-	0x01, 0x00,					// idProduct
-	0x00, 0x01,					// bcdDevice
+	0xcafe,						// idVendor
+	0x0001,						// idProduct
+	0x0100,						// bcdDevice
 	0x01,						// iManufacturer
 	0x02,						// iProduct
 	0x00,						// iSerialNumber
 	0x01						// bNumConfigurations
-};
+);
 
 enum
 {
@@ -63,65 +82,57 @@ enum
 
 #define EPNUM_HID   0x81
 
-static const uint8_t keyboard_report_descriptor[] =
-	{
-		0x05, 0x01, // Usage Page (Generic Desktop),
-		0x09, 0x06, // Usage (Keyboard),
-		0xA1, 0x01, 	// Collection (Application),
+static constexpr auto keyboard_report_descriptor = USBDescriptor::hidReport([] {
+	using namespace USBDescriptor::HIDItem;
+	return items(
+		usagePage(0x01),		// Usage Page (Generic Desktop),
+		usage(0x06),			// Usage (Keyboard),
+		collection(0x01),		// Collection (Application),
 
-		// Report ID (1)
-		0x85, KEYBOARD_KEY_REPORT_ID,
+		reportID(KEYBOARD_KEY_REPORT_ID),
 		// Keys
-		0x05, 0x07,			 // Usage Page (Key Codes),
-		0x19, 0x00,			 // Usage Minimum (0),
-		0x2A, 0xFF, 0x00, 	 // Usage Maximum (255),
-		0x15, 0x00,			 // Logical Minimum (0),
-		0x25, 0x01,			 // Logical Maximum (1),
-		0x75, 0x01,			 // Report Size (1),
-		0x96, 0x00, 0x01,	 // Report Count (256),
-		0x81, 0x02,			 // Input (Data, Variable, Absolute), Key byte (1-32)
-		0xC0,			// End Collection
-		0x05, 0x0C, //Usage Page (Consumer Devices)
-		0x09, 0x01, //Usage (Consumer Control)
-		0xA1, 0x01, 	//Collection (Application)
-		
-		//Report ID (2)
-		0x85, KEYBOARD_MULTIMEDIA_REPORT_ID,
-		0x05, 0x0C,			 //Usage Page (Consumer Devices)
-		0x15, 0x00,			 //Logical Minimum (0)
-		0x25, 0x01,			 //Logical Maximum (1)
-		0x75, 0x01,			 //Report Size (1)
-		0x95, 0x07,			 //Report Count (7)
-		0x09, 0xB5,			 //Usage (Scan Next Track)
-		0x09, 0xB6,			 //Usage (Scan Previous Track)
-		0x09, 0xB7,			 //Usage (Stop)
-		0x09, 0xCD,			 //Usage (Play/Pause)
-		0x09, 0xE2,			 //Usage (Mute)
-		0x09, 0xE9,			 //Usage (Volume Increment)
-		0x09, 0xEA,			 //Usage (Volume Decrement)
-		0x81, 0x02,			 //Input (Data,Var,Abs,NWrp,Lin,Pref,NNul,Bit)
-		0x95, 0x01,			 //Report Count (1)
-		0x81, 0x01,			 //Input (Const,Ary,Abs)
-		0xC0,			//End Collection
-};
+		usagePage(0x07),		 // Usage Page (Key Codes),
+		usageMinimum(0),		 // Usage Minimum (0),
+		usageMaximum(255, 2),	 // Usage Maximum (255),
+		logicalMinimum(0),		 // Logical Minimum (0),
+		logicalMaximum(1),		 // Logical Maximum (1),
+		reportSize(1),			 // Report Size (1),
+		reportCount(256),		 // Report Count (256),
+		input(0x02),			 // Input (Data, Variable, Absolute), Key byte (1-32)
+		endCollection(),		// End Collection
+		usagePage(0x0C),		//Usage Page (Consumer Devices)
+		usage(0x01),			//Usage (Consumer Control)
+		collection(0x01),		//Collection (Application)
 
-// Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
-static const uint8_t keyboard_hid_descriptor[] =
-{
-	0x09,								 	  // bLength
-	0x21,								 	  // bDescriptorType (HID)
-	0x11, 0x01,							 	  // bcdHID 1.11
-	0x00,								 	  // bCountryCode
-	0x01,									  // bNumDescriptors
-	0x22,									  // bDescriptorType[0] (HID)
-	sizeof(keyboard_report_descriptor), 0x00, // wDescriptorLength[0] 90
-};
+		reportID(KEYBOARD_MULTIMEDIA_REPORT_ID),
+		usagePage(0x0C),		 //Usage Page (Consumer Devices)
+		logicalMinimum(0),		 //Logical Minimum (0)
+		logicalMaximum(1),		 //Logical Maximum (1)
+		reportSize(1),			 //Report Size (1)
+		reportCount(7),			 //Report Count (7)
+		usage(0xB5),			 //Usage (Scan Next Track)
+		usage(0xB6),			 //Usage (Scan Previous Track)
+		usage(0xB7),			 //Usage (Stop)
+		usage(0xCD),			 //Usage (Play/Pause)
+		usage(0xE2),			 //Usage (Mute)
+		usage(0xE9),			 //Usage (Volume Increment)
+		usage(0xEA),			 //Usage (Volume Decrement)
+		input(0x02),			 //Input (Data,Var,Abs,NWrp,Lin,Pref,NNul,Bit)
+		reportCount(1),			 //Report Count (1)
+		input(0x01),			 //Input (Const,Ary,Abs)
+		endCollection()			//End Collection
+	);
+});
 
-static const uint8_t keyboard_configuration_descriptor[] =
-{
-	// Config number, interface count, string index, total length, attribute, power in mA
-	TUD_CONFIG_DESCRIPTOR(1, ITF_NUM_TOTAL_KEYBOARD, 0, CONFIG_TOTAL_LEN, 32, 100),
+static constexpr auto keyboard_hid_descriptor = USBDescriptor::hid(0x0111, 0x00, sizeof(keyboard_report_descriptor));
 
-	// Interface number, string index, protocol, report descriptor len, EP Out & In address, size & polling interval
-	TUD_HID_DESCRIPTOR(ITF_NUM_HID_KEYBOARD, 0, HID_ITF_PROTOCOL_KEYBOARD, sizeof(keyboard_report_descriptor), EPNUM_HID, CFG_TUD_HID_EP_BUFSIZE, 1)
-};
\ No newline at end of file
+static constexpr auto keyboard_configuration_descriptor = USBDescriptor::configuration(
+	1,							// bConfigurationValue
+	0,							// iConfiguration
+	TU_BIT(7) | TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP, // bmAttributes
+	100 / 2,					// bMaxPower 100mA
+	USBDescriptor::interface(ITF_NUM_HID_KEYBOARD, 0, 1, TUSB_CLASS_HID, HID_SUBCLASS_BOOT, HID_ITF_PROTOCOL_KEYBOARD, 0),
+	keyboard_hid_descriptor,
+	USBDescriptor::endpoint(EPNUM_HID, TUSB_XFER_INTERRUPT, CFG_TUD_HID_EP_BUFSIZE, 1)
+);
+static_assert(sizeof(keyboard_configuration_descriptor) == CONFIG_TOTAL_LEN, "unexpected keyboard configuration descriptor length");
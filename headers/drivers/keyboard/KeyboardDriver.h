@@ -12,6 +12,7 @@
 
 class KeyboardDriver : public GPDriver {
 public:
+    virtual ~KeyboardDriver();
     virtual void initialize();
     virtual bool process(Gamepad * gamepad);
     virtual void initializeAux() {}
@@ -28,14 +29,19 @@ public:
     virtual USBListener * get_usb_auth_listener() { return nullptr; }
     void handleEncoder(GPEvent* e); // for Volume - rotary encoder
 private:
-    void releaseAllKeys(void);
-	void pressKey(uint8_t code);
-    uint8_t getModifier(uint8_t code);
+    KeyboardKeyBit getKeyBit(uint8_t code);
     uint8_t getMultimedia(uint8_t code);
-    uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
-    uint16_t last_report_size;
+    void pressKey(const KeyboardKeyBit& key);
+    uint16_t fillBootReport(KeyboardBootReport * report);
+    bool sendKeyReport();
+    bool sendMultimediaReport();
+    KeyboardKeyBit buttonKeys[32];  // indexed by GAMEPAD_MASK_* bit
+    KeyboardKeyBit dpadKeys[4];     // indexed by GAMEPAD_MASK_UP..RIGHT bit
     KeyboardReport keyboardReport;
+    KeyboardReport lastReport;
+    uint8_t lastProtocol;
     int8_t volumeChange;
+    EventManager::EventHandle encoderHandle = 0;
 };
 
 #endif // _KEYBOARD_DRIVER_H_
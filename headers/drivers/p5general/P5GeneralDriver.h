@@ -20,6 +20,7 @@ typedef enum
 
 class P5GeneralDriver : public GPDriver {
 public:
+    virtual ~P5GeneralDriver() { delete p5GeneralAuthDriver; }
     virtual void initialize();
     virtual bool process(Gamepad * gamepad);
     virtual void initializeAux();
@@ -43,8 +44,8 @@ private:
     //PSSensor gyroscope;
     //PSSensor accelerometer;
     uint64_t last_report_us;
-    P5GeneralAuth * p5GeneralAuthDriver;
-    P5GeneralAuthData * p5GeneralAuthData;
+    P5GeneralAuth * p5GeneralAuthDriver = nullptr;
+    P5GeneralAuthData * p5GeneralAuthData = nullptr;
     bool pointOneTouched = false;
     bool pointTwoTouched = false;
     uint8_t diff_report_repeat;
@@ -40,34 +40,34 @@ private:
     InputModeDeviceType deviceType;
     uint8_t deviceDescriptor[sizeof(ps3_device_descriptor)];
 
-    GamepadButtonMapping *buttonFretGreen;
-    GamepadButtonMapping *buttonFretRed;
-    GamepadButtonMapping *buttonFretYellow;
-    GamepadButtonMapping *buttonFretBlue;
-    GamepadButtonMapping *buttonFretOrange;
-    GamepadButtonMapping *buttonWhammy;
-    GamepadButtonMapping *buttonPickup;
-    GamepadButtonMapping *buttonTilt;
+    GamepadButtonMapping buttonFretGreen{0};
+    GamepadButtonMapping buttonFretRed{0};
+    GamepadButtonMapping buttonFretYellow{0};
+    GamepadButtonMapping buttonFretBlue{0};
+    GamepadButtonMapping buttonFretOrange{0};
+    GamepadButtonMapping buttonWhammy{0};
+    GamepadButtonMapping buttonPickup{0};
+    GamepadButtonMapping buttonTilt{0};
 
-    GamepadButtonMapping *buttonDrumPadRed;
-    GamepadButtonMapping *buttonDrumPadBlue;
-    GamepadButtonMapping *buttonDrumPadYellow;
-    GamepadButtonMapping *buttonDrumPadGreen;
-    GamepadButtonMapping *buttonCymbalYellow;
-    GamepadButtonMapping *buttonCymbalBlue;
-    GamepadButtonMapping *buttonCymbalGreen;
+    GamepadButtonMapping buttonDrumPadRed{0};
+    GamepadButtonMapping buttonDrumPadBlue{0};
+    GamepadButtonMapping buttonDrumPadYellow{0};
+    GamepadButtonMapping buttonDrumPadGreen{0};
+    GamepadButtonMapping buttonCymbalYellow{0};
+    GamepadButtonMapping buttonCymbalBlue{0};
+    GamepadButtonMapping buttonCymbalGreen{0};
 
-    GamepadButtonMapping *buttonShiftUp;
-    GamepadButtonMapping *buttonShiftDown;
-    GamepadButtonMapping *buttonGas;
-    GamepadButtonMapping *buttonBrake;
-    GamepadButtonMapping *buttonSteerLeft;
-    GamepadButtonMapping *buttonSteerRight;
-    GamepadButtonMapping *buttonPlus;
-    GamepadButtonMapping *buttonMinus;
-    GamepadButtonMapping *buttonDialDown;
-    GamepadButtonMapping *buttonDialUp;
-    GamepadButtonMapping *buttonDialEnter;
+    GamepadButtonMapping buttonShiftUp{0};
+    GamepadButtonMapping buttonShiftDown{0};
+    GamepadButtonMapping buttonGas{0};
+    GamepadButtonMapping buttonBrake{0};
+    GamepadButtonMapping buttonSteerLeft{0};
+    GamepadButtonMapping buttonSteerRight{0};
+    GamepadButtonMapping buttonPlus{0};
+    GamepadButtonMapping buttonMinus{0};
+    GamepadButtonMapping buttonDialDown{0};
+    GamepadButtonMapping buttonDialUp{0};
+    GamepadButtonMapping buttonDialEnter{0};
 };
 
 #endif // _PS3_DRIVER_H_
@@ -17,6 +17,7 @@ typedef struct {
 class PS4Auth : public GPAuthDriver {
 public:
     PS4Auth(InputModeAuthType inType) { authType = inType; }
+    virtual ~PS4Auth();
     virtual void initialize();
     virtual bool available();
     void process();
@@ -26,6 +27,7 @@ private:
     void keyModeInitialize();
     void keyModeProcess();
     PS4AuthData ps4AuthData;
+    bool rsaInitialized = false;
 };
 
 #endif
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "descriptorbuilder.h"
 
 #define PS4_ENDPOINT_SIZE 64
 
@@ -422,12 +423,13 @@ typedef struct __attribute__((packed)) {
     };
 } PS4Report;
 
-static const uint8_t ps4_string_language[]     = { 0x09, 0x04 };
-static const uint8_t ps4_string_manufacturer[] = "Open Stick Community";
-static const uint8_t ps4_string_product[]      = "GP2040-CE (PS4)";
-static const uint8_t ps4_string_version[]      = "1.0";
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto ps4_string_language     = USBDescriptor::language(0x0009);
+static constexpr auto ps4_string_manufacturer = USBDescriptor::string("Open Stick Community");
+static constexpr auto ps4_string_product      = USBDescriptor::string("GP2040-CE (PS4)");
+static constexpr auto ps4_string_version      = USBDescriptor::string("1.0");
 
-static const uint8_t *ps4_string_descriptors[] __attribute__((unused)) =
+static const uint16_t *ps4_string_descriptors[] __attribute__((unused)) =
 {
     ps4_string_language,
     ps4_string_manufacturer,
@@ -435,327 +437,285 @@ static const uint8_t *ps4_string_descriptors[] __attribute__((unused)) =
     ps4_string_version
 };
 
-static const uint8_t ps4_device_descriptor[] =
-{
-	18,								  // bLength
-	1,								  // bDescriptorType
-	0x00, 0x02,						  // bcdUSB
+static constexpr auto ps4_device_descriptor = USBDescriptor::device(
+	0x0200,							  // bcdUSB
 	0,								  // bDeviceClass
 	0,								  // bDeviceSubClass
 	0,								  // bDeviceProtocol
 	ENDPOINT0_SIZE,					  // bMaxPacketSize0
-	LSB(PS4_VENDOR_ID), MSB(PS4_VENDOR_ID),	  // idVendor
-	LSB(PS4_PRODUCT_ID), MSB(PS4_PRODUCT_ID), // idProduct
-	0x00, 0x01,						  // bcdDevice
+	PS4_VENDOR_ID,					  // idVendor
+	PS4_PRODUCT_ID,					  // idProduct
+	0x0100,							  // bcdDevice
 	1,								  // iManufacturer
 	2,								  // iProduct
 	0,								  // iSerialNumber
 	1								  // bNumConfigurations
-};
-
-static const uint8_t ps4_report_descriptor[] =
-{
-	0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
-	0x09, 0x05,        // Usage (Game Pad)
-	0xA1, 0x01,        // Collection (Application)
-	0x85, 0x01,        //   Report ID (1)
-	0x09, 0x30,        //   Usage (X)
-	0x09, 0x31,        //   Usage (Y)
-	0x09, 0x32,        //   Usage (Z)
-	0x09, 0x35,        //   Usage (Rz)
-	0x15, 0x00,        //   Logical Minimum (0)
-	0x26, 0xFF, 0x00,  //   Logical Maximum (255)
-	0x75, 0x08,        //   Report Size (8)
-	0x95, 0x04,        //   Report Count (4)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-	0x09, 0x39,        //   Usage (Hat switch)
-	0x15, 0x00,        //   Logical Minimum (0)
-	0x25, 0x07,        //   Logical Maximum (7)
-	0x35, 0x00,        //   Physical Minimum (0)
-	0x46, 0x3B, 0x01,  //   Physical Maximum (315)
-	0x65, 0x14,        //   Unit (System: English Rotation, Length: Centimeter)
-	0x75, 0x04,        //   Report Size (4)
-	0x95, 0x01,        //   Report Count (1)
-	0x81, 0x42,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,Null State)
-
-	0x65, 0x00,        //   Unit (None)
-	0x05, 0x09,        //   Usage Page (Button)
-	0x19, 0x01,        //   Usage Minimum (0x01)
-	0x29, 0x0E,        //   Usage Maximum (0x0E)
-	0x15, 0x00,        //   Logical Minimum (0)
-	0x25, 0x01,        //   Logical Maximum (1)
-	0x75, 0x01,        //   Report Size (1)
-	0x95, 0x0E,        //   Report Count (14)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-	0x06, 0x00, 0xFF,  //   Usage Page (Vendor Defined 0xFF00)
-	0x09, 0x20,        //   Usage (0x20)
-	0x75, 0x06,        //   Report Size (6)
-	0x95, 0x01,        //   Report Count (1)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-	0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
-	0x09, 0x33,        //   Usage (Rx)
-	0x09, 0x34,        //   Usage (Ry)
-	0x15, 0x00,        //   Logical Minimum (0)
-	0x26, 0xFF, 0x00,  //   Logical Maximum (255)
-	0x75, 0x08,        //   Report Size (8)
-	0x95, 0x02,        //   Report Count (2)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-	0x06, 0x00, 0xFF,  //   Usage Page (Vendor Defined 0xFF00)
-	0x09, 0x21,        //   Usage (0x21)
-	0x95, 0x36,        //   Report Count (54)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-	0x85, 0x05,        //   Report ID (5)
-	0x09, 0x22,        //   Usage (0x22)
-	0x95, 0x1F,        //   Report Count (31)
-	0x91, 0x02,        //   Output (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-
-	0x85, 0x03,        //   Report ID (3)
-	0x0A, 0x21, 0x27,  //   Usage (0x2721)
-	0x95, 0x2F,        //   Report Count (47)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-
-	0x85, 0x02,        //   Report ID (2)
-	0x09, 0x24,        //   Usage (0x24)
-	0x95, 0x24,        //   Report Count (36)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x08,        //   Report ID (8)
-	0x09, 0x25,        //   Usage (0x25)
-	0x95, 0x03,        //   Report Count (3)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x10,        //   Report ID (16)
-	0x09, 0x26,        //   Usage (0x26)
-	0x95, 0x04,        //   Report Count (4)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x11,        //   Report ID (17)
-	0x09, 0x27,        //   Usage (0x27)
-	0x95, 0x02,        //   Report Count (2)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x12,        //   Report ID (18)
-	0x06, 0x02, 0xFF,  //   Usage Page (Vendor Defined 0xFF02)
-	0x09, 0x21,        //   Usage (0x21)
-	0x95, 0x0F,        //   Report Count (15)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x13,        //   Report ID (19)
-	0x09, 0x22,        //   Usage (0x22)
-	0x95, 0x16,        //   Report Count (22)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x14,        //   Report ID (20)
-	0x06, 0x05, 0xFF,  //   Usage Page (Vendor Defined 0xFF05)
-	0x09, 0x20,        //   Usage (0x20)
-	0x95, 0x10,        //   Report Count (16)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x15,        //   Report ID (21)
-	0x09, 0x21,        //   Usage (0x21)
-	0x95, 0x2C,        //   Report Count (44)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x06, 0x80, 0xFF,  //   Usage Page (Vendor Defined 0xFF80)
-	0x85, 0x80,        //   Report ID (128)
-	0x09, 0x20,        //   Usage (0x20)
-	0x95, 0x06,        //   Report Count (6)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x81,        //   Report ID (129)
-	0x09, 0x21,        //   Usage (0x21)
-	0x95, 0x06,        //   Report Count (6)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x82,        //   Report ID (130)
-	0x09, 0x22,        //   Usage (0x22)
-	0x95, 0x05,        //   Report Count (5)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x83,        //   Report ID (131)
-	0x09, 0x23,        //   Usage (0x23)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x84,        //   Report ID (132)
-	0x09, 0x24,        //   Usage (0x24)
-	0x95, 0x04,        //   Report Count (4)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x85,        //   Report ID (133)
-	0x09, 0x25,        //   Usage (0x25)
-	0x95, 0x06,        //   Report Count (6)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x86,        //   Report ID (134)
-	0x09, 0x26,        //   Usage (0x26)
-	0x95, 0x06,        //   Report Count (6)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x87,        //   Report ID (135)
-	0x09, 0x27,        //   Usage (0x27)
-	0x95, 0x23,        //   Report Count (35)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x88,        //   Report ID (136)
-	0x09, 0x28,        //   Usage (0x28)
-	0x95, 0x22,        //   Report Count (34)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x89,        //   Report ID (137)
-	0x09, 0x29,        //   Usage (0x29)
-	0x95, 0x02,        //   Report Count (2)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x90,        //   Report ID (144)
-	0x09, 0x30,        //   Usage (0x30)
-	0x95, 0x05,        //   Report Count (5)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x91,        //   Report ID (145)
-	0x09, 0x31,        //   Usage (0x31)
-	0x95, 0x03,        //   Report Count (3)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x92,        //   Report ID (146)
-	0x09, 0x32,        //   Usage (0x32)
-	0x95, 0x03,        //   Report Count (3)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0x93,        //   Report ID (147)
-	0x09, 0x33,        //   Usage (0x33)
-	0x95, 0x0C,        //   Report Count (12)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA0,        //   Report ID (160)
-	0x09, 0x40,        //   Usage (0x40)
-	0x95, 0x06,        //   Report Count (6)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA1,        //   Report ID (161)
-	0x09, 0x41,        //   Usage (0x41)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA2,        //   Report ID (162)
-	0x09, 0x42,        //   Usage (0x42)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA3,        //   Report ID (163)
-	0x09, 0x43,        //   Usage (0x43)
-	0x95, 0x30,        //   Report Count (48)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA4,        //   Report ID (164)
-	0x09, 0x44,        //   Usage (0x44)
-	0x95, 0x0D,        //   Report Count (13)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA5,        //   Report ID (165)
-	0x09, 0x45,        //   Usage (0x45)
-	0x95, 0x15,        //   Report Count (21)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA6,        //   Report ID (166)
-	0x09, 0x46,        //   Usage (0x46)
-	0x95, 0x15,        //   Report Count (21)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA7,        //   Report ID (247)
-	0x09, 0x4A,        //   Usage (0x4A)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA8,        //   Report ID (250)
-	0x09, 0x4B,        //   Usage (0x4B)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xA9,        //   Report ID (251)
-	0x09, 0x4C,        //   Usage (0x4C)
-	0x95, 0x08,        //   Report Count (8)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAA,        //   Report ID (252)
-	0x09, 0x4E,        //   Usage (0x4E)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAB,        //   Report ID (253)
-	0x09, 0x4F,        //   Usage (0x4F)
-	0x95, 0x39,        //   Report Count (57)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAC,        //   Report ID (254)
-	0x09, 0x50,        //   Usage (0x50)
-	0x95, 0x39,        //   Report Count (57)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAD,        //   Report ID (255)
-	0x09, 0x51,        //   Usage (0x51)
-	0x95, 0x0B,        //   Report Count (11)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAE,        //   Report ID (256)
-	0x09, 0x52,        //   Usage (0x52)
-	0x95, 0x01,        //   Report Count (1)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xAF,        //   Report ID (175)
-	0x09, 0x53,        //   Usage (0x53)
-	0x95, 0x02,        //   Report Count (2)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xB0,        //   Report ID (176)
-	0x09, 0x54,        //   Usage (0x54)
-	0x95, 0x3F,        //   Report Count (63)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0xC0,              // End Collection
-
-	0x06, 0xF0, 0xFF,  // Usage Page (Vendor Defined 0xFFF0)
-	0x09, 0x40,        // Usage (0x40)
-	0xA1, 0x01,        // Collection (Application)
-	0x85, 0xF0,        //   Report ID (-16) AUTH F0
-	0x09, 0x47,        //   Usage (0x47)
-	0x95, 0x3F,        //   Report Count (63)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xF1,        //   Report ID (-15) AUTH F1
-	0x09, 0x48,        //   Usage (0x48)
-	0x95, 0x3F,        //   Report Count (63)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xF2,        //   Report ID (-14) AUTH F2
-	0x09, 0x49,        //   Usage (0x49)
-	0x95, 0x0F,        //   Report Count (15)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0x85, 0xF3,        //   Report ID (-13) Auth F3 (Reset)
-	0x0A, 0x01, 0x47,  //   Usage (0x4701)
-	0x95, 0x07,        //   Report Count (7)
-	0xB1, 0x02,        //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0xC0,              // End Collection
-};
-
-static const uint8_t ps4_hid_descriptor[] =
-{
-	0x09,								 // bLength
-	0x21,								 // bDescriptorType (HID)
-	0x11, 0x01,							 // bcdHID 1.11
-	0x00,								 // bCountryCode
-	0x01,								 // bNumDescriptors
-	0x22,								 // bDescriptorType[0] (HID)
-	LSB(sizeof(ps4_report_descriptor)), MSB(sizeof(ps4_report_descriptor))
-};
+);
+
+static constexpr auto ps4_report_descriptor = USBDescriptor::hidReport([] {
+	using namespace USBDescriptor::HIDItem;
+	return items(
+
+		usagePage(0x01),       // Usage Page (Generic Desktop Ctrls)
+		usage(0x05),           // Usage (Game Pad)
+		collection(0x01),      // Collection (Application)
+		reportID(1),           //   Report ID (1)
+		usage(0x30),           //   Usage (X)
+		usage(0x31),           //   Usage (Y)
+		usage(0x32),           //   Usage (Z)
+		usage(0x35),           //   Usage (Rz)
+		logicalMinimum(0),     //   Logical Minimum (0)
+		logicalMaximum(255),   //   Logical Maximum (255)
+		reportSize(8),         //   Report Size (8)
+		reportCount(4),        //   Report Count (4)
+		input(0x02),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		usage(0x39),           //   Usage (Hat switch)
+		logicalMinimum(0),     //   Logical Minimum (0)
+		logicalMaximum(7),     //   Logical Maximum (7)
+		physicalMinimum(0),    //   Physical Minimum (0)
+		physicalMaximum(315),  //   Physical Maximum (315)
+		unit(0x14),            //   Unit (System: English Rotation, Length: Centimeter)
+		reportSize(4),         //   Report Size (4)
+		reportCount(1),        //   Report Count (1)
+		input(0x42),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,Null State)
+
+		unit(0),               //   Unit (None)
+		usagePage(0x09),       //   Usage Page (Button)
+		usageMinimum(0x01),    //   Usage Minimum (0x01)
+		usageMaximum(0x0E),    //   Usage Maximum (0x0E)
+		logicalMinimum(0),     //   Logical Minimum (0)
+		logicalMaximum(1),     //   Logical Maximum (1)
+		reportSize(1),         //   Report Size (1)
+		reportCount(14),       //   Report Count (14)
+		input(0x02),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		usagePage(0xFF00),     //   Usage Page (Vendor Defined 0xFF00)
+		usage(0x20),           //   Usage (0x20)
+		reportSize(6),         //   Report Size (6)
+		reportCount(1),        //   Report Count (1)
+		input(0x02),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		usagePage(0x01),       //   Usage Page (Generic Desktop Ctrls)
+		usage(0x33),           //   Usage (Rx)
+		usage(0x34),           //   Usage (Ry)
+		logicalMinimum(0),     //   Logical Minimum (0)
+		logicalMaximum(255),   //   Logical Maximum (255)
+		reportSize(8),         //   Report Size (8)
+		reportCount(2),        //   Report Count (2)
+		input(0x02),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		usagePage(0xFF00),     //   Usage Page (Vendor Defined 0xFF00)
+		usage(0x21),           //   Usage (0x21)
+		reportCount(54),       //   Report Count (54)
+		input(0x02),           //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		reportID(5),           //   Report ID (5)
+		usage(0x22),           //   Usage (0x22)
+		reportCount(31),       //   Report Count (31)
+		output(0x02),          //   Output (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+
+		reportID(3),           //   Report ID (3)
+		usage(0x2721),         //   Usage (0x2721)
+		reportCount(47),       //   Report Count (47)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+
+		reportID(2),           //   Report ID (2)
+		usage(0x24),           //   Usage (0x24)
+		reportCount(36),       //   Report Count (36)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(8),           //   Report ID (8)
+		usage(0x25),           //   Usage (0x25)
+		reportCount(3),        //   Report Count (3)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x10),        //   Report ID (16)
+		usage(0x26),           //   Usage (0x26)
+		reportCount(4),        //   Report Count (4)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x11),        //   Report ID (17)
+		usage(0x27),           //   Usage (0x27)
+		reportCount(2),        //   Report Count (2)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x12),        //   Report ID (18)
+		usagePage(0xFF02),     //   Usage Page (Vendor Defined 0xFF02)
+		usage(0x21),           //   Usage (0x21)
+		reportCount(15),       //   Report Count (15)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x13),        //   Report ID (19)
+		usage(0x22),           //   Usage (0x22)
+		reportCount(22),       //   Report Count (22)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x14),        //   Report ID (20)
+		usagePage(0xFF05),     //   Usage Page (Vendor Defined 0xFF05)
+		usage(0x20),           //   Usage (0x20)
+		reportCount(16),       //   Report Count (16)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x15),        //   Report ID (21)
+		usage(0x21),           //   Usage (0x21)
+		reportCount(44),       //   Report Count (44)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		usagePage(0xFF80),     //   Usage Page (Vendor Defined 0xFF80)
+		reportID(0x80),        //   Report ID (128)
+		usage(0x20),           //   Usage (0x20)
+		reportCount(6),        //   Report Count (6)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x81),        //   Report ID (129)
+		usage(0x21),           //   Usage (0x21)
+		reportCount(6),        //   Report Count (6)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x82),        //   Report ID (130)
+		usage(0x22),           //   Usage (0x22)
+		reportCount(5),        //   Report Count (5)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x83),        //   Report ID (131)
+		usage(0x23),           //   Usage (0x23)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x84),        //   Report ID (132)
+		usage(0x24),           //   Usage (0x24)
+		reportCount(4),        //   Report Count (4)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x85),        //   Report ID (133)
+		usage(0x25),           //   Usage (0x25)
+		reportCount(6),        //   Report Count (6)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x86),        //   Report ID (134)
+		usage(0x26),           //   Usage (0x26)
+		reportCount(6),        //   Report Count (6)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x87),        //   Report ID (135)
+		usage(0x27),           //   Usage (0x27)
+		reportCount(35),       //   Report Count (35)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x88),        //   Report ID (136)
+		usage(0x28),           //   Usage (0x28)
+		reportCount(34),       //   Report Count (34)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x89),        //   Report ID (137)
+		usage(0x29),           //   Usage (0x29)
+		reportCount(2),        //   Report Count (2)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x90),        //   Report ID (144)
+		usage(0x30),           //   Usage (0x30)
+		reportCount(5),        //   Report Count (5)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x91),        //   Report ID (145)
+		usage(0x31),           //   Usage (0x31)
+		reportCount(3),        //   Report Count (3)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x92),        //   Report ID (146)
+		usage(0x32),           //   Usage (0x32)
+		reportCount(3),        //   Report Count (3)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0x93),        //   Report ID (147)
+		usage(0x33),           //   Usage (0x33)
+		reportCount(12),       //   Report Count (12)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA0),        //   Report ID (160)
+		usage(0x40),           //   Usage (0x40)
+		reportCount(6),        //   Report Count (6)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA1),        //   Report ID (161)
+		usage(0x41),           //   Usage (0x41)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA2),        //   Report ID (162)
+		usage(0x42),           //   Usage (0x42)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA3),        //   Report ID (163)
+		usage(0x43),           //   Usage (0x43)
+		reportCount(48),       //   Report Count (48)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA4),        //   Report ID (164)
+		usage(0x44),           //   Usage (0x44)
+		reportCount(13),       //   Report Count (13)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA5),        //   Report ID (165)
+		usage(0x45),           //   Usage (0x45)
+		reportCount(21),       //   Report Count (21)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA6),        //   Report ID (166)
+		usage(0x46),           //   Usage (0x46)
+		reportCount(21),       //   Report Count (21)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA7),        //   Report ID (167)
+		usage(0x4A),           //   Usage (0x4A)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA8),        //   Report ID (168)
+		usage(0x4B),           //   Usage (0x4B)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xA9),        //   Report ID (169)
+		usage(0x4C),           //   Usage (0x4C)
+		reportCount(8),        //   Report Count (8)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAA),        //   Report ID (170)
+		usage(0x4E),           //   Usage (0x4E)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAB),        //   Report ID (171)
+		usage(0x4F),           //   Usage (0x4F)
+		reportCount(57),       //   Report Count (57)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAC),        //   Report ID (172)
+		usage(0x50),           //   Usage (0x50)
+		reportCount(57),       //   Report Count (57)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAD),        //   Report ID (173)
+		usage(0x51),           //   Usage (0x51)
+		reportCount(11),       //   Report Count (11)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAE),        //   Report ID (174)
+		usage(0x52),           //   Usage (0x52)
+		reportCount(1),        //   Report Count (1)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xAF),        //   Report ID (175)
+		usage(0x53),           //   Usage (0x53)
+		reportCount(2),        //   Report Count (2)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xB0),        //   Report ID (176)
+		usage(0x54),           //   Usage (0x54)
+		reportCount(63),       //   Report Count (63)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		endCollection(),       // End Collection
+
+		usagePage(0xFFF0),     // Usage Page (Vendor Defined 0xFFF0)
+		usage(0x40),           // Usage (0x40)
+		collection(0x01),      // Collection (Application)
+		reportID(0xF0),        //   Report ID (240) AUTH F0
+		usage(0x47),           //   Usage (0x47)
+		reportCount(63),       //   Report Count (63)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xF1),        //   Report ID (241) AUTH F1
+		usage(0x48),           //   Usage (0x48)
+		reportCount(63),       //   Report Count (63)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xF2),        //   Report ID (242) AUTH F2
+		usage(0x49),           //   Usage (0x49)
+		reportCount(15),       //   Report Count (15)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		reportID(0xF3),        //   Report ID (243) Auth F3 (Reset)
+		usage(0x4701),         //   Usage (0x4701)
+		reportCount(7),        //   Report Count (7)
+		feature(0x02),         //   Feature (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		endCollection()        // End Collection
+	);
+});
+static_assert(sizeof(ps4_report_descriptor) == 481, "unexpected PS4 report descriptor length");
+
+static constexpr auto ps4_hid_descriptor = USBDescriptor::hid(0x0111, 0x00, sizeof(ps4_report_descriptor));
 
 #define PS4_CONFIG1_DESC_SIZE		(9+9+9+7+7)
-static const uint8_t ps4_configuration_descriptor[] =
-{
-	// configuration descriptor, USB spec 9.6.3, page 264-266, Table 9-10
-	9,						       // bLength;
-	2,						       // bDescriptorType;
-	LSB(PS4_CONFIG1_DESC_SIZE),    // wTotalLength
-	MSB(PS4_CONFIG1_DESC_SIZE),
-	1,	                           // bNumInterfaces
+static constexpr auto ps4_configuration_descriptor = USBDescriptor::configuration(
 	1,	                           // bConfigurationValue
 	0,	                           // iConfiguration
 	0x80,                          // bmAttributes
 	50,	                           // bMaxPower
-		// interface descriptor, USB spec 9.6.5, page 267-269, Table 9-12
-	9,				               // bLength
-	4,				               // bDescriptorType
-	GAMEPAD_INTERFACE,             // bInterfaceNumber
-	0,				               // bAlternateSetting
-	2,				               // bNumEndpoints
-	0x03,			               // bInterfaceClass (0x03 = HID)
-	0x00,			               // bInterfaceSubClass (0x00 = No Boot)
-	0x00,			               // bInterfaceProtocol (0x00 = No Protocol)
-	0,				               // iInterface
-		// HID interface descriptor, HID 1.11 spec, section 6.2.1
-	9,							   // bLength
-	0x21,						   // bDescriptorType
-	0x11, 0x01,					   // bcdHID
-	0,							   // bCountryCode
-	1,							   // bNumDescriptors
-	0x22,						   // bDescriptorType
-	LSB(sizeof(ps4_report_descriptor)), // wDescriptorLength
-	MSB(sizeof(ps4_report_descriptor)),
-		// endpoint descriptor, USB spec 9.6.6, page 269-271, Table 9-13
-	7,						 	   // bLength
-	5,						       // bDescriptorType
-	GAMEPAD_ENDPOINT | 0x80,       // bEndpointAddress
-	0x03,					       // bmAttributes (0x03=intr)
-	GAMEPAD_SIZE, 0,		       // wMaxPacketSize
-	1,						       // bInterval (1 ms)
-	0x07,                          // bLength
-	0x05,                          // bDescriptorType (Endpoint)
-	0x03,                          // bEndpointAddress (OUT/H2D)
-	0x03,                          // bmAttributes (Interrupt)
-	0x40, 0x00,                    // wMaxPacketSize 64
-	0x01,                          // bInterval 1 (unit depends on device speed)
-};
+	USBDescriptor::interface(GAMEPAD_INTERFACE, 0, 2, 0x03, 0x00, 0x00, 0), // HID, no boot, no protocol
+	ps4_hid_descriptor,
+	USBDescriptor::endpoint(GAMEPAD_ENDPOINT | 0x80, 0x03, GAMEPAD_SIZE, 1), // IN/D2H, interrupt, 1 ms
+	USBDescriptor::endpoint(0x03, 0x03, 64, 1)                              // OUT/H2D, interrupt, 1 ms
+);
+static_assert(sizeof(ps4_configuration_descriptor) == PS4_CONFIG1_DESC_SIZE, "unexpected PS4 configuration descriptor length");
@@ -38,6 +38,7 @@ typedef enum
 class PS4Driver : public GPDriver {
 public:
     PS4Driver(uint32_t type): controllerType(type) {}
+    virtual ~PS4Driver() { delete ps4AuthDriver; }
     virtual void initialize();
     virtual bool process(Gamepad * gamepad);
     virtual void initializeAux();
@@ -62,7 +63,7 @@ private:
     TouchpadData touchpadData;
     PSSensorData sensorData;
     uint32_t last_report_timer;
-    PS4Auth * ps4AuthDriver;
+    PS4Auth * ps4AuthDriver = nullptr;
     PS4AuthData * ps4AuthData;      // PS4 Authentication Data
     uint8_t cur_nonce_chunk;            // PS4 Encryption Nonce Chunk (Max 19)
     uint8_t cur_nonce_id;
@@ -92,61 +93,61 @@ private:
     uint8_t shifterPosition = 0;
     const uint8_t shifterValues[PS4_MAX_GEARS] = {0,1,2,4,8,16,32,128};
     bool idleShifter = true;
-    GamepadButtonMapping *buttonShiftUp;
-    GamepadButtonMapping *buttonShiftDown;
-    GamepadButtonMapping *buttonShift1;
-    GamepadButtonMapping *buttonShift2;
-    GamepadButtonMapping *buttonShift3;
-    GamepadButtonMapping *buttonShift4;
-    GamepadButtonMapping *buttonShift5;
-    GamepadButtonMapping *buttonShift6;
-    GamepadButtonMapping *buttonShiftR;
-    GamepadButtonMapping *buttonShiftN;
-    GamepadButtonMapping *buttonGas;
-    GamepadButtonMapping *buttonBrake;
-    GamepadButtonMapping *buttonClutch;
-    GamepadButtonMapping *buttonSteerLeft;
-    GamepadButtonMapping *buttonSteerRight;
-    GamepadButtonMapping *buttonPlus;
-    GamepadButtonMapping *buttonMinus;
-    GamepadButtonMapping *buttonDialDown;
-    GamepadButtonMapping *buttonDialUp;
-    GamepadButtonMapping *buttonDialEnter;
+    GamepadButtonMapping buttonShiftUp{0};
+    GamepadButtonMapping buttonShiftDown{0};
+    GamepadButtonMapping buttonShift1{0};
+    GamepadButtonMapping buttonShift2{0};
+    GamepadButtonMapping buttonShift3{0};
+    GamepadButtonMapping buttonShift4{0};
+    GamepadButtonMapping buttonShift5{0};
+    GamepadButtonMapping buttonShift6{0};
+    GamepadButtonMapping buttonShiftR{0};
+    GamepadButtonMapping buttonShiftN{0};
+    GamepadButtonMapping buttonGas{0};
+    GamepadButtonMapping buttonBrake{0};
+    GamepadButtonMapping buttonClutch{0};
+    GamepadButtonMapping buttonSteerLeft{0};
+    GamepadButtonMapping buttonSteerRight{0};
+    GamepadButtonMapping buttonPlus{0};
+    GamepadButtonMapping buttonMinus{0};
+    GamepadButtonMapping buttonDialDown{0};
+    GamepadButtonMapping buttonDialUp{0};
+    GamepadButtonMapping buttonDialEnter{0};
 
-    GamepadButtonMapping *buttonRudderLeft;
-    GamepadButtonMapping *buttonRudderRight;
-    GamepadButtonMapping *buttonThrottleForward;
-    GamepadButtonMapping *buttonThrottleReverse;
-    GamepadButtonMapping *buttonRockerLeft;
-    GamepadButtonMapping *buttonRockerRight;
-    GamepadButtonMapping *buttonPedalLeft;
-    GamepadButtonMapping *buttonPedalRight;
-    GamepadButtonMapping *buttonPedalRudderLeft;
-    GamepadButtonMapping *buttonPedalRudderRight;
+    GamepadButtonMapping buttonRudderLeft{0};
+    GamepadButtonMapping buttonRudderRight{0};
+    GamepadButtonMapping buttonThrottleForward{0};
+    GamepadButtonMapping buttonThrottleReverse{0};
+    GamepadButtonMapping buttonRockerLeft{0};
+    GamepadButtonMapping buttonRockerRight{0};
+    GamepadButtonMapping buttonPedalLeft{0};
+    GamepadButtonMapping buttonPedalRight{0};
+    GamepadButtonMapping buttonPedalRudderLeft{0};
+    GamepadButtonMapping buttonPedalRudderRight{0};
 
-    GamepadButtonMapping *buttonFretGreen;
-    GamepadButtonMapping *buttonFretRed;
-    GamepadButtonMapping *buttonFretYellow;
-    GamepadButtonMapping *buttonFretBlue;
-    GamepadButtonMapping *buttonFretOrange;
-    GamepadButtonMapping *buttonFretSoloGreen;
-    GamepadButtonMapping *buttonFretSoloRed;
-    GamepadButtonMapping *buttonFretSoloYellow;
-    GamepadButtonMapping *buttonFretSoloBlue;
-    GamepadButtonMapping *buttonFretSoloOrange;
-    GamepadButtonMapping *buttonWhammy;
-    GamepadButtonMapping *buttonPickup;
-    GamepadButtonMapping *buttonTilt;
+    GamepadButtonMapping buttonFretGreen{0};
+    GamepadButtonMapping buttonFretRed{0};
+    GamepadButtonMapping buttonFretYellow{0};
+    GamepadButtonMapping buttonFretBlue{0};
+    GamepadButtonMapping buttonFretOrange{0};
+    GamepadButtonMapping buttonFretSoloGreen{0};
+    GamepadButtonMapping buttonFretSoloRed{0};
+    GamepadButtonMapping buttonFretSoloYellow{0};
+    GamepadButtonMapping buttonFretSoloBlue{0};
+    GamepadButtonMapping buttonFretSoloOrange{0};
+    GamepadButtonMapping buttonWhammy{0};
+    GamepadButtonMapping buttonPickup{0};
+    GamepadButtonMapping buttonTilt{0};
 
-    GamepadButtonMapping *buttonDrumPadRed;
-    GamepadButtonMapping *buttonDrumPadBlue;
-    GamepadButtonMapping *buttonDrumPadYellow;
-    GamepadButtonMapping *buttonDrumPadGreen;
-    GamepadButtonMapping *buttonCymbalYellow;
-    GamepadButtonMapping *buttonCymbalBlue;
-    GamepadButtonMapping *buttonCymbalGreen;
-    GamepadButtonMapping *buttonKickPedalLeft;
-    GamepadButtonMapping *buttonKickPedalRight;
+    GamepadButtonMapping buttonDrumPadRed{0};
+    GamepadButtonMapping buttonDrumPadBlue{0};
+    GamepadButtonMapping buttonDrumPadYellow{0};
+    GamepadButtonMapping buttonDrumPadGreen{0};
+    GamepadButtonMapping buttonCymbalYellow{0};
+    GamepadButtonMapping buttonCymbalBlue{0};
+    GamepadButtonMapping buttonCymbalGreen{0};
+    GamepadButtonMapping buttonKickPedalLeft{0};
+    GamepadButtonMapping buttonKickPedalRight{0};
 };
 
 #endif // _PS4_DRIVER_H_
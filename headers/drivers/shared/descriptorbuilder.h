@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _DESCRIPTOR_BUILDER_H_
+#define _DESCRIPTOR_BUILDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+//
+// Compile-time USB descriptor builder
+//
+// Device, configuration, HID report and string descriptors are assembled by
+// constexpr functions so lengths (wTotalLength, bNumInterfaces, HID report
+// sizes, string bLength) are derived from the content instead of being kept
+// in sync by hand. The results are plain byte/word arrays that convert to
+// the pointers TinyUSB expects, so they can be returned straight from the
+// descriptor callbacks and still work with sizeof().
+//
+namespace USBDescriptor {
+
+template <size_t N>
+struct Bytes {
+    uint8_t data[N];
+
+    constexpr size_t size() const { return N; }
+    constexpr operator const uint8_t *() const { return data; }
+};
+
+template <size_t N>
+struct String {
+    uint16_t data[N];
+
+    constexpr size_t size() const { return N * sizeof(uint16_t); }
+    constexpr operator const uint16_t *() const { return data; }
+};
+
+constexpr uint8_t lsb(uint16_t value) { return value & 0xFF; }
+constexpr uint8_t msb(uint16_t value) { return (value >> 8) & 0xFF; }
+
+// Raw bytes, for vendor specific descriptors with no builder of their own
+template <typename... T>
+constexpr Bytes<sizeof...(T)> raw(T... values) {
+    return Bytes<sizeof...(T)>{ { static_cast<uint8_t>(values)... } };
+}
+
+template <size_t N>
+constexpr Bytes<N> concat(const Bytes<N> &bytes) {
+    return bytes;
+}
+
+template <size_t A, size_t B, size_t... Rest>
+constexpr auto concat(const Bytes<A> &a, const Bytes<B> &b, const Bytes<Rest> &... rest) {
+    Bytes<A + B> out{};
+    for (size_t i = 0; i < A; i++)
+        out.data[i] = a.data[i];
+    for (size_t i = 0; i < B; i++)
+        out.data[A + i] = b.data[i];
+    return concat(out, rest...);
+}
+
+//
+// Standard descriptors (USB 2.0 spec, chapter 9.6)
+//
+
+constexpr Bytes<18> device(uint16_t bcdUSB, uint8_t deviceClass, uint8_t deviceSubClass, uint8_t deviceProtocol,
+                           uint8_t maxPacketSize0, uint16_t vendorID, uint16_t productID, uint16_t bcdDevice,
+                           uint8_t iManufacturer, uint8_t iProduct, uint8_t iSerialNumber, uint8_t numConfigurations) {
+    return Bytes<18>{ {
+        18, 0x01,
+        lsb(bcdUSB), msb(bcdUSB),
+        deviceClass, deviceSubClass, deviceProtocol,
+        maxPacketSize0,
+        lsb(vendorID), msb(vendorID),
+        lsb(productID), msb(productID),
+        lsb(bcdDevice), msb(bcdDevice),
+        iManufacturer, iProduct, iSerialNumber,
+        numConfigurations
+    } };
+}
+
+constexpr Bytes<9> interface(uint8_t interfaceNumber, uint8_t alternateSetting, uint8_t numEndpoints,
+                             uint8_t interfaceClass, uint8_t interfaceSubClass, uint8_t interfaceProtocol,
+                             uint8_t iInterface) {
+    return Bytes<9>{ {
+        9, 0x04,
+        interfaceNumber, alternateSetting, numEndpoints,
+        interfaceClass, interfaceSubClass, interfaceProtocol,
+        iInterface
+    } };
+}
+
+constexpr Bytes<7> endpoint(uint8_t endpointAddress, uint8_t attributes, uint16_t maxPacketSize, uint8_t interval) {
+    return Bytes<7>{ {
+        7, 0x05,
+        endpointAddress, attributes,
+        lsb(maxPacketSize), msb(maxPacketSize),
+        interval
+    } };
+}
+
+// HID class descriptor with a single report descriptor (HID 1.11, section 6.2.1)
+constexpr Bytes<9> hid(uint16_t bcdHID, uint8_t countryCode, uint16_t reportDescriptorLength) {
+    return Bytes<9>{ {
+        9, 0x21,
+        lsb(bcdHID), msb(bcdHID),
+        countryCode,
+        1, 0x22,
+        lsb(reportDescriptorLength), msb(reportDescriptorLength)
+    } };
+}
+
+// Configuration header followed by every interface, class and endpoint descriptor.
+// wTotalLength and bNumInterfaces are calculated from the contents.
+template <size_t... N>
+constexpr auto configuration(uint8_t configurationValue, uint8_t iConfiguration, uint8_t attributes, uint8_t maxPower,
+                             const Bytes<N> &... parts) {
+    constexpr size_t length = 9 + (N + ... + 0);
+    static_assert(length <= 0xFFFF, "configuration descriptor too long");
+
+    auto out = concat(raw(9, 0x02, lsb(length), msb(length), 0, configurationValue, iConfiguration, attributes, maxPower), parts...);
+
+    // count interfaces, alternate settings share their interface number
+    uint8_t numInterfaces = 0;
+    for (size_t i = 9; i + 1 < length && out.data[i] != 0; i += out.data[i]) {
+        if (out.data[i + 1] == 0x04 && out.data[i + 3] == 0)
+            numInterfaces++;
+    }
+    out.data[4] = numInterfaces;
+    return out;
+}
+
+//
+// String descriptors
+//
+
+// Language ID table (string index 0)
+constexpr String<2> language(uint16_t languageID) {
+    return String<2>{ { (0x03 << 8) | 4, languageID } };
+}
+
+// 8-bit string literal widened to UTF-16, only the Latin-1 range is supported
+template <size_t N>
+constexpr String<N> string(const char (&value)[N]) {
+    static_assert(N <= 127, "string descriptors are limited to 126 characters");
+    String<N> out{};
+    out.data[0] = (0x03 << 8) | (2 * (N - 1) + 2);
+    for (size_t i = 0; i < N - 1; i++)
+        out.data[i + 1] = static_cast<uint8_t>(value[i]);
+    return out;
+}
+
+//
+// HID report descriptor short items (HID 1.11, section 6.2.2)
+//
+namespace HIDItem {
+
+struct Item {
+    uint8_t data[5];
+    uint8_t length;
+};
+
+// size of 0 picks the smallest encoding for the value
+constexpr Item item(uint8_t prefix, uint32_t value, uint8_t size) {
+    Item out{};
+    out.data[0] = prefix | (size == 4 ? 3 : size);
+    for (uint8_t i = 0; i < size; i++)
+        out.data[1 + i] = (value >> (8 * i)) & 0xFF;
+    out.length = 1 + size;
+    return out;
+}
+
+constexpr uint8_t unsignedSize(uint32_t value) {
+    return value <= 0xFF ? 1 : (value <= 0xFFFF ? 2 : 4);
+}
+
+constexpr uint8_t signedSize(int32_t value) {
+    return (value >= -128 && value <= 127) ? 1 : ((value >= -32768 && value <= 32767) ? 2 : 4);
+}
+
+constexpr Item unsignedItem(uint8_t prefix, uint32_t value, uint8_t size) {
+    return item(prefix, value, size ? size : unsignedSize(value));
+}
+
+constexpr Item signedItem(uint8_t prefix, int32_t value, uint8_t size) {
+    return item(prefix, static_cast<uint32_t>(value), size ? size : signedSize(value));
+}
+
+// Main items
+constexpr Item input(uint32_t flags, uint8_t size = 0)         { return unsignedItem(0x80, flags, size); }
+constexpr Item output(uint32_t flags, uint8_t size = 0)        { return unsignedItem(0x90, flags, size); }
+constexpr Item feature(uint32_t flags, uint8_t size = 0)       { return unsignedItem(0xB0, flags, size); }
+constexpr Item collection(uint8_t type)                        { return item(0xA0, type, 1); }
+constexpr Item endCollection()                                 { return item(0xC0, 0, 0); }
+
+// Global items
+constexpr Item usagePage(uint32_t page, uint8_t size = 0)      { return unsignedItem(0x04, page, size); }
+constexpr Item logicalMinimum(int32_t value, uint8_t size = 0) { return signedItem(0x14, value, size); }
+constexpr Item logicalMaximum(int32_t value, uint8_t size = 0) { return signedItem(0x24, value, size); }
+constexpr Item physicalMinimum(int32_t value, uint8_t size = 0){ return signedItem(0x34, value, size); }
+constexpr Item physicalMaximum(int32_t value, uint8_t size = 0){ return signedItem(0x44, value, size); }
+constexpr Item unitExponent(uint32_t value, uint8_t size = 0)  { return unsignedItem(0x54, value, size); }
+constexpr Item unit(uint32_t value, uint8_t size = 0)          { return unsignedItem(0x64, value, size); }
+constexpr Item reportSize(uint32_t value, uint8_t size = 0)    { return unsignedItem(0x74, value, size); }
+constexpr Item reportID(uint8_t id)                            { return item(0x84, id, 1); }
+constexpr Item reportCount(uint32_t value, uint8_t size = 0)   { return unsignedItem(0x94, value, size); }
+
+// Local items
+constexpr Item usage(uint32_t value, uint8_t size = 0)         { return unsignedItem(0x08, value, size); }
+constexpr Item usageMinimum(uint32_t value, uint8_t size = 0)  { return unsignedItem(0x18, value, size); }
+constexpr Item usageMaximum(uint32_t value, uint8_t size = 0)  { return unsignedItem(0x28, value, size); }
+
+template <size_t Capacity>
+struct ItemList {
+    uint8_t data[Capacity];
+    size_t length;
+};
+
+template <typename... T>
+constexpr ItemList<5 * sizeof...(T)> items(T... values) {
+    ItemList<5 * sizeof...(T)> out{};
+    const Item list[] = { values... };
+    for (const Item &entry : list) {
+        for (uint8_t i = 0; i < entry.length; i++)
+            out.data[out.length++] = entry.data[i];
+    }
+    return out;
+}
+
+} // namespace HIDItem
+
+// Shrinks the item list returned by a (captureless) lambda to an exactly
+// sized report descriptor. The lambda is there so the items can be written
+// with `using namespace USBDescriptor::HIDItem` without leaking it.
+template <typename Builder>
+constexpr auto hidReport(Builder builder) {
+    constexpr auto list = builder();
+    Bytes<list.length> out{};
+    for (size_t i = 0; i < list.length; i++)
+        out.data[i] = list.data[i];
+    return out;
+}
+
+} // namespace USBDescriptor
+
+#endif // _DESCRIPTOR_BUILDER_H_
@@ -14,12 +14,13 @@ typedef enum {
 
 class GPAuthDriver {
 public:
+    virtual ~GPAuthDriver() { delete listener; }
     virtual void initialize() = 0;
     virtual bool available() = 0;
     virtual USBListener * getListener() { return listener; }
     InputModeAuthType getAuthType() { return authType; }
 protected:
-    USBListener * listener;
+    USBListener * listener = nullptr;
     InputModeAuthType authType;
 };
 
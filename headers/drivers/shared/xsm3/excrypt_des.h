@@ -2,9 +2,11 @@
 #define EXCRYPT_DES_H_
 // DES & 3DES functions
 
+// Round keys are stored pre-split into the eight 6-bit S-Box groups so
+// the round function can index SPBOX directly
 typedef struct _EXCRYPT_DES_STATE
 {
-  uint64_t keytab[16];
+  uint8_t keytab[16][8];
 } EXCRYPT_DES_STATE;
 
 void ExCryptDesParity(const uint8_t* input, uint32_t input_size, uint8_t* output);
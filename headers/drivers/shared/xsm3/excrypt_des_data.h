@@ -3,121 +3,166 @@
 // Data needed by DES/3DES functions
 // (only included by excrypt_des.c - no headers should include this!)
 
-#define LB32_MASK 0x00000001
 #define LB64_MASK 0x0000000000000001
-#define L64_MASK  0x00000000ffffffff
 
-// Initial Permutation Table [8*8]
-static const char IP[] =
+// Combined S-Box + P permutation tables [8*64]
+// Each entry is the 32-bit round function output for one S-Box, indexed
+// directly by the raw 6-bit S-Box input (row/column selection and the
+// post S-Box permutation are already applied).
+static const uint32_t SPBOX[8][64] =
 {
-    58, 50, 42, 34, 26, 18, 10, 2,
-    60, 52, 44, 36, 28, 20, 12, 4,
-    62, 54, 46, 38, 30, 22, 14, 6,
-    64, 56, 48, 40, 32, 24, 16, 8,
-    57, 49, 41, 33, 25, 17,  9, 1,
-    59, 51, 43, 35, 27, 19, 11, 3,
-    61, 53, 45, 37, 29, 21, 13, 5,
-    63, 55, 47, 39, 31, 23, 15, 7
-};
-
-// Inverse Initial Permutation Table [8*8]
-static const char FP[] =
-{
-    40, 8, 48, 16, 56, 24, 64, 32,
-    39, 7, 47, 15, 55, 23, 63, 31,
-    38, 6, 46, 14, 54, 22, 62, 30,
-    37, 5, 45, 13, 53, 21, 61, 29,
-    36, 4, 44, 12, 52, 20, 60, 28,
-    35, 3, 43, 11, 51, 19, 59, 27,
-    34, 2, 42, 10, 50, 18, 58, 26,
-    33, 1, 41,  9, 49, 17, 57, 25
-};
-
-// Expansion table [6*8]
-static const char EXPANSION[] =
-{
-    32,  1,  2,  3,  4,  5,
-     4,  5,  6,  7,  8,  9,
-     8,  9, 10, 11, 12, 13,
-    12, 13, 14, 15, 16, 17,
-    16, 17, 18, 19, 20, 21,
-    20, 21, 22, 23, 24, 25,
-    24, 25, 26, 27, 28, 29,
-    28, 29, 30, 31, 32,  1
-};
-
-// The S-Box tables [8*16*4]
-static const char SBOX[8][64] =
-{
-    {
+  {
     // S1
-    14,  4, 13,  1,  2, 15, 11,  8,  3, 10,  6, 12,  5,  9,  0,  7,
-     0, 15,  7,  4, 14,  2, 13,  1, 10,  6, 12, 11,  9,  5,  3,  8,
-     4,  1, 14,  8, 13,  6,  2, 11, 15, 12,  9,  7,  3, 10,  5,  0,
-    15, 12,  8,  2,  4,  9,  1,  7,  5, 11,  3, 14, 10,  0,  6, 13
-},
-{
-  // S2
-  15,  1,  8, 14,  6, 11,  3,  4,  9,  7,  2, 13, 12,  0,  5, 10,
-   3, 13,  4,  7, 15,  2,  8, 14, 12,  0,  1, 10,  6,  9, 11,  5,
-   0, 14,  7, 11, 10,  4, 13,  1,  5,  8, 12,  6,  9,  3,  2, 15,
-  13,  8, 10,  1,  3, 15,  4,  2, 11,  6,  7, 12,  0,  5, 14,  9
-},
-{
-  // S3
-  10,  0,  9, 14,  6,  3, 15,  5,  1, 13, 12,  7, 11,  4,  2,  8,
-  13,  7,  0,  9,  3,  4,  6, 10,  2,  8,  5, 14, 12, 11, 15,  1,
-  13,  6,  4,  9,  8, 15,  3,  0, 11,  1,  2, 12,  5, 10, 14,  7,
-   1, 10, 13,  0,  6,  9,  8,  7,  4, 15, 14,  3, 11,  5,  2, 12
-},
-{
-  // S4
-   7, 13, 14,  3,  0,  6,  9, 10,  1,  2,  8,  5, 11, 12,  4, 15,
-  13,  8, 11,  5,  6, 15,  0,  3,  4,  7,  2, 12,  1, 10, 14,  9,
-  10,  6,  9,  0, 12, 11,  7, 13, 15,  1,  3, 14,  5,  2,  8,  4,
-   3, 15,  0,  6, 10,  1, 13,  8,  9,  4,  5, 11, 12,  7,  2, 14
-},
-{
-  // S5
-   2, 12,  4,  1,  7, 10, 11,  6,  8,  5,  3, 15, 13,  0, 14,  9,
-  14, 11,  2, 12,  4,  7, 13,  1,  5,  0, 15, 10,  3,  9,  8,  6,
-   4,  2,  1, 11, 10, 13,  7,  8, 15,  9, 12,  5,  6,  3,  0, 14,
-  11,  8, 12,  7,  1, 14,  2, 13,  6, 15,  0,  9, 10,  4,  5,  3
-},
-{
-  // S6
-  12,  1, 10, 15,  9,  2,  6,  8,  0, 13,  3,  4, 14,  7,  5, 11,
-  10, 15,  4,  2,  7, 12,  9,  5,  6,  1, 13, 14,  0, 11,  3,  8,
-   9, 14, 15,  5,  2,  8, 12,  3,  7,  0,  4, 10,  1, 13, 11,  6,
-   4,  3,  2, 12,  9,  5, 15, 10, 11, 14,  1,  7,  6,  0,  8, 13
-},
-{
-  // S7
-   4, 11,  2, 14, 15,  0,  8, 13,  3, 12,  9,  7,  5, 10,  6,  1,
-  13,  0, 11,  7,  4,  9,  1, 10, 14,  3,  5, 12,  2, 15,  8,  6,
-   1,  4, 11, 13, 12,  3,  7, 14, 10, 15,  6,  8,  0,  5,  9,  2,
-   6, 11, 13,  8,  1,  4, 10,  7,  9,  5,  0, 15, 14,  2,  3, 12
-},
-{
-  // S8
-  13,  2,  8,  4,  6, 15, 11,  1, 10,  9,  3, 14,  5,  0, 12,  7,
-   1, 15, 13,  8, 10,  3,  7,  4, 12,  5,  6, 11,  0, 14,  9,  2,
-   7, 11,  4,  1,  9, 12, 14,  2,  0,  6, 10, 13, 15,  3,  5,  8,
-   2,  1, 14,  7,  4, 10,  8, 13, 15, 12,  9,  0,  3,  5,  6, 11
-}
-};
-
-// Post S-Box permutation [4*8]
-static const char PBOX[] =
-{
-    16,  7, 20, 21,
-    29, 12, 28, 17,
-     1, 15, 23, 26,
-     5, 18, 31, 10,
-     2,  8, 24, 14,
-    32, 27,  3,  9,
-    19, 13, 30,  6,
-    22, 11,  4, 25
+    0x00808200, 0x00000000, 0x00008000, 0x00808202,
+    0x00808002, 0x00008202, 0x00000002, 0x00008000,
+    0x00000200, 0x00808200, 0x00808202, 0x00000200,
+    0x00800202, 0x00808002, 0x00800000, 0x00000002,
+    0x00000202, 0x00800200, 0x00800200, 0x00008200,
+    0x00008200, 0x00808000, 0x00808000, 0x00800202,
+    0x00008002, 0x00800002, 0x00800002, 0x00008002,
+    0x00000000, 0x00000202, 0x00008202, 0x00800000,
+    0x00008000, 0x00808202, 0x00000002, 0x00808000,
+    0x00808200, 0x00800000, 0x00800000, 0x00000200,
+    0x00808002, 0x00008000, 0x00008200, 0x00800002,
+    0x00000200, 0x00000002, 0x00800202, 0x00008202,
+    0x00808202, 0x00008002, 0x00808000, 0x00800202,
+    0x00800002, 0x00000202, 0x00008202, 0x00808200,
+    0x00000202, 0x00800200, 0x00800200, 0x00000000,
+    0x00008002, 0x00008200, 0x00000000, 0x00808002,
+  },
+  {
+    // S2
+    0x40084010, 0x40004000, 0x00004000, 0x00084010,
+    0x00080000, 0x00000010, 0x40080010, 0x40004010,
+    0x40000010, 0x40084010, 0x40084000, 0x40000000,
+    0x40004000, 0x00080000, 0x00000010, 0x40080010,
+    0x00084000, 0x00080010, 0x40004010, 0x00000000,
+    0x40000000, 0x00004000, 0x00084010, 0x40080000,
+    0x00080010, 0x40000010, 0x00000000, 0x00084000,
+    0x00004010, 0x40084000, 0x40080000, 0x00004010,
+    0x00000000, 0x00084010, 0x40080010, 0x00080000,
+    0x40004010, 0x40080000, 0x40084000, 0x00004000,
+    0x40080000, 0x40004000, 0x00000010, 0x40084010,
+    0x00084010, 0x00000010, 0x00004000, 0x40000000,
+    0x00004010, 0x40084000, 0x00080000, 0x40000010,
+    0x00080010, 0x40004010, 0x40000010, 0x00080010,
+    0x00084000, 0x00000000, 0x40004000, 0x00004010,
+    0x40000000, 0x40080010, 0x40084010, 0x00084000,
+  },
+  {
+    // S3
+    0x00000104, 0x04010100, 0x00000000, 0x04010004,
+    0x04000100, 0x00000000, 0x00010104, 0x04000100,
+    0x00010004, 0x04000004, 0x04000004, 0x00010000,
+    0x04010104, 0x00010004, 0x04010000, 0x00000104,
+    0x04000000, 0x00000004, 0x04010100, 0x00000100,
+    0x00010100, 0x04010000, 0x04010004, 0x00010104,
+    0x04000104, 0x00010100, 0x00010000, 0x04000104,
+    0x00000004, 0x04010104, 0x00000100, 0x04000000,
+    0x04010100, 0x04000000, 0x00010004, 0x00000104,
+    0x00010000, 0x04010100, 0x04000100, 0x00000000,
+    0x00000100, 0x00010004, 0x04010104, 0x04000100,
+    0x04000004, 0x00000100, 0x00000000, 0x04010004,
+    0x04000104, 0x00010000, 0x04000000, 0x04010104,
+    0x00000004, 0x00010104, 0x00010100, 0x04000004,
+    0x04010000, 0x04000104, 0x00000104, 0x04010000,
+    0x00010104, 0x00000004, 0x04010004, 0x00010100,
+  },
+  {
+    // S4
+    0x80401000, 0x80001040, 0x80001040, 0x00000040,
+    0x00401040, 0x80400040, 0x80400000, 0x80001000,
+    0x00000000, 0x00401000, 0x00401000, 0x80401040,
+    0x80000040, 0x00000000, 0x00400040, 0x80400000,
+    0x80000000, 0x00001000, 0x00400000, 0x80401000,
+    0x00000040, 0x00400000, 0x80001000, 0x00001040,
+    0x80400040, 0x80000000, 0x00001040, 0x00400040,
+    0x00001000, 0x00401040, 0x80401040, 0x80000040,
+    0x00400040, 0x80400000, 0x00401000, 0x80401040,
+    0x80000040, 0x00000000, 0x00000000, 0x00401000,
+    0x00001040, 0x00400040, 0x80400040, 0x80000000,
+    0x80401000, 0x80001040, 0x80001040, 0x00000040,
+    0x80401040, 0x80000040, 0x80000000, 0x00001000,
+    0x80400000, 0x80001000, 0x00401040, 0x80400040,
+    0x80001000, 0x00001040, 0x00400000, 0x80401000,
+    0x00000040, 0x00400000, 0x00001000, 0x00401040,
+  },
+  {
+    // S5
+    0x00000080, 0x01040080, 0x01040000, 0x21000080,
+    0x00040000, 0x00000080, 0x20000000, 0x01040000,
+    0x20040080, 0x00040000, 0x01000080, 0x20040080,
+    0x21000080, 0x21040000, 0x00040080, 0x20000000,
+    0x01000000, 0x20040000, 0x20040000, 0x00000000,
+    0x20000080, 0x21040080, 0x21040080, 0x01000080,
+    0x21040000, 0x20000080, 0x00000000, 0x21000000,
+    0x01040080, 0x01000000, 0x21000000, 0x00040080,
+    0x00040000, 0x21000080, 0x00000080, 0x01000000,
+    0x20000000, 0x01040000, 0x21000080, 0x20040080,
+    0x01000080, 0x20000000, 0x21040000, 0x01040080,
+    0x20040080, 0x00000080, 0x01000000, 0x21040000,
+    0x21040080, 0x00040080, 0x21000000, 0x21040080,
+    0x01040000, 0x00000000, 0x20040000, 0x21000000,
+    0x00040080, 0x01000080, 0x20000080, 0x00040000,
+    0x00000000, 0x20040000, 0x01040080, 0x20000080,
+  },
+  {
+    // S6
+    0x10000008, 0x10200000, 0x00002000, 0x10202008,
+    0x10200000, 0x00000008, 0x10202008, 0x00200000,
+    0x10002000, 0x00202008, 0x00200000, 0x10000008,
+    0x00200008, 0x10002000, 0x10000000, 0x00002008,
+    0x00000000, 0x00200008, 0x10002008, 0x00002000,
+    0x00202000, 0x10002008, 0x00000008, 0x10200008,
+    0x10200008, 0x00000000, 0x00202008, 0x10202000,
+    0x00002008, 0x00202000, 0x10202000, 0x10000000,
+    0x10002000, 0x00000008, 0x10200008, 0x00202000,
+    0x10202008, 0x00200000, 0x00002008, 0x10000008,
+    0x00200000, 0x10002000, 0x10000000, 0x00002008,
+    0x10000008, 0x10202008, 0x00202000, 0x10200000,
+    0x00202008, 0x10202000, 0x00000000, 0x10200008,
+    0x00000008, 0x00002000, 0x10200000, 0x00202008,
+    0x00002000, 0x00200008, 0x10002008, 0x00000000,
+    0x10202000, 0x10000000, 0x00200008, 0x10002008,
+  },
+  {
+    // S7
+    0x00100000, 0x02100001, 0x02000401, 0x00000000,
+    0x00000400, 0x02000401, 0x00100401, 0x02100400,
+    0x02100401, 0x00100000, 0x00000000, 0x02000001,
+    0x00000001, 0x02000000, 0x02100001, 0x00000401,
+    0x02000400, 0x00100401, 0x00100001, 0x02000400,
+    0x02000001, 0x02100000, 0x02100400, 0x00100001,
+    0x02100000, 0x00000400, 0x00000401, 0x02100401,
+    0x00100400, 0x00000001, 0x02000000, 0x00100400,
+    0x02000000, 0x00100400, 0x00100000, 0x02000401,
+    0x02000401, 0x02100001, 0x02100001, 0x00000001,
+    0x00100001, 0x02000000, 0x02000400, 0x00100000,
+    0x02100400, 0x00000401, 0x00100401, 0x02100400,
+    0x00000401, 0x02000001, 0x02100401, 0x02100000,
+    0x00100400, 0x00000000, 0x00000001, 0x02100401,
+    0x00000000, 0x00100401, 0x02100000, 0x00000400,
+    0x02000001, 0x02000400, 0x00000400, 0x00100001,
+  },
+  {
+    // S8
+    0x08000820, 0x00000800, 0x00020000, 0x08020820,
+    0x08000000, 0x08000820, 0x00000020, 0x08000000,
+    0x00020020, 0x08020000, 0x08020820, 0x00020800,
+    0x08020800, 0x00020820, 0x00000800, 0x00000020,
+    0x08020000, 0x08000020, 0x08000800, 0x00000820,
+    0x00020800, 0x00020020, 0x08020020, 0x08020800,
+    0x00000820, 0x00000000, 0x00000000, 0x08020020,
+    0x08000020, 0x08000800, 0x00020820, 0x00020000,
+    0x00020820, 0x00020000, 0x08020800, 0x00000800,
+    0x00000020, 0x08020020, 0x00000800, 0x00020820,
+    0x08000800, 0x00000020, 0x08000020, 0x08020000,
+    0x08020020, 0x08000000, 0x00020000, 0x08000820,
+    0x00000000, 0x08020820, 0x00020020, 0x08000020,
+    0x08020000, 0x08000800, 0x08000820, 0x00000000,
+    0x08020820, 0x00020800, 0x00020800, 0x00000820,
+    0x00000820, 0x00020020, 0x08000000, 0x08020800,
+  }
 };
 
 // Permuted Choice 1 Table [7*8]
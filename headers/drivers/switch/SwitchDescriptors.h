@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "descriptorbuilder.h"
 
 #define SWITCH_ENDPOINT_SIZE 64
 
@@ -62,12 +63,13 @@ typedef struct
 	uint8_t ry;
 } SwitchOutReport;
 
-static const uint8_t switch_string_language[]     = { 0x09, 0x04 };
-static const uint8_t switch_string_manufacturer[] = "HORI CO.,LTD.";
-static const uint8_t switch_string_product[]      = "POKKEN CONTROLLER";
-static const uint8_t switch_string_version[]      = "1.0";
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto switch_string_language     = USBDescriptor::language(0x0009);
+static constexpr auto switch_string_manufacturer = USBDescriptor::string("HORI CO.,LTD.");
+static constexpr auto switch_string_product      = USBDescriptor::string("POKKEN CONTROLLER");
+static constexpr auto switch_string_version      = USBDescriptor::string("1.0");
 
-static const uint8_t *switch_string_descriptors[] __attribute__((unused)) =
+static const uint16_t *switch_string_descriptors[] __attribute__((unused)) =
 {
 	switch_string_language,
 	switch_string_manufacturer,
@@ -75,120 +77,79 @@ static const uint8_t *switch_string_descriptors[] __attribute__((unused)) =
 	switch_string_version
 };
 
-static const uint8_t switch_device_descriptor[] =
-{
-	0x12,        // bLength
-	0x01,        // bDescriptorType (Device)
-	0x00, 0x02,  // bcdUSB 2.00
+static constexpr auto switch_device_descriptor = USBDescriptor::device(
+	0x0200,      // bcdUSB 2.00
 	0x00,        // bDeviceClass (Use class information in the Interface Descriptors)
 	0x00,        // bDeviceSubClass
 	0x00,        // bDeviceProtocol
 	0x40,        // bMaxPacketSize0 64
-	0x0D, 0x0F,  // idVendor 0x0F0D
-	0x92, 0x00,  // idProduct 0x92
-	0x00, 0x01,  // bcdDevice 2.00
+	0x0F0D,      // idVendor 0x0F0D
+	0x0092,      // idProduct 0x92
+	0x0100,      // bcdDevice 2.00
 	0x01,        // iManufacturer (String Index)
 	0x02,        // iProduct (String Index)
 	0x00,        // iSerialNumber (String Index)
-	0x01,        // bNumConfigurations 1
-};
-
-static const uint8_t switch_hid_descriptor[] =
-{
-	0x09,        // bLength
-	0x21,        // bDescriptorType (HID)
-	0x11, 0x01,  // bcdHID 1.11
-	0x00,        // bCountryCode
-	0x01,        // bNumDescriptors
-	0x22,        // bDescriptorType[0] (HID)
-	0x56, 0x00,  // wDescriptorLength[0] 86
-};
-
-static const uint8_t switch_configuration_descriptor[] =
-{
-	0x09,        // bLength
-	0x02,        // bDescriptorType (Configuration)
-	0x29, 0x00,  // wTotalLength 41
-	0x01,        // bNumInterfaces 1
+	0x01         // bNumConfigurations 1
+);
+
+static constexpr auto switch_report_descriptor = USBDescriptor::hidReport([] {
+	using namespace USBDescriptor::HIDItem;
+	return items(
+		usagePage(0x01),        // Usage Page (Generic Desktop Ctrls)
+		usage(0x05),            // Usage (Game Pad)
+		collection(0x01),       // Collection (Application)
+		logicalMinimum(0),      //   Logical Minimum (0)
+		logicalMaximum(1),      //   Logical Maximum (1)
+		physicalMinimum(0),     //   Physical Minimum (0)
+		physicalMaximum(1),     //   Physical Maximum (1)
+		reportSize(1),          //   Report Size (1)
+		reportCount(16),        //   Report Count (16)
+		usagePage(0x09),        //   Usage Page (Button)
+		usageMinimum(0x01),     //   Usage Minimum (0x01)
+		usageMaximum(0x10),     //   Usage Maximum (0x10)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usagePage(0x01),        //   Usage Page (Generic Desktop Ctrls)
+		logicalMaximum(7),      //   Logical Maximum (7)
+		physicalMaximum(315),   //   Physical Maximum (315)
+		reportSize(4),          //   Report Size (4)
+		reportCount(1),         //   Report Count (1)
+		unit(0x14),             //   Unit (System: English Rotation, Length: Centimeter)
+		usage(0x39),            //   Usage (Hat switch)
+		input(0x42),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,Null State)
+		unit(0x00),             //   Unit (None)
+		reportCount(1),         //   Report Count (1)
+		input(0x01),            //   Input (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		logicalMaximum(255),    //   Logical Maximum (255)
+		physicalMaximum(255),   //   Physical Maximum (255)
+		usage(0x30),            //   Usage (X)
+		usage(0x31),            //   Usage (Y)
+		usage(0x32),            //   Usage (Z)
+		usage(0x35),            //   Usage (Rz)
+		reportSize(8),          //   Report Size (8)
+		reportCount(4),         //   Report Count (4)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usagePage(0xFF00),      //   Usage Page (Vendor Defined 0xFF00)
+		usage(0x20),            //   Usage (0x20)
+		reportCount(1),         //   Report Count (1)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usage(0x2621),          //   Usage (0x2621)
+		reportCount(8),         //   Report Count (8)
+		output(0x02),           //   Output (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
+		endCollection()         // End Collection
+	);
+});
+static_assert(sizeof(switch_report_descriptor) == 86, "unexpected Switch report descriptor length");
+
+static constexpr auto switch_hid_descriptor = USBDescriptor::hid(0x0111, 0x00, sizeof(switch_report_descriptor));
+
+static constexpr auto switch_configuration_descriptor = USBDescriptor::configuration(
 	0x01,        // bConfigurationValue
 	0x00,        // iConfiguration (String Index)
 	0x80,        // bmAttributes
 	0xFA,        // bMaxPower 500mA
-
-	0x09,        // bLength
-	0x04,        // bDescriptorType (Interface)
-	0x00,        // bInterfaceNumber 0
-	0x00,        // bAlternateSetting
-	0x02,        // bNumEndpoints 2
-	0x03,        // bInterfaceClass
-	0x00,        // bInterfaceSubClass
-	0x00,        // bInterfaceProtocol
-	0x00,        // iInterface (String Index)
-
-	0x09,        // bLength
-	0x21,        // bDescriptorType (HID)
-	0x11, 0x01,  // bcdHID 1.11
-	0x00,        // bCountryCode
-	0x01,        // bNumDescriptors
-	0x22,        // bDescriptorType[0] (HID)
-	0x56, 0x00,  // wDescriptorLength[0] 86
-
-	0x07,        // bLength
-	0x05,        // bDescriptorType (Endpoint)
-	0x02,        // bEndpointAddress (OUT/H2D)
-	0x03,        // bmAttributes (Interrupt)
-	0x40, 0x00,  // wMaxPacketSize 64
-	0x01,        // bInterval 1 (unit depends on device speed)
-
-	0x07,        // bLength
-	0x05,        // bDescriptorType (Endpoint)
-	0x81,        // bEndpointAddress (IN/D2H)
-	0x03,        // bmAttributes (Interrupt)
-	0x40, 0x00,  // wMaxPacketSize 64
-	0x01,        // bInterval 1 (unit depends on device speed)
-};
-
-static const uint8_t switch_report_descriptor[] =
-{
-	0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
-	0x09, 0x05,        // Usage (Game Pad)
-	0xA1, 0x01,        // Collection (Application)
-	0x15, 0x00,        //   Logical Minimum (0)
-	0x25, 0x01,        //   Logical Maximum (1)
-	0x35, 0x00,        //   Physical Minimum (0)
-	0x45, 0x01,        //   Physical Maximum (1)
-	0x75, 0x01,        //   Report Size (1)
-	0x95, 0x10,        //   Report Count (16)
-	0x05, 0x09,        //   Usage Page (Button)
-	0x19, 0x01,        //   Usage Minimum (0x01)
-	0x29, 0x10,        //   Usage Maximum (0x10)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-	0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
-	0x25, 0x07,        //   Logical Maximum (7)
-	0x46, 0x3B, 0x01,  //   Physical Maximum (315)
-	0x75, 0x04,        //   Report Size (4)
-	0x95, 0x01,        //   Report Count (1)
-	0x65, 0x14,        //   Unit (System: English Rotation, Length: Centimeter)
-	0x09, 0x39,        //   Usage (Hat switch)
-	0x81, 0x42,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,Null State)
-	0x65, 0x00,        //   Unit (None)
-	0x95, 0x01,        //   Report Count (1)
-	0x81, 0x01,        //   Input (Const,Array,Abs,No Wrap,Linear,Preferred State,No Null Position)
-	0x26, 0xFF, 0x00,  //   Logical Maximum (255)
-	0x46, 0xFF, 0x00,  //   Physical Maximum (255)
-	0x09, 0x30,        //   Usage (X)
-	0x09, 0x31,        //   Usage (Y)
-	0x09, 0x32,        //   Usage (Z)
-	0x09, 0x35,        //   Usage (Rz)
-	0x75, 0x08,        //   Report Size (8)
-	0x95, 0x04,        //   Report Count (4)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-	0x06, 0x00, 0xFF,  //   Usage Page (Vendor Defined 0xFF00)
-	0x09, 0x20,        //   Usage (0x20)
-	0x95, 0x01,        //   Report Count (1)
-	0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-	0x0A, 0x21, 0x26,  //   Usage (0x2621)
-	0x95, 0x08,        //   Report Count (8)
-	0x91, 0x02,        //   Output (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Non-volatile)
-	0xC0,              // End Collection
-};
+	USBDescriptor::interface(0, 0, 2, 0x03, 0x00, 0x00, 0x00), // HID, 2 endpoints
+	switch_hid_descriptor,
+	USBDescriptor::endpoint(0x02, 0x03, 64, 1), // OUT/H2D, interrupt, 1 ms
+	USBDescriptor::endpoint(0x81, 0x03, 64, 1)  // IN/D2H, interrupt, 1 ms
+);
+static_assert(sizeof(switch_configuration_descriptor) == 41, "unexpected Switch configuration descriptor length");
@@ -6,19 +6,13 @@
 #pragma once
 
 #include <stdint.h>
+#include "descriptorbuilder.h"
 
 #define SWITCH_PRO_ENDPOINT_SIZE 64
 
 #define SWITCH_PRO_VENDOR_ID     0x057E
 #define SWITCH_PRO_PRODUCT_ID    0x2009
 
-#ifndef LSB
-#define LSB(n) ((n) & 255)
-#endif
-#ifndef MSB
-#define MSB(n) (((n) >> 8) & 255)
-#endif
-
 // HAT report (4 bits)
 #define SWITCH_PRO_HAT_UP        0x00
 #define SWITCH_PRO_HAT_UPRIGHT   0x01
@@ -337,12 +331,13 @@ typedef struct
 	uint8_t ry;
 } SwitchProOutReport;
 
-static const uint8_t switch_pro_string_language[]     = { 0x09, 0x04 };
-static const uint8_t switch_pro_string_manufacturer[] = "Open Stick Community";
-static const uint8_t switch_pro_string_product[]      = "GP2040-CE (Pro Controller)";
-static const uint8_t switch_pro_string_version[]      = "000000000001";
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto switch_pro_string_language     = USBDescriptor::language(0x0009);
+static constexpr auto switch_pro_string_manufacturer = USBDescriptor::string("Open Stick Community");
+static constexpr auto switch_pro_string_product      = USBDescriptor::string("GP2040-CE (Pro Controller)");
+static constexpr auto switch_pro_string_version      = USBDescriptor::string("000000000001");
 
-static const uint8_t *switch_pro_string_descriptors[] __attribute__((unused)) =
+static const uint16_t *switch_pro_string_descriptors[] __attribute__((unused)) =
 {
 	switch_pro_string_language,
 	switch_pro_string_manufacturer,
@@ -350,178 +345,138 @@ static const uint8_t *switch_pro_string_descriptors[] __attribute__((unused)) =
 	switch_pro_string_version
 };
 
-static const uint8_t switch_pro_device_descriptor[] =
-{
-    0x12,        // bLength
-    0x01,        // bDescriptorType (Device)
-    0x00, 0x02,  // bcdUSB 2.00
-    0x00,        // bDeviceClass (Use class information in the Interface Descriptors)
-    0x00,        // bDeviceSubClass
-    0x00,        // bDeviceProtocol
-    0x40,        // bMaxPacketSize0 64
-    LSB(SWITCH_PRO_VENDOR_ID), MSB(SWITCH_PRO_VENDOR_ID),   // idVendor 0x057E
-    LSB(SWITCH_PRO_PRODUCT_ID), MSB(SWITCH_PRO_PRODUCT_ID), // idProduct 0x2009
-    0x10, 0x02,  // bcdDevice 4.10
-    0x01,        // iManufacturer (String Index)
-    0x02,        // iProduct (String Index)
-    0x03,        // iSerialNumber (String Index)
-    0x01,        // bNumConfigurations 1
-};
-
-static const uint8_t switch_pro_hid_descriptor[] =
-{
-    0x09,        // bLength
-    0x21,        // bDescriptorType (HID)
-    0x11, 0x01,  // bcdHID 1.11
-    0x00,        // bCountryCode
-    0x01,        // bNumDescriptors
-    0x22,        // bDescriptorType[0] (HID)
-    0xCB, 0x00,  // wDescriptorLength[0] 86
-};
-
-static const uint8_t switch_pro_configuration_descriptor[] =
-{
-    0x09,        // bLength
-    0x02,        // bDescriptorType (Configuration)
-    0x29, 0x00,  // wTotalLength 41
-    0x01,        // bNumInterfaces 1
+static constexpr auto switch_pro_device_descriptor = USBDescriptor::device(
+    0x0200,                 // bcdUSB 2.00
+    0x00,                   // bDeviceClass (Use class information in the Interface Descriptors)
+    0x00,                   // bDeviceSubClass
+    0x00,                   // bDeviceProtocol
+    0x40,                   // bMaxPacketSize0 64
+    SWITCH_PRO_VENDOR_ID,   // idVendor 0x057E
+    SWITCH_PRO_PRODUCT_ID,  // idProduct 0x2009
+    0x0210,                 // bcdDevice 2.10
+    0x01,                   // iManufacturer (String Index)
+    0x02,                   // iProduct (String Index)
+    0x03,                   // iSerialNumber (String Index)
+    0x01                    // bNumConfigurations 1
+);
+
+static constexpr auto switch_pro_report_descriptor = USBDescriptor::hidReport([] {
+	using namespace USBDescriptor::HIDItem;
+	return items(
+
+		usagePage(0x01),        // Usage Page (Generic Desktop Ctrls)
+		logicalMinimum(0),      // Logical Minimum (0)
+		usage(0x04),            // Usage (Joystick)
+		collection(0x01),       // Collection (Application)
+
+		reportID(0x30),         //   Report ID (48)
+		usagePage(0x01),        //   Usage Page (Generic Desktop Ctrls)
+		usagePage(0x09),        //   Usage Page (Button)
+		usageMinimum(0x01),     //   Usage Minimum (0x01)
+		usageMaximum(0x0A),     //   Usage Maximum (0x0A)
+		logicalMinimum(0),      //   Logical Minimum (0)
+		logicalMaximum(1),      //   Logical Maximum (1)
+		reportSize(1),          //   Report Size (1)
+		reportCount(10),        //   Report Count (10)
+		unitExponent(0),        //   Unit Exponent (0)
+		unit(0),                //   Unit (None)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usagePage(0x09),        //   Usage Page (Button)
+		usageMinimum(0x0B),     //   Usage Minimum (0x0B)
+		usageMaximum(0x0E),     //   Usage Maximum (0x0E)
+		logicalMinimum(0),      //   Logical Minimum (0)
+		logicalMaximum(1),      //   Logical Maximum (1)
+		reportSize(1),          //   Report Size (1)
+		reportCount(4),         //   Report Count (4)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		reportSize(1),          //   Report Size (1)
+		reportCount(2),         //   Report Count (2)
+		input(0x03),            //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usage(0x010001),        //   Usage (0x010001)
+		collection(0x00),       //   Collection (Physical)
+		usage(0x010030),        //     Usage (0x010030)
+		usage(0x010031),        //     Usage (0x010031)
+		usage(0x010032),        //     Usage (0x010032)
+		usage(0x010035),        //     Usage (0x010035)
+		logicalMinimum(0),      //     Logical Minimum (0)
+		logicalMaximum(65535),  //     Logical Maximum (65534)
+		reportSize(16),         //     Report Size (16)
+		reportCount(4),         //     Report Count (4)
+		input(0x02),            //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		endCollection(),        //   End Collection
+		usage(0x010039),        //   Usage (0x010039)
+		logicalMinimum(0),      //   Logical Minimum (0)
+		logicalMaximum(7),      //   Logical Maximum (7)
+		physicalMinimum(0),     //   Physical Minimum (0)
+		physicalMaximum(315),   //   Physical Maximum (315)
+		unit(0x14),             //   Unit (System: English Rotation, Length: Centimeter)
+		reportSize(4),          //   Report Size (4)
+		reportCount(1),         //   Report Count (1)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usagePage(0x09),        //   Usage Page (Button)
+		usageMinimum(0x0F),     //   Usage Minimum (0x0F)
+		usageMaximum(0x12),     //   Usage Maximum (0x12)
+		logicalMinimum(0),      //   Logical Minimum (0)
+		logicalMaximum(1),      //   Logical Maximum (1)
+		reportSize(1),          //   Report Size (1)
+		reportCount(4),         //   Report Count (4)
+		input(0x02),            //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		reportSize(8),          //   Report Size (8)
+		reportCount(52),        //   Report Count (52)
+		input(0x03),            //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+		usagePage(0xFF00),      //   Usage Page (Vendor Defined 0xFF00)
+
+		reportID(0x21),         //   Report ID (33)
+		usage(0x01),            //   Usage (0x01)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		input(0x03),            //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		reportID(0x81),         //   Report ID (129)
+		usage(0x02),            //   Usage (0x02)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		input(0x03),            //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
+
+		reportID(1),            //   Report ID (1)
+		usage(0x03),            //   Usage (0x03)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		output(0x83),           //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
+
+		reportID(0x10),         //   Report ID (16)
+		usage(0x04),            //   Usage (0x04)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		output(0x83),           //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
+
+		reportID(0x80),         //   Report ID (128)
+		usage(0x05),            //   Usage (0x05)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		output(0x83),           //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
+
+		reportID(0x82),         //   Report ID (130)
+		usage(0x06),            //   Usage (0x06)
+		reportSize(8),          //   Report Size (8)
+		reportCount(63),        //   Report Count (63)
+		output(0x83),           //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
+
+		endCollection()         // End Collection
+	);
+});
+static_assert(sizeof(switch_pro_report_descriptor) == 203, "unexpected Switch Pro report descriptor length");
+
+static constexpr auto switch_pro_hid_descriptor = USBDescriptor::hid(0x0111, 0x00, sizeof(switch_pro_report_descriptor));
+
+static constexpr auto switch_pro_configuration_descriptor = USBDescriptor::configuration(
     0x01,        // bConfigurationValue
     0x00,        // iConfiguration (String Index)
     0xA0,        // bmAttributes Remote Wakeup
     0xFA,        // bMaxPower 500mA
-
-    0x09,        // bLength
-    0x04,        // bDescriptorType (Interface)
-    0x00,        // bInterfaceNumber 0
-    0x00,        // bAlternateSetting
-    0x02,        // bNumEndpoints 2
-    0x03,        // bInterfaceClass
-    0x00,        // bInterfaceSubClass
-    0x00,        // bInterfaceProtocol
-    0x00,        // iInterface (String Index)
-
-    0x09,        // bLength
-    0x21,        // bDescriptorType (HID)
-    0x11, 0x01,  // bcdHID 1.11
-    0x00,        // bCountryCode
-    0x01,        // bNumDescriptors
-    0x22,        // bDescriptorType[0] (HID)
-    0xCB, 0x00,  // wDescriptorLength[0] 203
-
-    0x07,        // bLength
-    0x05,        // bDescriptorType (Endpoint)
-    0x81,        // bEndpointAddress (IN/D2H)
-    0x03,        // bmAttributes (Interrupt)
-    0x40, 0x00,  // wMaxPacketSize 64
-    0x08,        // bInterval 8 (unit depends on device speed)
-
-    0x07,        // bLength
-    0x05,        // bDescriptorType (Endpoint)
-    0x01,        // bEndpointAddress (OUT/H2D)
-    0x03,        // bmAttributes (Interrupt)
-    0x40, 0x00,  // wMaxPacketSize 64
-    0x08,        // bInterval 8 (unit depends on device speed)
-};
-
-static const uint8_t switch_pro_report_descriptor[] =
-{
-    0x05, 0x01,        // Usage Page (Generic Desktop Ctrls)
-    0x15, 0x00,        // Logical Minimum (0)
-    0x09, 0x04,        // Usage (Joystick)
-    0xA1, 0x01,        // Collection (Application)
-
-    0x85, 0x30,        //   Report ID (48)
-    0x05, 0x01,        //   Usage Page (Generic Desktop Ctrls)
-    0x05, 0x09,        //   Usage Page (Button)
-    0x19, 0x01,        //   Usage Minimum (0x01)
-    0x29, 0x0A,        //   Usage Maximum (0x0A)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x01,        //   Logical Maximum (1)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x0A,        //   Report Count (10)
-    0x55, 0x00,        //   Unit Exponent (0)
-    0x65, 0x00,        //   Unit (None)
-    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x05, 0x09,        //   Usage Page (Button)
-    0x19, 0x0B,        //   Usage Minimum (0x0B)
-    0x29, 0x0E,        //   Usage Maximum (0x0E)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x01,        //   Logical Maximum (1)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x04,        //   Report Count (4)
-    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x02,        //   Report Count (2)
-    0x81, 0x03,        //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x0B, 0x01, 0x00, 0x01, 0x00,  //   Usage (0x010001)
-    0xA1, 0x00,        //   Collection (Physical)
-    0x0B, 0x30, 0x00, 0x01, 0x00,  //     Usage (0x010030)
-    0x0B, 0x31, 0x00, 0x01, 0x00,  //     Usage (0x010031)
-    0x0B, 0x32, 0x00, 0x01, 0x00,  //     Usage (0x010032)
-    0x0B, 0x35, 0x00, 0x01, 0x00,  //     Usage (0x010035)
-    0x15, 0x00,        //     Logical Minimum (0)
-    0x27, 0xFF, 0xFF, 0x00, 0x00,  //     Logical Maximum (65534)
-    0x75, 0x10,        //     Report Size (16)
-    0x95, 0x04,        //     Report Count (4)
-    0x81, 0x02,        //     Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0xC0,              //   End Collection
-    0x0B, 0x39, 0x00, 0x01, 0x00,  //   Usage (0x010039)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x07,        //   Logical Maximum (7)
-    0x35, 0x00,        //   Physical Minimum (0)
-    0x46, 0x3B, 0x01,  //   Physical Maximum (315)
-    0x65, 0x14,        //   Unit (System: English Rotation, Length: Centimeter)
-    0x75, 0x04,        //   Report Size (4)
-    0x95, 0x01,        //   Report Count (1)
-    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x05, 0x09,        //   Usage Page (Button)
-    0x19, 0x0F,        //   Usage Minimum (0x0F)
-    0x29, 0x12,        //   Usage Maximum (0x12)
-    0x15, 0x00,        //   Logical Minimum (0)
-    0x25, 0x01,        //   Logical Maximum (1)
-    0x75, 0x01,        //   Report Size (1)
-    0x95, 0x04,        //   Report Count (4)
-    0x81, 0x02,        //   Input (Data,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x34,        //   Report Count (52)
-    0x81, 0x03,        //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-    0x06, 0x00, 0xFF,  //   Usage Page (Vendor Defined 0xFF00)
-
-    0x85, 0x21,        //   Report ID (33)
-    0x09, 0x01,        //   Usage (0x01)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x81, 0x03,        //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-    0x85, 0x81,        //   Report ID (-127)
-    0x09, 0x02,        //   Usage (0x02)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x81, 0x03,        //   Input (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position)
-
-    0x85, 0x01,        //   Report ID (1)
-    0x09, 0x03,        //   Usage (0x03)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x91, 0x83,        //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
-
-    0x85, 0x10,        //   Report ID (16)
-    0x09, 0x04,        //   Usage (0x04)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x91, 0x83,        //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
-
-    0x85, 0x80,        //   Report ID (-128)
-    0x09, 0x05,        //   Usage (0x05)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x91, 0x83,        //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
-
-    0x85, 0x82,        //   Report ID (-126)
-    0x09, 0x06,        //   Usage (0x06)
-    0x75, 0x08,        //   Report Size (8)
-    0x95, 0x3F,        //   Report Count (63)
-    0x91, 0x83,        //   Output (Const,Var,Abs,No Wrap,Linear,Preferred State,No Null Position,Volatile)
-
-    0xC0,              // End Collection
-};
+    USBDescriptor::interface(0, 0, 2, 0x03, 0x00, 0x00, 0x00), // HID, 2 endpoints
+    switch_pro_hid_descriptor,
+    USBDescriptor::endpoint(0x81, 0x03, 64, 8), // IN/D2H, interrupt, 8 ms
+    USBDescriptor::endpoint(0x01, 0x03, 64, 8)  // OUT/H2D, interrupt, 8 ms
+);
+static_assert(sizeof(switch_pro_configuration_descriptor) == 41, "unexpected Switch Pro configuration descriptor length");
@@ -6,13 +6,40 @@
 #ifndef _SWITCH_PRO_DRIVER_H_
 #define _SWITCH_PRO_DRIVER_H_
 
-#include <map>
+#include <stddef.h>
 #include <vector>
 #include "gpdriver.h"
 #include "drivers/switchpro/SwitchProDescriptors.h"
 
 #define SWITCH_PRO_KEEPALIVE_TIMER 5
 
+// subcommand replies waiting for the IN endpoint
+#define SWITCH_PRO_REPLY_QUEUE_SIZE 8
+
+// emulated SPI flash is served in 256 byte banks, anything not in a bank reads as erased (0xFF)
+// while the unprogrammed rest of a bank reads as 0x00, as the zero padded arrays it replaced did
+#define SWITCH_PRO_SPI_BANK_SIZE 0x100
+
+typedef struct {
+    uint8_t reportID;
+    uint8_t data[SWITCH_PRO_ENDPOINT_SIZE];
+} SwitchProReply;
+
+typedef struct {
+    uint32_t address;
+    uint8_t data[SWITCH_PRO_SPI_BANK_SIZE];
+} SwitchSPIFlashBank;
+
+// Builds a zero padded bank with the given contents at its start
+template <size_t N>
+constexpr SwitchSPIFlashBank switchSPIFlashBank(uint32_t address, const uint8_t (&contents)[N]) {
+    static_assert(N <= SWITCH_PRO_SPI_BANK_SIZE, "SPI flash bank contents too large");
+    SwitchSPIFlashBank bank{ address, { } };
+    for (size_t i = 0; i < N; i++)
+        bank.data[i] = contents[i];
+    return bank;
+}
+
 class SwitchProDriver : public GPDriver {
 public:
     virtual void initialize();
@@ -29,6 +56,7 @@ public:
     virtual const uint8_t * get_descriptor_device_qualifier_cb();
     virtual uint16_t GetJoystickMidValue();
     virtual USBListener * get_usb_auth_listener() { return nullptr; }
+    virtual void report_complete(uint8_t itf, uint8_t const *report, uint16_t len);
 private:
     uint8_t report[SWITCH_PRO_ENDPOINT_SIZE] = { };
     uint8_t last_report[SWITCH_PRO_ENDPOINT_SIZE] = { };
@@ -37,16 +65,13 @@ private:
     uint32_t last_report_timer;
     bool isReady = false;
     bool isInitialized = false;
-    bool isReportQueued = false;
     bool reportSent = false;
-    uint8_t queuedReportID = 0;
 
-    uint8_t handshakeCounter = 0;
+    SwitchProReply replyQueue[SWITCH_PRO_REPLY_QUEUE_SIZE];
+    uint8_t replyHead = 0;
+    uint8_t replyCount = 0;
 
-    std::map<uint32_t, const uint8_t*> spiFlashData = {
-        {0x6000, factoryConfigData},
-        {0x8000, userCalibrationData}
-    };
+    uint8_t handshakeCounter = 0;
 
     SwitchDeviceInfo deviceInfo;
     uint8_t playerID = 0;
@@ -54,15 +79,19 @@ private:
     bool isIMUEnabled = false;
     bool isVibrationEnabled = false;
 
-    void sendIdentify();
+    void sendIdentify(uint8_t* reply);
     void sendSubCommand(uint8_t subCommand);
 
     bool sendReport(uint8_t reportID, const void* reportData, uint16_t reportLength);
 
+    uint8_t* nextReply();
+    void pushReply(uint8_t reportID);
+    bool sendQueuedReply();
+
     void readSPIFlash(uint8_t* dest, uint32_t address, uint8_t size);
 
-    void handleConfigReport(uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength);
-    void handleFeatureReport(uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength);
+    bool handleConfigReport(uint8_t* reply, uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength);
+    bool handleFeatureReport(uint8_t* reply, uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength);
 
     //
     //void getConfigFromOffset(uint16_t configOffset, uint8_t* destData);
@@ -81,9 +110,8 @@ private:
     uint16_t rightCenX, rightCenY;
     uint16_t rightMaxX, rightMaxY;
 
-    // config data
-    SwitchFactoryConfig* factoryConfig = (SwitchFactoryConfig*)factoryConfigData;
-    const uint8_t factoryConfigData[0xEFF] = {
+    // config data, only used to build the SPI flash image below
+    static constexpr uint8_t factoryConfigData[] = {
         // serial number
         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
@@ -163,8 +191,7 @@ private:
         0xFF, 0xFF, 0xFF
     };
 
-    SwitchUserCalibration* userCalibration = (SwitchUserCalibration*)userCalibrationData;
-    const uint8_t userCalibrationData[0x3F] = {
+    static constexpr uint8_t userCalibrationData[] = {
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         
@@ -180,6 +207,18 @@ private:
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
     };
+
+    static_assert(sizeof(factoryConfigData) >= offsetof(SwitchFactoryConfig, stickParams2) + sizeof(SwitchFactoryConfig::stickParams2), "factory config is missing stick parameters");
+    static_assert(sizeof(userCalibrationData) >= offsetof(SwitchUserCalibration, rightCalibration) + sizeof(SwitchRightCalibration), "user calibration is missing stick calibration");
+
+    // SPI flash as the console reads it, built at compile time and kept in flash
+    static constexpr SwitchSPIFlashBank spiFlashImage[] = {
+        switchSPIFlashBank(0x6000, factoryConfigData),
+        switchSPIFlashBank(0x8000, userCalibrationData)
+    };
+
+    SwitchFactoryConfig* factoryConfig = (SwitchFactoryConfig*)spiFlashImage[0].data;
+    SwitchUserCalibration* userCalibration = (SwitchUserCalibration*)spiFlashImage[1].data;
 };
 
 #endif // _SWITCH_PRO_DRIVER_H_
\ No newline at end of file
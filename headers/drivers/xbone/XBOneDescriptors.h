@@ -9,6 +9,7 @@
 #include <pico/unique_id.h>
 #include <cstring>
 
+#include "descriptorbuilder.h"
 #include "drivers/shared/xgip_protocol.h"
 
 #define XBONE_ENDPOINT_SIZE 64
@@ -16,23 +17,27 @@
 // 0x80 = std. device
 //
 
-static const uint8_t xbone_string_language[]    = { 0x09, 0x04 };
-static const uint8_t xbone_string_manufacturer[] = "Open Stick Community";
-static const uint8_t xbone_string_product[]      = "GP2040-CE (Xbox One)";
-static const uint8_t xbone_string_version[]      = "1.0";
+#define XBONE_STRING_INDEX_SERIAL 3
+#define XBONE_STRING_INDEX_OS     0xEE
 
-static const uint8_t *xbone_string_descriptors[] __attribute__((unused)) =
+// Only the low byte of the language ID has ever been reported, keep it that way
+static constexpr auto xbone_string_language     = USBDescriptor::language(0x0009);
+static constexpr auto xbone_string_manufacturer = USBDescriptor::string("Open Stick Community");
+static constexpr auto xbone_string_product      = USBDescriptor::string("GP2040-CE (Xbox One)");
+static constexpr auto xbone_string_xsm3         = USBDescriptor::string("Xbox Security Method 3, Version 1.00, \xa9 2005 Microsoft Corporation. All rights reserved.");
+// Microsoft OS string descriptor (index 0xEE), the last character is the vendor request code 0x20
+static constexpr auto xbone_string_os           = USBDescriptor::string("MSFT100\x20");
+
+// The serial number (index 3) is generated from the Pico ID at runtime
+static const uint16_t *xbone_string_descriptors[] __attribute__((unused)) =
 {
 	xbone_string_language,
 	xbone_string_manufacturer,
 	xbone_string_product,
-	xbone_string_version
+	nullptr,
+	xbone_string_xsm3
 };
 
-static uint8_t uniqueSerial[] = "012345678ABCDEFGH";
-static const uint8_t xboxSecurityMethod[] = "Xbox Security Method 3, Version 1.00, \xa9 2005 Microsoft Corporation. All rights reserved.";
-static const uint8_t xboxOSDescriptor[] = "MSFT100\x20\x00";
-
 static const uint8_t XBOXONE_RUMBLE[] = {0x09, 0x00, 0x00, 0x09, 0x00, 0x0F, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x00, 0xFF};
 // power-on states and rumble-on with everything disabled
 static const uint8_t XBOXONE_POWER_ON[] = {0x06, 0x62, 0x45, 0xb8, 0x77, 0x26, 0x2c, 0x55,
@@ -42,24 +47,6 @@ static const uint8_t XBOXONE_RUMBLE_ON[] = {0x00, 0x0f, 0x00, 0x00, 0x00, 0x00,
 static const uint8_t XBOXONE_LED_ON[] = {0x00, 0x01, 0x14}; // 0x01 - LED on, 0x14 - Brightness
 
 
-static const uint8_t * xbone_get_string_descriptor(int index) {
-	if ( index == 3 ) {
-		// Generate a serial number from the pico's unique ID
-		pico_unique_board_id_t id;
-		pico_get_unique_board_id(&id);
-        for(int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++) {
-            uniqueSerial[i] = 'A' + (id.id[i]%26); // some alphanumeric from 'A' to 'Z'
-        }
-        return uniqueSerial;
-	} else if ( index == 4 ) { // security method used
-		return xboxSecurityMethod;
-	} else if ( index == 0xEE ) { // ONLY WINDOWS DOES THIS??
-		return xboxOSDescriptor;
-	}
-
-	return xbone_string_descriptors[index];
-}
-
 // MOVE THIS TO XBOX ONE DRIVER
 typedef enum
 {
@@ -128,8 +115,8 @@ typedef struct
     uint8_t brightness;
 } __attribute__((packed)) XboxOneLED_Data_t;
 
-static const uint8_t xbone_device_qualifier[] =
-{
+// Device qualifier (USB 2.0 spec, 9.6.2), no builder of its own
+static constexpr auto xbone_device_qualifier = USBDescriptor::raw(
     0x0A,         // bLength
     0x06,         // bDescriptorType (Qualifier Type)
     0x00, 0x02,   // bcdUSB 2.00
@@ -139,64 +126,30 @@ static const uint8_t xbone_device_qualifier[] =
     0x40,         // bMaxPacketSize0 64
     0x01,         // bNumConfigurations
     0x00          // bReserved
-};
-
-static const uint8_t xbone_device_descriptor[] =
-{
-    0x12,       // bLength
-	0x01,       // bDescriptorType (Device)
-	0x00, 0x02, // bcdUSB 2.00
-	0xFF,	      // bDeviceClass
-	0xFF,	      // bDeviceSubClass
-	0xFF,	      // bDeviceProtocol
-	0x40,	      // bMaxPacketSize0 64
-	0x6F, 0x0E, // idVendor 0x045E = Xbox One  0x0E6F = SuperPDP  0x0079 = MagicBootS
-	0xA4, 0x02, // idProduct 0x02A4 = SuperPDP Gamepad  0x02EA = Xbox One S  0x02D1 = Xbox One  0x2DD = Xbox One v2  0x1894 = MagicBootS
-	0x01, 0x01, // bcdDevice 1.01?
+);
+
+static constexpr auto xbone_device_descriptor = USBDescriptor::device(
+	0x0200,     // bcdUSB 2.00
+	0xFF,       // bDeviceClass
+	0xFF,       // bDeviceSubClass
+	0xFF,       // bDeviceProtocol
+	0x40,       // bMaxPacketSize0 64
+	0x0E6F,     // idVendor 0x045E = Xbox One  0x0E6F = SuperPDP  0x0079 = MagicBootS
+	0x02A4,     // idProduct 0x02A4 = SuperPDP Gamepad  0x02EA = Xbox One S  0x02D1 = Xbox One  0x2DD = Xbox One v2  0x1894 = MagicBootS
+	0x0101,     // bcdDevice 1.01?
 	0x01,       // iManufacturer (String Index)
 	0x02,       // iProduct (String Index)
 	0x03,       // iSerialNumber (String Index)
-	0x01,       // bNumConfigurations 1
-};
-
+	0x01        // bNumConfigurations 1
+);
 
-static const uint8_t xbone_configuration_descriptor[] =
-{
-	0x09,        // bLength
-	0x02,        // bDescriptorType (Configuration)
-	0x20, 0x00,  // wTotalLength 32
-	0x01,        // bNumInterfaces 1
+static constexpr auto xbone_configuration_descriptor = USBDescriptor::configuration(
 	0x01,        // bConfigurationValue
 	0x00,        // iConfiguration (String Index)
 	0xA0,        // bmAttributes (USB_CONFIG_ATTRIBUTE_RESERVED | USB_CONFIG_ATTRIBUTE_REMOTEWAKEUP)
 	0xFA,        // bMaxPower 500mA
-
-	0x09,        // bLength
-	0x04,        // bDescriptorType (Interface)
-	0x00,        // bInterfaceNumber 0
-	0x00,        // bAlternateSetting
-	0x02,        // bNumEndpoints 2
-	0xFF,        // bInterfaceClass
-	0x47,        // bInterfaceSubClass
-	0xD0,        // bInterfaceProtocol
-	0x00,        // iInterface (String Index)
-
-	0x07,        // bLength
-	0x05,        // bDescriptorType (Endpoint)
-	0x81,        // bEndpointAddress (IN/D2H)
-	0x03,        // bmAttributes (Interrupt)
-	0x40, 0x00,  // wMaxPacketSize 64
-	0x01,        // bInterval 1 (unit depends on device speed)
-
-	0x07,        // bLength
-	0x05,        // bDescriptorType (Endpoint)
-	0x02,        // bEndpointAddress (OUT/H2D)
-	0x03,        // bmAttributes (Interrupt)
-	0x40, 0x00,  // wMaxPacketSize 64
-	0x01,        // bInterval 1 (unit depends on device speed)
-};
-
-static uint8_t const * xbone_configuration_descriptor_cb(uint8_t index)
-{
-  return xbone_configuration_descriptor;
-}
+	USBDescriptor::interface(0, 0, 2, 0xFF, 0x47, 0xD0, 0x00), // vendor specific, 2 endpoints
+	USBDescriptor::endpoint(0x81, 0x03, 64, 1), // IN/D2H, interrupt, 1 ms
+	USBDescriptor::endpoint(0x02, 0x03, 64, 1)  // OUT/H2D, interrupt, 1 ms
+);
+static_assert(sizeof(xbone_configuration_descriptor) == 32, "unexpected Xbox One configuration descriptor length");
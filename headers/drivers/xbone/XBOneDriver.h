@@ -13,6 +13,7 @@
 
 class XBOneDriver : public GPDriver {
 public:
+    virtual ~XBOneDriver();
     virtual void initialize();
     virtual bool process(Gamepad * gamepad);
     virtual void initializeAux();
@@ -40,7 +41,7 @@ private:
     uint8_t keep_alive_sequence;
     uint8_t virtual_keycode_sequence;
     bool xb1_guide_pressed;
-    GPAuthDriver * authDriver;
+    GPAuthDriver * authDriver = nullptr;
     uint8_t xbone_led_mode;
 };
 
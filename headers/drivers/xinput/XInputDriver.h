@@ -16,6 +16,7 @@
 
 class XInputDriver : public GPDriver {
 public:
+    virtual ~XInputDriver() { delete xAuthDriver; }
     virtual void initialize();
     virtual bool process(Gamepad * gamepad);
     virtual void initializeAux();
@@ -34,7 +35,7 @@ public:
 private:
     uint8_t last_report[CFG_TUD_ENDPOINT0_SIZE] = { };
     XInputReport xinputReport;
-    XInputAuth * xAuthDriver;
+    XInputAuth * xAuthDriver = nullptr;
     uint8_t featureBuffer[XINPUT_OUT_SIZE];
     uint8_t tud_buffer[64];
     bool xAuthSent;
@@ -42,33 +43,33 @@ private:
     InputModeDeviceType deviceType;
     uint8_t configDescriptor[sizeof(xinput_configuration_descriptor)];
 
-    GamepadButtonMapping *buttonGas;
-    GamepadButtonMapping *buttonBrake;
-    GamepadButtonMapping *buttonSteerLeft;
-    GamepadButtonMapping *buttonSteerRight;
+    GamepadButtonMapping buttonGas{0};
+    GamepadButtonMapping buttonBrake{0};
+    GamepadButtonMapping buttonSteerLeft{0};
+    GamepadButtonMapping buttonSteerRight{0};
 
-    GamepadButtonMapping *buttonFretGreen;
-    GamepadButtonMapping *buttonFretRed;
-    GamepadButtonMapping *buttonFretYellow;
-    GamepadButtonMapping *buttonFretBlue;
-    GamepadButtonMapping *buttonFretOrange;
-    GamepadButtonMapping *buttonFretSoloGreen;
-    GamepadButtonMapping *buttonFretSoloRed;
-    GamepadButtonMapping *buttonFretSoloYellow;
-    GamepadButtonMapping *buttonFretSoloBlue;
-    GamepadButtonMapping *buttonFretSoloOrange;
-    GamepadButtonMapping *buttonWhammy;
-    GamepadButtonMapping *buttonTilt;
+    GamepadButtonMapping buttonFretGreen{0};
+    GamepadButtonMapping buttonFretRed{0};
+    GamepadButtonMapping buttonFretYellow{0};
+    GamepadButtonMapping buttonFretBlue{0};
+    GamepadButtonMapping buttonFretOrange{0};
+    GamepadButtonMapping buttonFretSoloGreen{0};
+    GamepadButtonMapping buttonFretSoloRed{0};
+    GamepadButtonMapping buttonFretSoloYellow{0};
+    GamepadButtonMapping buttonFretSoloBlue{0};
+    GamepadButtonMapping buttonFretSoloOrange{0};
+    GamepadButtonMapping buttonWhammy{0};
+    GamepadButtonMapping buttonTilt{0};
 
-    GamepadButtonMapping *buttonDrumPadRed;
-    GamepadButtonMapping *buttonDrumPadBlue;
-    GamepadButtonMapping *buttonDrumPadYellow;
-    GamepadButtonMapping *buttonDrumPadGreen;
-    GamepadButtonMapping *buttonCymbalYellow;
-    GamepadButtonMapping *buttonCymbalBlue;
-    GamepadButtonMapping *buttonCymbalGreen;
-    GamepadButtonMapping *buttonKickPedalLeft;
-    GamepadButtonMapping *buttonKickPedalRight;
+    GamepadButtonMapping buttonDrumPadRed{0};
+    GamepadButtonMapping buttonDrumPadBlue{0};
+    GamepadButtonMapping buttonDrumPadYellow{0};
+    GamepadButtonMapping buttonDrumPadGreen{0};
+    GamepadButtonMapping buttonCymbalYellow{0};
+    GamepadButtonMapping buttonCymbalBlue{0};
+    GamepadButtonMapping buttonCymbalGreen{0};
+    GamepadButtonMapping buttonKickPedalLeft{0};
+    GamepadButtonMapping buttonKickPedalRight{0};
 };
 
 #endif
@@ -14,6 +14,8 @@
 #include "GPEvent.h"
 #include "GPGamepadEvent.h"
 #include "GPEncoderEvent.h"
+#include "GPInputModeChangeEvent.h"
+#include "GPMacroRecordEvent.h"
 #include "GPMenuNavigateEvent.h"
 #include "GPProfileEvent.h"
 #include "GPRestartEvent.h"
@@ -27,7 +29,9 @@
 class EventManager {
     public:
         typedef std::function<void(GPEvent* event)> EventFunction;
-        typedef std::pair<GPEventType, std::vector<EventFunction>> EventEntry;
+        typedef uint32_t EventHandle;
+        typedef std::pair<EventHandle, EventFunction> EventHandler;
+        typedef std::pair<GPEventType, std::vector<EventHandler>> EventEntry;
 
         EventManager(EventManager const&) = delete;
         void operator=(EventManager const&)  = delete;
@@ -40,13 +44,16 @@ class EventManager {
         void init();
         void clearEventHandlers();
 
-        void registerEventHandler(GPEventType eventType, EventFunction handler);
-        void unregisterEventHandler(GPEventType eventType, EventFunction handler);
+        // the returned handle is what unregisterEventHandler() takes, anything
+        // that can be destroyed before the manager has to hand it back
+        EventHandle registerEventHandler(GPEventType eventType, EventFunction handler);
+        void unregisterEventHandler(GPEventType eventType, EventHandle handle);
         void triggerEvent(GPEvent* event);
     private:
         EventManager(){}
 
         std::vector<EventEntry> eventList;
+        EventHandle nextHandle = 1;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef _GPINPUTMODECHANGEEVENT_H_
+#define _GPINPUTMODECHANGEEVENT_H_
+
+class GPInputModeChangeEvent : public GPEvent {
+    public:
+        GPInputModeChangeEvent() {}
+        GPInputModeChangeEvent(InputMode mode) {
+            this->inputMode = mode;
+        }
+        virtual ~GPInputModeChangeEvent() {}
+
+        GPEventType eventType() { return this->_eventType; }
+
+        InputMode inputMode = INPUT_MODE_XINPUT;
+    private:
+        GPEventType _eventType = GP_EVENT_INPUT_MODE_CHANGE;
+};
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef _GPMACRORECORDEVENT_H_
+#define _GPMACRORECORDEVENT_H_
+
+class GPMacroRecordEvent : public GPEvent {
+    public:
+        GPMacroRecordEvent() {}
+        virtual ~GPMacroRecordEvent() {}
+
+        GPEventType eventType() { return this->_eventType; }
+    private:
+        GPEventType _eventType = GP_EVENT_MACRO_RECORD;
+};
+
+#endif
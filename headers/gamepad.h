@@ -18,6 +18,19 @@
 extern uint32_t getMillis();
 extern uint64_t getMicro();
 
+#define HOTKEY_COUNT 16
+
+// Hotkey entry compiled in Gamepad::setup()
+struct GamepadCompiledHotkey
+{
+	HotkeyEntry entry;
+	uint32_t leadButtonsMask;	// ordered hotkeys: held before the rest goes down
+	uint16_t leadAuxMask;
+	uint32_t holdDuration;		// ms
+	uint32_t releaseBefore;		// ms, 0 unless a longer hold shares the combination
+	uint32_t armedAt;			// ms, when the combination went down
+};
+
 struct GamepadButtonMapping
 {
 	GamepadButtonMapping(Mask_t bm) :
@@ -207,14 +220,26 @@ public:
 	};
 
 private:
+	void compileHotkeys();
 	void processHotkeyAction(GamepadHotkey action);
 
 	GamepadOptions & options;
 	DpadMode activeDpadMode;
 	bool map48WayModeToggle;
+	DpadFilter dpadFilter;
 	const HotkeyOptions & hotkeyOptions;
 
-	HotkeyEntry hotkeys[16];
+	GamepadCompiledHotkey hotkeys[HOTKEY_COUNT];
+	uint8_t hotkeyCount = 0;
+	uint16_t armedHotkeys = 0;		// bit per compiled hotkey whose combination is held
+	uint16_t releaseHotkeys = 0;	// bit per compiled hotkey that runs on release
+	uint16_t sharedHotkeys = 0;		// bit per compiled hotkey sharing its combination
+	uint32_t hotkeyButtonsMask = 0;	// anything a hotkey needs, see hotkey()
+	uint8_t hotkeyDpadMask = 0;
+	uint16_t hotkeyAuxMask = 0;
+	uint32_t lastHotkeyButtons = 0;	// state.buttons, dpadOriginal and aux of the previous hotkey()
+	uint8_t lastHotkeyDpad = 0;
+	uint16_t lastHotkeyAux = 0;
 	GamepadHotkey lastAction = HOTKEY_NONE;
 
 	absolute_time_t disableFocusModeTimeout = nil_time;
@@ -160,23 +160,37 @@ uint16_t dpadToAnalogY(uint8_t dpad);
 
 uint8_t getMaskFromDirection(DpadDirection direction);
 
-uint8_t updateDpad(uint8_t dpad, DpadDirection direction);
-
-/**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
- *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
- */
-uint8_t filterToFourWayMode(uint8_t dpad);
-
-/**
- * @brief Run SOCD cleaning against a D-pad value.
- *
- * @param mode The SOCD cleaning mode.
- * @param dpad The GamepadState.dpad value.
- * @return uint8_t The clean D-pad value.
- */
-uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad);
+//
+// SOCD cleaning and 4-way filtering for one D-pad source.
+//
+// Both keep history (the last direction on each axis, the order directions were pressed in),
+// so every source that cleans its own directions needs its own DpadFilter.
+//
+class DpadFilter {
+public:
+	void reset();
+
+	/**
+	 * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
+	 *
+	 * The most recent cardinal direction wins.
+	 *
+	 * @param dpad The GameState.dpad value.
+	 * @return uint8_t The new dpad value.
+	 */
+	uint8_t filterToFourWayMode(uint8_t dpad);
+
+	/**
+	 * @brief Run SOCD cleaning against a D-pad value.
+	 *
+	 * @param mode The SOCD cleaning mode.
+	 * @param dpad The GamepadState.dpad value.
+	 * @return uint8_t The clean D-pad value.
+	 */
+	uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad);
+private:
+	uint8_t socdState {0};		// last direction of each axis, up-down in bits 0-1, left-right in bits 2-3
+	uint8_t fourWayHeld {0};	// directions held during the previous filter
+	uint8_t fourWayCount {0};
+	uint8_t fourWayOrder[4] {};	// held direction masks, oldest press first
+};
@@ -80,6 +80,11 @@ private:
     bool rebootRequested = false;
     void handleSystemReboot(GPEvent* e);
 
+    bool checkInputModeSwitch();
+    bool inputModeSwitchRequested = false;
+    InputMode requestedInputMode = INPUT_MODE_XINPUT;
+    void handleInputModeChange(GPEvent* e);
+
     System::BootMode rebootMode = System::BootMode::DEFAULT;
 };
 
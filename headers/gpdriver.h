@@ -25,6 +25,7 @@ class Gamepad;
 //
 class GPDriver {
 public:
+    virtual ~GPDriver() {}
     virtual void initialize() = 0;
     virtual void initializeAux() = 0;
     virtual bool process(Gamepad * gamepad) = 0;
@@ -40,6 +41,8 @@ public:
     virtual uint16_t GetJoystickMidValue() = 0;
     const usbd_class_driver_t * get_class_driver() { return &class_driver; }
     virtual USBListener * get_usb_auth_listener() = 0;
+    // Invoked when an IN report has been delivered to the host
+    virtual void report_complete(uint8_t itf, uint8_t const *report, uint16_t len) {}
 protected:
     usbd_class_driver_t class_driver;
 };
@@ -39,4 +39,18 @@ static inline bool isValidPin(int32_t pin) {
     int32_t numBank0GPIOS = NUM_BANK0_GPIOS;
     return pin >= 0 && pin < numBank0GPIOS; }
 
+// Lets a bit of mask follow raw once it last changed more than delay ms ago, 1 = pressed
+static inline uint32_t debounceMask(uint32_t debounced, uint32_t raw, uint32_t mask, uint32_t * changeTime, uint32_t delay, uint32_t now) {
+    uint32_t changed = (debounced ^ raw) & mask;
+    while (changed) {
+        uint8_t bit = __builtin_ctz(changed);
+        changed &= changed - 1;
+        if ((now - changeTime[bit]) > delay) {
+            debounced ^= (1UL << bit);
+            changeTime[bit] = now;
+        }
+    }
+    return debounced;
+}
+
 #endif
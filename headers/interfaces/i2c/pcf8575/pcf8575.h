@@ -35,7 +35,12 @@ class PCF8575 : public I2CDeviceBase {
         void send(uint16_t value);
         uint16_t receive();
 
+        // Queues a read of all pins, pins() has it once receivePending() is false
+        bool requestReceive();
+        bool receivePending();
+
         uint16_t pins() { return dataReceived; }
+        uint16_t pinsSent() { return dataSent; }
 
         void setPin(uint8_t pinNumber, uint8_t value);
         bool getPin(uint8_t pinNumber);
@@ -45,6 +50,10 @@ class PCF8575 : public I2CDeviceBase {
 
         uint16_t dataSent = 0;
         uint16_t dataReceived = initialValue;
+
+        I2CTransaction readTransaction;
+        uint8_t readBuffer[2];
+        bool readQueued = false;
     protected:
         PeripheralI2C* i2c = nullptr;
         uint8_t address = 0;
@@ -97,6 +97,29 @@ class GPGFX_TinySSD1306 : public GPGFX_DisplayBase {
         uint8_t frameBuffer[MAX_SCREEN_SIZE];
         uint8_t framePage = 0;
 
+        // Frames go out in the background in short chunks, so input reads get the bus in between
+        static const uint16_t FRAME_CHUNK_SIZE = 32;
+        static const uint16_t FRAME_STAGE_SIZE = 1120;
+        static const uint8_t FRAME_MAX_TRANSACTIONS = 48;
+
+        // A frame is staged whole. The 132x64 panel is the largest: every page is a 3 byte command
+        // and a 130 byte row, each chunk with its own control byte (48 transactions, 1112 bytes)
+        static const uint16_t FRAME_PAGES = MAX_SCREEN_HEIGHT / 8;
+        static const uint16_t FRAME_ROW_132 = MAX_SCREEN_WIDTH + 2;
+        static const uint16_t FRAME_ROW_CHUNKS_132 = (FRAME_ROW_132 + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE;
+        static const uint16_t FRAME_CHUNKS_128 = (MAX_SCREEN_SIZE + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE;
+        static_assert(FRAME_MAX_TRANSACTIONS >= FRAME_PAGES * (1 + FRAME_ROW_CHUNKS_132), "132x64 frame needs more transactions");
+        static_assert(FRAME_STAGE_SIZE >= FRAME_PAGES * ((1 + 3) + FRAME_ROW_CHUNKS_132 + FRAME_ROW_132), "132x64 frame needs a larger stage");
+        static_assert(FRAME_MAX_TRANSACTIONS >= 1 + FRAME_CHUNKS_128, "128x64 frame needs more transactions");
+        static_assert(FRAME_STAGE_SIZE >= (1 + 6) + FRAME_CHUNKS_128 + MAX_SCREEN_SIZE, "128x64 frame needs a larger stage");
+
+        uint8_t frameStage[FRAME_STAGE_SIZE];
+        uint16_t frameStageUsed = 0;
+        I2CTransaction frameTransactions[FRAME_MAX_TRANSACTIONS];
+        uint8_t frameTransactionCount = 0;
+
+        void stageFrameData(const uint8_t* data, uint16_t length, uint8_t control);
+
         uint8_t screenType;
         bool _isSPI = false;
         bool _isI2C = true;
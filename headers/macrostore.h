@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _MACROSTORE_H_
+#define _MACROSTORE_H_
+
+#include <stdint.h>
+
+#include "FlashPROM.h"
+#include "config.pb.h"
+
+// One flash sector right below the config
+#define MACRO_STORE_SIZE_BYTES          0x1000
+#define MACRO_STORE_ADDRESS_START       (EEPROM_ADDRESS_START - MACRO_STORE_SIZE_BYTES)
+#define MACRO_STORE_MAGIC               0x4D414331 // 'MAC1'
+
+// Macros stay tied to the six macro GPIO actions, steps are shared between them
+#define MACRO_STORE_MAX_MACROS          6
+#define MACRO_STORE_MAX_MACRO_INPUTS    128
+#define MACRO_STORE_MAX_INPUTS          256
+
+typedef struct {
+    uint32_t buttonMask;
+    uint32_t duration;          // us
+    uint32_t waitDuration;      // us
+} MacroStoreInput;
+
+typedef struct {
+    uint8_t macroType;
+    uint8_t enabled;
+    uint8_t useMacroTriggerButton;
+    uint8_t exclusive;
+    uint8_t interruptible;
+    uint8_t showFrames;         // durations are whole 60 Hz game frames
+    uint16_t inputCount;
+    uint32_t macroTriggerButton;
+    char macroLabel[sizeof(Macro::macroLabel)];
+} MacroStoreMacro;
+
+// Inputs of macro n follow the inputs of macro n - 1
+typedef struct {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t crc;               // everything after the header
+    uint32_t inputCount;
+    MacroStoreMacro macros[MACRO_STORE_MAX_MACROS];
+    MacroStoreInput inputs[MACRO_STORE_MAX_INPUTS];
+} MacroStoreData;
+
+static_assert(sizeof(MacroStoreData) <= MACRO_STORE_SIZE_BYTES, "Macro store does not fit its flash sector");
+
+//
+// Macro steps kept in their own flash sector, outside of the protobuf config
+//
+// MacroOptions in the config is limited to 30 inputs per macro. Web config writes the
+// macros here as well, where one macro can use up to MACRO_STORE_MAX_MACRO_INPUTS steps,
+// and keeps the first 30 inputs of each in MacroOptions for backups and older firmware.
+// Input Macro prefers the store whenever it holds a valid image.
+//
+class MacroStore {
+public:
+    MacroStore(MacroStore const&) = delete;
+    void operator=(MacroStore const&)  = delete;
+    static MacroStore& getInstance() {
+        static MacroStore instance;
+        return instance;
+    }
+
+    const MacroStoreData * get() const;     // nullptr unless flash holds a valid image
+
+    MacroStoreData & create();              // write cache, empty
+    MacroStoreData & edit(const MacroOptions & options); // write cache, latest image or the macros in options
+    bool commit();                          // false if the firmware has grown into the store
+    void reset();
+private:
+    MacroStore() {}
+    void importOptions(MacroStoreData & data, const MacroOptions & options);
+    MacroStoreData & beginEdit();
+
+    bool cacheValid = false;                // the write cache holds the latest image
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _SPSCQUEUE_H_
+#define _SPSCQUEUE_H_
+
+#include <atomic>
+#include <stdint.h>
+
+//
+// Lock-free single producer, single consumer ring buffer
+//
+// One core pushes and the other pops, neither side ever waits for the other.
+// The indices run freely and are masked on access, so all Size slots are usable.
+// Size must be a power of two.
+//
+template <typename T, uint32_t Size>
+class SPSCQueue {
+    static_assert(Size > 0 && (Size & (Size - 1)) == 0, "SPSCQueue size must be a power of two");
+public:
+    // Producer side, returns false if the queue is full
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == Size)
+            return false;
+        items[h & (Size - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, returns false if the queue is empty
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+        item = items[t & (Size - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+private:
+    T items[Size];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+};
+
+#endif
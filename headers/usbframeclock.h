@@ -0,0 +1,38 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _USBFRAMECLOCK_H_
+#define _USBFRAMECLOCK_H_
+
+#include <stdint.h>
+
+#include "hardware/structs/usb.h"
+
+//
+// Running count of USB frames (1 ms at full speed) seen by the device controller
+//
+// The controller only latches the 11 bit frame number of the last SOF, update() extends
+// it and has to be called at least once every two seconds. The count stands still while
+// no host is sending SOFs.
+//
+class USBFrameClock {
+public:
+    void reset() {
+        lastFrameNumber = usb_hw->sof_rd & USB_SOF_RD_BITS;
+        frameCount = 0;
+    }
+
+    uint32_t update() {
+        uint16_t frameNumber = usb_hw->sof_rd & USB_SOF_RD_BITS;
+        frameCount += (uint16_t)(frameNumber - lastFrameNumber) & USB_SOF_RD_BITS;
+        lastFrameNumber = frameNumber;
+        return frameCount;
+    }
+private:
+    uint16_t lastFrameNumber = 0;
+    uint32_t frameCount = 0;
+};
+
+#endif
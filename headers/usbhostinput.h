@@ -0,0 +1,70 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _USBHOSTINPUT_H_
+#define _USBHOSTINPUT_H_
+
+#include <stdint.h>
+
+#include "spscqueue.h"
+
+// Inputs a device can publish before core0 drains them, core0 drains every loop
+#define USB_HOST_INPUT_QUEUE_SIZE 8
+
+typedef enum {
+    USB_HOST_INPUT_CONNECTED = (1 << 0),
+    USB_HOST_INPUT_ANALOG    = (1 << 1), // sticks and triggers are real analog values
+    USB_HOST_INPUT_MOUSE     = (1 << 2), // mouseX/Y/Z carry movement
+} USBHostInputFlags;
+
+// Parsed input of one host device, listeners fill it on core1
+struct USBHostInput {
+    uint32_t buttons;
+    uint16_t lx;
+    uint16_t ly;
+    uint16_t rx;
+    uint16_t ry;
+    uint8_t dpad;
+    uint8_t lt;
+    uint8_t rt;
+    uint8_t flags;
+    int16_t mouseX; // movement since the previous input
+    int16_t mouseY;
+    int16_t mouseZ;
+    uint8_t devAddr;
+    uint32_t timestamp; // us, arrival of the report this input was parsed from
+};
+
+//
+// Per-device hand-off between the USB host stack on core1 and the input loop on core0.
+//
+// Core1 publishes a new input whenever a report changes it, core0 collects once per
+// loop and keeps the latest. Buttons held in any input collected together are kept
+// for that loop so a tap shorter than a core0 loop is not lost, mouse movement is summed.
+//
+class USBHostInputSlot {
+public:
+    USBHostInputSlot();
+
+    // Core1
+    void publish(const USBHostInput& input);
+    void flush();                   // retry an input the queue had no room for
+
+    // Core0
+    bool collect();                 // true if the device published anything since the last collect
+    bool connected() const { return (latest.flags & USB_HOST_INPUT_CONNECTED) != 0; }
+    const USBHostInput& input() const { return latest; }
+private:
+    SPSCQueue<USBHostInput, USB_HOST_INPUT_QUEUE_SIZE> queue;
+    USBHostInput pending;
+    bool hasPending;
+    USBHostInput newest;            // last input popped
+    USBHostInput latest;            // newest plus anything held since the previous collect, stamped with the oldest arrival
+};
+
+// Picks whichever axis value is further from the center, so several devices can share the sticks
+uint16_t mergeUSBHostAxis(uint16_t current, uint16_t value, uint16_t center);
+
+#endif
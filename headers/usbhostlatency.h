@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _USBHOSTLATENCY_H_
+#define _USBHOSTLATENCY_H_
+
+#include <stdint.h>
+
+#include "tusb_option.h"
+
+// Every address TinyUSB can hand out, a hub takes one of its own
+#define USB_HOST_LATENCY_MAX_DEVICES    (CFG_TUH_DEVICE_MAX + CFG_TUH_HUB)
+#define USB_HOST_LATENCY_BINS           16
+// A host input that has not changed the outgoing report by then never will
+#define USB_HOST_LATENCY_STALE_US       100000
+#define USB_HOST_LATENCY_MAGIC          0x4C415431 // 'LAT1'
+
+// bin n counts samples of [2^(n-1), 2^n) us, last bin is open ended
+typedef struct {
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+    uint32_t bins[USB_HOST_LATENCY_BINS];
+} USBHostLatencyHistogram;
+
+typedef struct {
+    uint16_t vid;
+    uint16_t pid;
+    uint32_t lastReportUs;
+    USBHostLatencyHistogram pollInterval;   // between reports from the device, on any interface
+    USBHostLatencyHistogram decode;         // listeners parsing one report on the host core
+    USBHostLatencyHistogram passthrough;    // report arrival to the outgoing gamepad report that carries it
+    uint32_t unchanged;                     // inputs that never changed the outgoing report
+} USBHostLatencyDevice;
+
+//
+// Passthrough latency of USB host devices
+//
+// The USB host manager stamps every report when it arrives on core1 and times the
+// listeners decoding it. The stamp rides along with the parsed input to core0, and
+// once the input driver has sent a report the age of every input it carries is
+// recorded per device.
+//
+// Web config needs a reboot, so the histograms live in RAM that survives a watchdog
+// reboot: booting into web config shows the previous gamepad session, frozen.
+//
+class USBHostLatency {
+public:
+    USBHostLatency(USBHostLatency const&) = delete;
+    void operator=(USBHostLatency const&)  = delete;
+    static USBHostLatency& getInstance() {
+        static USBHostLatency instance;
+        return instance;
+    }
+
+    void init(bool configMode);             // before the USB host is requested
+
+    // Core1
+    void mount(uint8_t dev_addr);
+    uint32_t beginReport(uint8_t dev_addr);
+    void endReport(uint8_t dev_addr, uint32_t arrivalUs);
+    uint32_t reportTimestamp() const;       // arrival of the report being decoded, now outside of one
+
+    // Core0
+    void markInput(uint8_t dev_addr, uint32_t arrivalUs);
+    void reportProcessed(bool sent);
+
+    bool isPreviousSession() const { return !enabled; }
+    const USBHostLatencyDevice * getDevice(uint8_t dev_addr) const;
+private:
+    USBHostLatency() {}
+    static void record(USBHostLatencyHistogram & histogram, uint32_t us);
+
+    bool enabled = false;
+    bool inReport = false;
+    uint32_t currentReportUs = 0;
+
+    // Core0 only
+    uint32_t pendingMask = 0;
+    uint32_t pendingUs[USB_HOST_LATENCY_MAX_DEVICES] = {};
+};
+
+#endif
@@ -20,10 +20,11 @@ public:
 		static USBHostManager instance; // Guaranteed to be destroyed. // Instantiated on first use.
 		return instance;
 	}
-    void start();               // Start USB Host
+    void start();               // Request USB Host, the host stack itself is brought up on Core1
     void shutdown();            // Called on system reboot
     void pushListener(USBListener *); // If anything needs to update in the gpconfig driver
-    void process();
+    void removeListener(USBListener *); // Input driver is being swapped out at runtime
+    void process();             // Core1: runs the host stack and the listeners' parsing
     void hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
     void hid_umount_cb(uint8_t daddr, uint8_t instance);
     void hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len);
@@ -35,13 +36,12 @@ public:
     void xinput_report_sent_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len);
     
 private:
-    USBHostManager() : tuh_ready(false), core0Ready(false), core1Ready(false) {}
+    USBHostManager() : tuh_requested(false), tuh_ready(false) {}
     std::vector<USBListener*> listeners;
     usb_device_t *usb_device = nullptr;
     uint8_t dataPin = 0;
-    bool tuh_ready;
-    bool core0Ready;
-    bool core1Ready;
+    volatile bool tuh_requested;
+    volatile bool tuh_ready;
 };
 
 #endif
\ No newline at end of file
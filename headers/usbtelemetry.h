@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _USBTELEMETRY_H_
+#define _USBTELEMETRY_H_
+
+#include <stdint.h>
+
+#include "enums.pb.h"
+#include "tusb.h"
+#include "device/usbd_pvt.h"
+
+#include "addonmanager.h"
+#include "gamepad/GamepadState.h"
+
+// Build with GP2040_USB_TELEMETRY=1 to add the telemetry interface
+#ifndef USB_TELEMETRY_ENABLED
+#define USB_TELEMETRY_ENABLED 0
+#endif
+
+// Vendor interface appended to the gamepad configuration, the host finds it by subclass/protocol
+#define USB_TELEMETRY_SUBCLASS          0x47 // 'G'
+#define USB_TELEMETRY_PROTOCOL          0x54 // 'T'
+#define USB_TELEMETRY_ENDPOINT          0x8E // bulk IN, clear of every gamepad driver's endpoints
+#define USB_TELEMETRY_PACKET_SIZE       64
+
+#define USB_TELEMETRY_BUFFER_SIZE       2048 // must be a power of two
+#define USB_TELEMETRY_PERIOD_MS         100
+#define USB_TELEMETRY_NAMES_PERIODS     20   // add-on names are repeated every N periods for late readers
+#define USB_TELEMETRY_TRACE_BATCH       8
+#define USB_TELEMETRY_HISTOGRAM_BINS    16
+#define USB_TELEMETRY_MAX_CONFIG_SIZE   512
+
+//
+// Stream format, all values little endian.
+// Every frame is a USBTelemetryFrameHeader followed by `length` bytes of payload.
+// Frames are packed back to back into 64 byte bulk packets and may span packets.
+//
+#define USB_TELEMETRY_FRAME_MAGIC       0xA5
+
+typedef enum {
+    USB_TELEMETRY_FRAME_LOOP        = 0x01, // USBTelemetryLoopFrame
+    USB_TELEMETRY_FRAME_INPUT       = 0x02, // USBTelemetryInputEntry[]
+    USB_TELEMETRY_FRAME_ADDONS      = 0x03, // USBTelemetryAddonEntry[]
+    USB_TELEMETRY_FRAME_ADDON_NAMES = 0x04, // { uint8_t index, uint8_t length, char name[length] }[]
+} USBTelemetryFrameType;
+
+typedef struct __attribute((packed, aligned(1))) {
+    uint8_t magic;
+    uint8_t type;
+    uint16_t length;
+} USBTelemetryFrameHeader;
+
+// Core0 loop timing since the previous loop frame
+typedef struct __attribute((packed, aligned(1))) {
+    uint32_t timestamp;     // us since boot
+    uint32_t loops;
+    uint32_t maxLoopUs;
+    uint32_t dropped;       // frames lost because the host was not reading fast enough
+    uint16_t bins[USB_TELEMETRY_HISTOGRAM_BINS]; // bin n counts loops of [2^(n-1), 2^n) us, last bin is open ended
+} USBTelemetryLoopFrame;
+
+// Processed input, one entry per change
+typedef struct __attribute((packed, aligned(1))) {
+    uint32_t timestamp;     // us since boot
+    uint32_t buttons;
+    uint16_t aux;
+    uint8_t dpad;
+    uint8_t reserved;
+} USBTelemetryInputEntry;
+
+// Core0 add-on counters, running totals so a lost frame only costs resolution
+typedef struct __attribute((packed, aligned(1))) {
+    uint8_t index;
+    uint8_t reserved[3];
+    uint32_t calls;
+    uint32_t busyUs;
+} USBTelemetryAddonEntry;
+
+class USBTelemetry {
+public:
+    USBTelemetry(USBTelemetry const&) = delete;
+    void operator=(USBTelemetry const&)  = delete;
+    static USBTelemetry& getInstance() {
+        static USBTelemetry instance;
+        return instance;
+    }
+
+    static bool supportsInputMode(InputMode mode);
+    const usbd_class_driver_t * getClassDriver() { return &classDriver; }
+    const uint8_t * getConfigurationDescriptor(const uint8_t * descriptor);
+
+    void recordLoop(uint32_t loopUs);
+    void recordInput(const GamepadState& state);
+    void process(const AddonManager& addons);
+
+    // TinyUSB class driver hooks
+    void reset();
+    void open(uint8_t rhport, uint8_t endpoint);
+    bool owns(uint8_t endpoint) { return endpoint != 0 && endpoint == endpointIn; }
+    void flush();
+private:
+    USBTelemetry();
+    bool writeFrame(uint8_t type, const void * payload, uint16_t length);
+    void writeLoopFrame();
+    void writeInputFrame();
+    void writeAddonFrames(const AddonManager& addons, bool withNames);
+
+    usbd_class_driver_t classDriver;
+    uint8_t rhport = 0;
+    uint8_t endpointIn = 0;
+
+    uint8_t buffer[USB_TELEMETRY_BUFFER_SIZE];
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    uint32_t dropped = 0;
+
+    USBTelemetryLoopFrame loopFrame;
+    USBTelemetryInputEntry trace[USB_TELEMETRY_TRACE_BATCH];
+    uint8_t traceCount = 0;
+    GamepadState lastState;
+    uint8_t addonPayload[USB_TELEMETRY_BUFFER_SIZE / 4]; // too big for the stack
+
+    uint32_t lastPeriod = 0;
+    uint8_t periodsUntilNames = 0;
+
+    uint8_t configDescriptor[USB_TELEMETRY_MAX_CONFIG_SIZE];
+};
+
+#endif
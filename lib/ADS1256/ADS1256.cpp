@@ -13,6 +13,8 @@ Special thanks to Abraão Queiroz for spending time on the code and suggesting c
 #include "ADS1256.h"
 #include <cstdio>
 #include <math.h>
+#include <string.h>
+#include "hardware/irq.h"
 #include "hardware/sync.h"
 #include "pico.h"
 #include "pico/stdlib.h"
@@ -730,3 +732,159 @@ uint32_t ADS1256::cycleDifferential() {
 
     return _outputValue;
 }
+
+/**************************************
+ * Background acquisition
+ **************************************/
+
+#define ACQ_IDLE    0 // waiting for DRDY
+#define ACQ_COMMAND 1 // MUX, SYNC, WAKEUP, RDATA going out
+#define ACQ_WAIT    2 // t6
+#define ACQ_DATA    3 // 24 bits coming in
+
+static ADS1256 * acquisitionInstance = nullptr;
+
+static const uint8_t singleEndedInputs[ADS1256_CHANNEL_COUNT] = {
+    ADS1256_SING_0, ADS1256_SING_1, ADS1256_SING_2, ADS1256_SING_3,
+    ADS1256_SING_4, ADS1256_SING_5, ADS1256_SING_6, ADS1256_SING_7
+};
+
+static const uint8_t dataClocks[3] = {0, 0, 0};
+
+bool ADS1256::startAcquisition(uint8_t channelCount) {
+    if (acquisitionInstance != nullptr || _DRDY_pin < 0 || channelCount == 0 || channelCount > ADS1256_CHANNEL_COUNT)
+        return false;
+
+    _dmaTxChannel = dma_claim_unused_channel(false);
+    _dmaRxChannel = dma_claim_unused_channel(false);
+    if (_dmaTxChannel < 0 || _dmaRxChannel < 0) {
+        if (_dmaTxChannel >= 0) dma_channel_unclaim(_dmaTxChannel);
+        if (_dmaRxChannel >= 0) dma_channel_unclaim(_dmaRxChannel);
+        return false;
+    }
+
+    spi_inst_t * spi = _SPI->getController();
+
+    dma_channel_config txConfig = dma_channel_get_default_config(_dmaTxChannel);
+    channel_config_set_transfer_data_size(&txConfig, DMA_SIZE_8);
+    channel_config_set_dreq(&txConfig, spi_get_dreq(spi, true));
+    channel_config_set_write_increment(&txConfig, false);
+    dma_channel_configure(_dmaTxChannel, &txConfig, &spi_get_hw(spi)->dr, _acqCommand, 0, false);
+
+    dma_channel_config rxConfig = dma_channel_get_default_config(_dmaRxChannel);
+    channel_config_set_transfer_data_size(&rxConfig, DMA_SIZE_8);
+    channel_config_set_dreq(&rxConfig, spi_get_dreq(spi, false));
+    channel_config_set_read_increment(&rxConfig, false);
+    dma_channel_configure(_dmaRxChannel, &rxConfig, _acqReply, &spi_get_hw(spi)->dr, 0, false);
+
+    // RX finishing means every byte has been clocked
+    dma_channel_set_irq1_enabled(_dmaRxChannel, true);
+
+    acquisitionInstance = this;
+    irq_add_shared_handler(DMA_IRQ_1, dmaIRQ, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    _acqChannelCount = channelCount;
+    _acqChannel = 0;
+    _acqSets = 0;
+    _acqPhase = ACQ_IDLE;
+
+    // Restart conversions on the first input, DRDY then signals its result
+    _SPI->beginTransaction(_SPISpeed, _SPIBitOrder, _SPIMode);
+    waitForDRDY();
+    _SPI->select(_CS_pin);
+    _SPI->transfer(ADS1256_CMD_WREG | ADS1256_REG_MUX);
+    _SPI->transfer(0x00);
+    _SPI->transfer(singleEndedInputs[0]);
+    _SPI->transfer(ADS1256_CMD_SYNC);
+    _SPI->transfer(ADS1256_CMD_WAKEUP);
+    _SPI->deselect();
+    _isAcquisitionRunning = false;
+
+    gpio_add_raw_irq_handler(_DRDY_pin, drdyIRQ);
+    gpio_set_irq_enabled(_DRDY_pin, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    return true;
+}
+
+bool ADS1256::readLatest(int32_t * values) {
+    uint32_t sets;
+    do {
+        sets = _acqSets;
+        if (sets == 0)
+            return false;
+        memcpy(values, _acqRing[(sets - 1) % ADS1256_ACQUISITION_SETS], _acqChannelCount * sizeof(int32_t));
+        // the set being written is the only one that changes, unless the ring went all the way round
+    } while ((_acqSets - sets) >= (ADS1256_ACQUISITION_SETS - 1));
+
+    return true;
+}
+
+void ADS1256::drdyIRQ() {
+    ADS1256 * ads = acquisitionInstance;
+    if (!(gpio_get_irq_event_mask(ads->_DRDY_pin) & GPIO_IRQ_EDGE_FALL))
+        return;
+    gpio_acknowledge_irq(ads->_DRDY_pin, GPIO_IRQ_EDGE_FALL);
+
+    if (ads->_acqPhase != ACQ_IDLE)
+        return;
+
+    // Step 1. move the MUX on, Step 2. restart the conversion there, Step 3. ask for the finished one
+    uint8_t next = (ads->_acqChannel + 1) % ads->_acqChannelCount;
+    ads->_acqCommand[0] = ADS1256_CMD_WREG | ADS1256_REG_MUX;
+    ads->_acqCommand[1] = 0x00;
+    ads->_acqCommand[2] = singleEndedInputs[next];
+    ads->_acqCommand[3] = ADS1256_CMD_SYNC;
+    ads->_acqCommand[4] = ADS1256_CMD_WAKEUP;
+    ads->_acqCommand[5] = ADS1256_CMD_RDATA;
+
+    ads->_acqPhase = ACQ_COMMAND;
+    ads->_SPI->select(ads->_CS_pin);
+    ads->startTransfer(ads->_acqCommand, ads->_acqReply, 6);
+}
+
+void ADS1256::dmaIRQ() {
+    ADS1256 * ads = acquisitionInstance;
+    if (!dma_irqn_get_channel_status(1, ads->_dmaRxChannel))
+        return;
+    dma_irqn_acknowledge_channel(1, ads->_dmaRxChannel);
+
+    if (ads->_acqPhase == ACQ_COMMAND) {
+        ads->_acqPhase = ACQ_WAIT;
+        add_alarm_in_us(ADS1256_T6_US, dataAlarm, nullptr, true);
+    } else if (ads->_acqPhase == ACQ_DATA) {
+        ads->completeSample();
+    }
+}
+
+int64_t ADS1256::dataAlarm(alarm_id_t id, void * user_data) {
+    ADS1256 * ads = acquisitionInstance;
+    ads->_acqPhase = ACQ_DATA;
+    ads->startTransfer(dataClocks, ads->_acqReply, 3);
+    return 0;
+}
+
+void ADS1256::startTransfer(const uint8_t * tx, uint8_t * rx, uint8_t count) {
+    dma_channel_set_read_addr(_dmaTxChannel, tx, false);
+    dma_channel_set_trans_count(_dmaTxChannel, count, false);
+    dma_channel_set_write_addr(_dmaRxChannel, rx, false);
+    dma_channel_set_trans_count(_dmaRxChannel, count, false);
+    dma_start_channel_mask((1u << _dmaTxChannel) | (1u << _dmaRxChannel));
+}
+
+void ADS1256::completeSample() {
+    _SPI->deselect();
+
+    // 24 bit two's complement, sign extended
+    int32_t value = (int32_t)(((uint32_t)_acqReply[0] << 24) | ((uint32_t)_acqReply[1] << 16) | ((uint32_t)_acqReply[2] << 8)) >> 8;
+
+    uint32_t sets = _acqSets;
+    _acqRing[sets % ADS1256_ACQUISITION_SETS][_acqChannel] = value;
+
+    _acqChannel = (_acqChannel + 1) % _acqChannelCount;
+    if (_acqChannel == 0)
+        _acqSets = sets + 1;
+
+    _acqPhase = ACQ_IDLE;
+}
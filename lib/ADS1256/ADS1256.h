@@ -14,12 +14,16 @@
 #define _ADS1256_h
 
 #include "peripheral_spi.h"
+#include "pico/time.h"
 
 #define ADS1256_MAX_3V 3.3f
 #define ADS1256_MAX_5V 5.0f
 #define ADS1256_VREF_VOLTAGE 2.5f
 #define ADS1256_CHANNEL_COUNT 8
 
+#define ADS1256_ACQUISITION_SETS 4 // complete channel sets kept by the background acquisition
+#define ADS1256_T6_US 7            // RDATA to the first data clock, t6 is 50 tCLKIN (6.51us)
+
 #ifndef ADS1256_DEBUG
 #define ADS1256_DEBUG false
 #endif
@@ -192,9 +196,32 @@ public:
     // Stop AD
     void stopConversion();
 
+    // Background acquisition of the first channelCount single-ended inputs: DRDY interrupts
+    // start each SPI DMA read, the MUX moves on to the next input as the previous one is read
+    bool startAcquisition(uint8_t channelCount);
+
+    // Copies the latest complete set of sign extended raw codes, false until there is one
+    bool readLatest(int32_t * values);
+
 private:
     void waitForDRDY();
 
+    static void drdyIRQ();
+    static void dmaIRQ();
+    static int64_t dataAlarm(alarm_id_t id, void * user_data);
+    void startTransfer(const uint8_t * tx, uint8_t * rx, uint8_t count);
+    void completeSample();
+
+    int _dmaTxChannel = -1;
+    int _dmaRxChannel = -1;
+    uint8_t _acqChannelCount = 0;
+    uint8_t _acqChannel = 0;        // input of the conversion DRDY signals next
+    volatile uint8_t _acqPhase = 0;
+    uint8_t _acqCommand[6];
+    uint8_t _acqReply[6];
+    int32_t _acqRing[ADS1256_ACQUISITION_SETS][ADS1256_CHANNEL_COUNT];
+    volatile uint32_t _acqSets = 0; // complete sets written to the ring
+
     PeripheralSPI *_SPI;
 
     float _VREF; // Value of the reference voltage
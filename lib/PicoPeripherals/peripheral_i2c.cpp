@@ -1,6 +1,12 @@
 #include <cstdio>
 #include "peripheral_i2c.h"
 
+#include <hardware/dma.h>
+#include <hardware/irq.h>
+#include "pico/time.h"
+
+PeripheralI2C *PeripheralI2C::_instances[NUM_I2CS] = {};
+
 PeripheralI2C::PeripheralI2C() {
 #ifdef PICO_DEFAULT_I2C_INSTANCE
 
@@ -40,14 +46,274 @@ void PeripheralI2C::setup() {
     gpio_pull_up(_SDA);
     gpio_pull_up(_SCL);
 
+    if (_lock == nullptr) {
+        _lock = spin_lock_instance(spin_lock_claim_unused(true));
+    }
+
+    // queued transactions run on DMA, without free channels they run blocking from submit()
+    if (_dmaTx < 0) {
+        _dmaTx = dma_claim_unused_channel(false);
+        _dmaRx = dma_claim_unused_channel(false);
+        if ((_dmaTx < 0) || (_dmaRx < 0)) {
+            if (_dmaTx >= 0) dma_channel_unclaim(_dmaTx);
+            if (_dmaRx >= 0) dma_channel_unclaim(_dmaRx);
+            _dmaTx = -1;
+            _dmaRx = -1;
+        }
+    }
+
+    if (_dmaTx >= 0) {
+        i2c_hw_t *hw = i2c_get_hw(_I2C);
+        uint8_t index = i2c_hw_index(_I2C);
+
+        dma_channel_config txConfig = dma_channel_get_default_config(_dmaTx);
+        channel_config_set_transfer_data_size(&txConfig, DMA_SIZE_16);
+        channel_config_set_read_increment(&txConfig, true);
+        channel_config_set_write_increment(&txConfig, false);
+        channel_config_set_dreq(&txConfig, i2c_get_dreq(_I2C, true));
+        dma_channel_configure(_dmaTx, &txConfig, &hw->data_cmd, _words, 0, false);
+
+        dma_channel_config rxConfig = dma_channel_get_default_config(_dmaRx);
+        channel_config_set_transfer_data_size(&rxConfig, DMA_SIZE_8);
+        channel_config_set_read_increment(&rxConfig, false);
+        channel_config_set_write_increment(&rxConfig, true);
+        channel_config_set_dreq(&rxConfig, i2c_get_dreq(_I2C, false));
+        dma_channel_configure(_dmaRx, &rxConfig, nullptr, &hw->data_cmd, 0, false);
+
+        hw->intr_mask = 0;
+        _instances[index] = this;
+        irq_set_exclusive_handler(I2C0_IRQ + index, (index == 0) ? irqHandler0 : irqHandler1);
+        irq_set_enabled(I2C0_IRQ + index, true);
+    }
+
     // reset the bus before using it
     clear();
 }
 
+void PeripheralI2C::acquire() {
+    if (_lock == nullptr) return;
+
+    uint8_t core = get_core_num();
+    while (true) {
+        uint32_t save = spin_lock_blocking(_lock);
+        bool expired = _held && ((int32_t)(time_us_32() - _holdUntil) >= 0);
+        if ((_owner == OWNER_NONE) || (_owner == core) || (expired && (_owner != OWNER_ENGINE))) {
+            _owner = core;
+            _held = false;
+            _waiting &= ~(1 << core);
+            spin_unlock(_lock, save);
+            return;
+        }
+        _waiting |= (1 << core);
+        spin_unlock(_lock, save);
+        tight_loop_contents();
+    }
+}
+
+void PeripheralI2C::release(bool hold) {
+    if (_lock == nullptr) return;
+
+    uint32_t save = spin_lock_blocking(_lock);
+    if (hold) {
+        // keep the bus for the read that normally follows, but not forever
+        _held = true;
+        _holdUntil = time_us_32() + I2C_HOLD_TIMEOUT_US;
+    } else {
+        _held = false;
+        _owner = OWNER_NONE;
+        serviceLocked();
+    }
+    spin_unlock(_lock, save);
+}
+
+void PeripheralI2C::serviceLocked() {
+    if (_held && (_owner != OWNER_NONE) && (_owner != OWNER_ENGINE) && ((int32_t)(time_us_32() - _holdUntil) >= 0)) {
+        _held = false;
+        _owner = OWNER_NONE;
+    }
+    if ((_owner == OWNER_NONE) && (_waiting == 0)) {
+        startNextLocked();
+    }
+}
+
+void PeripheralI2C::startNextLocked() {
+    I2CTransaction *transaction = nullptr;
+    for (uint8_t priority = 0; priority < I2C_PRIORITY_COUNT; priority++) {
+        if (_queueHead[priority] != nullptr) {
+            transaction = _queueHead[priority];
+            _queueHead[priority] = transaction->next;
+            if (_queueHead[priority] == nullptr) _queueTail[priority] = nullptr;
+            break;
+        }
+    }
+    if (transaction == nullptr) return;
+
+    _owner = OWNER_ENGINE;
+    _active = transaction;
+    _aborted = false;
+    _wordPos = 0;
+    _wordCount = transaction->txLen + transaction->rxLen;
+
+    // a blocking write without a stop left the bus open, continue it like the SDK would
+    _restartFirst = _I2C->restart_on_next;
+    _I2C->restart_on_next = false;
+
+    i2c_hw_t *hw = i2c_get_hw(_I2C);
+    hw->enable = 0;
+    hw->tar = transaction->address;
+    hw->enable = 1;
+    hw->tx_tl = I2C_TX_REFILL_LEVEL;
+    hw->clr_intr;
+
+    if (transaction->rxLen > 0) {
+        dma_channel_transfer_to_buffer_now(_dmaRx, transaction->rx, transaction->rxLen);
+    }
+    feed();
+
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS |
+        ((_wordPos < _wordCount) ? I2C_IC_INTR_MASK_M_TX_EMPTY_BITS : 0);
+}
+
+void PeripheralI2C::feed() {
+    const I2CTransaction *transaction = _active;
+    uint32_t count = _wordCount - _wordPos;
+    if (count > I2C_DMA_WORDS) count = I2C_DMA_WORDS;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t pos = _wordPos + i;
+        uint16_t word;
+        if (pos < transaction->txLen) {
+            word = transaction->tx[pos];
+        } else {
+            word = I2C_IC_DATA_CMD_CMD_BITS;
+            if ((pos == transaction->txLen) && (pos > 0)) word |= I2C_IC_DATA_CMD_RESTART_BITS;
+        }
+        if ((pos == 0) && _restartFirst) word |= I2C_IC_DATA_CMD_RESTART_BITS;
+        if (pos == (_wordCount - 1)) word |= I2C_IC_DATA_CMD_STOP_BITS;
+        _words[i] = word;
+    }
+    _wordPos += count;
+    dma_channel_transfer_from_buffer_now(_dmaTx, _words, count);
+}
+
+void PeripheralI2C::irqHandler0() {
+    _instances[0]->handleIRQ();
+}
+
+void PeripheralI2C::irqHandler1() {
+    _instances[1]->handleIRQ();
+}
+
+void PeripheralI2C::handleIRQ() {
+    i2c_hw_t *hw = i2c_get_hw(_I2C);
+    uint32_t status = hw->intr_stat;
+
+    if (_active == nullptr) {
+        hw->intr_mask = 0;
+        return;
+    }
+
+    if (status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) {
+        // the controller flushes the FIFO and stops, finish on the stop
+        dma_channel_abort(_dmaTx);
+        dma_channel_abort(_dmaRx);
+        hw->clr_tx_abrt;
+        _aborted = true;
+        hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    }
+
+    if (status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        hw->clr_stop_det;
+        if (!_aborted) {
+            // the last bytes are already in the FIFO
+            while (dma_channel_is_busy(_dmaRx)) tight_loop_contents();
+        }
+        finish(_aborted ? PICO_ERROR_GENERIC : (int16_t)_wordCount);
+        return;
+    }
+
+    if ((status & I2C_IC_INTR_STAT_R_TX_EMPTY_BITS) && !dma_channel_is_busy(_dmaTx)) {
+        if (_wordPos < _wordCount) feed();
+        if (_wordPos >= _wordCount) hw->intr_mask &= ~I2C_IC_INTR_MASK_M_TX_EMPTY_BITS;
+    }
+}
+
+void PeripheralI2C::finish(int16_t result) {
+    i2c_get_hw(_I2C)->intr_mask = 0;
+
+    I2CTransaction *transaction = _active;
+    _active = nullptr;
+    transaction->result = result;
+    if (transaction->callback != nullptr) transaction->callback(transaction);
+    __dmb();
+    transaction->done = true;
+
+    uint32_t save = spin_lock_blocking(_lock);
+    _owner = OWNER_NONE;
+    serviceLocked();
+    spin_unlock(_lock, save);
+}
+
+int16_t PeripheralI2C::transfer(I2CTransaction *transaction) {
+    int16_t result = 0;
+    if (transaction->txLen > 0) {
+        result = i2c_write_blocking(_I2C, transaction->address, transaction->tx, transaction->txLen, (transaction->rxLen > 0));
+    }
+    if ((result >= 0) && (transaction->rxLen > 0)) {
+        result = i2c_read_blocking(_I2C, transaction->address, transaction->rx, transaction->rxLen, false);
+    }
+    return (result < 0) ? PICO_ERROR_GENERIC : (transaction->txLen + transaction->rxLen);
+}
+
+bool PeripheralI2C::submit(I2CTransaction *transaction) {
+    if ((_exclusiveAddress > -1) && (_exclusiveAddress != transaction->address)) return false;
+    if ((transaction->txLen + transaction->rxLen) == 0) return false;
+    if (transaction->priority >= I2C_PRIORITY_COUNT) return false;
+
+    transaction->next = nullptr;
+    transaction->done = false;
+
+    if (_dmaTx < 0) {
+        acquire();
+        transaction->result = transfer(transaction);
+        release(false);
+        if (transaction->callback != nullptr) transaction->callback(transaction);
+        transaction->done = true;
+        return true;
+    }
+
+    uint32_t save = spin_lock_blocking(_lock);
+    I2CPriority priority = transaction->priority;
+    if (_queueTail[priority] != nullptr) {
+        _queueTail[priority]->next = transaction;
+    } else {
+        _queueHead[priority] = transaction;
+    }
+    _queueTail[priority] = transaction;
+    serviceLocked();
+    spin_unlock(_lock, save);
+    return true;
+}
+
+int16_t PeripheralI2C::wait(I2CTransaction *transaction) {
+    while (!transaction->done) {
+        // picks the queue back up if a write without a stop was never followed up
+        if (_held) {
+            uint32_t save = spin_lock_blocking(_lock);
+            serviceLocked();
+            spin_unlock(_lock, save);
+        }
+        tight_loop_contents();
+    }
+    return transaction->result;
+}
+
 int16_t PeripheralI2C::read(uint8_t address, uint8_t *data, uint16_t len, bool isBlock) {
     if ((_exclusiveAddress > -1) && (_exclusiveAddress != address)) return -1;
 
+    acquire();
     int16_t result = i2c_read_blocking(_I2C, address, data, len, isBlock);
+    release(isBlock);
 #ifdef DEBUG_PERIPHERALI2C
     printf("PeripheralI2C::write %d:%d (blocking? %d)\n", address, len, isBlock);
     for (int i = 0; i < len; i++) {
@@ -63,10 +329,12 @@ int16_t PeripheralI2C::readRegister(uint8_t address, uint8_t reg, uint8_t *data,
     if ((_exclusiveAddress > -1) && (_exclusiveAddress != address)) return -1;
 
     int16_t registerCheck;
+    acquire();
     registerCheck = i2c_write_blocking(_I2C, address, &reg, 1, true);
     if (registerCheck >= 0) {
         registerCheck = i2c_read_blocking(_I2C, address, data, len, false);
     }
+    release(false);
     return (registerCheck >= 0);
 }
 
@@ -79,7 +347,9 @@ int16_t PeripheralI2C::write(uint8_t address, uint8_t *data, uint16_t len, bool
         printf("%02x ", data[i]);
     }
 #endif
+    acquire();
     int16_t result = i2c_write_blocking(_I2C, address, data, len, isBlock);
+    release(isBlock);
 #ifdef DEBUG_PERIPHERALI2C
     printf("\nResult: %d\n", result);
     printf("-----\n");
@@ -93,7 +363,9 @@ uint8_t PeripheralI2C::test(uint8_t address) {
     // TODO: Revert to i2c_read_blocking when we have I2C resolved
     // int16_t ret = i2c_read_blocking(_I2C, address, &data, 1, false);
     absolute_time_t test_timeout = make_timeout_time_ms(100);
+    acquire();
     int16_t ret = i2c_read_blocking_until(_I2C, address, &data, 1, false, test_timeout);
+    release(false);
     return (ret >= 0);
 }
 
@@ -105,6 +377,7 @@ void PeripheralI2C::clear() {
 std::map<uint8_t,bool> PeripheralI2C::scan() {
     std::map<uint8_t,bool> result;
 
+    acquire();
     for (uint8_t addr = 0; addr < (1 << 7); ++addr) {
         int8_t ret;
         uint8_t rxdata;
@@ -114,6 +387,7 @@ std::map<uint8_t,bool> PeripheralI2C::scan() {
             result.insert({addr,(ret >= 0)});
         }
     }
+    release(false);
 
 #ifdef DEBUG_PERIPHERALI2C
     printf("%d\n", result.size());
@@ -5,6 +5,7 @@
 #include <hardware/gpio.h>
 #include <hardware/i2c.h>
 #include <hardware/platform_defs.h>
+#include <hardware/sync.h>
 
 #if __has_include("BoardConfig.h")
 #include "BoardConfig.h"
@@ -44,6 +45,40 @@
 #define I2C1_SPEED 400000
 #endif
 
+// Command words the DMA engine queues at a time, longer transactions are refilled from the I2C interrupt
+#define I2C_DMA_WORDS 64
+// Refill once the TX FIFO has drained to this level
+#define I2C_TX_REFILL_LEVEL 4
+// How long a write without a stop keeps the bus for the core that issued it
+#define I2C_HOLD_TIMEOUT_US 2000
+
+typedef enum {
+    I2C_PRIORITY_INPUT = 0,     // add-on reads, always next on the bus
+    I2C_PRIORITY_DISPLAY,       // frame updates, split into chunks so input can go in between
+    I2C_PRIORITY_COUNT
+} I2CPriority;
+
+struct I2CTransaction;
+typedef void (*I2CCallback)(I2CTransaction* transaction);
+
+// Writes tx, then reads rx after a repeated start, then stops. Either part may be empty.
+// The buffers belong to the bus until done is set.
+struct I2CTransaction {
+    uint8_t address = 0;
+    const uint8_t *tx = nullptr;
+    uint16_t txLen = 0;
+    uint8_t *rx = nullptr;
+    uint16_t rxLen = 0;
+    I2CPriority priority = I2C_PRIORITY_INPUT;
+    I2CCallback callback = nullptr;     // from the I2C interrupt, before done is set
+    void *context = nullptr;
+
+    volatile int16_t result = 0;        // bytes transferred, or PICO_ERROR_GENERIC
+    volatile bool done = true;
+
+    I2CTransaction *next = nullptr;
+};
+
 class PeripheralI2C {
 public:
     PeripheralI2C();
@@ -60,6 +95,11 @@ public:
 
     int16_t write(uint8_t address, uint8_t *data, uint16_t len, bool isBlock=true);
 
+    // Queues a transaction and returns straight away, safe from either core
+    bool submit(I2CTransaction *transaction);
+    int16_t wait(I2CTransaction *transaction);
+    bool isAsync() { return _dmaTx >= 0; }  // false when submit() runs transactions blocking
+
     uint8_t test(uint8_t address);
     void clear();
 
@@ -80,6 +120,42 @@ private:
     int8_t _exclusiveAddress = -1;
 
     void setup();
+
+    //
+    // The bus belongs to one core at a time for blocking calls, or to the DMA engine.
+    // Blocking calls go first, queued transactions run whenever nobody is waiting.
+    //
+    enum { OWNER_NONE = -1, OWNER_ENGINE = NUM_CORES };
+
+    spin_lock_t *_lock = nullptr;
+    volatile int8_t _owner = OWNER_NONE;
+    volatile uint8_t _waiting = 0;          // cores waiting in acquire()
+    volatile bool _held = false;            // the owner wrote without a stop
+    volatile uint32_t _holdUntil = 0;
+
+    I2CTransaction *_queueHead[I2C_PRIORITY_COUNT] = {};
+    I2CTransaction *_queueTail[I2C_PRIORITY_COUNT] = {};
+    I2CTransaction *_active = nullptr;
+    volatile bool _aborted = false;
+    bool _restartFirst = false;
+    int _dmaTx = -1;
+    int _dmaRx = -1;
+    uint16_t _words[I2C_DMA_WORDS];
+    uint32_t _wordPos = 0;
+    uint32_t _wordCount = 0;
+
+    static PeripheralI2C *_instances[NUM_I2CS];
+    static void irqHandler0();
+    static void irqHandler1();
+
+    void acquire();
+    void release(bool hold);
+    void serviceLocked();
+    void startNextLocked();
+    int16_t transfer(I2CTransaction *transaction);
+    void feed();
+    void handleIRQ();
+    void finish(int16_t result);
 };
 
 #endif
@@ -31,6 +31,7 @@
 #else
     #include <cstring>
     #include <cstdio>
+    #include "SNESpad.pio.h"
 #endif
 
 SNESpad::SNESpad(int clock, int latch, int data) {
@@ -39,12 +40,23 @@ SNESpad::SNESpad(int clock, int latch, int data) {
     dataPin = data;
 }
 
+#ifdef ARDUINO
 void SNESpad::begin() {
     init();
 #if SNES_PAD_DEBUG==true
     printf("SNESpad::begin\n");
 #endif
 }
+#else
+void SNESpad::begin(PIO block) {
+    init();
+    if (block != nullptr)
+        startPIO(block);
+#if SNES_PAD_DEBUG==true
+    printf("SNESpad::begin %s\n", usingPIO() ? "pio" : "gpio");
+#endif
+}
+#endif
 
 void SNESpad::start() {
 #if SNES_PAD_DEBUG==true
@@ -129,23 +141,21 @@ void SNESpad::poll() {
 
                     break;
                 case SNES_PAD_MOUSE:
-                    int x = 127;  //set center position [0-255]
-                    int y = 127;
-
-                    // Mouse X axis
-                    x = (state & SNES_MOUSE_X) >> 25;
-                    x = reverse(x) * SNES_MOUSE_PRECISION;
-                    if (state & SNES_MOUSE_X_SIGN) x = 127 - x;
-                    else x = 127 + x;
-
-                    // Mouse Y axis
-                    y = (state & SNES_MOUSE_Y) >> 17;
-                    y = reverse(y) * SNES_MOUSE_PRECISION;
-                    if (state & SNES_MOUSE_Y_SIGN) y = 127 - y;
-                    else y = 127 + y;
-
-                    mouseX  = x;
-                    mouseY  = y;
+                    int x = mouseAxis(state, SNES_MOUSE_X, 25, SNES_MOUSE_X_SIGN);
+                    int y = mouseAxis(state, SNES_MOUSE_Y, 17, SNES_MOUSE_Y_SIGN);
+
+#ifndef ARDUINO
+                    // every frame read since the last poll moved the mouse
+                    if (usingPIO()) {
+                        x = pioMouseX;
+                        y = pioMouseY;
+                        pioMouseX = 0;
+                        pioMouseY = 0;
+                    }
+#endif
+
+                    mouseX  = 127 + x; //center position [0-255]
+                    mouseY  = 127 + y;
                     buttonB = (state & SNES_X);
                     buttonA = (state & SNES_A);
 
@@ -271,6 +281,11 @@ uint32_t SNESpad::read()
     uint32_t ret = 0;
     uint8_t i;
 
+#ifndef ARDUINO
+    if (usingPIO())
+        return readPIO();
+#endif
+
     /* A connected device will pull the data line low prior to latch.
        A disconnected pin is kept high by internal pull_up.*/
     uint32_t disconnected = false;
@@ -297,6 +312,12 @@ uint32_t SNESpad::read()
     }
     ret = ~ret; // buttons are active low, so invert bits
 
+    return identify(ret, disconnected);
+}
+
+// sets the device type from an inverted frame, 0 if nothing is connected
+uint32_t SNESpad::identify(uint32_t ret, bool disconnected)
+{
     // verify controller or mouse is connected
     if (disconnected && !(ret & 0xFFFF)) {
         type = SNES_PAD_NONE;
@@ -339,6 +360,82 @@ uint32_t SNESpad::read()
     return ret;
 }
 
+#ifndef ARDUINO
+bool SNESpad::startPIO(PIO block)
+{
+    if (!pio_can_add_program(block, &snespad_program))
+        return false;
+
+    int sm = pio_claim_unused_sm(block, false);
+    if (sm < 0)
+        return false;
+
+    uint offset = pio_add_program(block, &snespad_program);
+    snespad_program_init(block, sm, offset, clockPin, latchPin, dataPin);
+    pio = block;
+    pioSM = sm;
+
+    // wait for the first frame so buttons held at boot are seen by the first poll
+    absolute_time_t timeout = make_timeout_time_us(SNES_PIO_START_US);
+    while (pio_sm_get_rx_fifo_level(pio, pioSM) < 2 && !time_reached(timeout))
+        tight_loop_contents();
+
+    return true;
+}
+
+// identifies every frame the state machine has read since the last call, keeps the latest
+uint32_t SNESpad::readPIO()
+{
+    bool fresh = false;
+
+    while (pio_sm_get_rx_fifo_level(pio, pioSM) >= 2) {
+        bool disconnected = pio_sm_get(pio, pioSM) != 0;
+        uint32_t ret = pio_sm_get(pio, pioSM);
+
+        // pads only send 16 bits, read them like the bit-banged path does
+        if (ret & 0x8000)
+            ret |= 0xFFFF0000;
+
+        pioState = identify(~ret, disconnected);
+        if (type == SNES_PAD_MOUSE) {
+            pioMouseX += mouseAxis(pioState, SNES_MOUSE_X, 25, SNES_MOUSE_X_SIGN);
+            pioMouseY += mouseAxis(pioState, SNES_MOUSE_Y, 17, SNES_MOUSE_Y_SIGN);
+        }
+        if (pioSpeedWait > 0)
+            pioSpeedWait--;
+        fresh = true;
+    }
+
+    if (!fresh)
+        return pioState;
+
+    if (pioMouseX > SNES_MOUSE_MAX_DELTA) pioMouseX = SNES_MOUSE_MAX_DELTA;
+    if (pioMouseX < -SNES_MOUSE_MAX_DELTA) pioMouseX = -SNES_MOUSE_MAX_DELTA;
+    if (pioMouseY > SNES_MOUSE_MAX_DELTA) pioMouseY = SNES_MOUSE_MAX_DELTA;
+    if (pioMouseY < -SNES_MOUSE_MAX_DELTA) pioMouseY = -SNES_MOUSE_MAX_DELTA;
+
+    // the state machine pulses the speed on its next latch, the frame it was
+    // reading by then still has the old speed so wait for the one after
+    if (type == SNES_PAD_MOUSE
+        && mouseSpeed != SNES_MOUSE_FAST
+        && mouseSpeedFails < SNES_MOUSE_THRESHOLD
+        && pioSpeedWait == 0
+    ) {
+        pio_sm_put(pio, pioSM, 1);
+        pioSpeedWait = 2;
+    }
+
+    return pioState;
+}
+#endif
+
+// signed movement of one mouse axis
+int SNESpad::mouseAxis(uint32_t state, uint32_t mask, uint8_t shift, uint32_t sign)
+{
+    int value = reverse((state & mask) >> shift) * SNES_MOUSE_PRECISION;
+    return (state & sign) ? -value : value;
+}
+
 // reverse bits within a byte (ex: 0b1000 -> 0b0001)
 uint8_t SNESpad::reverse(uint8_t c) {
     char r = 0;
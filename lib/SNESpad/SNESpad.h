@@ -34,6 +34,7 @@
 #else
     // If we aren't compiling on Arduino, include the Pico SDK standard library
     #include "pico/stdlib.h"
+    #include "hardware/pio.h"
 #endif
 
 #define SNES_PAD_NONE   -1
@@ -69,6 +70,9 @@
 
 #define SNES_MOUSE_THRESHOLD 10  // max speed fails (Hyperkin compatiblity)
 #define SNES_MOUSE_PRECISION 1   // mouse movement velocity multiplier
+#define SNES_MOUSE_MAX_DELTA 254 // largest movement a single read can report
+
+#define SNES_PIO_START_US    5000 // wait for the first PIO frame in begin()
 
 #ifndef SNES_PAD_DEBUG
 #define SNES_PAD_DEBUG false
@@ -101,7 +105,12 @@ class SNESpad {
     SNESpad(int clock, int latch, int data);
 
     // Methods
+#ifdef ARDUINO
     void begin();
+#else
+    void begin(PIO pio = nullptr); // reads with a state machine on pio if one is free, bit-bangs otherwise
+    bool usingPIO() const { return pioSM >= 0; }
+#endif
     void start();
     void poll();
   private:
@@ -113,11 +122,25 @@ class SNESpad {
     uint8_t mouseSpeedFails = 0;
     uint32_t _lastRead;
 
+#ifndef ARDUINO
+    PIO pio = nullptr;
+    int pioSM = -1;
+    uint32_t pioState = 0;     // latest frame identified from the FIFO
+    int32_t pioMouseX = 0;     // movement summed over the frames since the last poll
+    int32_t pioMouseY = 0;
+    uint8_t pioSpeedWait = 0;  // frames until a speed pulse shows up
+
+    bool startPIO(PIO block);
+    uint32_t readPIO();
+#endif
+
     void init();
     void speed();
     void latch();
     uint32_t read();
+    uint32_t identify(uint32_t ret, bool disconnected);
     uint32_t clock();
+    int mouseAxis(uint32_t state, uint32_t mask, uint8_t shift, uint32_t sign);
     uint8_t reverse(uint8_t c);
 };
 
@@ -207,64 +207,47 @@ void WiiExtension::start() {
     }
 }
 
-void WiiExtension::poll() {
-    uint8_t regWrite[16];
-    uint8_t regRead[16];
-    int8_t result;
+bool WiiExtension::poll() {
+    uint8_t regRead[WII_EXTENSION_FRAME_SIZE];
+    int result;
 
 #if WII_EXTENSION_DEBUG==true
     //printf("WiiExtension::poll\n");
     //printf("WiiExtension::poll isReady? %1d\n", isReady);
 #endif
 
-    if (!isReady) return;
+    if (!isReady) return false;
 
     if (extensionType != WII_EXTENSION_NONE) {
-        switch (dataType) {
-            case WII_DATA_TYPE_1:
-                result = doI2CRead(regRead, 6);
-                break;
-            case WII_DATA_TYPE_2:
-                result = doI2CRead(regRead, 9);
-                break;
-            case WII_DATA_TYPE_3:
-                result = doI2CRead(regRead, 8);
-                break;
-            // Motion Plus data types
-            case WII_DATA_TYPE_4:
-            case WII_DATA_TYPE_5:
-            case WII_DATA_TYPE_6:
-            case WII_DATA_TYPE_7:
-                result = doI2CRead(regRead, 16);
-                break;
-            default:
-                // unknown. TBD
-                result = -1;
-#if WII_EXTENSION_DEBUG==true
-                printf("WiiExtension::poll Unknown data type: %1d\n", dataType);
-#endif
-                break;
+        if (i2c->isAsync()) {
+            if (pollStep == WII_POLL_STOPPED && !pollFailed) startPolling();
+            result = takeFrame(regRead);
+        } else {
+            result = readFrame(regRead);
         }
 
+        if (result == 0) return false;
+
         if (result > 0) {
-            extensionController->process(regRead);
-            if (!extensionController->skipPostProcess) extensionController->postProcess();
+            uint8_t frameLength = getFrameLength();
+
+            // most reports repeat the previous one, nothing to decode then
+            if (hasLastFrame && (memcmp(regRead, lastFrame, frameLength) == 0)) return false;
+            memcpy(lastFrame, regRead, frameLength);
+            hasLastFrame = true;
+
+            extensionController->update(regRead);
 
 #if WII_EXTENSION_DEBUG==true
-            for (int i = 0; i < result; ++i) {
+            for (int i = 0; i < frameLength; ++i) {
                 _lastRead[i] = regRead[i];
             }
 #endif
 
             if (extensionType == WII_EXTENSION_TURNTABLE) {
-                regWrite[0] = 0xFB;
-                regWrite[1] = ((TurntableExtension*)extensionController)->getLED();
-                result = doI2CWrite(regWrite, 2);
+                ledState = ((TurntableExtension*)extensionController)->getLED();
             }
-
-            // continue poll
-            regWrite[0] = 0x00;
-            result = doI2CWrite(regWrite, 1);
+            return true;
         } else {
             // device disconnected or invalid read
             extensionType = WII_EXTENSION_NONE;
@@ -275,10 +258,152 @@ void WiiExtension::poll() {
         reset();
         start();
     }
+    return false;
+}
+
+uint8_t WiiExtension::getFrameLength() {
+    switch (dataType) {
+        case WII_DATA_TYPE_1:
+            return 6;
+        case WII_DATA_TYPE_2:
+            return 9;
+        case WII_DATA_TYPE_3:
+            return 8;
+        // Motion Plus data types
+        case WII_DATA_TYPE_4:
+        case WII_DATA_TYPE_5:
+        case WII_DATA_TYPE_6:
+        case WII_DATA_TYPE_7:
+            return 16;
+        default:
+            // unknown. TBD
+#if WII_EXTENSION_DEBUG==true
+            printf("WiiExtension::poll Unknown data type: %1d\n", dataType);
+#endif
+            return 0;
+    }
+}
+
+int WiiExtension::readFrame(uint8_t *pData) {
+    uint8_t regWrite[2];
+    uint8_t frameLength = getFrameLength();
+    if (frameLength == 0) return -1;
+
+    int result = doI2CRead(pData, frameLength);
+    if (result > 0) {
+        if (extensionType == WII_EXTENSION_TURNTABLE) {
+            regWrite[0] = 0xFB;
+            regWrite[1] = ledState;
+            doI2CWrite(regWrite, 2);
+        }
+
+        // continue poll
+        regWrite[0] = 0x00;
+        doI2CWrite(regWrite, 1);
+    }
+    return (result > 0) ? result : -1;
+}
+
+int WiiExtension::takeFrame(uint8_t *pData) {
+    if (pollFailed) return -1;
+
+    uint32_t count;
+    do {
+        count = pollFrameCount;
+        if ((count == pollFrameTaken) || (count & 1)) return 0;
+        __compiler_memory_barrier();
+        memcpy(pData, pollFrame, WII_EXTENSION_FRAME_SIZE);
+        __compiler_memory_barrier();
+    } while (count != pollFrameCount);
+
+    pollFrameTaken = count;
+    return getFrameLength();
+}
+
+void WiiExtension::startPolling() {
+    if (getFrameLength() == 0) {
+        pollFailed = true;
+        return;
+    }
+
+    // start() finished by pointing at register 0x00
+    pollTransaction.address = address;
+    pollTransaction.priority = I2C_PRIORITY_INPUT;
+    pollTransaction.callback = pollDone;
+    pollTransaction.context = this;
+    ledSent = ledState;
+    pollStep = WII_POLL_POINTER;
+    nextPollStep();
+}
+
+void WiiExtension::nextPollStep() {
+    if (pollStep == WII_POLL_POINTER) {
+        pollStep = WII_POLL_READ;
+        pollTransaction.tx = nullptr;
+        pollTransaction.txLen = 0;
+        pollTransaction.rx = pollRead;
+        pollTransaction.rxLen = getFrameLength();
+    } else {
+        if ((pollStep == WII_POLL_READ) && (extensionType == WII_EXTENSION_TURNTABLE) && (ledState != ledSent)) {
+            pollStep = WII_POLL_LED;
+            ledSent = ledState;
+            pollWrite[0] = 0xFB;
+            pollWrite[1] = ledSent;
+            pollTransaction.txLen = 2;
+        } else {
+            pollStep = WII_POLL_POINTER;
+            pollWrite[0] = 0x00;
+            pollTransaction.txLen = 1;
+        }
+        pollTransaction.tx = pollWrite;
+        pollTransaction.rx = nullptr;
+        pollTransaction.rxLen = 0;
+    }
+
+    if (!i2c->submit(&pollTransaction)) {
+        pollStep = WII_POLL_STOPPED;
+        pollFailed = true;
+    }
+}
+
+void WiiExtension::pollDone(I2CTransaction *transaction) {
+    WiiExtension *extension = (WiiExtension*)transaction->context;
+
+    if (transaction->result < 0) {
+        extension->pollStep = WII_POLL_STOPPED;
+        extension->pollFailed = true;
+        return;
+    }
+
+    if (extension->pollStep == WII_POLL_READ) {
+        extension->pollFrameCount++;
+        __compiler_memory_barrier();
+        for (int i = 0; i < transaction->rxLen; ++i) {
+#if WII_EXTENSION_ENCRYPTION==true
+            extension->pollFrame[i] = WII_DECRYPT_BYTE(extension->pollRead[i]);
+#else
+            extension->pollFrame[i] = extension->pollRead[i];
+#endif
+        }
+        __compiler_memory_barrier();
+        extension->pollFrameCount++;
+    }
+
+    if (add_alarm_in_us(WII_EXTENSION_DELAY, pollAlarm, extension, true) < 0) {
+        extension->pollStep = WII_POLL_STOPPED;
+        extension->pollFailed = true;
+    }
+}
+
+int64_t WiiExtension::pollAlarm(alarm_id_t /*id*/, void *user_data) {
+    ((WiiExtension*)user_data)->nextPollStep();
+    return 0;
 }
 
 void WiiExtension::reset() {
     isReady = false;
+    pollFailed = false;
+    hasLastFrame = false;
 }
 
 int WiiExtension::doI2CWrite(uint8_t *pData, int iLen) {
@@ -42,6 +42,9 @@ typedef enum {
 #define WII_ANALOG_PRECISION_2      256
 #define WII_ANALOG_PRECISION_3      1024
 
+// analogState before process(), for the analogs an extension does not report
+#define WII_ANALOG_UNSET            0xFFFF
+
 #define WII_GUITAR_UNSET            0
 #define WII_GUITAR_GH3              1
 #define WII_GUITAR_GHWT             2
@@ -96,6 +99,9 @@ typedef enum {
 #define WII_ALARM_IRQ TIMER_IRQ_0
 #endif
 
+// Largest data report, Motion Plus formats
+#define WII_EXTENSION_FRAME_SIZE 16
+
 #define WII_CHECKSUM_MAGIC 0x55
 #define WII_CALIBRATION_SIZE 0x10
 #define WII_CALIBRATION_CHECKSUM_SIZE 0x02
@@ -134,7 +140,8 @@ class WiiExtension {
     void begin();
     void reset();
     void start();
-    void poll();
+    bool poll();        // true when a report that differs from the previous one was decoded
+    bool isAsync() { return i2c->isAsync(); }  // false when poll() reads the bus blocking
 
     void setI2C(PeripheralI2C *i2cController) { this->i2c = i2cController; }
     void setAddress(uint8_t addr) { this->address = addr; }
@@ -147,6 +154,41 @@ class WiiExtension {
     uint8_t _lastRead[16] = {0xFF};
 #endif
 
+    //
+    // With a DMA capable bus the extension is read in the background: read the report,
+    // point back at register 0x00, read again, with the usual delay after each transfer.
+    // Each step is started from the completion of the previous one, so poll() only
+    // picks up the newest report.
+    //
+    typedef enum {
+        WII_POLL_STOPPED,
+        WII_POLL_READ,
+        WII_POLL_LED,
+        WII_POLL_POINTER,
+    } WiiPollStep;
+
+    I2CTransaction pollTransaction;
+    uint8_t pollWrite[2];
+    uint8_t pollRead[WII_EXTENSION_FRAME_SIZE];
+    uint8_t pollFrame[WII_EXTENSION_FRAME_SIZE];
+    volatile WiiPollStep pollStep = WII_POLL_STOPPED;
+    volatile bool pollFailed = false;
+    volatile uint32_t pollFrameCount = 0;   // odd while pollFrame is being written
+    uint32_t pollFrameTaken = 0;
+    volatile uint8_t ledState = 0;
+    uint8_t ledSent = 0;
+
+    uint8_t lastFrame[WII_EXTENSION_FRAME_SIZE];
+    bool hasLastFrame = false;
+
+    uint8_t getFrameLength();
+    int readFrame(uint8_t *pData);
+    int takeFrame(uint8_t *pData);
+    void startPolling();
+    void nextPollStep();
+    static void pollDone(I2CTransaction *transaction);
+    static int64_t pollAlarm(alarm_id_t id, void *user_data);
+
     int doI2CWrite(uint8_t *pData, int iLen);
     int doI2CRead(uint8_t *pData, int iLen);
     uint8_t doI2CTest();
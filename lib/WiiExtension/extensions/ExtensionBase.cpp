@@ -17,6 +17,7 @@ void ExtensionBase::init(uint8_t dataType) {
     for (i = 0; i < WiiAnalogs::WII_MAX_ANALOGS; ++i) {
         analogState[i] = 0;
         initialAnalogState[i] = 0;
+        _analogUpdated[i] = false;
         _analogCalibration[i].minimum = 0;
         _analogCalibration[i].center = 0;
         _analogCalibration[i].maximum = 1;
@@ -64,7 +65,7 @@ void ExtensionBase::postProcess() {
 
     for (i = 0; i < WiiAnalogs::WII_MAX_ANALOGS; ++i) {
         // scale calibration values before using
-        if (i != WiiAnalogs::WII_ANALOG_CALIBRATION_PRECISION) {
+        if ((i != WiiAnalogs::WII_ANALOG_CALIBRATION_PRECISION) && _analogUpdated[i]) {
             outVal = applyCalibration(analogState[i], _analogCalibration[i].minimum, _analogCalibration[i].maximum, _analogCalibration[i].center);
 
             minVal = map(_analogCalibration[i].minimum, 0, _analogPrecision[WiiAnalogs::WII_ANALOG_CALIBRATION_PRECISION].origin-1, 0, _analogPrecision[WiiAnalogs::WII_ANALOG_CALIBRATION_PRECISION].destination-1);
@@ -105,6 +106,27 @@ void ExtensionBase::postProcess() {
 #endif
 }
 
+void ExtensionBase::update(uint8_t *inputData) {
+    uint16_t lastState[WiiAnalogs::WII_MAX_ANALOGS];
+    uint8_t i;
+
+    // postProcess() scales analogState in place, so only the analogs process() set this time
+    // get scaled. the others keep their last value instead of being scaled again on every report.
+    for (i = 0; i < WiiAnalogs::WII_MAX_ANALOGS; ++i) {
+        lastState[i] = analogState[i];
+        analogState[i] = WII_ANALOG_UNSET;
+    }
+
+    process(inputData);
+
+    for (i = 0; i < WiiAnalogs::WII_MAX_ANALOGS; ++i) {
+        _analogUpdated[i] = (analogState[i] != WII_ANALOG_UNSET);
+        if (!_analogUpdated[i]) analogState[i] = lastState[i];
+    }
+
+    if (!skipPostProcess) postProcess();
+}
+
 void ExtensionBase::setDataType(uint8_t dataType) { 
     _dataType = dataType;
 }
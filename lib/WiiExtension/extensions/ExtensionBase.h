@@ -74,6 +74,7 @@ class ExtensionBase {
         uint8_t _dataType;
         uint8_t _extensionType;
         bool _hasCalibrationData = false;
+        bool _analogUpdated[WiiAnalogs::WII_MAX_ANALOGS];
 
         WiiAnalogPrecision _analogPrecision[WiiAnalogs::WII_MAX_ANALOGS];
         WiiAnalogCalibration _analogCalibration[WiiAnalogs::WII_MAX_ANALOGS];
@@ -91,10 +92,13 @@ class ExtensionBase {
         bool isFirstRead = true;
         bool skipPostProcess = false;
 
+        virtual ~ExtensionBase() = default;
+
         virtual void init(uint8_t dataType);
         virtual bool calibrate(uint8_t *calibrationData);
         virtual void process(uint8_t *inputData) = 0;
         virtual void postProcess();
+        void update(uint8_t *inputData);
 
 #if WII_EXTENSION_DEBUG==true
         uint8_t _lastRead[16] = {0xFF};
@@ -113,6 +113,11 @@ void MotionPlusExtension::process(uint8_t *inputData) {
             initialYawValue = yawValue;
             initialRollValue = rollValue;
             initialPitchValue = pitchValue;
+
+            // the same report again would read as no movement, so start from there
+            motionState[WiiMotions::WII_GYROSCOPE_YAW]   = 0;
+            motionState[WiiMotions::WII_GYROSCOPE_ROLL]  = 0;
+            motionState[WiiMotions::WII_GYROSCOPE_PITCH] = 0;
         } else {
             motionState[WiiMotions::WII_GYROSCOPE_YAW]   = yawValue - initialYawValue;
             motionState[WiiMotions::WII_GYROSCOPE_ROLL]  = rollValue - initialRollValue;
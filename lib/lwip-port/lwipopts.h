@@ -48,8 +48,25 @@
 #define ETH_PAD_SIZE                    0
 #define LWIP_IP_ACCEPT_UDP_PORT(p)      ((p) == PP_NTOHS(67))
 
+/* RNDIS/ECM carry full size Ethernet frames (CFG_TUD_NET_MTU = 1514), so segments can use the whole 1500 byte MTU */
 #define TCP_MSS                         (1500 /*mtu*/ - 20 /*iphdr*/ - 20 /*tcphhr*/)
-#define TCP_SND_BUF                     (2 * TCP_MSS)
+
+/* Enough in flight to cover the host's delayed ACKs while the web UI bundle is sent.
+   httpd sends file data by reference from flash, so the send buffer costs segment headers, not copies */
+#define TCP_WND                         (8 * TCP_MSS)
+#define TCP_SND_BUF                     (8 * TCP_MSS)
+#define TCP_SND_QUEUELEN                ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#define MEMP_NUM_TCP_SEG                TCP_SND_QUEUELEN
+#define MEMP_NUM_PBUF                   TCP_SND_QUEUELEN
+#define MEM_SIZE                        (8 * 1024) /* segment headers */
+#define PBUF_POOL_SIZE                  16         /* received frames, enough to back TCP_WND plus the frame being received */
+#define IP_REASSEMBLY                   0          /* hosts never fragment on a 1500 byte link */
+
+/* received frames are handed to lwip in place by rndis.c, which moves a frame lwip keeps by patching its
+   payload; queued out of order segments would keep header pointers into the old buffer, and the USB link
+   doesn't reorder, so they are dropped and retransmitted instead */
+#define LWIP_SUPPORT_CUSTOM_PBUF        1
+#define TCP_QUEUE_OOSEQ                 0
 
 #define ETHARP_SUPPORT_STATIC_ENTRIES   1
 
@@ -62,6 +79,7 @@
 #define LWIP_HTTPD_SUPPORT_V09          0
 #define LWIP_HTTPD_SUPPORT_11_KEEPALIVE 0 // Causes lockups with CGI requests
 #define LWIP_HTTPD_ABORT_ON_CLOSE_MEM_ERROR 1
+#define HTTPD_LIMIT_SENDING_TO_2MSS     0 // Fill the send buffer instead of 2 segments per sent callback
 
 #define LWIP_SINGLE_NETIF               1
 
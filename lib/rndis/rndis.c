@@ -47,7 +47,10 @@ try changing the first byte of tud_network_mac_address[] below from 0x02 to 0x00
 #include "dhserver.h"
 #include "dnserver.h"
 #include "lwip/init.h"
+#include "lwip/mem.h"
+#include "lwip/pbuf.h"
 #include "lwip/timeouts.h"
+#include "netif/ethernet.h"
 #include "lwip/apps/httpd.h"
 #include "lwip/apps/mdns.h"
 
@@ -59,6 +62,43 @@ static struct netif netif_data;
 /* shared between tud_network_recv_cb() and service_traffic() */
 static struct pbuf *received_frame;
 
+/* TinyUSB's receive buffer was handed to tud_network_recv_cb() and waits to be renewed */
+static bool rx_pending_renew;
+
+/*
+received frames are lent to lwip in place, wrapped in a custom pbuf pointing into TinyUSB's receive
+buffer, and the buffer is renewed as soon as lwip frees the frame, which it normally does before
+ethernet_input() returns. If lwip keeps the frame (refused HTTP POST data) it is moved to the
+wrapper's own spill buffer so TinyUSB can carry on; lwip only re-reads p->payload after that since
+out of order segments (which cache header pointers) are not queued, see TCP_QUEUE_OOSEQ.
+When every wrapper is held by lwip, frames are copied into a pool pbuf instead.
+*/
+#define RX_FRAMES 2
+
+typedef struct
+{
+  struct pbuf_custom pc;
+  const uint8_t *frame; /* start of the frame, payload offsets are relative to it */
+  bool in_use;
+  uint8_t spill[CFG_TUD_NET_MTU];
+} rx_frame_t;
+
+static rx_frame_t rx_frames[RX_FRAMES];
+
+/* the frame lent from TinyUSB's receive buffer, if lwip still holds it */
+static rx_frame_t *rx_usb_frame;
+
+/*
+frames are queued by reference while TinyUSB is busy sending, so lwip can keep queuing segments
+instead of spinning in linkoutput; lwip's TCP already holds off retransmitting a segment the
+driver still references
+*/
+#define TX_QUEUE_LEN 8
+
+static struct pbuf *tx_queue[TX_QUEUE_LEN];
+static uint8_t tx_head;
+static uint8_t tx_count;
+
 /* this is used by this code, ./class/net/net_driver.c, and usb_descriptors.c */
 /* ideally speaking, this should be generated from the hardware's unique ID (if available) */
 /* it is suggested that the first byte is 0x02 to indicate a link-local address */
@@ -87,26 +127,52 @@ static const dhcp_config_t dhcp_config =
     TU_ARRAY_SIZE(entries),                    /* num entry */
     entries                                    /* entries */
 };
+static void tx_queue_drain(void)
+{
+  while (tx_count && tud_network_can_xmit(tx_queue[tx_head]->tot_len))
+  {
+    struct pbuf *p = tx_queue[tx_head];
+    /* tud_network_xmit() copies the frame out through tud_network_xmit_cb() before returning */
+    tud_network_xmit(p, 0 /* unused */);
+    pbuf_free(p);
+    tx_head = (tx_head + 1) % TX_QUEUE_LEN;
+    tx_count--;
+  }
+}
+
+static void tx_queue_flush(void)
+{
+  while (tx_count)
+  {
+    pbuf_free(tx_queue[tx_head]);
+    tx_head = (tx_head + 1) % TX_QUEUE_LEN;
+    tx_count--;
+  }
+}
+
 static err_t linkoutput_fn(struct netif *netif, struct pbuf *p)
 {
   (void)netif;
 
-  for (;;)
+  /* if TinyUSB isn't ready, we must signal back to lwip that there is nothing we can do */
+  if (!tud_ready())
+    return ERR_USE;
+
+  /* keep frames in order, only send directly when nothing is waiting */
+  tx_queue_drain();
+  if (!tx_count && tud_network_can_xmit(p->tot_len))
   {
-    /* if TinyUSB isn't ready, we must signal back to lwip that there is nothing we can do */
-    if (!tud_ready())
-      return ERR_USE;
+    tud_network_xmit(p, 0 /* unused */);
+    return ERR_OK;
+  }
 
-    /* if the network driver can accept another packet, we make it happen */
-    if (tud_network_can_xmit(p->tot_len))
-    {
-      tud_network_xmit(p, 0 /* unused for this example */);
-      return ERR_OK;
-    }
+  if (tx_count == TX_QUEUE_LEN)
+    return ERR_MEM;
 
-    /* transfer execution to TinyUSB in the hopes that it will finish transmitting the prior packet */
-    tud_task();
-  }
+  pbuf_ref(p);
+  tx_queue[(tx_head + tx_count) % TX_QUEUE_LEN] = p;
+  tx_count++;
+  return ERR_OK;
 }
 
 static err_t ip4_output_fn(struct netif *netif, struct pbuf *p, const ip4_addr_t *addr)
@@ -117,7 +183,8 @@ static err_t ip4_output_fn(struct netif *netif, struct pbuf *p, const ip4_addr_t
 static err_t netif_init_cb(struct netif *netif)
 {
   LWIP_ASSERT("netif != NULL", (netif != NULL));
-  netif->mtu = CFG_TUD_NET_MTU;
+  /* CFG_TUD_NET_MTU is the whole Ethernet frame, lwip wants the IP MTU */
+  netif->mtu = CFG_TUD_NET_MTU - SIZEOF_ETH_HDR;
   netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP | NETIF_FLAG_UP | NETIF_FLAG_IGMP;
   netif->state = NULL;
   netif->name[0] = 'E';
@@ -153,6 +220,32 @@ bool dns_query_proc(const char *name, ip4_addr_t *addr)
   return false;
 }
 
+static void rx_frame_free(struct pbuf *p)
+{
+  rx_frame_t *rx = (rx_frame_t *)p;
+
+  /* lwip let go of TinyUSB's buffer, service_traffic() renews it */
+  if (rx == rx_usb_frame)
+  {
+    rx_usb_frame = NULL;
+    rx_pending_renew = true;
+  }
+
+  rx->frame = NULL;
+  rx->in_use = false;
+}
+
+/* move a frame lwip still holds out of TinyUSB's receive buffer */
+static void rx_frame_spill(rx_frame_t *rx)
+{
+  struct pbuf *p = &rx->pc.pbuf;
+  uint16_t offset = (const uint8_t *)p->payload - rx->frame;
+
+  memcpy(rx->spill, rx->frame, offset + p->len);
+  p->payload = rx->spill + offset;
+  rx->frame = rx->spill;
+}
+
 bool tud_network_recv_cb(const uint8_t *src, uint16_t size)
 {
   /* this shouldn't happen, but if we get another packet before
@@ -160,20 +253,46 @@ bool tud_network_recv_cb(const uint8_t *src, uint16_t size)
   if (received_frame)
     return false;
 
+  /* can't happen with TinyUSB's buffer, but the spill buffer relies on it */
+  if (size > CFG_TUD_NET_MTU)
+    return false;
+
   if (size)
   {
-    struct pbuf *p = pbuf_alloc(PBUF_RAW, size, PBUF_POOL);
+    rx_frame_t *rx = NULL;
+    for (int i = 0; i < RX_FRAMES; i++)
+    {
+      if (!rx_frames[i].in_use)
+      {
+        rx = &rx_frames[i];
+        break;
+      }
+    }
 
-    if (p)
+    if (rx)
     {
-      /* pbuf_alloc() has already initialized struct; all we need to do is copy the data */
-      memcpy(p->payload, src, size);
+      rx->pc.custom_free_function = rx_frame_free;
+      rx->frame = src;
+      rx->in_use = true;
+      rx_usb_frame = rx;
 
       /* store away the pointer for service_traffic() to later handle */
-      received_frame = p;
+      received_frame = pbuf_alloced_custom(PBUF_RAW, size, PBUF_REF, &rx->pc, (void *)src, size);
+      return true;
     }
+
+    /* every wrapper is held by lwip, copy the frame out instead */
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, size, PBUF_POOL);
+
+    /* out of pool pbufs, drop the frame and let TinyUSB renew */
+    if (!p)
+      return false;
+
+    pbuf_take(p, src, size);
+    received_frame = p;
   }
 
+  rx_pending_renew = true;
   return true;
 }
 
@@ -191,14 +310,29 @@ static void service_traffic(void)
   /* handle any packet received by tud_network_recv_cb() */
   if (received_frame)
   {
-    err_t ret = ethernet_input(received_frame, &netif_data);
-    pbuf_free(received_frame);
+    struct pbuf *p = received_frame;
     received_frame = NULL;
-    if ( ret == ERR_OK ) {
-      tud_network_recv_renew();
+
+    /* ethernet_input() owns the frame from here, whether it is accepted or not */
+    ethernet_input(p, &netif_data);
+
+    /* lwip kept the frame, give TinyUSB its buffer back */
+    if (rx_usb_frame)
+    {
+      rx_frame_spill(rx_usb_frame);
+      rx_usb_frame = NULL;
+      rx_pending_renew = true;
     }
   }
 
+  /* the frame was released, copied out or dropped, TinyUSB can use its buffer again */
+  if (rx_pending_renew)
+  {
+    rx_pending_renew = false;
+    tud_network_recv_renew();
+  }
+
+  tx_queue_drain();
   sys_check_timeouts();
 }
 
@@ -211,6 +345,17 @@ void tud_network_init_cb(void)
     received_frame = NULL;
   }
 
+  /* TinyUSB starts over with its receive buffer, a frame lwip still holds from it must move out first */
+  if (rx_usb_frame)
+  {
+    rx_frame_spill(rx_usb_frame);
+    rx_usb_frame = NULL;
+  }
+  rx_pending_renew = false;
+
+  /* anything still queued was meant for the previous session */
+  tx_queue_flush();
+
   /* re-announce mDNS, so hostname resolves after reconnect, getting issues on windows on hard-refresh without this */
   mdns_resp_announce(&netif_data);
 }
@@ -1,5 +1,15 @@
 #include "addonmanager.h"
 #include "usbhostmanager.h"
+#include "usbtelemetry.h"
+
+#include "pico/time.h"
+
+// Accumulate the time spent in each core0 add-on call for the telemetry interface
+#if USB_TELEMETRY_ENABLED
+#define ADDON_TIMED(block, call) { uint32_t start = time_us_32(); call; (block)->busyUs += time_us_32() - start; }
+#else
+#define ADDON_TIMED(block, call) call
+#endif
 
 bool AddonManager::LoadAddon(GPAddon* addon) {
     if (addon->available()) {
@@ -32,21 +42,24 @@ void AddonManager::ReinitializeAddons() {
 void AddonManager::PreprocessAddons() {
     // Loop through all addons and process any that match our type
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        (*it)->ptr->preprocess();
+        ADDON_TIMED(*it, (*it)->ptr->preprocess());
     }
 }
 
 void AddonManager::ProcessAddons() {
     // Loop through all addons and process any that match our type
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        (*it)->ptr->process();
+#if USB_TELEMETRY_ENABLED
+        (*it)->calls++;
+#endif
+        ADDON_TIMED(*it, (*it)->ptr->process());
     }
 }
 
 void AddonManager::PostprocessAddons(bool reportSent) {
     // Loop through all addons and process any that match our type
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        (*it)->ptr->postprocess(reportSent);
+        ADDON_TIMED(*it, (*it)->ptr->postprocess(reportSent));
     }
 }
 
@@ -6,13 +6,84 @@
 #include "storagemanager.h"
 #include "drivermanager.h"
 
+#include <algorithm>
 #include <math.h>
+#include <string.h>
 
 #define ADC_MAX ((1 << 12) - 1) // 4095
 #define ADC_PIN_OFFSET 26
-#define ANALOG_MAX 1.0f
-#define ANALOG_CENTER 0.5f
-#define ANALOG_MINIMUM 0.0f
+
+// Positions count 1/256ths of 1/(ADC_MAX * 16) of the travel: every ADC reading, oversampled
+// or not, lands exactly on one, and so does the float path's smoothed reading to within half
+#define ANALOG_UNIT (ADC_MAX * 16)
+#define ANALOG_FRACTION_BITS 8
+#define ANALOG_MAX (ANALOG_UNIT << ANALOG_FRACTION_BITS)
+#define ANALOG_CENTER (ANALOG_MAX / 2)
+
+// Stick results carry 30 fractional bits of an LSB of joystick travel
+#define ANALOG_RESULT_BITS 30
+// Radii are compared 1000 * 256 times larger: error rate per mille, square root with 8 fractional bits
+#define ANALOG_RADIUS_SCALE (1000 * 256)
+// The float magnitude is within a few ulps of the exact one, results closer than this to the
+// inner deadzone are left to it
+#define ANALOG_DEADZONE_MARGIN (((int64_t)ANALOG_MAX * ANALOG_RADIUS_SCALE) >> 20)
+
+// Integer square root, rounded to nearest
+static uint32_t isqrt(uint64_t value) {
+    uint64_t root = 0;
+    uint64_t remainder = value;
+    uint64_t bit = 1ULL << 62;
+    while (bit > remainder)
+        bit >>= 2;
+    while (bit != 0) {
+        if (remainder >= root + bit) {
+            remainder -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    // value - root^2 is left over, the true root is past root + 1/2 when that exceeds root
+    if (remainder > root)
+        root++;
+    return (uint32_t)root;
+}
+
+// Whole LSBs of a result clamped to the joystick range, or -1 when it is within tolerance of
+// a step and the float path could have rounded across it
+static int32_t settleResult(int64_t value, uint32_t joystickMax, int64_t tolerance) {
+    const int64_t one = 1LL << ANALOG_RESULT_BITS;
+    int64_t step = std::clamp((value + one / 2) >> ANALOG_RESULT_BITS, (int64_t)0, (int64_t)joystickMax);
+    int64_t distance = value - (step << ANALOG_RESULT_BITS);
+    if (distance < tolerance && -distance < tolerance)
+        return -1;
+    return (int32_t)(std::clamp(value, (int64_t)0, (int64_t)joystickMax << ANALOG_RESULT_BITS) >> ANALOG_RESULT_BITS);
+}
+
+// Exact position of a float reading, 0.0 to 1.0 of the travel
+static uint32_t floatToPosition(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF);
+    if (exponent == 0 || (bits & 0x80000000))
+        return 0;
+    uint64_t product = (uint64_t)((bits & 0x7FFFFF) | 0x800000) * ANALOG_MAX;
+    int32_t shift = 150 - exponent; // 127 bias and 23 mantissa bits
+    if (shift <= 0)
+        return ANALOG_MAX; // 2.0 or more, smoothing never gets there
+    if (shift >= 64)
+        return 0;
+    return (uint32_t)((product + (1ULL << (shift - 1))) >> shift);
+}
+
+// Largest power of two up to ANALOG_OVERSAMPLE_MAX that fits in samples, as a shift
+static uint8_t oversampleShift(uint32_t samples) {
+    uint8_t shift = 0;
+    while ((2UL << shift) <= std::min(samples, (uint32_t)ANALOG_OVERSAMPLE_MAX))
+        shift++;
+    return shift;
+}
 
 bool AnalogInput::available() {
     return Storage::getInstance().getAddonOptions().analogOptions.enabled;
@@ -27,10 +98,7 @@ void AnalogInput::setup() {
     adc_pairs[0].analog_invert = analogOptions.analogAdc1Invert;
     adc_pairs[0].analog_dpad = analogOptions.analogAdc1Mode;
     adc_pairs[0].ema_option = analogOptions.analog_smoothing;
-    adc_pairs[0].ema_smoothing = analogOptions.smoothing_factor / 1000.0f;
-    adc_pairs[0].error_rate = analogOptions.analog_error / 1000.0f;
-    adc_pairs[0].in_deadzone = analogOptions.inner_deadzone / 100.0f;
-    adc_pairs[0].out_deadzone = analogOptions.outer_deadzone / 100.0f;
+    adc_pairs[0].oversample_shift = oversampleShift(analogOptions.analog_oversample);
     adc_pairs[0].auto_calibration = analogOptions.auto_calibrate;
     adc_pairs[0].forced_circularity = analogOptions.forced_circularity;
     adc_pairs[0].joystick_center_x = analogOptions.joystick_center_x;
@@ -40,15 +108,17 @@ void AnalogInput::setup() {
     adc_pairs[1].analog_invert = analogOptions.analogAdc2Invert;
     adc_pairs[1].analog_dpad = analogOptions.analogAdc2Mode;
     adc_pairs[1].ema_option = analogOptions.analog_smoothing2;
-    adc_pairs[1].ema_smoothing = analogOptions.smoothing_factor2 / 1000.0f;
-    adc_pairs[1].error_rate = analogOptions.analog_error2 / 1000.0f;
-    adc_pairs[1].in_deadzone = analogOptions.inner_deadzone2 / 100.0f;
-    adc_pairs[1].out_deadzone = analogOptions.outer_deadzone2 / 100.0f;
+    adc_pairs[1].oversample_shift = oversampleShift(analogOptions.analog_oversample2);
     adc_pairs[1].auto_calibration = analogOptions.auto_calibrate2;
     adc_pairs[1].forced_circularity = analogOptions.forced_circularity2;
     adc_pairs[1].joystick_center_x = analogOptions.joystick_center_x2;
     adc_pairs[1].joystick_center_y = analogOptions.joystick_center_y2;
-    
+
+    // Options only change through a reboot, so everything the loop divides by is worked out here
+    buildScaling(0, analogOptions.smoothing_factor, analogOptions.analog_error, analogOptions.inner_deadzone, analogOptions.outer_deadzone);
+    buildScaling(1, analogOptions.smoothing_factor2, analogOptions.analog_error2, analogOptions.inner_deadzone2, analogOptions.outer_deadzone2);
+    buildCurve(0, analogOptions.analog_curve, analogOptions.analog_curve_points);
+    buildCurve(1, analogOptions.analog_curve2, analogOptions.analog_curve_points2);
 
     // Setup defaults and helpers
     for (int i = 0; i < ADC_COUNT; i++) {
@@ -56,11 +126,10 @@ void AnalogInput::setup() {
         adc_pairs[i].y_pin_adc = adc_pairs[i].y_pin - ADC_PIN_OFFSET;
         adc_pairs[i].x_value = ANALOG_CENTER;
         adc_pairs[i].y_value = ANALOG_CENTER;
-        adc_pairs[i].xy_magnitude = 0.0f;
-        adc_pairs[i].x_magnitude = 0.0f;
-        adc_pairs[i].y_magnitude = 0.0f;
-        adc_pairs[i].x_ema = 0.0f;
-        adc_pairs[i].y_ema = 0.0f;
+        adc_pairs[i].x_magnitude = 0;
+        adc_pairs[i].y_magnitude = 0;
+        adc_pairs[i].x_ema = 0;
+        adc_pairs[i].y_ema = 0;
     }
 
     // Intialize and auto center X/Y for each pair
@@ -99,95 +168,338 @@ void AnalogInput::process() {
     }
 
     for(int i = 0; i < ADC_COUNT; i++) {
+        adc_instance & stick = adc_pairs[i];
+        if (!isValidPin(stick.x_pin) && !isValidPin(stick.y_pin))
+            continue;
+
+        bool invert_x = (stick.analog_invert == InvertMode::INVERT_X || stick.analog_invert == InvertMode::INVERT_XY);
+        bool invert_y = (stick.analog_invert == InvertMode::INVERT_Y || stick.analog_invert == InvertMode::INVERT_XY);
+        uint32_t x_reading = 0;
+        uint32_t y_reading = 0;
+        float x_float = 0.5f;
+        float y_float = 0.5f;
+        stick.x_value = ANALOG_CENTER;
+        stick.y_value = ANALOG_CENTER;
+
         // Read X-Axis
-        if (isValidPin(adc_pairs[i].x_pin)) {
-            adc_pairs[i].x_value = readPin(i, adc_pairs[i].x_pin_adc, adc_pairs[i].x_center);
-            if (adc_pairs[i].analog_invert == InvertMode::INVERT_X || 
-                adc_pairs[i].analog_invert == InvertMode::INVERT_XY) {
-                adc_pairs[i].x_value = ANALOG_MAX - adc_pairs[i].x_value;
-            }
-            if (adc_pairs[i].ema_option) {
-                adc_pairs[i].x_value = emaCalculation(i, adc_pairs[i].x_value, adc_pairs[i].x_ema);
-                adc_pairs[i].x_ema = adc_pairs[i].x_value;
+        if (isValidPin(stick.x_pin)) {
+            x_reading = readPin(i, stick.x_pin_adc, stick.x_center);
+            stick.x_value = invert_x ? ANALOG_MAX - x_reading : x_reading;
+            if (stick.ema_option) {
+                float value = (float)x_reading / ANALOG_MAX;
+                stick.x_ema = emaCalculation(i, invert_x ? 1.0f - value : value, stick.x_ema);
+                stick.x_value = floatToPosition(stick.x_ema);
+                x_float = stick.x_ema;
             }
         }
         // Read Y-Axis
-        if (isValidPin(adc_pairs[i].y_pin)) {
-            adc_pairs[i].y_value = readPin(i, adc_pairs[i].y_pin_adc, adc_pairs[i].y_center);
-            if (adc_pairs[i].analog_invert == InvertMode::INVERT_Y || 
-                adc_pairs[i].analog_invert == InvertMode::INVERT_XY) {
-                adc_pairs[i].y_value = ANALOG_MAX - adc_pairs[i].y_value;
-            }
-            if (adc_pairs[i].ema_option) {
-                adc_pairs[i].y_value = emaCalculation(i, adc_pairs[i].y_value, adc_pairs[i].y_ema);
-                adc_pairs[i].y_ema = adc_pairs[i].y_value;
+        if (isValidPin(stick.y_pin)) {
+            y_reading = readPin(i, stick.y_pin_adc, stick.y_center);
+            stick.y_value = invert_y ? ANALOG_MAX - y_reading : y_reading;
+            if (stick.ema_option) {
+                float value = (float)y_reading / ANALOG_MAX;
+                stick.y_ema = emaCalculation(i, invert_y ? 1.0f - value : value, stick.y_ema);
+                stick.y_value = floatToPosition(stick.y_ema);
+                y_float = stick.y_ema;
             }
         }
-        // Look for dead-zones and circularity
-        adc_pairs[i].xy_magnitude = magnitudeCalculation(i, adc_pairs[i]);
-        if (adc_pairs[i].xy_magnitude < adc_pairs[i].in_deadzone) {
-            adc_pairs[i].x_value = ANALOG_CENTER;
-            adc_pairs[i].y_value = ANALOG_CENTER;
-        } else {
-            radialDeadzone(i, adc_pairs[i]);
-        }
 
-        // If MID is 0x8000, clamp our max to 0xFFFF incase we are at 0x10000. 0x7FFF will max at 0xFFFE
-        uint16_t clampedX = (uint16_t)std::min((uint32_t)(joystickMax * std::min(adc_pairs[i].x_value, 1.0f)), (uint32_t)0xFFFF);
-        uint16_t clampedY = (uint16_t)std::min((uint32_t)(joystickMax * std::min(adc_pairs[i].y_value, 1.0f)), (uint32_t)0xFFFF);
+        // Dead-zones and circularity
+        uint16_t clampedX;
+        uint16_t clampedY;
+        AnalogResult result = scaleStick(i, stick, joystickMax, clampedX, clampedY);
+        if (result == ANALOG_RESULT_UNSURE) {
+            // smoothing already has the float readings, otherwise they are made as the float path did
+            if (!stick.ema_option) {
+                if (isValidPin(stick.x_pin)) {
+                    x_float = (float)x_reading / ANALOG_MAX;
+                    if (invert_x) x_float = 1.0f - x_float;
+                }
+                if (isValidPin(stick.y_pin)) {
+                    y_float = (float)y_reading / ANALOG_MAX;
+                    if (invert_y) y_float = 1.0f - y_float;
+                }
+            }
+            result = scaleStickFloat(i, x_float, y_float, joystickMax, clampedX, clampedY);
+        }
 
-        if (adc_pairs[i].x_value == ANALOG_CENTER && adc_pairs[i].y_value == ANALOG_CENTER) {
+        if (result == ANALOG_RESULT_CENTERED) {
+            stick.x_value = ANALOG_CENTER;
+            stick.y_value = ANALOG_CENTER;
             continue;
         }
 
-        if (adc_pairs[i].analog_dpad == DpadMode::DPAD_MODE_LEFT_ANALOG) {
+        if (stick.analog_dpad == DpadMode::DPAD_MODE_LEFT_ANALOG) {
             gamepad->state.lx = clampedX;
             gamepad->state.ly = clampedY;
-        } else if (adc_pairs[i].analog_dpad == DpadMode::DPAD_MODE_RIGHT_ANALOG) {
+        } else if (stick.analog_dpad == DpadMode::DPAD_MODE_RIGHT_ANALOG) {
             gamepad->state.rx = clampedX;
             gamepad->state.ry = clampedY;
         }
     }
 }
 
-float AnalogInput::readPin(int stick_num, Pin_t pin_adc, uint16_t center) {
-    adc_select_input(pin_adc);
-    uint16_t adc_value = adc_read();
+uint32_t AnalogInput::readPin(int stick_num, Pin_t pin_adc, uint16_t center) {
+    // Averaged in 1/16ths of a step, the most ANALOG_OVERSAMPLE_MAX samples can add. A single
+    // reading stays in whole steps so calibration maps it exactly as the float path did
+    uint8_t shift = adc_pairs[stick_num].oversample_shift;
+    uint16_t steps = (shift != 0) ? 16 : 1;
+    uint16_t adc_value = (burstRead(pin_adc, 1UL << shift) * steps) >> shift;
+    const uint16_t adc_max = ADC_MAX * steps;
+    const uint16_t adc_mid = (ADC_MAX / 2) * steps;
+    center *= steps;
     // Apply calibration only if auto calibration is enabled or manual calibration has been performed
     // Manual calibration is considered performed if the center value is not 0 (default)
     if (adc_pairs[stick_num].auto_calibration || center != 0) {
         if (adc_value > center) {
-            adc_value = map(adc_value, center, ADC_MAX, ADC_MAX / 2, ADC_MAX);
+            adc_value = map(adc_value, center, adc_max, adc_mid, adc_max);
         } else if (adc_value == center) {
-            adc_value = ADC_MAX / 2;
+            adc_value = adc_mid;
         } else {
-            adc_value = map(adc_value, 0, center, 0, ADC_MAX / 2);
+            adc_value = map(adc_value, 0, center, 0, adc_mid);
         }
     }
-    return ((float)adc_value) / ADC_MAX;
+    return (uint32_t)adc_value * (ANALOG_MAX / adc_max);
+}
+
+uint32_t AnalogInput::burstRead(Pin_t pin_adc, uint32_t count, uint16_t * samples) {
+    adc_select_input(pin_adc);
+    if (count == 1 && samples == nullptr)
+        return adc_read();
+
+    // free running into the FIFO, so samples are one conversion apart
+    uint32_t sum = 0;
+    adc_fifo_setup(true, false, 0, false, false);
+    adc_run(true);
+    for (uint32_t i = 0; i < count; i++) {
+        uint16_t sample = adc_fifo_get_blocking();
+        sum += sample;
+        if (samples != nullptr)
+            samples[i] = sample;
+    }
+    adc_run(false);
+    adc_fifo_drain();
+    adc_fifo_setup(false, false, 0, false, false);
+    return sum;
+}
+
+void AnalogInput::measureNoise(Pin_t pin_adc, AnalogNoise & noise) {
+    static uint16_t samples[ANALOG_NOISE_SAMPLES];
+    uint32_t sum = burstRead(pin_adc, ANALOG_NOISE_SAMPLES, samples);
+
+    noise = {};
+    noise.mean = (float)sum / ANALOG_NOISE_SAMPLES;
+    noise.minimum = ADC_MAX;
+    int32_t center = (int32_t)(noise.mean + 0.5f);
+    float squares = 0.0f;
+    for (uint32_t i = 0; i < ANALOG_NOISE_SAMPLES; i++) {
+        float difference = samples[i] - noise.mean;
+        squares += difference * difference;
+        noise.minimum = std::min(noise.minimum, samples[i]);
+        noise.maximum = std::max(noise.maximum, samples[i]);
+        int32_t bin = (int32_t)samples[i] - center + (ANALOG_NOISE_BINS / 2);
+        noise.histogram[std::clamp(bin, (int32_t)0, (int32_t)ANALOG_NOISE_BINS - 1)]++;
+    }
+    noise.deviation = sqrtf(squares / ANALOG_NOISE_SAMPLES);
+}
+
+AnalogNoiseSuggestion AnalogInput::suggestNoiseSettings(const AnalogNoise & x, const AnalogNoise & y) {
+    AnalogNoiseSuggestion suggestion = {};
+    float deviation = std::max(x.deviation, y.deviation);
+    float spread = std::max(x.maximum - x.minimum, y.maximum - y.minimum) / 2.0f;
+
+    // oversample until what is left is within half a step
+    suggestion.oversample = 1;
+    while (suggestion.oversample < ANALOG_OVERSAMPLE_MAX && deviation / sqrtf(suggestion.oversample) > 0.5f)
+        suggestion.oversample <<= 1;
+    float residual = deviation / sqrtf(suggestion.oversample);
+    spread /= sqrtf(suggestion.oversample);
+
+    // an EMA of factor s leaves s / (2 - s) of the variance, smooth just enough for half a step
+    if (residual > 0.5f) {
+        float ratio = (0.5f / residual) * (0.5f / residual);
+        float factor = 2.0f * ratio / (1.0f + ratio);
+        suggestion.smoothing_factor = std::clamp((uint32_t)(factor * 1000.0f + 0.5f), (uint32_t)1, (uint32_t)100);
+        float kept = suggestion.smoothing_factor / 1000.0f;
+        residual *= sqrtf(kept / (2.0f - kept));
+        spread *= sqrtf(kept / (2.0f - kept));
+    }
+
+    // both axes at four deviations, or the widest swing seen
+    float radius = std::max(4.0f * residual, spread) * 1.41421356f;
+    suggestion.inner_deadzone = std::max((uint32_t)ceilf(radius * 100.0f / ADC_MAX), (uint32_t)1);
+    return suggestion;
 }
 
 float AnalogInput::emaCalculation(int stick_num, float ema_value, float ema_previous) {
-    return (adc_pairs[stick_num].ema_smoothing * ema_value) + ((1.0f - adc_pairs[stick_num].ema_smoothing) * ema_previous);
+    // kept in float, integer smoothing drifts from the float path's rounding over time
+    return (adc_pairs[stick_num].ema_smoothing * ema_value) + (adc_pairs[stick_num].ema_keep * ema_previous);
 }
 
 uint16_t AnalogInput::map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max) {
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
-float AnalogInput::magnitudeCalculation(int stick_num, adc_instance & adc_inst) {
-    adc_inst.x_magnitude = adc_inst.x_value - ANALOG_CENTER;
-    adc_inst.y_magnitude = adc_inst.y_value - ANALOG_CENTER;
-    return adc_pairs[stick_num].error_rate * std::sqrt((adc_inst.x_magnitude * adc_inst.x_magnitude) + (adc_inst.y_magnitude * adc_inst.y_magnitude));
+// Radial deadzone, circularity and response curve in integers. On the linear curve results the
+// float path could round the other way come back as ANALOG_RESULT_UNSURE, so the two always agree
+AnalogResult AnalogInput::scaleStick(int stick_num, adc_instance & adc_inst, uint32_t joystickMax, uint16_t & x, uint16_t & y) {
+    const adc_instance & stick = adc_pairs[stick_num];
+    if (stick.float_only)
+        return ANALOG_RESULT_UNSURE;
+    bool linear = (stick.curve == ANALOG_CURVE_LINEAR);
+
+    adc_inst.x_magnitude = (int32_t)adc_inst.x_value - ANALOG_CENTER;
+    adc_inst.y_magnitude = (int32_t)adc_inst.y_value - ANALOG_CENTER;
+    uint64_t squared = (uint64_t)((int64_t)adc_inst.x_magnitude * adc_inst.x_magnitude)
+        + (uint64_t)((int64_t)adc_inst.y_magnitude * adc_inst.y_magnitude);
+    if (squared < stick.deadzone_threshold)
+        return ANALOG_RESULT_CENTERED;
+
+    // error rate * radius past the inner deadzone, ANALOG_RADIUS_SCALE times larger
+    uint32_t root = isqrt(squared << 16);
+    int64_t beyond = (int64_t)stick.error_rate * root - stick.in_deadzone;
+    if (linear && beyond < ANALOG_DEADZONE_MARGIN && -beyond < ANALOG_DEADZONE_MARGIN)
+        return ANALOG_RESULT_UNSURE;
+    if (beyond <= 0)
+        return ANALOG_RESULT_CENTERED;
+
+    if (stick.forced_circularity == true) {
+        beyond = std::min(beyond, stick.half_scale);
+    }
+    // the circle the stick draws at full travel has a radius of half the axis
+    if (!linear && beyond < stick.half_scale) {
+        uint32_t deflection = (uint32_t)((beyond << 16) / stick.half_scale); // twice the scale, as 0.16
+        beyond = ((int64_t)applyCurve(stick_num, deflection) * stick.half_scale + (1 << 15)) >> 16;
+    }
+
+    // scale / error rate as 2.30, each axis takes its share of the radius from it
+    uint64_t scale = ((uint64_t)beyond * 102400) / stick.scale_divisor;
+    bool wide = (scale >= (1ULL << 33));
+    if (linear && wide)
+        return ANALOG_RESULT_UNSURE;
+    uint64_t reciprocal = (1ULL << 62) / root;
+    int64_t tolerance = linear ? (int64_t)joystickMax * stick.tolerance : 0;
+
+    const int32_t magnitudes[2] = { adc_inst.x_magnitude, adc_inst.y_magnitude };
+    int32_t results[2];
+    for (int axis = 0; axis < 2; axis++) {
+        uint32_t distance = (magnitudes[axis] < 0) ? -magnitudes[axis] : magnitudes[axis];
+        uint64_t share = ((uint64_t)distance * 256 * reciprocal) >> 32;
+        uint64_t offset = wide ? (share * (scale >> 10)) >> 20 : (share * scale) >> 30;
+        int64_t position = (1LL << 29) + (int64_t)std::min(offset, (uint64_t)1 << 31) * ((magnitudes[axis] < 0) ? -1 : 1);
+        results[axis] = settleResult((int64_t)joystickMax * position, joystickMax, tolerance);
+        if (results[axis] < 0)
+            return ANALOG_RESULT_UNSURE;
+    }
+
+    // If MID is 0x8000, clamp our max to 0xFFFF incase we are at 0x10000. 0x7FFF will max at 0xFFFE
+    x = (uint16_t)std::min(results[0], (int32_t)0xFFFF);
+    y = (uint16_t)std::min(results[1], (int32_t)0xFFFF);
+    return ANALOG_RESULT_MOVED;
 }
 
-void AnalogInput::radialDeadzone(int stick_num, adc_instance & adc_inst) {
-    float scaling_factor = (adc_inst.xy_magnitude - adc_pairs[stick_num].in_deadzone) / (adc_pairs[stick_num].out_deadzone - adc_pairs[stick_num].in_deadzone);
-    if (adc_pairs[stick_num].forced_circularity == true) {
-        scaling_factor = std::fmin(scaling_factor, ANALOG_CENTER);
+// The float pipeline the integer one replaced, for the results scaleStick() can't be sure of
+AnalogResult AnalogInput::scaleStickFloat(int stick_num, float x_value, float y_value, uint32_t joystickMax, uint16_t & x, uint16_t & y) {
+    const adc_instance & stick = adc_pairs[stick_num];
+    float x_magnitude = x_value - 0.5f;
+    float y_magnitude = y_value - 0.5f;
+    float xy_magnitude = stick.error_rate_float * std::sqrt((x_magnitude * x_magnitude) + (y_magnitude * y_magnitude));
+    if (xy_magnitude < stick.in_deadzone_float)
+        return ANALOG_RESULT_CENTERED;
+
+    float scaling_factor = (xy_magnitude - stick.in_deadzone_float) / (stick.out_deadzone_float - stick.in_deadzone_float);
+    if (stick.forced_circularity == true) {
+        scaling_factor = std::fmin(scaling_factor, 0.5f);
     }
-    adc_inst.x_value = ((adc_inst.x_magnitude / adc_inst.xy_magnitude) * scaling_factor) + ANALOG_CENTER;
-    adc_inst.y_value = ((adc_inst.y_magnitude / adc_inst.xy_magnitude) * scaling_factor) + ANALOG_CENTER;
-    adc_inst.x_value = std::clamp(adc_inst.x_value, ANALOG_MINIMUM, ANALOG_MAX);
-    adc_inst.y_value = std::clamp(adc_inst.y_value, ANALOG_MINIMUM, ANALOG_MAX);
+    x_value = std::clamp(((x_magnitude / xy_magnitude) * scaling_factor) + 0.5f, 0.0f, 1.0f);
+    y_value = std::clamp(((y_magnitude / xy_magnitude) * scaling_factor) + 0.5f, 0.0f, 1.0f);
+    if (x_value == 0.5f && y_value == 0.5f)
+        return ANALOG_RESULT_CENTERED;
+
+    x = (uint16_t)std::min((uint32_t)(joystickMax * std::min(x_value, 1.0f)), (uint32_t)0xFFFF);
+    y = (uint16_t)std::min((uint32_t)(joystickMax * std::min(y_value, 1.0f)), (uint32_t)0xFFFF);
+    return ANALOG_RESULT_MOVED;
+}
+
+void AnalogInput::buildScaling(int stick_num, float smoothing_factor, uint32_t error_rate, uint32_t inner_deadzone, uint32_t outer_deadzone) {
+    adc_instance & stick = adc_pairs[stick_num];
+    stick.ema_smoothing = smoothing_factor / 1000.0f;
+    stick.ema_keep = 1.0f - stick.ema_smoothing;
+    stick.error_rate = error_rate;
+    stick.error_rate_float = error_rate / 1000.0f;
+    stick.in_deadzone_float = inner_deadzone / 100.0f;
+    stick.out_deadzone_float = outer_deadzone / 100.0f;
+
+    // no outer range or error rate to scale by, or outside what the divisor holds
+    stick.float_only = (outer_deadzone <= inner_deadzone) || (error_rate == 0) || (error_rate > 1000) || (outer_deadzone > 100);
+    if (stick.float_only) {
+        stick.scale_divisor = 1;
+        stick.deadzone_threshold = 0;
+        return;
+    }
+
+    // radii in positions, ANALOG_RADIUS_SCALE times larger
+    uint32_t range = outer_deadzone - inner_deadzone;
+    stick.in_deadzone = (int64_t)inner_deadzone * (ANALOG_RADIUS_SCALE / 100) * ANALOG_MAX;
+    stick.half_scale = (int64_t)range * (ANALOG_RADIUS_SCALE / 200) * ANALOG_MAX;
+    stick.scale_divisor = range * ADC_MAX * error_rate;
+
+    // The float path lands within J * 2^-24 * (1 + 3 / (range * error rate)) LSBs of the exact
+    // result, J being the joystick travel: a few ulps, magnified by the division by the range.
+    // That is 2-4 times the worst case measured over every reading on the host
+    uint64_t tolerance = 64 * (1 + (300000 + range * error_rate - 1) / (range * error_rate));
+    stick.tolerance = (uint32_t)std::min(tolerance, (uint64_t)1 << 24);
+
+    // squared distance that is inside the inner deadzone by more than ANALOG_DEADZONE_MARGIN
+    int64_t limit = stick.in_deadzone - ANALOG_DEADZONE_MARGIN;
+    uint64_t radius = (limit > 0) ? (uint64_t)limit / (256 * error_rate) : 0;
+    radius = std::min(radius, (uint64_t)1 << 24);
+    stick.deadzone_threshold = radius * radius;
+}
+
+void AnalogInput::buildCurve(int stick_num, AnalogResponseCurve curve, uint32_t points) {
+    adc_instance & stick = adc_pairs[stick_num];
+    stick.curve = curve;
+
+    // custom points sit on every quarter, the LUT is filled in between them
+    int32_t knots[5] = {
+        0,
+        (int32_t)((points & 0xFF) * ANALOG_CURVE_ONE / 100),
+        (int32_t)(((points >> 8) & 0xFF) * ANALOG_CURVE_ONE / 100),
+        (int32_t)(((points >> 16) & 0xFF) * ANALOG_CURVE_ONE / 100),
+        ANALOG_CURVE_ONE,
+    };
+
+    for (int i = 0; i <= ANALOG_CURVE_SEGMENTS; i++) {
+        uint32_t input = i * (ANALOG_CURVE_ONE / ANALOG_CURVE_SEGMENTS);
+        uint32_t remaining = ANALOG_CURVE_ONE - input;
+        int32_t output;
+        switch (curve) {
+            case ANALOG_CURVE_AGGRESSIVE:
+                output = ANALOG_CURVE_ONE - (int32_t)(((uint64_t)remaining * remaining) >> 16);
+                break;
+            case ANALOG_CURVE_RELAXED:
+                output = (int32_t)(((uint64_t)input * input) >> 16);
+                break;
+            case ANALOG_CURVE_CUSTOM: {
+                int knot = i / (ANALOG_CURVE_SEGMENTS / 4);
+                int step = i % (ANALOG_CURVE_SEGMENTS / 4);
+                output = (knot == 4) ? knots[4] : knots[knot] + (knots[knot + 1] - knots[knot]) * step / (ANALOG_CURVE_SEGMENTS / 4);
+                break;
+            }
+            case ANALOG_CURVE_LINEAR:
+            default:
+                output = input;
+                break;
+        }
+        stick.curve_lut[i] = std::clamp(output, (int32_t)0, (int32_t)ANALOG_CURVE_ONE);
+    }
+}
+
+uint32_t AnalogInput::applyCurve(int stick_num, uint32_t deflection) {
+    const int32_t * lut = adc_pairs[stick_num].curve_lut;
+    const uint32_t step = 12; // log2(ANALOG_CURVE_ONE / ANALOG_CURVE_SEGMENTS)
+    uint32_t index = deflection >> step;
+    int32_t fraction = deflection & ((1 << step) - 1);
+    return lut[index] + (((lut[index + 1] - lut[index]) * fraction + (1 << (step - 1))) >> step);
 }
@@ -28,11 +28,8 @@ void DualDirectionalInput::setup() {
 
     dualState = 0;
 
-    lastGPUD = DIRECTION_NONE;
-    lastGPLR = DIRECTION_NONE;
-
-    lastDualUD = DIRECTION_NONE;
-    lastDualLR = DIRECTION_NONE;
+    dualFilter.reset();
+    mixedFilter.reset();
 }
 
 /**
@@ -48,53 +45,6 @@ void DualDirectionalInput::reinit()
 }
 
 
-uint8_t DualDirectionalInput::updateDpadDDI(uint8_t dpad, DpadDirection direction)
-{
-	static bool inList[] = {false, false, false, false, false}; // correspond to DpadDirection: none, up, down, left, right
-	static list<DpadDirection> dpadList;
-
-	if(dpad & getMaskFromDirection(direction))
-	{
-		if(!inList[direction])
-		{
-			dpadList.push_back(direction);
-			inList[direction] = true;
-		}
-	}
-	else
-	{
-		if(inList[direction])
-		{
-			dpadList.remove(direction);
-			inList[direction] = false;
-		}
-	}
-
-	if(dpadList.empty()) {
-		return 0;
-	}
-	else {
-		return getMaskFromDirection(dpadList.back());
-	}
-}
-
-/**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
- *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
- */
-uint8_t DualDirectionalInput::filterToFourWayModeDDI(uint8_t dpad)
-{
-	updateDpadDDI(dpad, DIRECTION_UP);
-	updateDpadDDI(dpad, DIRECTION_DOWN);
-	updateDpadDDI(dpad, DIRECTION_LEFT);
-	return updateDpadDDI(dpad, DIRECTION_RIGHT);
-}
-
-
 void DualDirectionalInput::preprocess()
 {
     const DualDirectionalOptions& options = Storage::getInstance().getAddonOptions().dualDirectionalOptions;
@@ -111,11 +61,11 @@ void DualDirectionalInput::preprocess()
 
     // 4-way before SOCD, might have better history without losing any coherent functionality
     if (options.fourWayMode) {
-        dualState = filterToFourWayModeDDI(dualState);
+        dualState = dualFilter.filterToFourWayMode(dualState);
     }
 
     // SOCD clean the dual inputs based on the mode in the gamepad config
-    SOCDDualClean(socdMode);
+    dualState = dualFilter.runSOCDCleaner(socdMode, dualState);
 }
 
 void DualDirectionalInput::process()
@@ -132,16 +82,8 @@ void DualDirectionalInput::process()
     if (options.combineMode == DualDirectionalCombinationMode::MIXED_MODE ||
             (options.combineMode == DualDirectionalCombinationMode::NONE_MODE &&
              gamepad->getActiveDpadMode() == options.dpadMode)) {
-        if ( socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL ) {
-            // neutral/up priority SOCD cleaning are pretty simple, they just need to be re-neutralized
-            dualOut = SOCDCombine(socdMode, gamepadDpad);
-        } else if ( socdMode != SOCD_MODE_BYPASS ) {
-            // else if not bypass, what's left is first/last input wins SOCD, which need a complicated re-clean
-            dualOut = SOCDGamepadClean(dualOut | gamepadDpad, socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY);
-        } else {
-            // this is bypass SOCD, just OR them together
-            dualOut |= gamepadDpad;
-        }
+        // the combined directions keep their own SOCD history, bypass just ORs them together
+        dualOut = mixedFilter.runSOCDCleaner(socdMode, dualOut | gamepadDpad);
         OverrideGamepad(gamepad, gamepad->getActiveDpadMode(), dualOut);
     } else if (options.combineMode != DualDirectionalCombinationMode::NONE_MODE) {
         // this is either of the override modes, which we will treat the same way --- they replace
@@ -173,132 +115,6 @@ void DualDirectionalInput::OverrideGamepad(Gamepad * gamepad, DpadMode mode, uin
     }
 }
 
-uint8_t DualDirectionalInput::SOCDGamepadClean(uint8_t gamepadState, bool isLastWin) {
-    // Gamepad SOCD Last-Win OR First-Win Clean
-    switch (gamepadState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-        case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-            if (isLastWin) gamepadState ^= (lastGPUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-            else gamepadState ^= (lastGPUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-            break;
-        case GAMEPAD_MASK_UP:
-            gamepadState |= GAMEPAD_MASK_UP;
-            lastGPUD = DIRECTION_UP;
-            break;
-        case GAMEPAD_MASK_DOWN:
-            gamepadState |= GAMEPAD_MASK_DOWN;
-            lastGPUD = DIRECTION_DOWN;
-            break;
-        default:
-            lastGPUD = DIRECTION_NONE;
-            break;
-    }
-    switch (gamepadState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-        case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-            if (lastGPLR != DIRECTION_NONE)
-                if (isLastWin) gamepadState ^= (lastGPLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT;
-                else gamepadState ^= (lastGPLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT;
-            else
-                lastGPLR = DIRECTION_NONE;
-            break;
-        case GAMEPAD_MASK_LEFT:
-            gamepadState |= GAMEPAD_MASK_LEFT;
-            lastGPLR = DIRECTION_LEFT;
-            break;
-        case GAMEPAD_MASK_RIGHT:
-            gamepadState |= GAMEPAD_MASK_RIGHT;
-            lastGPLR = DIRECTION_RIGHT;
-            break;
-        default:
-            lastGPLR = DIRECTION_NONE;
-            break;
-    }
-    return gamepadState;
-}
-
-
-uint8_t DualDirectionalInput::SOCDCombine(SOCDMode mode, uint8_t gamepadState) {
-    uint8_t outState = dualState | gamepadState;
-
-    if (mode == SOCD_MODE_BYPASS) {
-        return outState;
-    }
-
-    switch (outState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-        case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-            if ( mode == SOCD_MODE_NEUTRAL )
-                outState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
-            else if ( mode == SOCD_MODE_UP_PRIORITY )
-                outState = GAMEPAD_MASK_UP;
-            break;
-        default:
-            break;
-    }
-    switch (outState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-        case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-            outState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
-            break;
-        default:
-            break;
-    }
-
-    return outState;
-}
-
-void DualDirectionalInput::SOCDDualClean(SOCDMode socdMode) { 
-    if (socdMode == SOCD_MODE_BYPASS) {
-        return;
-    }
-
-    // Dual SOCD Last-Win Clean
-    switch (dualState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-        case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-            if ( socdMode == SOCD_MODE_UP_PRIORITY ) {
-                dualState ^= GAMEPAD_MASK_DOWN; // Remove Down
-                lastDualUD = DIRECTION_UP; // We're in UP mode
-            } else if ( socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastDualUD != DIRECTION_NONE ) {
-                dualState ^= (lastDualUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-            } else if ( socdMode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastDualUD != DIRECTION_NONE ) {
-                dualState ^= (lastDualUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-            } else {
-                dualState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-                lastDualUD = DIRECTION_NONE;
-            }
-            break;
-        case GAMEPAD_MASK_UP:
-            lastDualUD = DIRECTION_UP;
-            break;
-        case GAMEPAD_MASK_DOWN:
-            lastDualUD = DIRECTION_DOWN;
-            break;
-        default:
-            lastDualUD = DIRECTION_NONE;
-            break;
-    }
-    switch (dualState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-        case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-            if ( socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL ) {
-                dualState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-                lastDualLR = DIRECTION_NONE;
-            } else if ( socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY || socdMode == SOCD_MODE_FIRST_INPUT_PRIORITY ) {
-                if (lastDualLR != DIRECTION_NONE)
-                    if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) dualState ^= (lastDualLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-                    else dualState ^= (lastDualLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT; // First Win
-                else
-                    lastDualLR = DIRECTION_NONE;
-            }
-            break;
-        case GAMEPAD_MASK_LEFT:
-            lastDualLR = DIRECTION_LEFT;
-            break;
-        case GAMEPAD_MASK_RIGHT:
-            lastDualLR = DIRECTION_RIGHT;
-            break;
-        default:
-            lastDualLR = DIRECTION_NONE;
-            break;
-    }
-}
-
 uint8_t DualDirectionalInput::gpadToBinary(DpadMode dpadMode, GamepadState state) {
     uint8_t out = 0;
     switch(dpadMode) { // Convert gamepad to dual if we're in mixed
@@ -0,0 +1,503 @@
+#include "addons/gamepad_usb_host_decoder.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "CRC32.h"
+
+// HID usage pages and usages (HID Usage Tables 1.3)
+#define HID_PAGE_GENERIC_DESKTOP    0x01
+#define HID_PAGE_SIMULATION         0x02
+#define HID_PAGE_BUTTON             0x09
+
+#define HID_USAGE_JOYSTICK          0x04
+#define HID_USAGE_GAMEPAD           0x05
+#define HID_USAGE_MULTI_AXIS        0x08
+#define HID_USAGE_X                 0x30
+#define HID_USAGE_Y                 0x31
+#define HID_USAGE_Z                 0x32
+#define HID_USAGE_RX                0x33
+#define HID_USAGE_RY                0x34
+#define HID_USAGE_RZ                0x35
+#define HID_USAGE_HAT_SWITCH        0x39
+#define HID_USAGE_DPAD_UP           0x90
+#define HID_USAGE_DPAD_DOWN         0x91
+#define HID_USAGE_DPAD_RIGHT        0x92
+#define HID_USAGE_DPAD_LEFT         0x93
+#define HID_USAGE_ACCELERATOR       0xC4
+#define HID_USAGE_BRAKE             0xC5
+
+#define HID_COLLECTION_APPLICATION  0x01
+#define HID_INPUT_CONSTANT          0x01
+#define HID_INPUT_VARIABLE          0x02
+
+#define HID_PARSE_MAX_USAGES        16
+#define HID_PARSE_STACK_DEPTH       2
+#define HID_PARSE_MAX_REPORT_IDS    8
+
+// Largest field the decoder extracts, keeps every read within four bytes
+#define HID_GAMEPAD_MAX_FIELD_BITS  24
+// Longest input report the host buffer takes, plans reaching past it are rejected
+#define HID_GAMEPAD_MAX_REPORT_BITS (CFG_TUH_HID_EPIN_BUFSIZE * 8)
+static_assert(HID_GAMEPAD_MAX_REPORT_BITS <= 0xFFFF, "field offsets and the plan's report length are 16 bits");
+
+typedef struct {
+    uint16_t usagePage;
+    int32_t logicalMin;
+    int32_t logicalMax;
+    uint32_t reportSize;
+    uint32_t reportCount;
+    uint8_t reportID;
+} HIDGlobalState;
+
+// A composite device has a report descriptor per HID interface, so the VID/PID
+// alone does not name a plan
+typedef struct {
+    uint16_t vid;
+    uint16_t pid;
+    uint8_t instance;
+    uint16_t descLen;
+    uint32_t descCrc;
+    uint8_t users;
+    bool valid;
+    HIDGamepadPlan plan;
+} HIDGamepadPlanCacheEntry;
+
+// Only touched from the USB host core
+static HIDGamepadPlanCacheEntry planCache[HID_GAMEPAD_PLAN_CACHE_SIZE];
+static uint8_t planCacheNext = 0;
+
+// HID buttons 1-4 follow the PlayStation layout, the rest are in GP2040 mask order
+static const uint8_t faceButtonMasks[16] = {
+    0,
+    GAMEPAD_MASK_B3,
+    GAMEPAD_MASK_B1,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B1,
+    GAMEPAD_MASK_B2,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B2,
+    GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2,
+    GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B1 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B1 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B2 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B2 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2 | GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_B3 | GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2 | GAMEPAD_MASK_B4,
+};
+
+// Hat values clockwise from up
+static const uint8_t hatDpadMasks[8] = {
+    GAMEPAD_MASK_UP,
+    GAMEPAD_MASK_UP | GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_DOWN | GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_DOWN,
+    GAMEPAD_MASK_DOWN | GAMEPAD_MASK_LEFT,
+    GAMEPAD_MASK_LEFT,
+    GAMEPAD_MASK_UP | GAMEPAD_MASK_LEFT,
+};
+
+// HID button bits (button 1 in bit 0) to GP2040 button masks
+static inline uint32_t mapButtons(uint32_t bits) {
+    return faceButtonMasks[bits & 0x0F]
+        | (bits & 0x0000FFF0)
+        | ((bits & 0x0FFF0000) << 4);
+}
+
+static inline uint32_t extractBits(uint8_t const* data, uint16_t bitOffset, uint8_t bitSize) {
+    uint8_t const* bytes = data + (bitOffset >> 3);
+    uint8_t shift = bitOffset & 7;
+    uint8_t count = (shift + bitSize + 7) >> 3;
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        value |= (uint32_t)bytes[i] << (8 * i);
+    }
+    return (value >> shift) & ((1UL << bitSize) - 1);
+}
+
+static inline uint32_t scaleValue(const HIDGamepadField & field, uint32_t raw) {
+    int32_t value = field.isSigned ? ((int32_t)(raw << (32 - field.bitSize)) >> (32 - field.bitSize)) : (int32_t)raw;
+    uint32_t offset = (value <= field.logicalMin) ? 0 : (uint32_t)(value - field.logicalMin);
+    if (offset > field.range)
+        offset = field.range;
+    return (offset * field.scale) >> 16;
+}
+
+static HIDGamepadField * addField(HIDGamepadPlan & plan, uint8_t type, uint32_t bitOffset, uint8_t bitSize, const HIDGlobalState & global) {
+    if (plan.numFields >= HID_GAMEPAD_MAX_FIELDS || bitSize == 0 || bitSize > HID_GAMEPAD_MAX_FIELD_BITS)
+        return nullptr;
+
+    HIDGamepadField & field = plan.fields[plan.numFields++];
+    memset(&field, 0, sizeof(field));
+    field.bitOffset = bitOffset;
+    field.bitSize = bitSize;
+    field.type = type;
+    field.isSigned = global.logicalMin < 0;
+    field.logicalMin = global.logicalMin;
+    // a maximum that does not fit the field is a descriptor relying on unsigned values
+    field.range = (global.logicalMax > global.logicalMin) ? (uint32_t)(global.logicalMax - global.logicalMin) : ((1UL << bitSize) - 1);
+
+    uint32_t outputMax = (type == HID_GAMEPAD_FIELD_LT || type == HID_GAMEPAD_FIELD_RT) ? 0xFF : (GAMEPAD_JOYSTICK_MAX - GAMEPAD_JOYSTICK_MIN);
+    field.scale = field.range ? (outputMax << 16) / field.range : 0;
+
+    if (bitOffset + bitSize > plan.reportBits)
+        plan.reportBits = bitOffset + bitSize;
+    return &field;
+}
+
+static bool hasField(const HIDGamepadPlan & plan, uint8_t type) {
+    for (uint8_t i = 0; i < plan.numFields; i++) {
+        if (plan.fields[i].type == type)
+            return true;
+    }
+    return false;
+}
+
+// Adds one variable input control, returns true if it belongs to the gamepad
+static bool addControl(HIDGamepadPlan & plan, uint32_t usage, uint32_t bitOffset, const HIDGlobalState & global) {
+    uint16_t page = usage >> 16;
+    uint16_t id = usage & 0xFFFF;
+    if (global.reportSize > HID_GAMEPAD_MAX_FIELD_BITS)
+        return false;
+    uint8_t bitSize = global.reportSize;
+    uint8_t type;
+    uint8_t param = 0;
+
+    if (page == HID_PAGE_BUTTON) {
+        if (id == 0 || id > HID_GAMEPAD_MAX_BUTTONS || bitSize != 1)
+            return false;
+
+        // extend the previous block when the buttons continue straight on
+        if (plan.numFields > 0) {
+            HIDGamepadField & last = plan.fields[plan.numFields - 1];
+            if (last.type == HID_GAMEPAD_FIELD_BUTTONS
+                    && last.bitOffset + last.bitSize == bitOffset
+                    && last.param + last.bitSize == id - 1
+                    && last.bitSize < HID_GAMEPAD_MAX_FIELD_BITS) {
+                last.bitSize++;
+                if (bitOffset + 1 > plan.reportBits)
+                    plan.reportBits = bitOffset + 1;
+                return true;
+            }
+        }
+        HIDGamepadField * field = addField(plan, HID_GAMEPAD_FIELD_BUTTONS, bitOffset, 1, global);
+        if (field != nullptr)
+            field->param = id - 1;
+        return field != nullptr;
+    }
+
+    if (page == HID_PAGE_SIMULATION) {
+        if (id == HID_USAGE_BRAKE)
+            type = HID_GAMEPAD_FIELD_LT;
+        else if (id == HID_USAGE_ACCELERATOR)
+            type = HID_GAMEPAD_FIELD_RT;
+        else
+            return false;
+    } else if (page == HID_PAGE_GENERIC_DESKTOP) {
+        switch (id) {
+            case HID_USAGE_X:           type = HID_GAMEPAD_FIELD_LX; break;
+            case HID_USAGE_Y:           type = HID_GAMEPAD_FIELD_LY; break;
+            case HID_USAGE_Z:           type = HID_GAMEPAD_FIELD_RX; break;
+            case HID_USAGE_RZ:          type = HID_GAMEPAD_FIELD_RY; break;
+            case HID_USAGE_RX:          type = HID_GAMEPAD_FIELD_LT; break;
+            case HID_USAGE_RY:          type = HID_GAMEPAD_FIELD_RT; break;
+            case HID_USAGE_HAT_SWITCH:  type = HID_GAMEPAD_FIELD_HAT; break;
+            case HID_USAGE_DPAD_UP:     type = HID_GAMEPAD_FIELD_DPAD; param = GAMEPAD_MASK_UP; break;
+            case HID_USAGE_DPAD_DOWN:   type = HID_GAMEPAD_FIELD_DPAD; param = GAMEPAD_MASK_DOWN; break;
+            case HID_USAGE_DPAD_RIGHT:  type = HID_GAMEPAD_FIELD_DPAD; param = GAMEPAD_MASK_RIGHT; break;
+            case HID_USAGE_DPAD_LEFT:   type = HID_GAMEPAD_FIELD_DPAD; param = GAMEPAD_MASK_LEFT; break;
+            default:
+                return false;
+        }
+    } else {
+        return false;
+    }
+
+    // first control wins when a descriptor repeats a usage
+    if (type != HID_GAMEPAD_FIELD_DPAD && hasField(plan, type))
+        return false;
+
+    HIDGamepadField * field = addField(plan, type, bitOffset, bitSize, global);
+    if (field == nullptr)
+        return false;
+
+    if (type == HID_GAMEPAD_FIELD_HAT) {
+        field->param = (field->range == 3) ? 1 : 0; // four way hat
+    } else if (type == HID_GAMEPAD_FIELD_DPAD) {
+        field->param = param;
+    } else if (type != HID_GAMEPAD_FIELD_LT && type != HID_GAMEPAD_FIELD_RT) {
+        plan.analog = true;
+    }
+    return true;
+}
+
+bool GamepadUSBHostDecoder::parse(uint8_t const* desc_report, uint16_t desc_len, HIDGamepadPlan & plan) {
+    HIDGlobalState global;
+    HIDGlobalState stack[HID_PARSE_STACK_DEPTH];
+    uint8_t stackDepth = 0;
+
+    uint32_t usages[HID_PARSE_MAX_USAGES];
+    uint8_t usageCount = 0;
+    uint32_t usageMin = 0;
+    uint32_t usageMax = 0;
+    bool hasUsageRange = false;
+
+    // bit position inside each input report seen so far
+    uint8_t offsetIDs[HID_PARSE_MAX_REPORT_IDS];
+    uint32_t offsetBits[HID_PARSE_MAX_REPORT_IDS];
+    uint8_t offsetCount = 0;
+
+    uint8_t collectionDepth = 0;
+    uint8_t gamepadDepth = 0;   // collection depth of the gamepad application collection, 0 outside it
+    bool usesReportIDs = false;
+    bool planReportSet = false;
+
+    memset(&global, 0, sizeof(global));
+    memset(&plan, 0, sizeof(plan));
+
+    uint16_t i = 0;
+    while (i < desc_len) {
+        uint8_t prefix = desc_report[i];
+
+        // long items carry nothing a gamepad needs
+        if (prefix == 0xFE) {
+            if (i + 1 >= desc_len)
+                break;
+            i += 3 + desc_report[i + 1];
+            continue;
+        }
+
+        uint8_t size = prefix & 0x03;
+        if (size == 3)
+            size = 4;
+        uint8_t type = (prefix >> 2) & 0x03;
+        uint8_t tag = prefix >> 4;
+        if (i + 1 + size > desc_len)
+            break;
+
+        uint32_t data = 0;
+        for (uint8_t b = 0; b < size; b++) {
+            data |= (uint32_t)desc_report[i + 1 + b] << (8 * b);
+        }
+        int32_t signedData = data;
+        if (size == 1)
+            signedData = (int8_t)data;
+        else if (size == 2)
+            signedData = (int16_t)data;
+        i += 1 + size;
+
+        switch (type) {
+            case 0: // Main
+                if (tag == 0x8) { // Input
+                    uint8_t slot = 0;
+                    while (slot < offsetCount && offsetIDs[slot] != global.reportID) {
+                        slot++;
+                    }
+                    if (slot == offsetCount) {
+                        if (offsetCount == HID_PARSE_MAX_REPORT_IDS)
+                            return plan.numFields > 0;
+                        offsetIDs[offsetCount] = global.reportID;
+                        offsetBits[offsetCount++] = 0;
+                    }
+                    uint32_t bitOffset = offsetBits[slot];
+                    uint64_t totalBits = (uint64_t)global.reportSize * global.reportCount;
+
+                    bool usable = gamepadDepth != 0
+                        && (data & (HID_INPUT_CONSTANT | HID_INPUT_VARIABLE)) == HID_INPUT_VARIABLE
+                        && (!planReportSet || global.reportID == plan.reportID);
+                    if (usable) {
+                        for (uint32_t n = 0; n < global.reportCount; n++) {
+                            uint32_t usage;
+                            if (hasUsageRange) {
+                                usage = usageMin + n;
+                                if (usage > usageMax)
+                                    break;
+                            } else if (usageCount > 0) {
+                                usage = usages[n < usageCount ? n : usageCount - 1];
+                            } else {
+                                break;
+                            }
+                            // a report longer than the host buffer never arrives whole
+                            uint64_t controlOffset = bitOffset + (uint64_t)n * global.reportSize;
+                            if (controlOffset + global.reportSize > HID_GAMEPAD_MAX_REPORT_BITS)
+                                return false;
+                            if (addControl(plan, usage, (uint32_t)controlOffset, global)) {
+                                plan.reportID = global.reportID;
+                                planReportSet = true;
+                            }
+                        }
+                    }
+                    offsetBits[slot] = (uint32_t)std::min(bitOffset + totalBits, (uint64_t)UINT32_MAX);
+                } else if (tag == 0xA) { // Collection
+                    collectionDepth++;
+                    if (gamepadDepth == 0 && data == HID_COLLECTION_APPLICATION && usageCount > 0) {
+                        uint32_t usage = usages[0];
+                        if ((usage >> 16) == HID_PAGE_GENERIC_DESKTOP) {
+                            uint16_t id = usage & 0xFFFF;
+                            if (id == HID_USAGE_JOYSTICK || id == HID_USAGE_GAMEPAD || id == HID_USAGE_MULTI_AXIS)
+                                gamepadDepth = collectionDepth;
+                        }
+                    }
+                } else if (tag == 0xC) { // End Collection
+                    if (collectionDepth == gamepadDepth)
+                        gamepadDepth = 0;
+                    if (collectionDepth > 0)
+                        collectionDepth--;
+                }
+                // every main item clears the local state
+                usageCount = 0;
+                hasUsageRange = false;
+                break;
+            case 1: // Global
+                switch (tag) {
+                    case 0x0: global.usagePage = data; break;
+                    case 0x1: global.logicalMin = signedData; break;
+                    case 0x2: global.logicalMax = signedData; break;
+                    case 0x7: global.reportSize = data; break;
+                    case 0x8:
+                        global.reportID = data;
+                        usesReportIDs = true;
+                        break;
+                    case 0x9: global.reportCount = data; break;
+                    case 0xA: // Push
+                        if (stackDepth < HID_PARSE_STACK_DEPTH)
+                            stack[stackDepth++] = global;
+                        break;
+                    case 0xB: // Pop
+                        if (stackDepth > 0)
+                            global = stack[--stackDepth];
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            case 2: { // Local
+                // four byte usages carry their own page
+                uint32_t usage = (size == 4) ? data : (((uint32_t)global.usagePage << 16) | data);
+                switch (tag) {
+                    case 0x0:
+                        if (usageCount < HID_PARSE_MAX_USAGES)
+                            usages[usageCount++] = usage;
+                        break;
+                    case 0x1:
+                        usageMin = usage;
+                        hasUsageRange = true;
+                        break;
+                    case 0x2:
+                        usageMax = usage;
+                        hasUsageRange = true;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    if (!usesReportIDs)
+        plan.reportID = 0;
+    return plan.numFields > 0;
+}
+
+bool GamepadUSBHostDecoder::load(uint16_t vid, uint16_t pid, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
+    release();
+
+    uint32_t descCrc = CRC32::calculate(desc_report, desc_len);
+    for (uint8_t i = 0; i < HID_GAMEPAD_PLAN_CACHE_SIZE; i++) {
+        HIDGamepadPlanCacheEntry & entry = planCache[i];
+        if (entry.valid && entry.vid == vid && entry.pid == pid && entry.instance == instance &&
+            entry.descLen == desc_len && entry.descCrc == descCrc) {
+            entry.users++;
+            cacheIndex = i;
+            plan = &entry.plan;
+            return true;
+        }
+    }
+
+    // replace the oldest plan no mounted device is using, there is always one
+    for (uint8_t n = 0; n < HID_GAMEPAD_PLAN_CACHE_SIZE; n++) {
+        uint8_t i = planCacheNext;
+        planCacheNext = (planCacheNext + 1) % HID_GAMEPAD_PLAN_CACHE_SIZE;
+
+        HIDGamepadPlanCacheEntry & entry = planCache[i];
+        if (entry.users != 0)
+            continue;
+
+        entry.valid = parse(desc_report, desc_len, entry.plan);
+        if (!entry.valid)
+            return false;
+
+        entry.vid = vid;
+        entry.pid = pid;
+        entry.instance = instance;
+        entry.descLen = desc_len;
+        entry.descCrc = descCrc;
+        entry.users = 1;
+        cacheIndex = i;
+        plan = &entry.plan;
+        return true;
+    }
+    return false;
+}
+
+void GamepadUSBHostDecoder::release() {
+    if (plan != nullptr) {
+        planCache[cacheIndex].users--;
+        plan = nullptr;
+    }
+}
+
+bool GamepadUSBHostDecoder::decode(uint8_t const* report, uint16_t len, GamepadState & state) const {
+    if (plan == nullptr)
+        return false;
+
+    if (plan->reportID != 0) {
+        if (len == 0 || report[0] != plan->reportID)
+            return false;
+        report++;
+        len--;
+    }
+    if ((uint32_t)len * 8 < plan->reportBits)
+        return false;
+
+    state.buttons = 0;
+    state.dpad = 0;
+
+    for (uint8_t i = 0; i < plan->numFields; i++) {
+        const HIDGamepadField & field = plan->fields[i];
+        if ((uint32_t)field.bitOffset + field.bitSize > (uint32_t)len * 8)
+            return false;
+        uint32_t raw = extractBits(report, field.bitOffset, field.bitSize);
+
+        switch (field.type) {
+            case HID_GAMEPAD_FIELD_BUTTONS:
+                state.buttons |= mapButtons(raw << field.param);
+                break;
+            case HID_GAMEPAD_FIELD_HAT: {
+                // values outside the logical range are the null state
+                int32_t value = (int32_t)raw - field.logicalMin;
+                if (value >= 0 && (uint32_t)value <= field.range && value < 8)
+                    state.dpad |= hatDpadMasks[field.param ? value * 2 : value];
+                break;
+            }
+            case HID_GAMEPAD_FIELD_DPAD:
+                if (raw)
+                    state.dpad |= field.param;
+                break;
+            case HID_GAMEPAD_FIELD_LX: state.lx = GAMEPAD_JOYSTICK_MIN + scaleValue(field, raw); break;
+            case HID_GAMEPAD_FIELD_LY: state.ly = GAMEPAD_JOYSTICK_MIN + scaleValue(field, raw); break;
+            case HID_GAMEPAD_FIELD_RX: state.rx = GAMEPAD_JOYSTICK_MIN + scaleValue(field, raw); break;
+            case HID_GAMEPAD_FIELD_RY: state.ry = GAMEPAD_JOYSTICK_MIN + scaleValue(field, raw); break;
+            case HID_GAMEPAD_FIELD_LT: state.lt = scaleValue(field, raw); break;
+            case HID_GAMEPAD_FIELD_RT: state.rt = scaleValue(field, raw); break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
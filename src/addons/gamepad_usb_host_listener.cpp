@@ -1,5 +1,6 @@
 #include "addons/gamepad_usb_host_listener.h"
 #include "storagemanager.h"
+#include "usbhostlatency.h"
 #include "class/hid/hid.h"
 #include "class/hid/hid_host.h"
 
@@ -11,61 +12,128 @@
 #include "drivers/switchpro/SwitchProDescriptors.h"
 #include "drivers/shared/xinput_host.h"
 
+#include <algorithm>
+
 void GamepadUSBHostListener::setup() {
-    _controller_host_enabled = false;
 #if GAMEPAD_HOST_DEBUG
     stdio_init_all();
 #endif
 }
 
+// Core0: merge every connected controller into the gamepad
 void GamepadUSBHostListener::process() {
     Gamepad *gamepad = Storage::getInstance().GetGamepad();
-    gamepad->hasAnalogTriggers   = _controller_host_analog;
-    gamepad->hasLeftAnalogStick  = _controller_host_analog;
-    gamepad->hasRightAnalogStick = _controller_host_analog;
-    gamepad->state.dpad     |= _controller_host_state.dpad;
-    gamepad->state.buttons  |= _controller_host_state.buttons;
-    gamepad->state.lx       = _controller_host_state.lx;
-    gamepad->state.ly       = _controller_host_state.ly;
-    gamepad->state.rx       = _controller_host_state.rx;
-    gamepad->state.ry       = _controller_host_state.ry;
-    gamepad->state.rt       = _controller_host_state.rt;
-    gamepad->state.lt       = _controller_host_state.lt;
+    bool connected = false;
+    bool analog = false;
+
+    for (GamepadUSBHostController & controller : controllers) {
+        bool received = controller.inputSlot.collect();
+        if (!controller.inputSlot.connected())
+            continue;
+
+        const USBHostInput & input = controller.inputSlot.input();
+        if (received)
+            USBHostLatency::getInstance().markInput(input.devAddr, input.timestamp);
+        gamepad->state.dpad     |= input.dpad;
+        gamepad->state.buttons  |= input.buttons;
+        gamepad->state.lx       = mergeUSBHostAxis(gamepad->state.lx, input.lx, GAMEPAD_JOYSTICK_MID);
+        gamepad->state.ly       = mergeUSBHostAxis(gamepad->state.ly, input.ly, GAMEPAD_JOYSTICK_MID);
+        gamepad->state.rx       = mergeUSBHostAxis(gamepad->state.rx, input.rx, GAMEPAD_JOYSTICK_MID);
+        gamepad->state.ry       = mergeUSBHostAxis(gamepad->state.ry, input.ry, GAMEPAD_JOYSTICK_MID);
+        gamepad->state.lt       = std::max(gamepad->state.lt, input.lt);
+        gamepad->state.rt       = std::max(gamepad->state.rt, input.rt);
+        analog |= (input.flags & USB_HOST_INPUT_ANALOG) != 0;
+        connected = true;
+    }
 
-    if (_controller_host_enabled && getMillis() > _next_update) {
-        update_ctrlr();
-        _next_update = getMillis() + GAMEPAD_HOST_POLL_INTERVAL_MS;
+    if (connected) {
+        gamepad->hasAnalogTriggers   = analog;
+        gamepad->hasLeftAnalogStick  = analog;
+        gamepad->hasRightAnalogStick = analog;
     }
 }
 
-void GamepadUSBHostListener::mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
-    uint16_t vid = 0;
-    uint16_t pid = 0;
-    tuh_vid_pid_get(dev_addr, &vid, &pid);
-
-    if (_controller_host_enabled
-            && vid != 0 && pid != 0
-            && vid == controller_vid
-            && pid == controller_pid
-            && _controller_type == 1) {
-        // received XInput again...
-#ifdef GAMEPAD_HOST_DEBUG
-        printf("Ignoring mount twice (XInput -> HID) on VID_%04x PID_%04x\n", vid, pid);
-#endif
-        return;
+void GamepadUSBHostListener::host_task() {
+    for (GamepadUSBHostController & controller : controllers) {
+        controller.host_task();
     }
+}
 
-    _controller_host_enabled = true;
-    _controller_dev_addr = dev_addr;
-    _controller_instance = instance;
-    _controller_type = xinput_type_t::UNKNOWN; // HID controller
-    controller_vid = vid;
-    controller_pid = pid;
+GamepadUSBHostController * GamepadUSBHostListener::find_controller(uint8_t dev_addr, uint8_t instance) {
+    for (GamepadUSBHostController & controller : controllers) {
+        if (controller.matches(dev_addr, instance))
+            return &controller;
+    }
+    return nullptr;
+}
+
+GamepadUSBHostController * GamepadUSBHostListener::free_controller() {
+    for (GamepadUSBHostController & controller : controllers) {
+        if (!controller.enabled())
+            return &controller;
+    }
+    return nullptr;
+}
+
+void GamepadUSBHostListener::mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
+    // keyboards and mice behind the same hub belong to the keyboard host
+    uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
+    if (itf_protocol == HID_ITF_PROTOCOL_KEYBOARD || itf_protocol == HID_ITF_PROTOCOL_MOUSE) return;
 
+    for (GamepadUSBHostController & controller : controllers) {
+        if (controller.is_xinput_on(dev_addr)) {
+            // received XInput again...
 #if GAMEPAD_HOST_DEBUG
-    printf("Mount: VID_%04x PID_%04x\n", controller_vid, controller_pid);
+            printf("Ignoring mount twice (XInput -> HID) on device %d\n", dev_addr);
 #endif
+            return;
+        }
+    }
+
+    GamepadUSBHostController * controller = free_controller();
+    if (controller != nullptr) {
+        controller->mount(dev_addr, instance, desc_report, desc_len);
+    }
+}
+
+void GamepadUSBHostListener::xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype) {
+    GamepadUSBHostController * controller = find_controller(dev_addr, instance);
+    if (controller == nullptr)
+        controller = free_controller();
+    if (controller != nullptr) {
+        controller->xmount(dev_addr, instance, controllerType, subtype);
+    }
+}
+
+void GamepadUSBHostListener::unmount(uint8_t dev_addr) {
+    for (GamepadUSBHostController & controller : controllers) {
+        if (controller.enabled() && controller.dev_addr() == dev_addr)
+            controller.unmount();
+    }
+}
+
+void GamepadUSBHostListener::report_received(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+    GamepadUSBHostController * controller = find_controller(dev_addr, instance);
+    if (controller != nullptr) {
+        controller->report_received(report, len);
+    }
+}
+
+void GamepadUSBHostListener::set_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {
+    GamepadUSBHostController * controller = find_controller(dev_addr, instance);
+    if (controller != nullptr) {
+        controller->set_report_complete(report_id, report_type, len);
+    }
+}
+
+void GamepadUSBHostListener::get_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {
+    GamepadUSBHostController * controller = find_controller(dev_addr, instance);
+    if (controller != nullptr) {
+        controller->get_report_complete(report_id, report_type, len);
+    }
+}
 
+void GamepadUSBHostController::reset_state() {
     uint16_t joystick_mid = GAMEPAD_JOYSTICK_MID;
     _controller_host_state.buttons = 0;
     _controller_host_state.dpad = 0;
@@ -73,6 +141,57 @@ void GamepadUSBHostListener::mount(uint8_t dev_addr, uint8_t instance, uint8_t c
     _controller_host_state.ly = joystick_mid;
     _controller_host_state.rx = joystick_mid;
     _controller_host_state.ry = joystick_mid;
+    _controller_host_state.lt = 0;
+    _controller_host_state.rt = 0;
+    memset(&_published, 0, sizeof(_published));
+}
+
+// Hand the parsed state to core0 when it has changed
+void GamepadUSBHostController::publish() {
+    USBHostInput input;
+    memset(&input, 0, sizeof(input));
+    if (_controller_host_enabled) {
+        input.buttons = _controller_host_state.buttons;
+        input.dpad = _controller_host_state.dpad;
+        input.lx = _controller_host_state.lx;
+        input.ly = _controller_host_state.ly;
+        input.rx = _controller_host_state.rx;
+        input.ry = _controller_host_state.ry;
+        input.lt = _controller_host_state.lt;
+        input.rt = _controller_host_state.rt;
+        input.flags = USB_HOST_INPUT_CONNECTED | (_controller_host_analog ? USB_HOST_INPUT_ANALOG : 0);
+    }
+
+    if (memcmp(&input, &_published, sizeof(input)) != 0) {
+        _published = input;
+        input.devAddr = _controller_dev_addr;
+        input.timestamp = USBHostLatency::getInstance().reportTimestamp();
+        inputSlot.publish(input);
+    }
+}
+
+void GamepadUSBHostController::host_task() {
+    inputSlot.flush();
+
+    if (_controller_host_enabled && getMillis() > _next_update) {
+        update_ctrlr();
+        _next_update = getMillis() + GAMEPAD_HOST_POLL_INTERVAL_MS;
+    }
+}
+
+void GamepadUSBHostController::mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
+    _controller_host_enabled = true;
+    _controller_dev_addr = dev_addr;
+    _controller_instance = instance;
+    _controller_type = xinput_type_t::UNKNOWN; // HID controller
+    tuh_vid_pid_get(dev_addr, &controller_vid, &controller_pid);
+
+#if GAMEPAD_HOST_DEBUG
+    printf("Mount: VID_%04x PID_%04x\n", controller_vid, controller_pid);
+#endif
+
+    reset_state();
+    publish();
 
     switch(controller_pid)
     {
@@ -114,12 +233,16 @@ void GamepadUSBHostListener::mount(uint8_t dev_addr, uint8_t instance, uint8_t c
         case 0x9400:               // Google Stadia controller
         case 0x0510:               // pre-2015 Ultrakstik 360
         case 0x0511:               // Ultrakstik 360
+            break;
+
+        // anything else is decoded from its report descriptor
         default:
+            hidDecoder.load(controller_vid, controller_pid, instance, desc_report, desc_len);
             break;
     }
 }
 
-void GamepadUSBHostListener::xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype) {
+void GamepadUSBHostController::xmount(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype) {
     _controller_host_enabled = true;
     _controller_dev_addr = dev_addr;
     _controller_instance = instance;
@@ -130,13 +253,8 @@ void GamepadUSBHostListener::xmount(uint8_t dev_addr, uint8_t instance, uint8_t
     printf("XMount: VID_%04x PID_%04x Type:%d Subtype:%d\n", controller_vid, controller_pid, controllerType, subtype);
 #endif
 
-    uint16_t joystick_mid = GAMEPAD_JOYSTICK_MID;
-    _controller_host_state.buttons = 0;
-    _controller_host_state.dpad = 0;
-    _controller_host_state.lx = joystick_mid;
-    _controller_host_state.ly = joystick_mid;
-    _controller_host_state.rx = joystick_mid;
-    _controller_host_state.ry = joystick_mid;
+    reset_state();
+    publish();
 
     if (controllerType != xinput_type_t::UNKNOWN) {
         switch (controllerType) {
@@ -152,11 +270,12 @@ void GamepadUSBHostListener::xmount(uint8_t dev_addr, uint8_t instance, uint8_t
     }
 }
 
-void GamepadUSBHostListener::unmount(uint8_t dev_addr) {
+void GamepadUSBHostController::unmount() {
 #if GAMEPAD_HOST_DEBUG
-    printf("Unmount: %x\n", dev_addr);
+    printf("Unmount: %x\n", _controller_dev_addr);
 #endif
     _controller_host_enabled = false;
+    hidDecoder.release();
     controller_pid = 0x00;
     controller_vid = 0x00;
     _controller_dev_addr = 0;
@@ -168,16 +287,22 @@ void GamepadUSBHostListener::unmount(uint8_t dev_addr) {
     switchProState = SwitchOutputSubtypes::IDENTIFY;
     switchReportCounter = 0;
     lastSwitchLed = 0;
+    awaiting_cb = false;
+    memset(&prev_ds4_report, 0, sizeof(prev_ds4_report));
+    memset(&prev_ds_report, 0, sizeof(prev_ds_report));
+    memset(&prev_switch_report, 0, sizeof(prev_switch_report));
+    memset(&prev_xinput_report, 0, sizeof(prev_xinput_report));
+    last_left_rumble = 0;
+    last_right_rumble = 0;
+    publish();
 }
 
-void GamepadUSBHostListener::report_received(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
-    // if a hid device hasn't been mounted
-    if ( _controller_host_enabled == false ) return;
-
+void GamepadUSBHostController::report_received(uint8_t const* report, uint16_t len) {
     // handle xinput
     switch (_controller_type) {
         case xinput_type_t::XBOX360:
             process_xbox360(report, len);
+            publish();
             return;
         case xinput_type_t::XBOXONE:
             // not implemented
@@ -186,16 +311,11 @@ void GamepadUSBHostListener::report_received(uint8_t dev_addr, uint8_t instance,
             break;
     }
 
-    // Interface protocol (hid_interface_protocol_enum_t)
-    uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
-
-    // stop execution if a keyboard or mouse is mounted
-    if ( itf_protocol == HID_ITF_PROTOCOL_KEYBOARD ) return;
-
-    process_ctrlr_report(dev_addr, report, len);
+    process_ctrlr_report(report, len);
+    publish();
 }
 
-void GamepadUSBHostListener::process_ctrlr_report(uint8_t dev_addr, uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_ctrlr_report(uint8_t const* report, uint16_t len) {
 #if GAMEPAD_HOST_DEBUG
     //printf("\033[1;0H\nHost (%d):\n", len);
     //for (uint8_t i = 0; i < len; i++) {
@@ -240,6 +360,9 @@ void GamepadUSBHostListener::process_ctrlr_report(uint8_t dev_addr, uint8_t cons
             process_ultrastik360(report, len);
             break;
         default:
+            if (hidDecoder.decode(report, len, _controller_host_state)) {
+                _controller_host_analog = hidDecoder.analog();
+            }
             break;
     }
 }
@@ -247,7 +370,7 @@ void GamepadUSBHostListener::process_ctrlr_report(uint8_t dev_addr, uint8_t cons
 // this is primarily for xinput updates as the controller refuses the send unnecessary
 // data, so update wouldn't be called otherwise. but works for every controller and
 // provides a more consistent way of quick rumble updates
-void GamepadUSBHostListener::update_ctrlr() {
+void GamepadUSBHostController::update_ctrlr() {
     switch (_controller_type) {
         case xinput_type_t::XBOX360:
             update_xinput(_controller_dev_addr, _controller_instance);
@@ -276,21 +399,21 @@ void GamepadUSBHostListener::update_ctrlr() {
     }
 }
 
-bool GamepadUSBHostListener::host_get_report(uint8_t report_id, void* report, uint16_t len) {
+bool GamepadUSBHostController::host_get_report(uint8_t report_id, void* report, uint16_t len) {
     awaiting_cb = true;
     return tuh_hid_get_report(_controller_dev_addr, _controller_instance, report_id, HID_REPORT_TYPE_FEATURE, report, len);
 }
 
-bool GamepadUSBHostListener::host_set_report(uint8_t report_id, void* report, uint16_t len) {
+bool GamepadUSBHostController::host_set_report(uint8_t report_id, void* report, uint16_t len) {
     awaiting_cb = true;
     return tuh_hid_set_report(_controller_dev_addr, _controller_instance, report_id, HID_REPORT_TYPE_FEATURE, report, len);
 }
 
-void GamepadUSBHostListener::set_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {
+void GamepadUSBHostController::set_report_complete(uint8_t report_id, uint8_t report_type, uint16_t len) {
     awaiting_cb = false;
 }
 
-void GamepadUSBHostListener::get_report_complete(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {
+void GamepadUSBHostController::get_report_complete(uint8_t report_id, uint8_t report_type, uint16_t len) {
 #if GAMEPAD_HOST_DEBUG
     //printf("get_report_complete Report ID: %02x\n", report_id);
 #endif
@@ -307,18 +430,18 @@ void GamepadUSBHostListener::get_report_complete(uint8_t dev_addr, uint8_t insta
     awaiting_cb = false;
 }
 
-uint32_t GamepadUSBHostListener::map(uint32_t x, uint32_t in_min, uint32_t in_max, uint32_t out_min, uint32_t out_max) {
+uint32_t GamepadUSBHostController::map(uint32_t x, uint32_t in_min, uint32_t in_max, uint32_t out_min, uint32_t out_max) {
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
 
 
 //check if different than 2
-bool GamepadUSBHostListener::diff_than_2(uint8_t x, uint8_t y) {
+bool GamepadUSBHostController::diff_than_2(uint8_t x, uint8_t y) {
     return (x - y > 2) || (y - x > 2);
 }
 
 // check if 2 reports are different enough
-bool GamepadUSBHostListener::diff_report(PS4Report const* rpt1, PS4Report const* rpt2) {
+bool GamepadUSBHostController::diff_report(PS4Report const* rpt1, PS4Report const* rpt2) {
     bool result;
 
     // x, y, z, rz must different than 2 to be counted
@@ -331,7 +454,7 @@ bool GamepadUSBHostListener::diff_report(PS4Report const* rpt1, PS4Report const*
     return result;
 }
 
-void GamepadUSBHostListener::setup_ds4() {
+void GamepadUSBHostController::setup_ds4() {
     if (hasDS4DefReport) {
         // report came from the controller so copy the buffer
         memcpy(&ds4Config, report_buffer+1, sizeof(PS4ControllerConfig));
@@ -353,7 +476,7 @@ void GamepadUSBHostListener::setup_ds4() {
     }
 }
 
-void GamepadUSBHostListener::init_ds4(const uint8_t* descReport, uint16_t descLen) {
+void GamepadUSBHostController::init_ds4(const uint8_t* descReport, uint16_t descLen) {
     isDS4Identified = false;
 
     tuh_hid_report_info_t report_info[4];
@@ -378,7 +501,7 @@ void GamepadUSBHostListener::init_ds4(const uint8_t* descReport, uint16_t descLe
     }
 }
 
-void GamepadUSBHostListener::update_ds4() {
+void GamepadUSBHostController::update_ds4() {
 #if GAMEPAD_HOST_USE_FEATURES
     Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
     PS4FeatureOutputReport controller_output;
@@ -411,18 +534,15 @@ void GamepadUSBHostListener::update_ds4() {
 #endif
 }
 
-void GamepadUSBHostListener::process_ds4(uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_ds4(uint8_t const* report, uint16_t len) {
     PS4Report controller_report;
 
-    // previous report used to compare for changes
-    static PS4Report prev_report = { 0 };
-
     uint8_t const report_id = report[0];
 
     if (report_id == 1) {
         memcpy(&controller_report, report, sizeof(controller_report));
 
-        if ( diff_report(&prev_report, &controller_report) ) {
+        if ( diff_report(&prev_ds4_report, &controller_report) ) {
             _controller_host_state.lx = map(controller_report.leftStickX, 0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
             _controller_host_state.ly = map(controller_report.leftStickY, 0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
             _controller_host_state.rx = map(controller_report.rightStickX,0,255,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
@@ -459,15 +579,12 @@ void GamepadUSBHostListener::process_ds4(uint8_t const* report, uint16_t len) {
         }
     }
 
-    prev_report = controller_report;
+    prev_ds4_report = controller_report;
 }
 
-void GamepadUSBHostListener::process_ds(uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_ds(uint8_t const* report, uint16_t len) {
     DSReport controller_report;
 
-    // previous report used to compare for changes
-    static DSReport prev_ds_report = { 0 };
-
     uint8_t const report_id = report[0];
 
     if (report_id == 1) {
@@ -515,7 +632,7 @@ void GamepadUSBHostListener::process_ds(uint8_t const* report, uint16_t len) {
 
 // init phase
 // https://github.com/wiredopposite/OGX-Mini/blob/ccccf6651b54bcca3c94b5d4e73e8f2796fc8c05/Firmware/RP2040/src/USBHost/HostDriver/SwitchPro/SwitchPro.cpp#L23
-void GamepadUSBHostListener::setup_switch_pro(uint8_t const *report, uint16_t len) {
+void GamepadUSBHostController::setup_switch_pro(uint8_t const *report, uint16_t len) {
     SwitchProHostReport out_report{
         .rumble_l = {0x00, 0x01, 0x40, 0x40}, // default rumble states
         .rumble_r = {0x00, 0x01, 0x40, 0x40},
@@ -574,7 +691,7 @@ void GamepadUSBHostListener::setup_switch_pro(uint8_t const *report, uint16_t le
     }
 }
 
-void GamepadUSBHostListener::update_switch_pro()
+void GamepadUSBHostController::update_switch_pro()
 {
 #if GAMEPAD_HOST_USE_FEATURES
     if (!switchProFinished) return;
@@ -644,7 +761,7 @@ void GamepadUSBHostListener::update_switch_pro()
 #endif
 }
 
-void GamepadUSBHostListener::process_switch_pro(uint8_t const *report, uint16_t len)
+void GamepadUSBHostController::process_switch_pro(uint8_t const *report, uint16_t len)
 {
     if (len == 0) return;
     if (!switchProFinished) {
@@ -657,8 +774,6 @@ void GamepadUSBHostListener::process_switch_pro(uint8_t const *report, uint16_t
 
     SwitchProReport controller_report;
 
-    static SwitchProReport prev_report = { 0 };
-
     if (len < sizeof(SwitchProReport)) {
 #ifdef GAMEPAD_HOST_DEBUG
         printf("ignoring report with len %d (%x)...\n", len, report[0]);
@@ -673,7 +788,7 @@ void GamepadUSBHostListener::process_switch_pro(uint8_t const *report, uint16_t
     }
     memcpy(&controller_report, report, sizeof(controller_report));
 
-    if (memcmp(&prev_report, &controller_report, sizeof(SwitchProReport)) == 0)
+    if (memcmp(&prev_switch_report, &controller_report, sizeof(SwitchProReport)) == 0)
         return;
 
     _controller_host_state.dpad = 0;
@@ -709,10 +824,10 @@ void GamepadUSBHostListener::process_switch_pro(uint8_t const *report, uint16_t
     _controller_host_state.ry = map(ry12, 0, 4095, GAMEPAD_JOYSTICK_MIN, GAMEPAD_JOYSTICK_MAX);
     _controller_host_analog = false;
 
-    prev_report = controller_report;
+    prev_switch_report = controller_report;
 }
 
-uint8_t GamepadUSBHostListener::get_next_switch_counter()
+uint8_t GamepadUSBHostController::get_next_switch_counter()
 {
     if (switchReportCounter < 255) {
     switchReportCounter++;
@@ -722,7 +837,7 @@ uint8_t GamepadUSBHostListener::get_next_switch_counter()
     return switchReportCounter;
 }
 
-void GamepadUSBHostListener::process_stadia(uint8_t const *report, uint16_t len)
+void GamepadUSBHostController::process_stadia(uint8_t const *report, uint16_t len)
 {
     google_stadia_report_t controller_report;
 
@@ -762,7 +877,7 @@ void GamepadUSBHostListener::process_stadia(uint8_t const *report, uint16_t len)
     if (controller_report.GD_GamePadHatSwitch == 7) _controller_host_state.dpad |= GAMEPAD_MASK_LEFT | GAMEPAD_MASK_UP;
 }
 
-void GamepadUSBHostListener::setup_df_wheel() {
+void GamepadUSBHostController::setup_df_wheel() {
     // send commands to see if can be reset to Driving Force GT mode for more compatibility
     uint8_t command[8] = {0xF8, 0x09, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00};
     uint16_t commandSize = sizeof(command);
@@ -772,7 +887,7 @@ void GamepadUSBHostListener::setup_df_wheel() {
     }
 }
 
-void GamepadUSBHostListener::process_dfgt(uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_dfgt(uint8_t const* report, uint16_t len) {
     PS3ReportAlt ps3Report;
     memcpy(&ps3Report, report, len);
 #if GAMEPAD_HOST_DEBUG
@@ -790,7 +905,7 @@ void GamepadUSBHostListener::process_dfgt(uint8_t const* report, uint16_t len) {
 #endif
 }
 
-void GamepadUSBHostListener::process_ultrastik360(uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_ultrastik360(uint8_t const* report, uint16_t len) {
 
     ultrastik360_t controller_report;
 
@@ -810,7 +925,7 @@ void GamepadUSBHostListener::process_ultrastik360(uint8_t const* report, uint16_
     if (controller_report.BTN_GamePadButton8 == 1) _controller_host_state.buttons |= GAMEPAD_MASK_R2;
 }
 
-void GamepadUSBHostListener::xbox360_set_led(uint8_t dev_addr, uint8_t instance, uint8_t quadrant) {
+void GamepadUSBHostController::xbox360_set_led(uint8_t dev_addr, uint8_t instance, uint8_t quadrant) {
     uint8_t out[32] = { 0 };
 
     memcpy(out, XBOX360_WIRED_LED, sizeof(XBOX360_WIRED_LED));
@@ -821,7 +936,7 @@ void GamepadUSBHostListener::xbox360_set_led(uint8_t dev_addr, uint8_t instance,
     }
 }
 
-void GamepadUSBHostListener::xinput_set_rumble(uint8_t dev_addr, uint8_t instance, uint8_t left, uint8_t right) {
+void GamepadUSBHostController::xinput_set_rumble(uint8_t dev_addr, uint8_t instance, uint8_t left, uint8_t right) {
     uint8_t out[32] = { 0 };
     uint16_t len = 0;
     switch (_controller_type) {
@@ -849,7 +964,7 @@ void GamepadUSBHostListener::xinput_set_rumble(uint8_t dev_addr, uint8_t instanc
     }
 }
 
-void GamepadUSBHostListener::setup_xinput(uint8_t dev_addr, uint8_t instance) {
+void GamepadUSBHostController::setup_xinput(uint8_t dev_addr, uint8_t instance) {
     Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
 
     switch (_controller_type) {
@@ -874,12 +989,9 @@ void GamepadUSBHostListener::setup_xinput(uint8_t dev_addr, uint8_t instance) {
     tuh_xinput_receive_report(dev_addr, instance);
 }
 
-void GamepadUSBHostListener::update_xinput(uint8_t dev_addr, uint8_t instance) {
+void GamepadUSBHostController::update_xinput(uint8_t dev_addr, uint8_t instance) {
     Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
 
-    static uint8_t last_left_rumble = 0;
-    static uint8_t last_right_rumble = 0;
-
     // rumble
     gamepad->auxState.haptics.leftActuator.enabled = 1;
     gamepad->auxState.haptics.rightActuator.enabled = 1;
@@ -901,11 +1013,9 @@ void GamepadUSBHostListener::update_xinput(uint8_t dev_addr, uint8_t instance) {
     xinput_set_rumble(dev_addr, instance, leftRumble, rightRumble);
 }
 
-void GamepadUSBHostListener::process_xbox360(uint8_t const* report, uint16_t len) {
+void GamepadUSBHostController::process_xbox360(uint8_t const* report, uint16_t len) {
     XInputReport controller_report;
 
-    static XInputReport prev_report = { 0 };
-
     if (len < sizeof(XInputReport)) {
 #if GAMEPAD_HOST_DEBUG
         printf("Xbox 360 report too small: %d bytes\n", len);
@@ -915,7 +1025,7 @@ void GamepadUSBHostListener::process_xbox360(uint8_t const* report, uint16_t len
 
     memcpy(&controller_report, report, sizeof(controller_report));
 
-    if (memcmp(&prev_report, &controller_report, sizeof(XInputReport)) == 0)
+    if (memcmp(&prev_xinput_report, &controller_report, sizeof(XInputReport)) == 0)
         return;
 
     _controller_host_state.dpad = 0;
@@ -946,5 +1056,5 @@ void GamepadUSBHostListener::process_xbox360(uint8_t const* report, uint16_t len
     _controller_host_state.rt = controller_report.rt;
     _controller_host_analog = true;
 
-    prev_report = controller_report;
+    prev_xinput_report = controller_report;
 }
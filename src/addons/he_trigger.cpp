@@ -1,9 +1,31 @@
 #include "addons/he_trigger.h"
 #include "storagemanager.h"
+#include "drivermanager.h"
+#include "helper.h"
 
 #include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#include <string.h>
 
 #define ADC_MAX ((1 << 12) - 1) // 4095
+#define ADC_CONVERSION_US 2     // 96 cycles of the 48MHz ADC clock
+
+// Up to 8 settle rounds plus the oversampled rounds of 4 inputs
+#define STEP_BUFFER_SAMPLES ((HETRIGGER_OVERSAMPLE + 8) * 4)
+
+static constexpr uint32_t ringBits(uint32_t bytes) {
+    uint32_t bits = 0;
+    while ( (1u << bits) < bytes )
+        bits++;
+    return bits;
+}
+
+// Each step buffer is the DMA write ring of its channel: when the IRQ is late and the
+// chained channel restarts from its advanced write address, it wraps inside its own buffer
+static constexpr uint32_t STEP_RING_BITS = ringBits(STEP_BUFFER_SAMPLES * sizeof(uint16_t));
+static uint16_t stepBuffers[2][(1u << STEP_RING_BITS) / sizeof(uint16_t)] __attribute__((aligned(1u << STEP_RING_BITS)));
 
 bool HETriggerAddon::available() {
     return Storage::getInstance().getAddonOptions().heTriggerOptions.enabled;
@@ -11,6 +33,8 @@ bool HETriggerAddon::available() {
 
 void HETriggerAddon::setup() {
     HETriggerOptions & options = Storage::getInstance().getAddonOptions().heTriggerOptions;
+    const AddonOptions & addonOptions = Storage::getInstance().getAddonOptions();
+    this->muxChannels = options.muxChannels;
     this->muxTotal = 32 / options.muxChannels;
     if ( this->muxTotal > 4 )
         this->muxTotal = 4; // Direct = 4, 4-Channel = 4, 8-Channel = 3, 16-Channel = 2
@@ -20,9 +44,25 @@ void HETriggerAddon::setup() {
     muxPinArray[1] = options.muxADCPin1;
     muxPinArray[2] = options.muxADCPin2;
     muxPinArray[3] = options.muxADCPin3;
+    uint32_t adcMask = 0;
     for(int i = 0; i < muxTotal; i++) {
         if ( muxPinArray[i] >= 26 && muxPinArray[i] <= 29 ) {
             adc_gpio_init(muxPinArray[i]);
+            adcMask |= 1 << (muxPinArray[i] - 26);
+        }
+    }
+
+    // Round robin converts the inputs in ascending order
+    adcInputCount = 0;
+    for(int input = 0; input < 4; input++) {
+        if ( adcMask & (1 << input) ) {
+            slotInputs[adcInputCount++] = input;
+        }
+    }
+    for(int i = 0; i < 4; i++) {
+        muxSlot[i] = -1;
+        if ( i < muxTotal && muxPinArray[i] >= 26 && muxPinArray[i] <= 29 ) {
+            muxSlot[i] = __builtin_popcount(adcMask & ((1 << (muxPinArray[i] - 26)) - 1));
         }
     }
 
@@ -55,27 +95,38 @@ void HETriggerAddon::setup() {
         }
     }
 
-    lastADCSelected = -1;
-
-    if ( options.emaSmoothing == 1 ) {
-        // Read all ADC values once
-        for(int i = 0; i < 32; i++) {
-            // Ignore triggers with no actions
-            if (options.triggers[i].action == -10 )
-                continue;
-            mux = (i / options.muxChannels);
-            channel = (i % options.muxChannels);
-            selectChannel(channel);
-            // Only Switch ADC if we are not currently on the mux ADC
-            if ( lastADCSelected != muxPinArray[mux]) {
-                adc_select_input(muxPinArray[mux]-26);
-                lastADCSelected = muxPinArray[mux];
+    // Only visit mux channels that carry a trigger with an action
+    scanChannelCount = 0;
+    for(uint32_t channel = 0; channel < options.muxChannels && channel < 16; channel++) {
+        for(uint32_t he = channel; he < 32; he += options.muxChannels) {
+            if ( options.triggers[he].action != -10 ) {
+                scanChannels[scanChannelCount++] = channel;
+                break;
             }
-            emaSmoothingReads[i] = adc_read();
-            lastIncrement[i] = adc_read();
-            triggerActive[i] = false;
         }
-        emaSmoothingFactor = (float)options.smoothingFactor / 100.f; // 99 = max smoothing factor
+    }
+
+    memset(scanFrames, 0, sizeof(scanFrames));
+    scanFront = 0;
+    scannerRunning = false;
+    emaSmoothingFactor = ((uint32_t)options.smoothingFactor << 8) / 100; // 99 = max smoothing factor
+
+    // Prime every trigger with one unsmoothed scan
+    emaEnabled = false;
+    scanPolled();
+    for(int i = 0; i < 32; i++) {
+        emaSmoothingReads[i] = (uint32_t)scanFrames[0][i] << 4;
+        lastIncrement[i] = scanFrames[0][i];
+        triggerActive[i] = false;
+    }
+    emaEnabled = options.emaSmoothing == 1;
+
+    // The analog stick and turbo dial add-ons use blocking ADC reads, and web config
+    // reads trigger voltages directly, so the ADC can only run free when it is ours
+    bool sharedADC = addonOptions.analogOptions.enabled ||
+        (addonOptions.turboOptions.enabled && isValidPin(addonOptions.turboOptions.shmupDialPin));
+    if ( !sharedADC && !DriverManager::getInstance().isConfigMode() && adcInputCount > 0 && scanChannelCount > 0 ) {
+        startScanner();
     }
 }
 
@@ -87,29 +138,189 @@ void HETriggerAddon::selectChannel(uint8_t channel) {
     }
 }
 
-uint16_t HETriggerAddon::emaSmoothing(uint16_t value, uint16_t previous) {
-    float ema_value = (float)value / ADC_MAX;
-    float ema_previous = (float)previous / ADC_MAX;
-    return ((emaSmoothingFactor*ema_value) + ((1.0f-emaSmoothingFactor) * ema_previous)) * ADC_MAX;
+uint16_t HETriggerAddon::emaSmoothing(uint8_t he, uint16_t value) {
+    int32_t difference = ((int32_t)value << 4) - (int32_t)emaSmoothingReads[he];
+    emaSmoothingReads[he] += (difference * emaSmoothingFactor) >> 8;
+    return (emaSmoothingReads[he] + 8) >> 4;
+}
+
+// Average the oversampled sums of one mux channel into every trigger it carries
+void HETriggerAddon::storeChannel(uint8_t channel, const uint32_t * sums, uint16_t * frame) {
+    for(int mux = 0; mux < muxTotal; mux++) {
+        uint32_t he = mux * muxChannels + channel;
+        if ( muxSlot[mux] < 0 || he >= 32 )
+            continue;
+        uint16_t raw = sums[muxSlot[mux]] / HETRIGGER_OVERSAMPLE;
+        frame[he] = emaEnabled ? emaSmoothing(he, raw) : raw;
+    }
+}
+
+void HETriggerAddon::scanPolled() {
+    uint32_t sums[4];
+    for(uint8_t i = 0; i < scanChannelCount; i++) {
+        selectChannel(scanChannels[i]);
+        if ( scanChannelCount > 1 && selectPins > 0 ) {
+            busy_wait_us(HETRIGGER_MUX_SETTLE_US);
+        }
+        for(uint8_t slot = 0; slot < adcInputCount; slot++) {
+            adc_select_input(slotInputs[slot]);
+            sums[slot] = 0;
+            for(int n = 0; n < HETRIGGER_OVERSAMPLE; n++) {
+                sums[slot] += adc_read();
+            }
+        }
+        storeChannel(scanChannels[i], sums, scanFrames[0]);
+    }
+    scanFront = 0;
+}
+
+static HETriggerAddon * scannerInstance = nullptr;
+
+void HETriggerAddon::startScanner() {
+    // Two step buffers chained into each other so the FIFO is never left waiting. Without two
+    // free DMA channels the triggers stay on the polled scan in preprocess()
+    dmaChannels[0] = dma_claim_unused_channel(false);
+    dmaChannels[1] = dma_claim_unused_channel(false);
+    if ( dmaChannels[0] < 0 || dmaChannels[1] < 0 ) {
+        if ( dmaChannels[0] >= 0 ) dma_channel_unclaim(dmaChannels[0]);
+        if ( dmaChannels[1] >= 0 ) dma_channel_unclaim(dmaChannels[1]);
+        return;
+    }
+
+    // One round robin pass covers the IRQ latency before the select lines move, then the mux settles
+    settleRounds = 0;
+    if ( scanChannelCount > 1 && selectPins > 0 ) {
+        uint32_t roundUs = ADC_CONVERSION_US * adcInputCount;
+        settleRounds = 1 + (HETRIGGER_MUX_SETTLE_US + roundUs - 1) / roundUs;
+        if ( settleRounds > 8 )
+            settleRounds = 8;
+    }
+    stepSamples = (settleRounds + HETRIGGER_OVERSAMPLE) * adcInputCount;
+
+    uint32_t adcMask = 0;
+    for(uint8_t slot = 0; slot < adcInputCount; slot++) {
+        adcMask |= 1 << slotInputs[slot];
+    }
+    adc_run(false);
+    adc_select_input(slotInputs[0]);
+    adc_set_round_robin(adcMask);
+    adc_set_clkdiv(0); // back to back conversions
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+
+    for(int i = 0; i < 2; i++) {
+        dma_channel_config config = dma_channel_get_default_config(dmaChannels[i]);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, true);
+        channel_config_set_ring(&config, true, STEP_RING_BITS);
+        channel_config_set_dreq(&config, DREQ_ADC);
+        channel_config_set_chain_to(&config, dmaChannels[i ^ 1]);
+        dma_channel_configure(dmaChannels[i], &config, stepBuffers[i], &adc_hw->fifo, stepSamples, false);
+        dma_channel_set_irq1_enabled(dmaChannels[i], true);
+    }
+
+    scannerInstance = this;
+    irq_add_shared_handler(DMA_IRQ_1, dmaIRQ, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    scannerRunning = true;
+    restartSteps();
+}
+
+// Start over from the first channel in buffer 0, with nothing in flight
+void HETriggerAddon::restartSteps() {
+    adc_run(false);
+    for(int i = 0; i < 2; i++) {
+        dma_channel_set_irq1_enabled(dmaChannels[i], false);
+    }
+    // Aborting one channel can still trigger the other through its chain
+    for(int pass = 0; pass < 2; pass++) {
+        dma_channel_abort(dmaChannels[0]);
+        dma_channel_abort(dmaChannels[1]);
+    }
+    for(int i = 0; i < 2; i++) {
+        dma_irqn_acknowledge_channel(1, dmaChannels[i]);
+        dma_channel_set_write_addr(dmaChannels[i], stepBuffers[i], false);
+        dma_channel_set_trans_count(dmaChannels[i], stepSamples, false);
+        dma_channel_set_irq1_enabled(dmaChannels[i], true);
+    }
+    adc_select_input(slotInputs[0]);
+    adc_fifo_drain();
+
+    bufferChannel[0] = scanChannels[0];
+    bufferChannel[1] = scanChannels[1 % scanChannelCount];
+    scanChannelIndex = 1 % scanChannelCount;
+    selectChannel(bufferChannel[0]);
+
+    dma_channel_start(dmaChannels[0]);
+    adc_run(true);
+}
+
+void HETriggerAddon::dmaIRQ() {
+    HETriggerAddon * scanner = scannerInstance;
+    bool done[2];
+    for(int i = 0; i < 2; i++) {
+        done[i] = dma_irqn_get_channel_status(1, scanner->dmaChannels[i]);
+    }
+
+    // Both buffers finished since the last IRQ: the first one was chained again before its
+    // write address was rewound, so the buffers are out of step with the select lines
+    if ( done[0] && done[1] ) {
+        scanner->restartSteps();
+        return;
+    }
+
+    for(int i = 0; i < 2; i++) {
+        if ( done[i] ) {
+            dma_irqn_acknowledge_channel(1, scanner->dmaChannels[i]);
+            scanner->completeStep(i);
+        }
+    }
+}
+
+// DMA IRQ: buffer finished, the other one has just started on the next channel
+void HETriggerAddon::completeStep(uint8_t buffer) {
+    uint8_t running = buffer ^ 1;
+    selectChannel(bufferChannel[running]);
+
+    uint32_t sums[4] = {0, 0, 0, 0};
+    const uint16_t * samples = stepBuffers[buffer] + settleRounds * adcInputCount;
+    for(int n = 0; n < HETRIGGER_OVERSAMPLE; n++) {
+        for(uint8_t slot = 0; slot < adcInputCount; slot++) {
+            sums[slot] += *samples++;
+        }
+    }
+
+    uint8_t channel = bufferChannel[buffer];
+    uint8_t back = scanFront ^ 1;
+    storeChannel(channel, sums, scanFrames[back]);
+    if ( channel == scanChannels[scanChannelCount - 1] ) {
+        scanFront = back;
+    }
+
+    // Re-arm for the channel after the running one, it starts when that buffer completes
+    scanChannelIndex = (scanChannelIndex + 1) % scanChannelCount;
+    bufferChannel[buffer] = scanChannels[scanChannelIndex];
+    dma_channel_set_write_addr(dmaChannels[buffer], stepBuffers[buffer], false);
 }
 
 void HETriggerAddon::preprocess() {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     HETriggerOptions & options = Storage::getInstance().getAddonOptions().heTriggerOptions;
+
+    // Another add-on reads the ADC directly, scan in the loop instead
+    if ( !scannerRunning ) {
+        scanPolled();
+    }
+    const uint16_t * frame = scanFrames[scanFront];
+
     for (uint8_t he = 0; he < 32; he++) {
         // Ignore triggers with no actions
         if (options.triggers[he].action == -10 )
             continue;
-        mux = (he / options.muxChannels);
-        channel = (he % options.muxChannels);
-        selectChannel(channel);
-        // Only Switch ADC if we are not currently on the mux ADC
-        if ( lastADCSelected != muxPinArray[mux]) {
-            adc_select_input(muxPinArray[mux]-26);
-            lastADCSelected = muxPinArray[mux];
-        }
 
-        value = adc_read();
+        value = frame[he];
         activationThreshold = (uint16_t)options.triggers[he].active;
         releaseThreshold = (uint16_t)options.triggers[he].active;
 
@@ -117,12 +328,6 @@ void HETriggerAddon::preprocess() {
             releaseThreshold = (uint16_t)options.triggers[he].release;
         }
 
-        // EMA Smoothing
-        if ( options.emaSmoothing == 1 ) {
-            value = emaSmoothing(value, emaSmoothingReads[he]);
-            emaSmoothingReads[he] = value;
-        }
-
         if (options.triggers[he].is_polarized) {
             // effectively inverting value and thresholds
             value = ADC_MAX - value;
@@ -3,6 +3,12 @@
 #include "helper.h"
 #include "config.pb.h"
 
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+
+volatile bool PCF8575Addon::inputChanged = true;
+static int32_t pcf8575InterruptPin = -1;
+
 bool PCF8575Addon::available() {
     const PCF8575Options& options = Storage::getInstance().getAddonOptions().pcf8575Options;
     if (options.enabled) {
@@ -38,16 +44,70 @@ void PCF8575Addon::setup() {
         // set default mask
         pcf->send(pinMask);
     }
+
+    for (std::map<uint8_t, GpioMappingInfo>::iterator pin = pinRef.begin(); pin != pinRef.end(); ++pin) {
+        if (pin->second.direction == GpioDirection::GPIO_DIRECTION_INPUT) inputMask |= (1 << pin->first);
+    }
+
+    // without INT the pins are read every loop
+    if (isValidPin(options.interruptPin) && (inputMask != 0)) {
+        interruptPin = options.interruptPin;
+        pcf8575InterruptPin = interruptPin;
+        gpio_init(interruptPin);
+        gpio_set_dir(interruptPin, GPIO_IN);
+        gpio_pull_up(interruptPin);
+        gpio_add_raw_irq_handler(interruptPin, interruptIRQ);
+        gpio_set_irq_enabled(interruptPin, GPIO_IRQ_EDGE_FALL, true);
+        irq_set_enabled(IO_IRQ_BANK0, true);
+    }
+    inputChanged = true;
+    nextWatchdog = getMillis();
+}
+
+void PCF8575Addon::interruptIRQ() {
+    if (!(gpio_get_irq_event_mask(pcf8575InterruptPin) & GPIO_IRQ_EDGE_FALL))
+        return;
+    gpio_acknowledge_irq(pcf8575InterruptPin, GPIO_IRQ_EDGE_FALL);
+    inputChanged = true;
+}
+
+void PCF8575Addon::readInputs() {
+    // a finished read lands in pcf->pins()
+    if (pcf->receivePending()) return;
+
+    uint32_t now = getMillis();
+    bool readNeeded = (interruptPin < 0) || inputChanged || !gpio_get(interruptPin) || ((int32_t)(now - nextWatchdog) >= 0);
+    if (readNeeded) {
+        // INT is released by the read, a change after this point raises it again
+        inputChanged = false;
+        if (pcf->requestReceive()) {
+            nextWatchdog = now + PCF8575_WATCHDOG_MS;
+        } else {
+            inputChanged = true;
+        }
+        // a bus without DMA has already finished it
+        pcf->receivePending();
+    }
+
+    uint16_t pressed = ~pcf->pins() & inputMask;
+    uint32_t debounceDelay = Storage::getInstance().getGamepadOptions().debounceDelay;
+    if (debounceDelay == 0) {
+        debouncedInputs = pressed;
+    } else if (debouncedInputs != pressed) {
+        debouncedInputs = debounceMask(debouncedInputs, pressed, inputMask, inputDebounceTime, debounceDelay, now);
+    }
 }
 
 void PCF8575Addon::process()
 {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    uint16_t outputs = pcf->pinsSent();
+
+    if (inputMask != 0) readInputs();
 
     for (std::map<uint8_t, GpioMappingInfo>::iterator pin = pinRef.begin(); pin != pinRef.end(); ++pin) {
         if (pin->second.direction == GpioDirection::GPIO_DIRECTION_INPUT) {
-            uint8_t pinRaw = pcf->getPin(pin->first);
-            bool pinValue = (bool)(!(pinRaw == 1));
+            bool pinValue = (debouncedInputs & (1 << pin->first)) != 0;
             switch (pin->second.action) {
                 case GpioAction::BUTTON_PRESS_UP:    inputButtonUp = pinValue; break;
                 case GpioAction::BUTTON_PRESS_DOWN:  inputButtonDown = pinValue; break;
@@ -71,32 +131,41 @@ void PCF8575Addon::process()
                 default:                             break;
             }
         } else if (pin->second.direction == GpioDirection::GPIO_DIRECTION_OUTPUT) {
+            bool pinValue = (outputs & (1 << pin->first)) != 0;
             switch (pin->second.action) {
-                case GpioAction::BUTTON_PRESS_UP:    pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_UP) == GAMEPAD_MASK_UP)); break;
-                case GpioAction::BUTTON_PRESS_DOWN:  pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_DOWN) == GAMEPAD_MASK_DOWN)); break;
-                case GpioAction::BUTTON_PRESS_LEFT:  pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_LEFT) == GAMEPAD_MASK_LEFT)); break;
-                case GpioAction::BUTTON_PRESS_RIGHT: pcf->setPin(pin->first, !((gamepad->state.dpad & GAMEPAD_MASK_RIGHT) == GAMEPAD_MASK_RIGHT)); break;
-                case GpioAction::BUTTON_PRESS_B1:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_B1) == GAMEPAD_MASK_B1)); break;
-                case GpioAction::BUTTON_PRESS_B2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_B2) == GAMEPAD_MASK_B2)); break;
-                case GpioAction::BUTTON_PRESS_B3:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_B3) == GAMEPAD_MASK_B3)); break;
-                case GpioAction::BUTTON_PRESS_B4:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_B4) == GAMEPAD_MASK_B4)); break;
-                case GpioAction::BUTTON_PRESS_L1:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_L1) == GAMEPAD_MASK_L1)); break;
-                case GpioAction::BUTTON_PRESS_R1:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_R1) == GAMEPAD_MASK_R1)); break;
-                case GpioAction::BUTTON_PRESS_L2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_L2) == GAMEPAD_MASK_L2)); break;
-                case GpioAction::BUTTON_PRESS_R2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_R2) == GAMEPAD_MASK_R2)); break;
-                case GpioAction::BUTTON_PRESS_S1:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_S1) == GAMEPAD_MASK_S1)); break;
-                case GpioAction::BUTTON_PRESS_S2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_S2) == GAMEPAD_MASK_S2)); break;
-                case GpioAction::BUTTON_PRESS_L3:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_L3) == GAMEPAD_MASK_L3)); break;
-                case GpioAction::BUTTON_PRESS_R3:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_R3) == GAMEPAD_MASK_R3)); break;
-                case GpioAction::BUTTON_PRESS_A1:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_A1) == GAMEPAD_MASK_A1)); break;
-                case GpioAction::BUTTON_PRESS_A2:    pcf->setPin(pin->first, !((gamepad->state.buttons & GAMEPAD_MASK_A2) == GAMEPAD_MASK_A2)); break;
+                case GpioAction::BUTTON_PRESS_UP:    pinValue = !((gamepad->state.dpad & GAMEPAD_MASK_UP) == GAMEPAD_MASK_UP); break;
+                case GpioAction::BUTTON_PRESS_DOWN:  pinValue = !((gamepad->state.dpad & GAMEPAD_MASK_DOWN) == GAMEPAD_MASK_DOWN); break;
+                case GpioAction::BUTTON_PRESS_LEFT:  pinValue = !((gamepad->state.dpad & GAMEPAD_MASK_LEFT) == GAMEPAD_MASK_LEFT); break;
+                case GpioAction::BUTTON_PRESS_RIGHT: pinValue = !((gamepad->state.dpad & GAMEPAD_MASK_RIGHT) == GAMEPAD_MASK_RIGHT); break;
+                case GpioAction::BUTTON_PRESS_B1:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_B1) == GAMEPAD_MASK_B1); break;
+                case GpioAction::BUTTON_PRESS_B2:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_B2) == GAMEPAD_MASK_B2); break;
+                case GpioAction::BUTTON_PRESS_B3:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_B3) == GAMEPAD_MASK_B3); break;
+                case GpioAction::BUTTON_PRESS_B4:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_B4) == GAMEPAD_MASK_B4); break;
+                case GpioAction::BUTTON_PRESS_L1:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_L1) == GAMEPAD_MASK_L1); break;
+                case GpioAction::BUTTON_PRESS_R1:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_R1) == GAMEPAD_MASK_R1); break;
+                case GpioAction::BUTTON_PRESS_L2:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_L2) == GAMEPAD_MASK_L2); break;
+                case GpioAction::BUTTON_PRESS_R2:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_R2) == GAMEPAD_MASK_R2); break;
+                case GpioAction::BUTTON_PRESS_S1:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_S1) == GAMEPAD_MASK_S1); break;
+                case GpioAction::BUTTON_PRESS_S2:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_S2) == GAMEPAD_MASK_S2); break;
+                case GpioAction::BUTTON_PRESS_L3:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_L3) == GAMEPAD_MASK_L3); break;
+                case GpioAction::BUTTON_PRESS_R3:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_R3) == GAMEPAD_MASK_R3); break;
+                case GpioAction::BUTTON_PRESS_A1:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_A1) == GAMEPAD_MASK_A1); break;
+                case GpioAction::BUTTON_PRESS_A2:    pinValue = !((gamepad->state.buttons & GAMEPAD_MASK_A2) == GAMEPAD_MASK_A2); break;
                 default:                             break;
             }
+            if (pinValue) {
+                outputs |= (1 << pin->first);
+            } else {
+                outputs &= ~(1 << pin->first);
+            }
         } else {
             // NYI
         }
     }
 
+    // outputs only go on the bus when one of them changes
+    if (outputs != pcf->pinsSent()) pcf->send(outputs);
+
     if (inputButtonUp) gamepad->state.dpad |= GAMEPAD_MASK_UP;
     if (inputButtonDown) gamepad->state.dpad |= GAMEPAD_MASK_DOWN;
     if (inputButtonLeft) gamepad->state.dpad |= GAMEPAD_MASK_LEFT;
@@ -2,7 +2,44 @@
 #include "storagemanager.h"
 #include "GamepadState.h"
 
+#include <algorithm>
+
 #include "hardware/gpio.h"
+#include "tusb.h"
+
+static inline uint64_t macroLengthNs(uint32_t us, bool frames) {
+    if (!frames)
+        return (uint64_t)us * 1000;
+    return ((us + INPUT_HOLD_US / 2) / INPUT_HOLD_US) * INPUT_MACRO_FRAME_NS;
+}
+
+// Rounds the running total rather than every step, so long macros do not drift
+static inline uint32_t nsToFrames(uint64_t ns) {
+    return (uint32_t)((ns + 500000) / 1000000);
+}
+
+static void compileStep(MacroStep& step, uint32_t buttonMask, uint32_t duration, uint32_t waitDuration, bool frames,
+                        uint64_t& elapsedNs, uint32_t& lastStepEnd) {
+    uint64_t pressNs = macroLengthNs(duration, frames);
+    uint64_t stepNs = pressNs + macroLengthNs(waitDuration, frames);
+    if (stepNs == 0)
+        stepNs = macroLengthNs(INPUT_HOLD_US, frames);
+
+    step.buttonMask = buttonMask;
+    step.dpad = 0;
+    if (buttonMask & GAMEPAD_MASK_DU) step.dpad |= GAMEPAD_MASK_UP;
+    if (buttonMask & GAMEPAD_MASK_DD) step.dpad |= GAMEPAD_MASK_DOWN;
+    if (buttonMask & GAMEPAD_MASK_DL) step.dpad |= GAMEPAD_MASK_LEFT;
+    if (buttonMask & GAMEPAD_MASK_DR) step.dpad |= GAMEPAD_MASK_RIGHT;
+
+    step.pressEnd = nsToFrames(elapsedNs + pressNs);
+    elapsedNs += stepNs;
+    // every step lasts at least one USB frame
+    step.stepEnd = nsToFrames(elapsedNs);
+    if (step.stepEnd <= lastStepEnd)
+        step.stepEnd = lastStepEnd + 1;
+    lastStepEnd = step.stepEnd;
+}
 
 bool InputMacro::available() {
     // Macro Button initialized by void Gamepad::setup()
@@ -68,7 +105,61 @@ void InputMacro::setup() {
     }
     boardLedEnabled = false;
     prevMacroInputPressed = false;
+    useFrameClock = false;
+    usbFrames.reset();
+    recordState = MACRO_RECORD_OFF;
+    recordSavePending = false;
+    compile(MacroStore::getInstance().get());
     reset();
+
+    EventManager::getInstance().registerEventHandler(GP_EVENT_MACRO_RECORD, GPEVENT_CALLBACK(this->handleMacroRecord(event)));
+}
+
+void InputMacro::compile(const MacroStoreData * store) {
+    uint16_t stepIndex = 0;
+    uint32_t storeIndex = 0;
+
+    for (int i = 0; i < MAX_MACRO_LIMIT; i++) {
+        MacroProgram& program = macroPrograms[i];
+        uint64_t elapsedNs = 0;
+        uint32_t lastStepEnd = 0;
+        program.firstStep = stepIndex;
+
+        if (store != nullptr) {
+            const MacroStoreMacro& macro = store->macros[i];
+            program.macroType = (MacroType)macro.macroType;
+            program.enabled = macro.enabled;
+            program.useMacroTriggerButton = macro.useMacroTriggerButton;
+            program.macroTriggerButton = macro.macroTriggerButton;
+            program.exclusive = macro.exclusive;
+            program.interruptible = macro.interruptible;
+            for (uint16_t j = 0; j < macro.inputCount && storeIndex < store->inputCount; j++, storeIndex++) {
+                const MacroStoreInput& input = store->inputs[storeIndex];
+                compileStep(macroSteps[stepIndex++], input.buttonMask, input.duration, input.waitDuration,
+                    macro.showFrames, elapsedNs, lastStepEnd);
+            }
+        } else {
+            const Macro& macro = inputMacroOptions->macroList[i];
+            program.macroType = macro.macroType;
+            program.enabled = macro.enabled;
+            program.useMacroTriggerButton = macro.useMacroTriggerButton;
+            program.macroTriggerButton = macro.macroTriggerButton;
+            program.exclusive = macro.exclusive;
+            program.interruptible = macro.interruptible;
+            for (pb_size_t j = 0; j < macro.macroInputs_count; j++) {
+                const MacroInput& input = macro.macroInputs[j];
+                compileStep(macroSteps[stepIndex++], input.buttonMask, input.duration, input.waitDuration,
+                    macro.showFrames, elapsedNs, lastStepEnd);
+            }
+        }
+        program.stepCount = stepIndex - program.firstStep;
+    }
+}
+
+uint32_t InputMacro::frameClock() {
+    // Preprocess runs far more often than the SOF frame number wraps
+    uint32_t frameCount = usbFrames.update();
+    return useFrameClock ? frameCount : getMillis();
 }
 
 
@@ -76,33 +167,24 @@ void InputMacro::reset() {
     macroPosition = -1;
     pressedMacro = -1;
     isMacroRunning = false;
-    macroStartTime = 0;
+    macroStartFrame = 0;
     macroInputPosition = 0;
     isMacroTriggerHeld = false;
-    macroInputHoldTime = INPUT_HOLD_US;
     if (boardLedEnabled) {
         gpio_put(BOARD_LED_PIN, 0);
     }
 }
 
-void InputMacro::restart(Macro& macro) {
-    macroStartTime = currentMicros;
-    macroInputPosition = 0;
-    MacroInput& newMacroInput = macro.macroInputs[macroInputPosition];
-    uint32_t newMacroInputDuration = newMacroInput.duration + newMacroInput.waitDuration;
-    macroInputHoldTime = newMacroInputDuration <= 0 ? INPUT_HOLD_US : newMacroInputDuration;
-}
-
-void InputMacro::checkMacroPress() {
+void InputMacro::checkMacroPress(bool includeDisabled) {
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     Mask_t allPins = gamepad->debouncedGpio;
 
     // Go through our macro list
     pressedMacro = -1;
     for(int i = 0; i < MAX_MACRO_LIMIT; i++) {
-        if ( inputMacroOptions->macroList[i].enabled == false ) // Skip disabled macros
+        if ( macroPrograms[i].enabled == false && !includeDisabled ) // Skip disabled macros
             continue;
-        Macro * macro = &inputMacroOptions->macroList[i];
+        MacroProgram * macro = &macroPrograms[i];
         if ( macro->useMacroTriggerButton ) {
             // Use Gamepad Button for Macro Trigger
             if ((allPins & macroButtonMask) &&
@@ -129,15 +211,21 @@ void InputMacro::checkMacroAction() {
 
     bool newPress = macroInputPressed && (prevMacroInputPressed ^ macroInputPressed);
 
+    if ( macroPosition == -1 ) {
+        isMacroTriggerHeld = false;
+        prevMacroInputPressed = macroInputPressed;
+        return;
+    }
+
     // Check to see if we should change the current macro (or turn off based on input)
-    if ( inputMacroOptions->macroList[macroPosition].macroType == ON_PRESS ) {
+    if ( macroPrograms[macroPosition].macroType == ON_PRESS ) {
         // START Macro: On Press or On Hold Repeat
         if (!isMacroRunning ) {
             isMacroTriggerHeld = newPress;
         }
-    } else if ( inputMacroOptions->macroList[macroPosition].macroType == ON_HOLD_REPEAT ) {
+    } else if ( macroPrograms[macroPosition].macroType == ON_HOLD_REPEAT ) {
         isMacroTriggerHeld = macroInputPressed;
-    } else if ( inputMacroOptions->macroList[macroPosition].macroType == ON_TOGGLE ) {
+    } else if ( macroPrograms[macroPosition].macroType == ON_TOGGLE ) {
         //isMacroTriggerHeld = macroInputPressed;
         if (!isMacroRunning ) {
             isMacroTriggerHeld = newPress;
@@ -153,12 +241,16 @@ void InputMacro::checkMacroAction() {
     if (!isMacroRunning && isMacroTriggerHeld) {
         // New Macro to run
         macroPosition = pressedMacro; // Set current macro
-        Macro& macro = inputMacroOptions->macroList[macroPosition];
-        MacroInput& macroInput = macro.macroInputs[macroInputPosition];
-        uint32_t macroInputDuration = macroInput.duration + macroInput.waitDuration;
-        macroInputHoldTime = macroInputDuration <= 0 ? INPUT_HOLD_US : macroInputDuration;
+        if (macroPrograms[macroPosition].stepCount == 0) {
+            isMacroTriggerHeld = false;
+            return;
+        }
+        // Count USB frames while a host polls us, so steps land on the frames reports go out in
+        useFrameClock = tud_mounted();
+        macroInputPosition = 0;
         isMacroRunning = true;
-        macroStartTime = getMicro(); // current time
+        currentFrame = frameClock(); // current time
+        macroStartFrame = currentFrame;
     }
 }
 
@@ -168,18 +260,22 @@ void InputMacro::runCurrentMacro() {
             macroPosition == -1)
         return;
 
-    Macro& macro = inputMacroOptions->macroList[macroPosition];
+    const MacroProgram& macro = macroPrograms[macroPosition];
 
     // Stop Macro if released (ON PRESS & ON HOLD REPEAT)
-    if (inputMacroOptions->macroList[macroPosition].macroType == ON_HOLD_REPEAT &&
+    if (macro.macroType == ON_HOLD_REPEAT &&
             !isMacroTriggerHeld ) {
         reset();
         return;
     }
 
-    MacroInput& macroInput = macro.macroInputs[macroInputPosition];
+    // Unplugged mid-macro, the frame clock has stopped
+    if (useFrameClock && !tud_mounted()) {
+        reset();
+        return;
+    }
+
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
-    currentMicros = getMicro();
 
     if (!macro.interruptible && macro.exclusive) {
         // Prevent any other inputs from modifying our input (Exclusive)
@@ -199,40 +295,28 @@ void InputMacro::runCurrentMacro() {
         }
     }
 
-    // Have we elapsed the input hold time?
-    if ((currentMicros - macroStartTime) >= macroInputHoldTime) {
-        macroStartTime = currentMicros;
-        macroInputPosition++;
-        
-        if (macroInputPosition >= (macro.macroInputs_count)) {
+    // Step ends are counted from the start of the macro, a late loop catches up instead of delaying the rest
+    const MacroStep * steps = &macroSteps[macro.firstStep];
+    uint32_t elapsed = currentFrame - macroStartFrame;
+    while (elapsed >= steps[macroInputPosition].stepEnd) {
+        if (++macroInputPosition >= macro.stepCount) {
             if ( macro.macroType == ON_PRESS ) {
                 reset(); // On press = no more macro
-            } else {
-                restart(macro); // On Hold-Repeat or On Toggle = start macro again
+                return;
             }
-        } else {
-            MacroInput& newMacroInput = macro.macroInputs[macroInputPosition];
-            uint32_t newMacroInputDuration = newMacroInput.duration + newMacroInput.waitDuration;
-            macroInputHoldTime = newMacroInputDuration <= 0 ? INPUT_HOLD_US : newMacroInputDuration;
+            // On Hold-Repeat or On Toggle = start macro again
+            uint32_t length = steps[macro.stepCount - 1].stepEnd;
+            macroStartFrame += elapsed - (elapsed % length);
+            elapsed %= length;
+            macroInputPosition = 0;
         }
     }
 
     // Check if we should still hold this macro input based on duration
-    if ((currentMicros - macroStartTime) <= macroInput.duration) {
-        uint32_t buttonMask = macroInput.buttonMask;
-        if (buttonMask & GAMEPAD_MASK_DU) {
-            gamepad->state.dpad |= GAMEPAD_MASK_UP;
-        }
-        if (buttonMask & GAMEPAD_MASK_DD) {
-            gamepad->state.dpad |= GAMEPAD_MASK_DOWN;
-        }
-        if (buttonMask & GAMEPAD_MASK_DL) {
-            gamepad->state.dpad |= GAMEPAD_MASK_LEFT;
-        }
-        if (buttonMask & GAMEPAD_MASK_DR) {
-            gamepad->state.dpad |= GAMEPAD_MASK_RIGHT;
-        }
-        gamepad->state.buttons |= buttonMask;
+    const MacroStep& step = steps[macroInputPosition];
+    if (elapsed < step.pressEnd) {
+        gamepad->state.dpad |= step.dpad;
+        gamepad->state.buttons |= step.buttonMask;
 
         // Macro LED is on if we're currently running and inputs are doing something (wait-timers turn it off)
         if (boardLedEnabled) {
@@ -243,6 +327,8 @@ void InputMacro::runCurrentMacro() {
 
 void InputMacro::preprocess()
 {
+    currentFrame = frameClock();
+
     FocusModeOptions * focusModeOptions = &Storage::getInstance().getAddonOptions().focusModeOptions;
     if (focusModeOptions->enabled && focusModeOptions->macroLockEnabled) {
         Gamepad * gamepad = Storage::getInstance().GetGamepad();
@@ -253,11 +339,167 @@ void InputMacro::preprocess()
         }
     }
 
+    if (recordState == MACRO_RECORD_ARMED) {
+        // Any macro trigger picks the slot, disabled macros included
+        checkMacroPress(true);
+        if (pressedMacro != -1) {
+            recordSlot = pressedMacro;
+            recordState = MACRO_RECORD_RUNNING;
+            recordWaitRelease = true;
+            recordHead = 0;
+            recordCount = 0;
+            lastRecordMask = 0;
+            useFrameClock = tud_mounted();
+        }
+        return;
+    } else if (recordState == MACRO_RECORD_RUNNING) {
+        return;
+    }
+
     checkMacroPress();
     checkMacroAction();
     runCurrentMacro();
 }
 
+void InputMacro::postprocess(bool sent)
+{
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    bool idle = (gamepad->state.buttons == 0 && gamepad->state.dpad == 0 && !isMacroRunning);
+
+    if (recordState == MACRO_RECORD_RUNNING) {
+        recordInput();
+    }
+
+    // Writing flash stalls both cores, wait until nobody is playing
+    if (recordSavePending) {
+        uint32_t now = getMillis();
+        if (!idle || recordState != MACRO_RECORD_OFF) {
+            recordIdleSince = now;
+        } else if ((now - recordIdleSince) >= INPUT_MACRO_RECORD_SAVE_IDLE_MS) {
+            MacroStore::getInstance().commit();
+            recordSavePending = false;
+        }
+    }
+}
+
+void InputMacro::handleMacroRecord(GPEvent* e) {
+    switch (recordState) {
+        case MACRO_RECORD_OFF:
+            reset();
+            recordState = MACRO_RECORD_ARMED;
+            break;
+        case MACRO_RECORD_ARMED:
+            recordState = MACRO_RECORD_OFF;
+            break;
+        case MACRO_RECORD_RUNNING:
+            finishRecording();
+            recordState = MACRO_RECORD_OFF;
+            break;
+    }
+}
+
+void InputMacro::recordInput() {
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    uint32_t buttonMask = gamepad->state.buttons;
+    if (gamepad->state.dpad & GAMEPAD_MASK_UP) buttonMask |= GAMEPAD_MASK_DU;
+    if (gamepad->state.dpad & GAMEPAD_MASK_DOWN) buttonMask |= GAMEPAD_MASK_DD;
+    if (gamepad->state.dpad & GAMEPAD_MASK_LEFT) buttonMask |= GAMEPAD_MASK_DL;
+    if (gamepad->state.dpad & GAMEPAD_MASK_RIGHT) buttonMask |= GAMEPAD_MASK_DR;
+
+    if (recordWaitRelease) {
+        recordWaitRelease = (buttonMask != 0);
+        return;
+    }
+    if (buttonMask == lastRecordMask)
+        return;
+    lastRecordMask = buttonMask;
+
+    uint32_t frame = frameClock();
+    MacroRecordEvent * last = recordCount ? &recordEvents[(recordHead + recordCount - 1) % INPUT_MACRO_RECORD_EVENTS] : nullptr;
+    if (last != nullptr && last->frame == frame) {
+        // Changes within one frame go out in the same report
+        last->buttonMask = buttonMask;
+        return;
+    }
+
+    if (recordCount == INPUT_MACRO_RECORD_EVENTS) {
+        recordHead = (recordHead + 1) % INPUT_MACRO_RECORD_EVENTS;
+        recordCount--;
+    }
+    MacroRecordEvent& event = recordEvents[(recordHead + recordCount) % INPUT_MACRO_RECORD_EVENTS];
+    event.frame = frame;
+    event.buttonMask = buttonMask;
+    recordCount++;
+}
+
+void InputMacro::finishRecording() {
+    auto recordEvent = [this](int i) -> const MacroRecordEvent& {
+        return recordEvents[(recordHead + i) % INPUT_MACRO_RECORD_EVENTS];
+    };
+
+    // The recording starts at the first press and ends when everything was last released,
+    // so the hotkey stopping it is left out
+    uint16_t first = 0;
+    while (first < recordCount && recordEvent(first).buttonMask == 0)
+        first++;
+    int end = recordCount - 1;
+    while (end > first && recordEvent(end).buttonMask != 0)
+        end--;
+    if (end <= first)
+        return;
+
+    uint16_t inputCount = 0;
+    for (int i = first; i < end; i++) {
+        if (recordEvent(i).buttonMask != 0)
+            inputCount++;
+    }
+
+    MacroStoreData& store = MacroStore::getInstance().edit(*inputMacroOptions);
+    MacroStoreMacro& macro = store.macros[recordSlot];
+
+    // Make room for the recording between the inputs of the other macros
+    uint32_t offset = 0;
+    for (int i = 0; i < recordSlot; i++)
+        offset += store.macros[i].inputCount;
+    uint32_t following = store.inputCount - offset - macro.inputCount;
+    uint32_t room = MACRO_STORE_MAX_INPUTS - (store.inputCount - macro.inputCount);
+    if (inputCount > room)
+        inputCount = room;
+    if (inputCount > MACRO_STORE_MAX_MACRO_INPUTS)
+        inputCount = MACRO_STORE_MAX_MACRO_INPUTS;
+    memmove(&store.inputs[offset + inputCount], &store.inputs[offset + macro.inputCount], following * sizeof(MacroStoreInput));
+    store.inputCount = offset + inputCount + following;
+
+    // Idle gaps become the wait of the input before them
+    MacroStoreInput * input = nullptr;
+    uint16_t written = 0;
+    for (int i = first; i < end; i++) {
+        uint32_t frames = recordEvent(i + 1).frame - recordEvent(i).frame;
+        if (recordEvent(i).buttonMask == 0) {
+            if (input != nullptr)
+                input->waitDuration = std::min(frames, (uint32_t)INPUT_MACRO_RECORD_MAX_IDLE_MS) * 1000;
+            continue;
+        }
+        if (written == inputCount)
+            break;
+        input = &store.inputs[offset + written++];
+        input->buttonMask = recordEvent(i).buttonMask;
+        input->duration = frames * 1000;
+        input->waitDuration = 0;
+    }
+
+    macro.inputCount = inputCount;
+    macro.enabled = true;
+    macro.showFrames = false;
+    if (macro.macroLabel[0] == '\0')
+        strncpy(macro.macroLabel, "Recorded", sizeof(macro.macroLabel) - 1);
+
+    // Playable right away, flash follows once the loop is idle
+    compile(&store);
+    recordSavePending = true;
+    recordIdleSince = getMillis();
+}
+
 void InputMacro::reinit() {
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
     macroButtonMask = 0;
@@ -290,4 +532,11 @@ void InputMacro::reinit() {
                 break;
         }
     }
+
+    // A recording waiting for its flash write is newer than flash
+    if (recordSavePending)
+        compile(&MacroStore::getInstance().edit(*inputMacroOptions));
+    else
+        compile(MacroStore::getInstance().get());
+    reset();
 }
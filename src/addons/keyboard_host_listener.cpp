@@ -1,8 +1,10 @@
 #include "addons/keyboard_host_listener.h"
 #include "drivermanager.h"
 #include "storagemanager.h"
+#include "usbhostlatency.h"
 #include "class/hid/hid_host.h"
 #include <algorithm>
+#include <string.h>
 
 #define DEV_ADDR_NONE 0xFF
 #define MOUSE_SCALE_FACTOR (GAMEPAD_JOYSTICK_MID / 127)
@@ -59,101 +61,186 @@ void KeyboardHostListener::setup() {
   mouseMovementMode = keyboardHostOptions.movementMode;
   mouseSensitivityScale = mouseSensitivity / 10.0f;
   mouseResetMS = 16;
-  mouseResetNextTimer = 0;
 
-  joystickMid = DriverManager::getInstance().getDriver() != nullptr ?
-      DriverManager::getInstance().getDriver()->GetJoystickMidValue() : GAMEPAD_JOYSTICK_MID;
+  joystickMid = getJoystickMid();
+}
 
-  _keyboard_host_mounted = false;
-  _keyboard_dev_addr = DEV_ADDR_NONE;
-  _keyboard_instance = 0;
+// The center depends on the running driver, which can change with a live input mode switch
+uint16_t KeyboardHostListener::getJoystickMid() {
+  return DriverManager::getInstance().getDriver() != nullptr ?
+      DriverManager::getInstance().getDriver()->GetJoystickMidValue() : GAMEPAD_JOYSTICK_MID;
+}
 
-  _mouse_host_mounted = false;
-  _mouse_dev_addr = DEV_ADDR_NONE;
-  _mouse_instance = 0;
+// Core1: move sticks resting on the old center to the new one after an input mode switch
+void KeyboardHostListener::refreshJoystickMid() {
+  uint16_t newMid = getJoystickMid();
+  if (newMid == joystickMid)
+    return;
 
-  mouseX = 0;
-  mouseY = 0;
-  mouseZ = 0;
-  mouseActive = false;
+  for (KeyboardHostDevice & device : devices) {
+    if (device.mounted == false)
+      continue;
+    if (device.state.lx == joystickMid) device.state.lx = newMid;
+    if (device.state.ly == joystickMid) device.state.ly = newMid;
+    if (device.state.rx == joystickMid) device.state.rx = newMid;
+    if (device.state.ry == joystickMid) device.state.ry = newMid;
+    publish(device);
+  }
+  joystickMid = newMid;
 }
 
+// Core0: merge every connected keyboard and mouse into the gamepad
 void KeyboardHostListener::process() {
   Gamepad *gamepad = Storage::getInstance().GetGamepad();
-  if (_keyboard_host_mounted == true || _mouse_host_mounted == true) {
-    gamepad->state.dpad     |= _keyboard_host_state.dpad;
-    gamepad->state.buttons  |= _keyboard_host_state.buttons;
-    gamepad->state.lx       = _keyboard_host_state.lx;
-    gamepad->state.ly       = _keyboard_host_state.ly;
-    gamepad->state.rx       = _keyboard_host_state.rx;
-    gamepad->state.ry       = _keyboard_host_state.ry;
+  uint16_t joystickMid = getJoystickMid();
+  bool mouseMounted = false;
+  bool mouseActive = false;
+  int32_t mouseX = 0;
+  int32_t mouseY = 0;
+  int32_t mouseZ = 0;
+
+  for (KeyboardHostDevice & device : devices) {
+    bool received = device.inputSlot.collect();
+    if (!device.inputSlot.connected())
+      continue;
+
+    const USBHostInput & input = device.inputSlot.input();
+    if (received)
+      USBHostLatency::getInstance().markInput(input.devAddr, input.timestamp);
+    gamepad->state.dpad     |= input.dpad;
+    gamepad->state.buttons  |= input.buttons;
+    gamepad->state.lx       = mergeUSBHostAxis(gamepad->state.lx, input.lx, joystickMid);
+    gamepad->state.ly       = mergeUSBHostAxis(gamepad->state.ly, input.ly, joystickMid);
+    gamepad->state.rx       = mergeUSBHostAxis(gamepad->state.rx, input.rx, joystickMid);
+    gamepad->state.ry       = mergeUSBHostAxis(gamepad->state.ry, input.ry, joystickMid);
     if (!gamepad->hasAnalogTriggers) {
-        gamepad->state.lt       |= _keyboard_host_state.lt;
-        gamepad->state.rt       |= _keyboard_host_state.rt;
+        gamepad->state.lt       |= input.lt;
+        gamepad->state.rt       |= input.rt;
+    }
+
+    if (input.flags & USB_HOST_INPUT_MOUSE) {
+      mouseMounted = true;
+      if (input.mouseX != 0 || input.mouseY != 0 || input.mouseZ != 0) {
+        mouseActive = true;
+        mouseX += input.mouseX;
+        mouseY += input.mouseY;
+        mouseZ += input.mouseZ;
+      }
     }
   }
 
-  if ( _mouse_host_mounted == true ) {
+  gamepad->auxState.sensors.mouse.enabled = mouseMounted;
+  if ( mouseMounted == true ) {
     gamepad->auxState.sensors.mouse.active = mouseActive;
 
     if ( mouseActive == true ) {
-        gamepad->auxState.sensors.mouse.active = true;
-        gamepad->auxState.sensors.mouse.x = mouseX;
-        gamepad->auxState.sensors.mouse.y = mouseY;
-        gamepad->auxState.sensors.mouse.z = mouseZ;
-        mouseActive = false;
-    } else if(mouseResetNextTimer < getMillis()) {
-        // Since mouse position reports only happen when the mouse is moved, we need to reset the position manually
-       _keyboard_host_state.lx = joystickMid;
-       _keyboard_host_state.ly = joystickMid;
-       _keyboard_host_state.rx = joystickMid;
-       _keyboard_host_state.ry = joystickMid;
+        gamepad->auxState.sensors.mouse.x = std::clamp<int32_t>(mouseX, INT16_MIN, INT16_MAX);
+        gamepad->auxState.sensors.mouse.y = std::clamp<int32_t>(mouseY, INT16_MIN, INT16_MAX);
+        gamepad->auxState.sensors.mouse.z = std::clamp<int32_t>(mouseZ, INT16_MIN, INT16_MAX);
+    }
+  }
+}
+
+void KeyboardHostListener::host_task() {
+  refreshJoystickMid();
+
+  for (KeyboardHostDevice & device : devices) {
+    device.inputSlot.flush();
+
+    if (device.mounted == false || device.mouse == false)
+      continue;
+
+    // Since mouse position reports only happen when the mouse is moved, we need to reset the position manually
+    if (device.mouseResetNextTimer != 0 && device.mouseResetNextTimer < getMillis()) {
+       device.mouseResetNextTimer = 0;
+       device.state.lx = joystickMid;
+       device.state.ly = joystickMid;
+       device.state.rx = joystickMid;
+       device.state.ry = joystickMid;
+       publish(device);
     }
   }
 }
 
+// Hand the parsed state to core0
+void KeyboardHostListener::publish(KeyboardHostDevice & device) {
+  USBHostInput input;
+  memset(&input, 0, sizeof(input));
+  if (device.mounted == true) {
+    input.buttons = device.state.buttons;
+    input.dpad = device.state.dpad;
+    input.lx = device.state.lx;
+    input.ly = device.state.ly;
+    input.rx = device.state.rx;
+    input.ry = device.state.ry;
+    input.lt = device.state.lt;
+    input.rt = device.state.rt;
+    input.flags = USB_HOST_INPUT_CONNECTED | (device.mouse ? USB_HOST_INPUT_MOUSE : 0);
+    input.mouseX = device.mouseX;
+    input.mouseY = device.mouseY;
+    input.mouseZ = device.mouseZ;
+    input.devAddr = device.dev_addr;
+    input.timestamp = USBHostLatency::getInstance().reportTimestamp();
+  }
+  device.inputSlot.publish(input);
+
+  // movement is relative, only send it once
+  device.mouseX = 0;
+  device.mouseY = 0;
+  device.mouseZ = 0;
+}
+
 void KeyboardHostListener::mount(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
     // Interface protocol (hid_interface_protocol_enum_t)
     uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
+    if (itf_protocol != HID_ITF_PROTOCOL_KEYBOARD && itf_protocol != HID_ITF_PROTOCOL_MOUSE)
+        return;
+
+    refreshJoystickMid();
 
     // tuh_hid_report_received_cb() will be invoked when report is available
-    if (_keyboard_host_mounted == false && itf_protocol == HID_ITF_PROTOCOL_KEYBOARD) {
-        _keyboard_host_mounted = true;
-        _keyboard_dev_addr = dev_addr;
-        _keyboard_instance = instance;
-    } else if (_mouse_host_mounted == false && itf_protocol == HID_ITF_PROTOCOL_MOUSE) {
-        Gamepad *gamepad = Storage::getInstance().GetGamepad();
-        gamepad->auxState.sensors.mouse.enabled = true;
-        _mouse_host_mounted = true;
-        _mouse_dev_addr = dev_addr;
-        _mouse_instance = instance;
+    for (KeyboardHostDevice & device : devices) {
+        if (device.mounted == false) {
+            device.mounted = true;
+            device.mouse = (itf_protocol == HID_ITF_PROTOCOL_MOUSE);
+            device.dev_addr = dev_addr;
+            device.instance = instance;
+            device.state = GamepadState();
+            device.state.lx = joystickMid;
+            device.state.ly = joystickMid;
+            device.state.rx = joystickMid;
+            device.state.ry = joystickMid;
+            device.mouseResetNextTimer = 0;
+            publish(device);
+            break;
+        }
     }
 }
 
 void KeyboardHostListener::unmount(uint8_t dev_addr) {
-    if ( _keyboard_host_mounted == true && _keyboard_dev_addr == dev_addr ) {
-        _keyboard_host_mounted = false;
-        _keyboard_dev_addr = DEV_ADDR_NONE;
-        _keyboard_instance = 0;
-    } else if ( _mouse_host_mounted == true && _mouse_dev_addr == dev_addr ) {
-        Gamepad *gamepad = Storage::getInstance().GetGamepad();
-        gamepad->auxState.sensors.mouse.enabled = false;
-        _mouse_host_mounted = false;
-        _mouse_dev_addr = DEV_ADDR_NONE;
-        _mouse_instance = 0;
+    for (KeyboardHostDevice & device : devices) {
+        if ( device.mounted == true && device.dev_addr == dev_addr ) {
+            device.mounted = false;
+            device.dev_addr = DEV_ADDR_NONE;
+            device.instance = 0;
+            publish(device);
+        }
     }
 }
 
 void KeyboardHostListener::report_received(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len){
-  // do nothing if we haven't mounted
-if ( _keyboard_host_mounted == false && _mouse_host_mounted == false )
-    return;
+  refreshJoystickMid();
 
-  // tuh_hid_report_received_cb() will be invoked when report is available
-  if ( _keyboard_host_mounted == true && _keyboard_dev_addr == dev_addr && _keyboard_instance == instance ) {
-    process_kbd_report(dev_addr, (hid_keyboard_report_t const*) report );
-  } else if ( _mouse_host_mounted == true && _mouse_dev_addr == dev_addr && _mouse_instance == instance) {
-    process_mouse_report(dev_addr, (hid_mouse_report_t const*) report );
+  for (KeyboardHostDevice & device : devices) {
+    if ( device.mounted == true && device.dev_addr == dev_addr && device.instance == instance ) {
+      if ( device.mouse == true ) {
+        process_mouse_report(device, (hid_mouse_report_t const*) report );
+      } else {
+        process_kbd_report(device, (hid_keyboard_report_t const*) report );
+      }
+      publish(device);
+      return;
+    }
   }
 }
 
@@ -172,32 +259,32 @@ uint8_t KeyboardHostListener::getKeycodeFromModifier(uint8_t modifier) {
 	return 0;
 }
 
-void KeyboardHostListener::preprocess_report()
+void KeyboardHostListener::preprocess_report(GamepadState & state)
 {
-  _keyboard_host_state.buttons = 0;
+  state.buttons = 0;
   // --- preprocess only select analog movements --- // (by Pelsin)
   if (mouseMovementMode == MOUSE_MOVEMENT_LEFT_ANALOG) {
-    _keyboard_host_state.lx = joystickMid;
-    _keyboard_host_state.ly = joystickMid;
+    state.lx = joystickMid;
+    state.ly = joystickMid;
   } else if (mouseMovementMode == MOUSE_MOVEMENT_RIGHT_ANALOG) {
-    _keyboard_host_state.rx = joystickMid;
-    _keyboard_host_state.ry = joystickMid;
+    state.rx = joystickMid;
+    state.ry = joystickMid;
   } else {
-    _keyboard_host_state.lx = joystickMid;
-    _keyboard_host_state.ly = joystickMid;
-    _keyboard_host_state.rx = joystickMid;
-    _keyboard_host_state.ry = joystickMid;
+    state.lx = joystickMid;
+    state.ly = joystickMid;
+    state.rx = joystickMid;
+    state.ry = joystickMid;
   }
-  _keyboard_host_state.lt = 0;
-  _keyboard_host_state.rt = 0;
+  state.lt = 0;
+  state.rt = 0;
 }
 
 // convert hid keycode to ascii and print via usb device CDC (ignore non-printable)
-void KeyboardHostListener::process_kbd_report(uint8_t dev_addr, hid_keyboard_report_t const *report)
+void KeyboardHostListener::process_kbd_report(KeyboardHostDevice & device, hid_keyboard_report_t const *report)
 {
-  preprocess_report();
+  preprocess_report(device.state);
   // move this preprocess dpad reset only to kbd_report (so as to not have it run on mouse input, by Fran89)
-  _keyboard_host_state.dpad = 0;
+  device.state.dpad = 0;
 
   // make this 13 instead of 7 to include modifier bitfields from hid_keyboard_modifier_bm_t
   for(uint8_t i=0; i<13; i++)
@@ -214,30 +301,30 @@ void KeyboardHostListener::process_kbd_report(uint8_t dev_addr, hid_keyboard_rep
     }
     if ( keycode )
     {
-      _keyboard_host_state.dpad |=
-            ((keycode == _keyboard_host_mapDpadUp.key)    ? _keyboard_host_mapDpadUp.buttonMask : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadDown.key)  ? _keyboard_host_mapDpadDown.buttonMask : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadLeft.key)  ? _keyboard_host_mapDpadLeft.buttonMask  : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadRight.key) ? _keyboard_host_mapDpadRight.buttonMask : _keyboard_host_state.dpad)
+      device.state.dpad |=
+            ((keycode == _keyboard_host_mapDpadUp.key)    ? _keyboard_host_mapDpadUp.buttonMask : device.state.dpad)
+          | ((keycode == _keyboard_host_mapDpadDown.key)  ? _keyboard_host_mapDpadDown.buttonMask : device.state.dpad)
+          | ((keycode == _keyboard_host_mapDpadLeft.key)  ? _keyboard_host_mapDpadLeft.buttonMask  : device.state.dpad)
+          | ((keycode == _keyboard_host_mapDpadRight.key) ? _keyboard_host_mapDpadRight.buttonMask : device.state.dpad)
         ;
 
-        _keyboard_host_state.buttons |=
-            ((keycode == _keyboard_host_mapButtonB1.key)  ? _keyboard_host_mapButtonB1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB2.key)  ? _keyboard_host_mapButtonB2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB3.key)  ? _keyboard_host_mapButtonB3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB4.key)  ? _keyboard_host_mapButtonB4.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL1.key)  ? _keyboard_host_mapButtonL1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR1.key)  ? _keyboard_host_mapButtonR1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL2.key)  ? _keyboard_host_mapButtonL2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR2.key)  ? _keyboard_host_mapButtonR2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonS1.key)  ? _keyboard_host_mapButtonS1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonS2.key)  ? _keyboard_host_mapButtonS2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL3.key)  ? _keyboard_host_mapButtonL3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR3.key)  ? _keyboard_host_mapButtonR3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA1.key)  ? _keyboard_host_mapButtonA1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA2.key)  ? _keyboard_host_mapButtonA2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA3.key)  ? _keyboard_host_mapButtonA3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA4.key)  ? _keyboard_host_mapButtonA4.buttonMask  : _keyboard_host_state.buttons)
+        device.state.buttons |=
+            ((keycode == _keyboard_host_mapButtonB1.key)  ? _keyboard_host_mapButtonB1.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonB2.key)  ? _keyboard_host_mapButtonB2.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonB3.key)  ? _keyboard_host_mapButtonB3.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonB4.key)  ? _keyboard_host_mapButtonB4.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonL1.key)  ? _keyboard_host_mapButtonL1.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonR1.key)  ? _keyboard_host_mapButtonR1.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonL2.key)  ? _keyboard_host_mapButtonL2.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonR2.key)  ? _keyboard_host_mapButtonR2.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonS1.key)  ? _keyboard_host_mapButtonS1.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonS2.key)  ? _keyboard_host_mapButtonS2.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonL3.key)  ? _keyboard_host_mapButtonL3.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonR3.key)  ? _keyboard_host_mapButtonR3.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonA1.key)  ? _keyboard_host_mapButtonA1.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonA2.key)  ? _keyboard_host_mapButtonA2.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonA3.key)  ? _keyboard_host_mapButtonA3.buttonMask  : device.state.buttons)
+          | ((keycode == _keyboard_host_mapButtonA4.key)  ? _keyboard_host_mapButtonA4.buttonMask  : device.state.buttons)
         ;
     }
   }
@@ -248,35 +335,34 @@ uint16_t KeyboardHostListener::scaleMouseToJoystick(int8_t mouseVal) {
   return std::clamp(result, GAMEPAD_JOYSTICK_MIN_I32, GAMEPAD_JOYSTICK_MAX_I32);
 }
 
-void KeyboardHostListener::process_mouse_report(uint8_t dev_addr, hid_mouse_report_t const * report)
+void KeyboardHostListener::process_mouse_report(KeyboardHostDevice & device, hid_mouse_report_t const * report)
 {
-  preprocess_report();
+  preprocess_report(device.state);
 
   //------------- button state  -------------//
-  _keyboard_host_state.buttons |=
-      (report->buttons & MOUSE_BUTTON_LEFT   ?   mouseLeftMapping : _keyboard_host_state.buttons)
-    | (report->buttons & MOUSE_BUTTON_MIDDLE ? mouseMiddleMapping : _keyboard_host_state.buttons)
-    | (report->buttons & MOUSE_BUTTON_RIGHT  ?  mouseRightMapping : _keyboard_host_state.buttons)
+  device.state.buttons |=
+      (report->buttons & MOUSE_BUTTON_LEFT   ?   mouseLeftMapping : device.state.buttons)
+    | (report->buttons & MOUSE_BUTTON_MIDDLE ? mouseMiddleMapping : device.state.buttons)
+    | (report->buttons & MOUSE_BUTTON_RIGHT  ?  mouseRightMapping : device.state.buttons)
   ;
 
   //------------- cursor movement -------------//
-  mouseX = report->x;
-  mouseY = report->y;
-  mouseZ = report->wheel;
-  mouseActive = true;
+  device.mouseX = report->x;
+  device.mouseY = report->y;
+  device.mouseZ = report->wheel;
 
   if (mouseMovementMode == MOUSE_MOVEMENT_NONE) {
     return;
   }
 
-  mouseResetNextTimer = getMillis() + mouseResetMS;
+  device.mouseResetNextTimer = getMillis() + mouseResetMS;
   //-------- report correct analog move --------// (by Pelsin)
   if (mouseMovementMode == MOUSE_MOVEMENT_LEFT_ANALOG) {
-    _keyboard_host_state.lx = scaleMouseToJoystick(report->x);
-    _keyboard_host_state.ly = scaleMouseToJoystick(report->y);
+    device.state.lx = scaleMouseToJoystick(report->x);
+    device.state.ly = scaleMouseToJoystick(report->y);
   } else if (mouseMovementMode == MOUSE_MOVEMENT_RIGHT_ANALOG) {
-    _keyboard_host_state.rx = scaleMouseToJoystick(report->x);
-    _keyboard_host_state.ry = scaleMouseToJoystick(report->y);
+    device.state.rx = scaleMouseToJoystick(report->x);
+    device.state.ry = scaleMouseToJoystick(report->y);
   }
 
 }
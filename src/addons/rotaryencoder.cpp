@@ -1,6 +1,7 @@
 #include "addons/rotaryencoder.h"
 
 #include "eventmanager.h"
+#include "peripheralmanager.h"
 #include "storagemanager.h"
 #include "GPEncoderEvent.h"
 #include "types.h"
@@ -9,6 +10,8 @@
 #include "helper.h"
 #include "config.pb.h"
 
+#include "quadrature_encoder.pio.h"
+
 bool RotaryEncoderInput::available() {
     const RotaryOptions& options = Storage::getInstance().getAddonOptions().rotaryOptions;
     return options.enabled;
@@ -41,10 +44,18 @@ void RotaryEncoderInput::setup()
         encoderMap[1].multiplier = options.encoderTwo.multiplier;
     }
 
+    // PIO USB host needs all of pio0, encoders are polled then
+    pio = PeripheralManager::getInstance().isUSBEnabled(0) ? nullptr : pio0;
+
     for (uint8_t i = 0; i < MAX_ENCODERS; i++) {
         encoderValues[i] = 0;
-   
+
         if (encoderMap[i].enabled) {
+            encoderMap[i].increment = (ENCODER_RADIUS / (encoderMap[i].pulsesPerRevolution / (ENCODER_PRECISION * encoderMap[i].multiplier)));
+            encoderMap[i].totalPositions = ENCODER_RADIUS * (int32_t)(encoderMap[i].pulsesPerRevolution / (ENCODER_PRECISION * encoderMap[i].multiplier));
+        }
+
+        if (encoderMap[i].enabled && !startPIO(i)) {
             gpio_init(encoderMap[i].pinA);             // Initialize pin
             gpio_set_dir(encoderMap[i].pinA, GPIO_IN); // Set as INPUT
             gpio_pull_up(encoderMap[i].pinA);          // Set as PULLUP
@@ -73,30 +84,8 @@ void RotaryEncoderInput::process()
 
     for (uint8_t i = 0; i < MAX_ENCODERS; i++) {
         if (encoderMap[i].enabled) {
-            uint32_t lastUpdate = now - encoderState[i].updateTime;
-
-            if (lastUpdate >= encoderState[i].delay) {
-                bool pinAValue = gpio_get(encoderMap[i].pinA);
-                bool pinBValue = gpio_get(encoderMap[i].pinB);
-
-                uint32_t encoderIncrement = (ENCODER_RADIUS / (encoderMap[i].pulsesPerRevolution / (ENCODER_PRECISION * encoderMap[i].multiplier)));
-
-                if (encoderState[i].pinA != pinAValue || encoderState[i].pinB != pinBValue) {
-                    if ((encoderState[i].pinA == encoderState[i].prevA) && (encoderState[i].pinB == encoderState[i].prevB)) {
-                        if ((encoderState[i].pinA && !encoderState[i].pinB && pinBValue) || (!encoderState[i].pinA && encoderState[i].pinB && !pinBValue)) {
-                            encoderValues[i]+=encoderIncrement;
-                        } else if ((!encoderState[i].pinA && encoderState[i].pinB && pinBValue) || (encoderState[i].pinA && !encoderState[i].pinB && !pinBValue)) {
-                            encoderValues[i]-=encoderIncrement;
-                        }
-                    }
-                }
-
-                encoderState[i].pinA = pinAValue;
-                encoderState[i].pinB = pinBValue;
-                encoderState[i].prevA = pinAValue;
-                encoderState[i].prevB = pinBValue;
-                encoderState[i].updateTime = now;
-            }
+            int32_t steps = (encoderState[i].stateMachine >= 0) ? readSteps(i) : pollSteps(i, now);
+            encoderValues[i] += steps * encoderMap[i].increment;
         }
     }
 
@@ -105,23 +94,23 @@ void RotaryEncoderInput::process()
             uint32_t lastChange = now - encoderState[i].changeTime;
 
             if (encoderMap[i].mode == ENCODER_MODE_LEFT_ANALOG_X) {
-                gamepad->state.lx = -mapEncoderValueStick(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.lx = -mapEncoderValueStick(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_LEFT_ANALOG_Y) {
-                gamepad->state.ly = -mapEncoderValueStick(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.ly = -mapEncoderValueStick(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_RIGHT_ANALOG_X) {
-                gamepad->state.rx = -mapEncoderValueStick(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.rx = -mapEncoderValueStick(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_RIGHT_ANALOG_Y) {
-                gamepad->state.ry = -mapEncoderValueStick(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.ry = -mapEncoderValueStick(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_LEFT_TRIGGER) {
-                gamepad->state.lt = mapEncoderValueTrigger(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.lt = mapEncoderValueTrigger(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_RIGHT_TRIGGER) {
-                gamepad->state.rt = mapEncoderValueTrigger(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                gamepad->state.rt = mapEncoderValueTrigger(i, encoderValues[i]);
             } else if (encoderMap[i].mode == ENCODER_MODE_DPAD_X) {
-                int8_t axis = mapEncoderValueDPad(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                int8_t axis = mapEncoderValueDPad(i, encoderValues[i]);
                 dpadLeft = (axis == 1);
                 dpadRight = (axis == -1);
             } else if (encoderMap[i].mode == ENCODER_MODE_DPAD_Y) {
-                int8_t axis = mapEncoderValueDPad(i, encoderValues[i], encoderMap[i].pulsesPerRevolution);
+                int8_t axis = mapEncoderValueDPad(i, encoderValues[i]);
                 dpadUp = (axis == 1);
                 dpadDown = (axis == -1);
             } else if (encoderMap[i].mode == ENCODER_MODE_VOLUME) {
@@ -153,9 +142,94 @@ void RotaryEncoderInput::process()
     if (dpadRight) gamepad->state.dpad |= GAMEPAD_MASK_RIGHT;
 }
 
-uint16_t RotaryEncoderInput::mapEncoderValueStick(int8_t index, int32_t encoderValue, uint16_t ppr) {
-    // Calculate total number of positions based on PPR
-    int32_t totalPositions = ENCODER_RADIUS * (int32_t)(ppr / (ENCODER_PRECISION * encoderMap[index].multiplier));
+bool RotaryEncoderInput::startPIO(uint8_t index) {
+    if (pio == nullptr)
+        return false;
+
+    // the program reads A and B as two consecutive pins
+    uint pin;
+    bool swapped;
+    if (encoderMap[index].pinB == encoderMap[index].pinA + 1) {
+        pin = encoderMap[index].pinA;
+        swapped = false;
+    } else if (encoderMap[index].pinA == encoderMap[index].pinB + 1) {
+        pin = encoderMap[index].pinB;
+        swapped = true;
+    } else {
+        return false;
+    }
+
+    // NeoPico drives state machine 0 without claiming it
+    int8_t sm = -1;
+    for (int8_t candidate = 3; candidate > 0; candidate--) {
+        if (!pio_sm_is_claimed(pio, candidate)) {
+            sm = candidate;
+            break;
+        }
+    }
+    if (sm < 0)
+        return false;
+
+    // both encoders share the program, it has to sit at offset 0
+    bool loaded = false;
+    for (uint8_t i = 0; i < MAX_ENCODERS; i++) {
+        if (encoderState[i].stateMachine >= 0)
+            loaded = true;
+    }
+    if (!loaded) {
+        if (!pio_can_add_program(pio, &quadrature_encoder_program))
+            return false;
+        pio_add_program(pio, &quadrature_encoder_program);
+    }
+
+    pio_sm_claim(pio, sm);
+    quadrature_encoder_program_init(pio, sm, pin, 0);
+
+    encoderState[index].stateMachine = sm;
+    encoderState[index].swapped = swapped;
+    encoderState[index].count = quadrature_encoder_get_count(pio, sm);
+    return true;
+}
+
+int32_t RotaryEncoderInput::readSteps(uint8_t index) {
+    int32_t count = quadrature_encoder_get_count(pio, encoderState[index].stateMachine);
+    int32_t steps = (count >> ENCODER_PIO_SHIFT) - (encoderState[index].count >> ENCODER_PIO_SHIFT);
+    encoderState[index].count = count;
+
+    // the PIO counts up when B leads, the encoder value goes up when A leads
+    return encoderState[index].swapped ? steps : -steps;
+}
+
+int32_t RotaryEncoderInput::pollSteps(uint8_t index, uint32_t now) {
+    int32_t steps = 0;
+    uint32_t lastUpdate = now - encoderState[index].updateTime;
+
+    if (lastUpdate >= encoderState[index].delay) {
+        bool pinAValue = gpio_get(encoderMap[index].pinA);
+        bool pinBValue = gpio_get(encoderMap[index].pinB);
+
+        if (encoderState[index].pinA != pinAValue || encoderState[index].pinB != pinBValue) {
+            if ((encoderState[index].pinA == encoderState[index].prevA) && (encoderState[index].pinB == encoderState[index].prevB)) {
+                if ((encoderState[index].pinA && !encoderState[index].pinB && pinBValue) || (!encoderState[index].pinA && encoderState[index].pinB && !pinBValue)) {
+                    steps = 1;
+                } else if ((!encoderState[index].pinA && encoderState[index].pinB && pinBValue) || (encoderState[index].pinA && !encoderState[index].pinB && !pinBValue)) {
+                    steps = -1;
+                }
+            }
+        }
+
+        encoderState[index].pinA = pinAValue;
+        encoderState[index].pinB = pinBValue;
+        encoderState[index].prevA = pinAValue;
+        encoderState[index].prevB = pinBValue;
+        encoderState[index].updateTime = now;
+    }
+
+    return steps;
+}
+
+uint16_t RotaryEncoderInput::mapEncoderValueStick(int8_t index, int32_t encoderValue) {
+    int32_t totalPositions = encoderMap[index].totalPositions;
 
     // Calculate range of encoder values corresponding to mapped range
     int32_t minValue = -totalPositions / 2;
@@ -174,9 +248,8 @@ uint16_t RotaryEncoderInput::mapEncoderValueStick(int8_t index, int32_t encoderV
     }
 }
 
-uint16_t RotaryEncoderInput::mapEncoderValueTrigger(int8_t index, int32_t encoderValue, uint16_t ppr) {
-    // Calculate total number of positions based on PPR
-    int32_t totalPositions = ENCODER_RADIUS * (int32_t)(ppr / (ENCODER_PRECISION * encoderMap[index].multiplier));
+uint16_t RotaryEncoderInput::mapEncoderValueTrigger(int8_t index, int32_t encoderValue) {
+    int32_t totalPositions = encoderMap[index].totalPositions;
 
     // Calculate range of encoder values corresponding to mapped range
     int32_t minValue = 0;
@@ -192,9 +265,8 @@ uint16_t RotaryEncoderInput::mapEncoderValueTrigger(int8_t index, int32_t encode
     }
 }
 
-int8_t RotaryEncoderInput::mapEncoderValueDPad(int8_t index, int32_t encoderValue, uint16_t ppr) {
-    // Calculate total number of positions based on PPR
-    int32_t totalPositions = ENCODER_RADIUS * (int32_t)(ppr / (ENCODER_PRECISION * encoderMap[index].multiplier));
+int8_t RotaryEncoderInput::mapEncoderValueDPad(int8_t index, int32_t encoderValue) {
+    int32_t totalPositions = encoderMap[index].totalPositions;
 
     // Calculate range of encoder values corresponding to mapped range
     int32_t minValue = -totalPositions / 2;
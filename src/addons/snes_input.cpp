@@ -1,6 +1,7 @@
 #include "addons/snes_input.h"
 #include "drivermanager.h"
 #include "storagemanager.h"
+#include "peripheralmanager.h"
 #include "hardware/gpio.h"
 #include "helper.h"
 
@@ -27,7 +28,9 @@ void SNESpadInput::setup() {
         snesOptions.clockPin,
         snesOptions.latchPin,
         snesOptions.dataPin);
-    snes->begin();
+
+    // PIO USB host takes both PIO blocks' instruction memory, read the pad from GPIO then
+    snes->begin(PeripheralManager::getInstance().isUSBEnabled(0) ? nullptr : pio1);
     snes->start();
 
     // Run during setup to catch boot selection mode
@@ -81,7 +84,8 @@ void SNESpadInput::setup() {
 }
 
 void SNESpadInput::process() {
-    if (nextTimer < getMillis()) {
+    // a PIO read only collects finished frames, so take the newest every loop
+    if (snes->usingPIO() || nextTimer < getMillis()) {
         snes->poll();
 
         uint16_t joystickMid = GAMEPAD_JOYSTICK_MID;
@@ -11,7 +11,12 @@ void SPIAnalog1256Input::setup() {
     PeripheralSPI* spi = PeripheralManager::getInstance().getSPI(options.spiBlock);
     enableTriggers = options.enableTriggers;
     readChannelCount = 4 + (enableTriggers ? 2 : 0);
-    analogMax = options.avdd / 10.0f;
+
+    // Full scale is +-2 VREF at PGA 1, so AVDD sits at this code
+    float analogMax = options.avdd / 10.0f;
+    rawMax = std::max((int32_t)(analogMax * 8388607.0f / (2.0f * ADS1256_VREF_VOLTAGE)), (int32_t)1);
+    scale16 = ((65535ull << 32) + rawMax - 1) / (uint32_t)rawMax;
+    scale8 = ((255ull << 32) + rawMax - 1) / (uint32_t)rawMax;
 
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     gamepad->hasAnalogTriggers = enableTriggers;
@@ -19,17 +24,26 @@ void SPIAnalog1256Input::setup() {
     // Init our ADS1256 library
     ads = new ADS1256(spi, options.drdyPin, -1, -1, options.csPin, (float)ADS1256_VREF_VOLTAGE);
     ads->init(ADS1256_DRATE_30000SPS, ADS1256_PGA_1, true);
+
+    // Read in the background, out of DMA channels we read in the loop
+    acquiring = ads->startAcquisition(readChannelCount);
 }
 
 void SPIAnalog1256Input::process() {
-    // Read the first X channels
-    for (uint8_t i = 0; i < readChannelCount; i++) {
-        values[i] = ads->convertToVoltage(ads->cycleSingle());
-    }
+    if (acquiring) {
+        // Keeps the previous set until the first one is complete
+        ads->readLatest(values);
+    } else {
+        // Read the first X channels
+        for (uint8_t i = 0; i < readChannelCount; i++) {
+            uint32_t raw = ads->cycleSingle();
+            values[i] = (int32_t)(raw << 8) >> 8;
+        }
 
-    // Tells the ADC we're done sampling and flags to reset
-    // the read cycle next time an ADC read is performed
-    ads->stopConversion();
+        // Tells the ADC we're done sampling and flags to reset
+        // the read cycle next time an ADC read is performed
+        ads->stopConversion();
+    }
 
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
 
@@ -45,12 +59,12 @@ void SPIAnalog1256Input::process() {
     }
 }
 
-uint8_t SPIAnalog1256Input::convert24to8bit(float voltage) {
-    float ratio = std::clamp(voltage, 0.0f, analogMax) / analogMax;
-    return (uint8_t)(255.f * ratio);
+uint8_t SPIAnalog1256Input::convert24to8bit(int32_t raw) {
+    uint32_t code = std::clamp(raw, (int32_t)0, rawMax);
+    return (uint8_t)((code * scale8) >> 32);
 }
 
-uint16_t SPIAnalog1256Input::convert24to16bit(float voltage) {
-    float ratio = std::clamp(voltage, 0.0f, analogMax) / analogMax;
-    return (uint16_t)(65535.f * ratio);
+uint16_t SPIAnalog1256Input::convert24to16bit(int32_t raw) {
+    uint32_t code = std::clamp(raw, (int32_t)0, rawMax);
+    return (uint16_t)((code * scale16) >> 32);
 }
@@ -2,6 +2,7 @@
 #include "drivermanager.h"
 #include "storagemanager.h"
 #include "hardware/gpio.h"
+#include "pico/time.h"
 #include "helper.h"
 
 #if TG16_PAD_DEBUG==true
@@ -11,13 +12,6 @@
 // Helper macros for pin access
 #define SET_PIN(pin) gpio_put(pin, 1)
 #define CLR_PIN(pin) gpio_put(pin, 0)
-#define READ_PIN(pin) gpio_get(pin)
-
-// 6-button support state
-static bool sixButtonMode = false;
-static uint32_t sixButtonTimeout = 0;
-#define SIX_BUTTON_TIMEOUT_MS 150
-static int sixButtonSequenceStep = 0;
 
 // Extra buttons for 6-button mode
 static bool buttonIII = false;
@@ -25,20 +19,85 @@ static bool buttonIV = false;
 static bool buttonV = false;
 static bool buttonVI = false;
 
-// Helper to detect 6-button sequence (3 rapid reads with SELECT high/low)
-static void detectSixButtonSequence(bool selectState) {
-    // Sequence: High, Low, High (SEL)
-    static int lastSelect = -1;
-    if (lastSelect == -1) lastSelect = selectState;
-    if (selectState != lastSelect) {
-        sixButtonSequenceStep++;
-        lastSelect = selectState;
-        if (sixButtonSequenceStep >= 3) {
-            sixButtonMode = true;
-            sixButtonTimeout = getMillis() + SIX_BUTTON_TIMEOUT_MS;
-            sixButtonSequenceStep = 0;
-        }
+//
+// The pad is scanned from a timer alarm, one step per alarm so nothing waits for
+// the lines to settle: OE low and SELECT high, read the directions, SELECT low,
+// read the buttons, OE high. A six button pad answers every other scan with all
+// four directions held and buttons III-VI in place of I, II, Select and Run.
+//
+static struct {
+    uint oePin;
+    uint selectPin;
+    uint dataPins[4];           // D3..D0, first pin lands in bit 0
+    uint8_t step;
+    uint8_t scanned;            // directions of the scan in progress
+    uint8_t directions;
+    uint8_t buttons;
+    uint8_t extra;              // III, IV, V, VI
+    bool sixButton;
+    uint32_t sixButtonUs;       // last six button scan
+    volatile uint16_t data;     // last complete read, bits as in updateButtons
+} scanner;
+
+static uint8_t readNibble()
+{
+    uint32_t pins = gpio_get_all();
+    uint8_t nibble = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (!(pins & (1u << scanner.dataPins[i]))) // active low
+            nibble |= (1 << i);
     }
+    return nibble;
+}
+
+static int64_t scanStep(alarm_id_t id, void *user_data)
+{
+    switch (scanner.step)
+    {
+        case 0:
+            // Set OE active (active low), SELECT high for the directions
+            CLR_PIN(scanner.oePin);
+            SET_PIN(scanner.selectPin);
+            scanner.step = 1;
+            return TG16_PAD_SETTLE_US;
+        case 1:
+            scanner.scanned = readNibble();
+            CLR_PIN(scanner.selectPin);
+            scanner.step = 2;
+            return TG16_PAD_SETTLE_US;
+        default:
+            break;
+    }
+
+    uint8_t nibble = readNibble();
+    SET_PIN(scanner.oePin);
+    scanner.step = 0;
+
+    uint32_t now = time_us_32();
+    if (scanner.scanned == 0x0F)
+    {
+        // D0..D3 are III..VI, reversed like the rest of the nibble
+        scanner.extra = ((nibble & 0x1) << 3) | ((nibble & 0x2) << 1) | ((nibble & 0x4) >> 1) | ((nibble & 0x8) >> 3);
+        scanner.sixButton = true;
+        scanner.sixButtonUs = now;
+    }
+    else
+    {
+        scanner.directions = scanner.scanned;
+        scanner.buttons = nibble;
+    }
+
+    if (scanner.sixButton && (now - scanner.sixButtonUs) > TG16_SIX_BUTTON_TIMEOUT_US)
+    {
+        scanner.sixButton = false;
+        scanner.extra = 0;
+    }
+
+    scanner.data = scanner.directions | (scanner.buttons << 4) | (scanner.extra << 8);
+
+    // positive keeps scans on a fixed period from the first one
+    return TG16_PAD_SCAN_US - (2 * TG16_PAD_SETTLE_US);
 }
 
 bool TG16padInput::available()
@@ -54,12 +113,11 @@ bool TG16padInput::available()
 void TG16padInput::setup()
 {
 	const TG16Options &tg16Options = Storage::getInstance().getAddonOptions().tg16Options;
-	nextTimer = getMillis();
-	uIntervalMS = 0;
 
-	// Set up OE and SELECT as outputs
+	// Set up OE and SELECT as outputs, OE inactive between scans
 	gpio_init(tg16Options.oePin);
 	gpio_set_dir(tg16Options.oePin, GPIO_OUT);
+	SET_PIN(tg16Options.oePin);
 	gpio_init(tg16Options.selectPin);
 	gpio_set_dir(tg16Options.selectPin, GPIO_OUT);
 
@@ -71,62 +129,16 @@ void TG16padInput::setup()
 		gpio_set_dir(dataPins[i], GPIO_IN);
 		gpio_pull_up(dataPins[i]);
 	}
-}
-
-uint8_t TG16padInput::readController()
-{
-    const TG16Options &tg16Options = Storage::getInstance().getAddonOptions().tg16Options;
-    int dataPins[4] = {tg16Options.dataPin3, tg16Options.dataPin2, tg16Options.dataPin1, tg16Options.dataPin0};
-    uint8_t a = 0, b = 0, c = 0;
-    // Set OE active (active low)
-    CLR_PIN(tg16Options.oePin);
-    sleep_ms(1);
-
-    // SELECT high, read first nibble
-    SET_PIN(tg16Options.selectPin);
-    sleep_ms(1);
-    for (int i = 0; i < 4; ++i)
-    {
-        if (!READ_PIN(dataPins[i])) // active low
-            a |= (1 << i);
-    }
-    // Detect 6-button sequence (SEL high)
-    detectSixButtonSequence(1);
-
-    // SELECT low, read second nibble
-    CLR_PIN(tg16Options.selectPin);
-    sleep_ms(1);
-    for (int i = 0; i < 4; ++i)
-    {
-        if (!READ_PIN(dataPins[i])) // active low
-            b |= (1 << i);
-    }
-    // Detect 6-button sequence (SEL low)
-    detectSixButtonSequence(0);
-
-    // If in 6-button mode, read third nibble (extra buttons)
-    if (sixButtonMode) {
-        // SELECT high again
-        SET_PIN(tg16Options.selectPin);
-        sleep_ms(1);
-        for (int i = 0; i < 4; ++i)
-        {
-            if (!READ_PIN(dataPins[i])) // active low
-                c |= (1 << i);
-        }
-        // After reading, revert SELECT to low
-        CLR_PIN(tg16Options.selectPin);
-    }
-
-    // Set OE inactive
-    SET_PIN(tg16Options.oePin);
 
-    // Pack nibbles: a = 1st (I,II,Select,Run), b = 2nd (Up,Right,Down,Left), c = 3rd (III,IV,V,VI)
-    if (sixButtonMode) {
-        return (a & 0x0F) | ((b & 0x0F) << 4) | ((c & 0x0F) << 8); // 12 bits
-    } else {
-        return (a & 0x0F) | ((b & 0x0F) << 4); // 8 bits
-    }
+	scanner.oePin = tg16Options.oePin;
+	scanner.selectPin = tg16Options.selectPin;
+	scanner.dataPins[0] = tg16Options.dataPin3;
+	scanner.dataPins[1] = tg16Options.dataPin2;
+	scanner.dataPins[2] = tg16Options.dataPin1;
+	scanner.dataPins[3] = tg16Options.dataPin0;
+	scanner.step = 0;
+	scanner.data = 0;
+	add_alarm_in_us(TG16_PAD_SETTLE_US, scanStep, nullptr, true);
 }
 
 void TG16padInput::updateButtons(uint16_t data)
@@ -154,16 +166,8 @@ void TG16padInput::updateButtons(uint16_t data)
 
 void TG16padInput::process()
 {
-    if (nextTimer < getMillis())
-    {
-        uint16_t data = readController();
-        updateButtons(data);
-        nextTimer = getMillis() + uIntervalMS;
-    }
-    // Timeout for 6-button mode
-    if (sixButtonMode && getMillis() > sixButtonTimeout) {
-        sixButtonMode = false;
-    }
+    // the scanner publishes a complete read every scan
+    updateButtons(scanner.data);
 #if TG16_PAD_DEBUG==true
     stdio_init_all();
     const TG16Options &tg16Options = Storage::getInstance().getAddonOptions().tg16Options;
@@ -172,7 +176,7 @@ void TG16padInput::process()
     printf(
         "OE: %d SELECT: %d | I=%1d II=%1d III=%1d IV=%1d V=%1d VI=%1d Select=%1d Run=%1d Up=%1d Down=%1d Left=%1d Right=%1d | 6btn: %d\n",
         oeState, selectState,
-        buttonI, buttonII, buttonIII, buttonIV, buttonV, buttonVI, buttonSelect, buttonRun, dpadUp, dpadDown, dpadLeft, dpadRight, sixButtonMode
+        buttonI, buttonII, buttonIII, buttonIV, buttonV, buttonVI, buttonSelect, buttonRun, dpadUp, dpadDown, dpadLeft, dpadRight, scanner.sixButton
     );
 #endif
     Gamepad *gamepad = Storage::getInstance().GetGamepad();
@@ -65,7 +65,8 @@ void TiltInput::process()
 	// don't process if no pins are bound. we can pause by disabling the addon, but pins are required.
 	if (!options.enabled || ((mapAnalogModLow->pinMask == 0) && (mapAnalogModHigh->pinMask == 0))) return;
 
-	SOCDTiltClean(tiltSOCDMode);
+	tiltLeftState = leftFilter.runSOCDCleaner(tiltSOCDMode, tiltLeftState);
+	tiltRightState = rightFilter.runSOCDCleaner(tiltSOCDMode, tiltRightState);
 
 	Gamepad* gamepad = Storage::getInstance().GetGamepad();
 
@@ -117,14 +118,8 @@ void TiltInput::reloadMappings() {
 	tiltLeftState = 0;
 	tiltRightState = 0;
 
-	lastGPUD = DIRECTION_NONE;
-	lastGPLR = DIRECTION_NONE;
-
-	leftLastTiltUD = DIRECTION_NONE;
-	leftLastTiltLR = DIRECTION_NONE;
-
-	rightLastTiltUD = DIRECTION_NONE;
-	rightLastTiltLR = DIRECTION_NONE;
+	leftFilter.reset();
+	rightFilter.reset();
 }
 
 void TiltInput::OverrideGamepad(Gamepad* gamepad, uint8_t dpad1, uint8_t dpad2) {
@@ -210,108 +205,6 @@ uint16_t TiltInput::getAnalogValue(bool isMin, bool isMax) {
 	}
 }
 
-void TiltInput::SOCDTiltClean(SOCDMode socdMode) {
-    // Left Stick SOCD Cleaning
-	// Tilt SOCD Last-Win Clean
-	switch (tiltLeftState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-	case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-		if (socdMode == SOCD_MODE_UP_PRIORITY) {
-			tiltLeftState ^= GAMEPAD_MASK_DOWN; // Remove Down
-			leftLastTiltUD = DIRECTION_UP; // We're in UP mode
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && leftLastTiltUD != DIRECTION_NONE) {
-			tiltLeftState ^= (leftLastTiltUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-		}
-		else {
-			tiltLeftState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-			leftLastTiltUD = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_UP:
-		leftLastTiltUD = DIRECTION_UP;
-		break;
-	case GAMEPAD_MASK_DOWN:
-		leftLastTiltUD = DIRECTION_DOWN;
-		break;
-	default:
-		leftLastTiltUD = DIRECTION_NONE;
-		break;
-	}
-	switch (tiltLeftState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-	case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-		if (socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL) {
-			tiltLeftState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-			leftLastTiltLR = DIRECTION_NONE;
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) {
-			if (leftLastTiltLR != DIRECTION_NONE)
-				tiltLeftState ^= (leftLastTiltLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-			else
-				leftLastTiltLR = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_LEFT:
-		leftLastTiltLR = DIRECTION_LEFT;
-		break;
-	case GAMEPAD_MASK_RIGHT:
-		leftLastTiltLR = DIRECTION_RIGHT;
-		break;
-	default:
-		leftLastTiltLR = DIRECTION_NONE;
-		break;
-	}
-	// Right Stick SOCD Cleaning
-	// Tilt SOCD Last-Win Clean
-	switch (tiltRightState & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
-	case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN): // If last state was Up or Down, exclude it from our gamepad
-		if (socdMode == SOCD_MODE_UP_PRIORITY) {
-			tiltRightState ^= GAMEPAD_MASK_DOWN; // Remove Down
-			rightLastTiltUD = DIRECTION_UP; // We're in UP mode
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY && rightLastTiltUD != DIRECTION_NONE) {
-			tiltRightState ^= (rightLastTiltUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-		}
-		else {
-			tiltRightState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN); // Remove UP and Down in Neutral
-			rightLastTiltUD = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_UP:
-		rightLastTiltUD = DIRECTION_UP;
-		break;
-	case GAMEPAD_MASK_DOWN:
-		rightLastTiltUD = DIRECTION_DOWN;
-		break;
-	default:
-		rightLastTiltUD = DIRECTION_NONE;
-		break;
-	}
-    
-	switch (tiltRightState & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
-	case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-		if (socdMode == SOCD_MODE_UP_PRIORITY || socdMode == SOCD_MODE_NEUTRAL) {
-			tiltRightState ^= (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT); // Remove L + R to Neutral
-			rightLastTiltLR = DIRECTION_NONE;
-		}
-		else if (socdMode == SOCD_MODE_SECOND_INPUT_PRIORITY) {
-			if (rightLastTiltLR != DIRECTION_NONE)
-				tiltRightState ^= (rightLastTiltLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT; // Last Win
-			else
-				rightLastTiltLR = DIRECTION_NONE;
-		}
-		break;
-	case GAMEPAD_MASK_LEFT:
-		rightLastTiltLR = DIRECTION_LEFT;
-		break;
-	case GAMEPAD_MASK_RIGHT:
-		rightLastTiltLR = DIRECTION_RIGHT;
-		break;
-	default:
-		rightLastTiltLR = DIRECTION_NONE;
-		break;
-	}
-}
-
 void TiltInput::handleProfileChange(GPEvent* e) {
 	reloadMappings();
 }
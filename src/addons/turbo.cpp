@@ -1,18 +1,19 @@
 #include "addons/turbo.h"
 
 #include "hardware/adc.h"
+#include "tusb.h"
 
 #include "storagemanager.h"
 #include "helper.h"
 #include "config.pb.h"
 
 #include <algorithm>
-#include <cmath>
+#include <string.h>
 
 #define TURBO_SHOT_MIN 2
 #define TURBO_SHOT_MAX 30
 #define TURBO_DIAL_INCREMENTS (0xFFF / (TURBO_SHOT_MAX - TURBO_SHOT_MIN)) // 12-bit ADC
-#define TURBO_LOOP_OFFSET 50 // Extra time to compensate for loop runtime variance, turbo lags a bit otherwise
+#define TURBO_DIAL_INTERVAL_MS 100
 
 #ifndef TURBO_LED_STATE_OFF
 #define TURBO_LED_STATE_OFF 0
@@ -92,6 +93,17 @@ void TurboInput::setup(){
         turboButtonsMask = 0;
     }
 
+    // Per button shot counts, bit order of the gamepad button masks
+    memset(buttonShotCount, 0, sizeof(buttonShotCount));
+    const uint32_t rates[TURBO_RATE_BUTTON_COUNT] = {
+        options.shotCountB1, options.shotCountB2, options.shotCountB3, options.shotCountB4,
+        options.shotCountL1, options.shotCountR1, options.shotCountL2, options.shotCountR2,
+    };
+    for (uint8_t i = 0; i < TURBO_RATE_BUTTON_COUNT; i++) {
+        if (rates[i] != 0)
+            buttonShotCount[i] = std::clamp<uint32_t>(rates[i], TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+    }
+
     lastButtons = 0;
     bDebState = false;
     uDebTime = now;
@@ -102,8 +114,10 @@ void TurboInput::setup(){
     incrementValue = 0;
     lastPressed = 0;
     lastDpad = 0;
-    bTurboFlicker = false;
-    nextTimer = getMicro();
+    lastTurboPressed = 0;
+    usbFrames.reset();
+    nextAdcRead = now + TURBO_DIAL_INTERVAL_MS;
+    adcConverting = false;
     encoderValue = shotCount;
     updateTurboShotCount(shotCount, false);
 }
@@ -146,9 +160,6 @@ void TurboInput::process()
             if (options.shmupModeEnabled) {
                 turboButtonsMask |= alwaysEnabled;  // SHMUP Always-on Buttons Set
             }
-
-            // Reset Turbo flicker on a new button press
-            bTurboFlicker = false;
         }
 
         if (dpadPressed & GAMEPAD_MASK_DOWN && (lastDpad != dpadPressed)) {
@@ -178,24 +189,16 @@ void TurboInput::process()
         }
     }
 
-    uint64_t now = getMicro();
-
-    // Use the dial to modify our turbo shot speed (don't save on dial modify)
-    if (hasShmupDial && nextAdcRead < now) {
+    // Start a dial conversion, it finishes while the report is sent and postprocess collects it
+    if (hasShmupDial && !adcConverting && (int32_t)(getMillis() - nextAdcRead) >= 0) {
         adc_select_input(adcShmupDial);
-        dialValue = adc_read();
-        uint8_t shotCount = (dialValue / TURBO_DIAL_INCREMENTS) + TURBO_SHOT_MIN;
-        if (shotCount != options.shotCount) {
-            updateTurboShotCount(shotCount, false);
-        }
-        nextAdcRead = now + 100000; // Sample every 100ms
+        hw_set_bits(&adc_hw->cs, ADC_CS_START_ONCE_BITS);
+        adcConverting = true;
     }
 
-    // Check if we've reached the next timer right before applying turbo state
-    if (nextTimer < now) {
-        bTurboFlicker ^= true;
-        nextTimer = now + uIntervalUS - TURBO_LOOP_OFFSET;
-    }
+    // Phases of the turbo buttons being held, charge buttons included
+    uint16_t turboPressed = (gamepad->state.buttons | (options.shmupModeEnabled ? chargeState : 0)) & turboButtonsMask;
+    uint16_t flickerMask = getFlickerMask(turboPressed);
 
     // Set TURBO LED
     // OFF: No turbo buttons enabled
@@ -204,7 +207,7 @@ void TurboInput::process()
     Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
     if (turboButtonsMask) {
         if (gamepad->state.buttons & turboButtonsMask)
-            processedGamepad->auxState.turbo.activity = bTurboFlicker ? TURBO_LED_STATE_ON : TURBO_LED_STATE_OFF;
+            processedGamepad->auxState.turbo.activity = flickerMask ? TURBO_LED_STATE_ON : TURBO_LED_STATE_OFF;
         else
             processedGamepad->auxState.turbo.activity = TURBO_LED_STATE_ON;
     } else {
@@ -228,16 +231,70 @@ void TurboInput::process()
         gamepad->state.buttons |= chargeState;  // Inject Mask into button states
     }
 
-    // Disable button during turbo flicker
-    if (bTurboFlicker) {
+    // Disable buttons during their turbo flicker
+    if (flickerMask) {
         if ( options.shmupModeEnabled && options.shmupMixMode == SHMUP_MIX_MODE_CHARGE_PRIORITY) {
-            gamepad->state.buttons &= ~(turboButtonsMask & ~(chargeState));  // Do not flicker charge buttons
+            gamepad->state.buttons &= ~(flickerMask & ~(chargeState));  // Do not flicker charge buttons
         } else {
-            gamepad->state.buttons &= ~(turboButtonsMask);
+            gamepad->state.buttons &= ~(flickerMask);
         }
     }
 }
 
+void TurboInput::postprocess(bool sent)
+{
+    if (!adcConverting || !(adc_hw->cs & ADC_CS_READY_BITS))
+        return;
+
+    // Use the dial to modify our turbo shot speed (don't save on dial modify)
+    const TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
+    dialValue = adc_hw->result;
+    adcConverting = false;
+    nextAdcRead = getMillis() + TURBO_DIAL_INTERVAL_MS;
+    uint8_t shotCount = (dialValue / TURBO_DIAL_INCREMENTS) + TURBO_SHOT_MIN;
+    if (shotCount != options.shotCount) {
+        updateTurboShotCount(shotCount, false);
+    }
+}
+
+uint32_t TurboInput::frameClock()
+{
+    // Without a host there are no SOFs to count, milliseconds keep the same pace
+    uint32_t frameCount = usbFrames.update();
+    return tud_mounted() ? frameCount : getMillis();
+}
+
+/**
+ * @brief Turbo buttons currently in the off half of their shot.
+ *
+ * Every button counts its shots from the frame it was pressed on, so the first shot is
+ * always a whole one. The phase is worked out from the frames since then rather than
+ * toggled by a timer, so each half lasts a whole number of USB frames and the average
+ * rate is exact.
+ */
+uint16_t TurboInput::getFlickerMask(uint16_t pressed)
+{
+    const TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
+    uint32_t frame = frameClock();
+    uint16_t newlyPressed = pressed & ~lastTurboPressed;
+    lastTurboPressed = pressed;
+
+    uint16_t flickerMask = 0;
+    for (uint8_t i = 0; i < TURBO_PHASE_BUTTON_COUNT; i++) {
+        uint16_t bit = 1 << i;
+        if (!(pressed & bit))
+            continue;
+        if (newlyPressed & bit)
+            turboStart[i] = frame;
+
+        uint32_t shotCount = buttonShotCount[i] ? buttonShotCount[i] : options.shotCount;
+        uint64_t halfShots = ((uint64_t)(frame - turboStart[i]) * shotCount * 2) / 1000;
+        if (halfShots & 1)
+            flickerMask |= bit;
+    }
+    return flickerMask;
+}
+
 void TurboInput::updateTurboShotCount(uint8_t shotCount, bool save) {
   TurboOptions &options = Storage::getInstance().getAddonOptions().turboOptions;
   shotCount = std::clamp<uint8_t>(shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
@@ -248,6 +305,4 @@ void TurboInput::updateTurboShotCount(uint8_t shotCount, bool save) {
   if (save) {
     EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(false));
   }
-
-  uIntervalUS = (uint32_t)std::floor(1000000.0 / (shotCount * 2));
 }
@@ -41,19 +41,23 @@ void WiiExtensionInput::setup() {
 
     reloadConfig();
 
-    // Run during setup to catch boot selection mode
-    wii->poll();
+    // Run during setup to catch boot selection mode, the first report needs a few transfers
+    uint32_t firstReportTimeout = getMillis() + WII_FIRST_REPORT_TIMEOUT_MS;
+    while (!wii->poll() && (wii->extensionType != WII_EXTENSION_NONE) && (getMillis() < firstReportTimeout)) {}
 
     update();
 }
 
 void WiiExtensionInput::process() {
-    if (nextTimer < getMillis()) {
-        wii->poll();
+    // in the background poll() only takes the newest report, a blocking bus is still read at most
+    // once a millisecond. Only a changed report needs mapping again
+    bool blocking = !wii->isAsync();
+    if (!blocking || (nextTimer < getMillis())) {
+        if (wii->poll() || (wii->extensionType == WII_EXTENSION_NONE)) {
+            update();
+        }
 
-        update();
-              
-        nextTimer = getMillis() + uIntervalMS;
+        if (blocking) nextTimer = getMillis() + uIntervalMS;
     }
 
     if (currentConfig != NULL) {
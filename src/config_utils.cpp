@@ -328,66 +328,98 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey01, buttonsMask, HOTKEY_01_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey01, dpadMask, HOTKEY_01_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey01, action, GamepadHotkey(HOTKEY_01_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey01, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey01, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, auxMask, HOTKEY_02_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, buttonsMask, HOTKEY_02_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, dpadMask, HOTKEY_02_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, action, GamepadHotkey(HOTKEY_02_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey02, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, auxMask, HOTKEY_03_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, buttonsMask, HOTKEY_03_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, dpadMask, HOTKEY_03_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, action, GamepadHotkey(HOTKEY_03_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey03, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, auxMask, HOTKEY_04_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, buttonsMask, HOTKEY_04_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, dpadMask, HOTKEY_04_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, action, GamepadHotkey(HOTKEY_04_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey04, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, auxMask, HOTKEY_05_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, buttonsMask, HOTKEY_05_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, dpadMask, HOTKEY_05_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, action, GamepadHotkey(HOTKEY_05_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey05, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, auxMask, HOTKEY_06_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, buttonsMask, HOTKEY_06_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, dpadMask, HOTKEY_06_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, action, GamepadHotkey(HOTKEY_06_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey06, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, auxMask, HOTKEY_07_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, buttonsMask, HOTKEY_07_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, dpadMask, HOTKEY_07_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, action, GamepadHotkey(HOTKEY_07_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey07, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, auxMask, HOTKEY_08_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, buttonsMask, HOTKEY_08_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, dpadMask, HOTKEY_08_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, action, GamepadHotkey(HOTKEY_08_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey08, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, auxMask, HOTKEY_09_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, buttonsMask, HOTKEY_09_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, dpadMask, HOTKEY_09_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, action, GamepadHotkey(HOTKEY_09_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey09, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, auxMask, HOTKEY_10_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, buttonsMask, HOTKEY_10_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, dpadMask, HOTKEY_10_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, action, GamepadHotkey(HOTKEY_10_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey10, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, auxMask, HOTKEY_11_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, buttonsMask, HOTKEY_11_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, dpadMask, HOTKEY_11_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, action, GamepadHotkey(HOTKEY_11_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey11, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, auxMask, HOTKEY_12_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, buttonsMask, HOTKEY_12_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, dpadMask, HOTKEY_12_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, action, GamepadHotkey(HOTKEY_12_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey12, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, auxMask, HOTKEY_13_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, buttonsMask, HOTKEY_13_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, dpadMask, HOTKEY_13_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, action, GamepadHotkey(HOTKEY_13_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey13, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, auxMask, HOTKEY_14_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, buttonsMask, HOTKEY_14_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, dpadMask, HOTKEY_14_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, action, GamepadHotkey(HOTKEY_14_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey14, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, auxMask, HOTKEY_15_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, buttonsMask, HOTKEY_15_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, dpadMask, HOTKEY_15_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, action, GamepadHotkey(HOTKEY_15_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey15, ordered, false);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, auxMask, HOTKEY_16_AUX_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, buttonsMask, HOTKEY_16_BUTTONS_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, dpadMask, HOTKEY_16_DPAD_MASK);
     INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, action, GamepadHotkey(HOTKEY_16_ACTION));
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, holdDuration, 0);
+    INIT_UNSET_PROPERTY(hotkeyOptions.hotkey16, ordered, false);
 
     // forcedSetupMode
     INIT_UNSET_PROPERTY(config.forcedSetupOptions, mode, DEFAULT_FORCED_SETUP_MODE);
@@ -663,6 +695,12 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, outer_deadzone2, DEFAULT_OUTER_DEADZONE2);
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, auto_calibrate2, !!AUTO_CALIBRATE2_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, forced_circularity2, !!FORCED_CIRCULARITY2_ENABLED);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_curve, ANALOG_CURVE);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_curve2, ANALOG_CURVE2);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_curve_points, ANALOG_CURVE_POINTS);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_curve_points2, ANALOG_CURVE_POINTS2);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_oversample, ANALOG_OVERSAMPLE);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_oversample2, ANALOG_OVERSAMPLE2);
 
     // addonOptions.turboOptions
     INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, enabled, !!TURBO_ENABLED);
@@ -685,6 +723,14 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shmupBtnMask4, SHMUP_BUTTON4);
     INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shmupMixMode, SHMUP_MIX_MODE);
     INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, turboLedType, TURBO_LED_TYPE);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountB1, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountB2, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountB3, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountB4, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountL1, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountR1, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountL2, 0);
+    INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, shotCountR2, 0);
 
     // addonOptions.reverseOptions
     INIT_UNSET_PROPERTY(config.addonOptions.reverseOptions, enabled, !!REVERSE_ENABLED);
@@ -785,6 +831,7 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     // addonOptions.pcf8575Options
     INIT_UNSET_PROPERTY(config.addonOptions.pcf8575Options, enabled, I2C_PCF8575_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.pcf8575Options, deprecatedI2cBlock, (I2C_PCF8575_BLOCK == i2c0) ? 0 : 1);
+    INIT_UNSET_PROPERTY(config.addonOptions.pcf8575Options, interruptPin, PCF8575_INTERRUPT_PIN);
 
     GpioAction pcf8575Actions[PCF8575_PIN_COUNT] = {
         PCF8575_PIN00_ACTION,PCF8575_PIN01_ACTION,PCF8575_PIN02_ACTION,PCF8575_PIN03_ACTION,
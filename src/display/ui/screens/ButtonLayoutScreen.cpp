@@ -256,6 +256,9 @@ void ButtonLayoutScreen::generateHeader() {
 	}
 
     if (showInputMode) {
+        // Input mode can be switched live, pick up the running one
+        inputMode = DriverManager::getInstance().getInputMode();
+
         // Display standard header
         switch (inputMode)
         {
@@ -320,10 +320,10 @@ void MainMenuScreen::selectInputMode() {
 
         chooseAndReturn();
 
+        // input mode is switched live, it is only written to flash when the user saves
         if (prevInputMode != valueToSave) {
-            // input mode requires a save and reboot
-            changeRequiresReboot = true;
-            changeRequiresSave = true;
+            inputModeUnsaved = true;
+            EventManager::getInstance().triggerEvent(new GPInputModeChangeEvent(valueToSave));
         }
     }
 }
@@ -366,7 +366,6 @@ int32_t MainMenuScreen::currentSOCDMode() {
 
 void MainMenuScreen::resetOptions() {
     if (changeRequiresSave) {
-        if (prevInputMode != updateInputMode) updateInputMode = prevInputMode;
         if (prevDpadMode != updateDpadMode) updateDpadMode = prevDpadMode;
         if (prevSocdMode != updateSocdMode) updateSocdMode = prevSocdMode;
         if (prevProfile != updateProfile) updateProfile = prevProfile;
@@ -383,12 +382,14 @@ void MainMenuScreen::saveOptions() {
     GamepadOptions& options = Storage::getInstance().getGamepadOptions();
     AddonOptions& addonOptions = Storage::getInstance().getAddonOptions();
 
+    bool saveHasChanged = false;
+    // the running driver already updated options.inputMode when it switched
+    if (inputModeUnsaved) {
+        saveHasChanged = true;
+        inputModeUnsaved = false;
+    }
+
     if (changeRequiresSave) {
-        bool saveHasChanged = false;
-        if (prevInputMode != updateInputMode) {
-            options.inputMode = updateInputMode;
-            saveHasChanged = true;
-        }
         if (prevDpadMode != updateDpadMode) {
             options.dpadMode = updateDpadMode;
             saveHasChanged = true;
@@ -410,13 +411,14 @@ void MainMenuScreen::saveOptions() {
             saveHasChanged = true;
         }
 
-        if (saveHasChanged) {
-            EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(true, changeRequiresReboot));
-        }
         changeRequiresSave = false;
-        changeRequiresReboot = false;
     }
 
+    if (saveHasChanged) {
+        EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(true, changeRequiresReboot));
+    }
+    changeRequiresReboot = false;
+
     screenIsPrompting = false;
 
     if (exitToScreenBeforePrompt != -1) {
@@ -19,68 +19,152 @@
 #include "drivers/p5general/P5GeneralDriver.h"
 
 #include "usbhostmanager.h"
+#include "storagemanager.h"
+
+#include "pico/time.h"
 
 void DriverManager::setup(InputMode mode) {
+    driver = createDriver(mode);
+    if (driver == nullptr)
+        return;
+
+    // Initialize our chosen driver
+    driver->initialize();
+#if USB_TELEMETRY_ENABLED
+    classDrivers[0] = *USBTelemetry::getInstance().getClassDriver();
+#endif
+    classDrivers[DRIVER_MANAGER_CLASS_DRIVERS - 1] = *driver->get_class_driver();
+    inputMode = mode;
+}
+
+GPDriver * DriverManager::createDriver(InputMode mode) {
     switch (mode) {
         case INPUT_MODE_CONFIG:
-            driver = new NetDriver();
-            break;
+            return new NetDriver();
         case INPUT_MODE_ASTRO:
-            driver = new AstroDriver();
-            break;
+            return new AstroDriver();
         case INPUT_MODE_EGRET:
-            driver = new EgretDriver();
-            break;
+            return new EgretDriver();
         case INPUT_MODE_KEYBOARD:
-            driver = new KeyboardDriver();
-            break;
+            return new KeyboardDriver();
         case INPUT_MODE_GENERIC:
-            driver = new HIDDriver();
-            break;
+            return new HIDDriver();
         case INPUT_MODE_MDMINI:
-            driver = new MDMiniDriver();
-            break;
+            return new MDMiniDriver();
         case INPUT_MODE_NEOGEO:
-            driver = new NeoGeoDriver();
-            break;
+            return new NeoGeoDriver();
         case INPUT_MODE_PSCLASSIC:
-            driver = new PSClassicDriver();
-            break;
+            return new PSClassicDriver();
         case INPUT_MODE_PCEMINI:
-            driver = new PCEngineDriver();
-            break;
+            return new PCEngineDriver();
         case INPUT_MODE_PS3:
-            driver = new PS3Driver();
-            break;
+            return new PS3Driver();
         case INPUT_MODE_PS4:
-            driver = new PS4Driver(PS4_CONTROLLER);
-            break;
+            return new PS4Driver(PS4_CONTROLLER);
         case INPUT_MODE_PS5:
-            driver = new PS4Driver(PS4_ARCADESTICK);
-            break;
+            return new PS4Driver(PS4_ARCADESTICK);
         case INPUT_MODE_P5GENERAL:
-            driver = new P5GeneralDriver();
-            break;
+            return new P5GeneralDriver();
         case INPUT_MODE_SWITCH:
-            driver = new SwitchDriver();
-            break;
+            return new SwitchDriver();
         case INPUT_MODE_XBONE:
-            driver = new XBOneDriver();
-            break;
+            return new XBOneDriver();
         case INPUT_MODE_XBOXORIGINAL:
-            driver = new XboxOriginalDriver();
-            break;
+            return new XboxOriginalDriver();
         case INPUT_MODE_XINPUT:
-            driver = new XInputDriver();
-            break;
+            return new XInputDriver();
         case INPUT_MODE_SWITCH_PRO:
-            driver = new SwitchProDriver();
-            break;
+            return new SwitchProDriver();
         default:
-            return;
+            return nullptr;
+    }
+}
+
+// Replace the running driver without going through a reboot:
+// detach from the bus, park core1, tear down the old driver and its auth
+// listener, bring up the new one and re-attach so the host enumerates it.
+// Add-ons and storage are left alone. Web config runs its own network stack
+// and main loop, so entering or leaving it still needs a reboot.
+bool DriverManager::switchInputMode(InputMode mode) {
+    if (driver == nullptr || mode == inputMode || mode == INPUT_MODE_CONFIG || isConfigMode())
+        return false;
+
+    GPDriver * newDriver = createDriver(mode);
+    if (newDriver == nullptr)
+        return false;
+
+    absolute_time_t reattachTime = make_timeout_time_ms(INPUT_MODE_SWITCH_DETACH_MS);
+    tud_disconnect();
+
+    // flush anything TinyUSB queued for the old driver before it goes away
+    tud_task();
+
+    // core1 runs processAux() on the current driver, wait until it is parked
+    // and stay on the old driver if it doesn't get there in time
+    absolute_time_t pauseTimeout = make_timeout_time_ms(INPUT_MODE_SWITCH_PAUSE_TIMEOUT_MS);
+    auxPauseRequested = true;
+    while (!auxPaused) {
+        if (time_reached(pauseTimeout)) {
+            auxPauseRequested = false;
+            delete newDriver;
+            sleep_until(reattachTime);
+            tud_connect();
+            return false;
+        }
+        tight_loop_contents();
     }
 
-    // Initialize our chosen driver
+    USBListener * listener = driver->get_usb_auth_listener();
+    if (listener != nullptr) {
+        USBHostManager::getInstance().removeListener(listener);
+    }
+    delete driver;
+
+    driver = newDriver;
     driver->initialize();
+
+    listener = driver->get_usb_auth_listener();
+    if (listener != nullptr) {
+        USBHostManager::getInstance().pushListener(listener);
+        USBHostManager::getInstance().start();
+    }
+
+    // TinyUSB only runs init() for the class driver it found in tud_init()
+    usbd_class_driver_t & classDriver = classDrivers[DRIVER_MANAGER_CLASS_DRIVERS - 1];
+    classDriver = *driver->get_class_driver();
+    if (classDriver.init != nullptr) {
+        classDriver.init();
+    }
     inputMode = mode;
+
+    // keep the in-memory options in step with the running driver before
+    // core1 looks at them again, saving is up to whoever asked for the switch
+    Storage::getInstance().GetGamepad()->setInputMode(mode);
+
+    // let core1 pick up the new driver and run its aux setup, as it does at boot
+    auxInitPending = true;
+    auxPauseRequested = false;
+    while (auxPaused) {
+        tight_loop_contents();
+    }
+
+    sleep_until(reattachTime);
+    tud_connect();
+    return true;
+}
+
+void DriverManager::checkAuxPause() {
+    if (!auxPauseRequested)
+        return;
+
+    auxPaused = true;
+    while (auxPauseRequested) {
+        tight_loop_contents();
+    }
+
+    if (auxInitPending) {
+        auxInitPending = false;
+        driver->initializeAux();
+    }
+    auxPaused = false;
 }
@@ -149,14 +149,16 @@ const uint16_t * HIDDriver::get_descriptor_string_cb(uint8_t index, uint16_t lan
                 value = gamepadOptions.usbDescVersion;
                 break;
             default:
-                value = (char *)hid_string_descriptors[index];
+                value = nullptr;
                 break;
         }
-    } else {
-        value = (char *)hid_string_descriptors[index];
+        if (value != nullptr)
+            return getStringDescriptor(value, index); // getStringDescriptor returns a static array
     }
 
-	return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+    if (index >= sizeof(hid_string_descriptors) / sizeof(hid_string_descriptors[0]))
+        return nullptr;
+    return hid_string_descriptors[index];
 }
 
 const uint8_t * HIDDriver::get_descriptor_device_cb() {
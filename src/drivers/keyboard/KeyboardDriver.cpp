@@ -1,16 +1,69 @@
 #include "drivers/keyboard/KeyboardDriver.h"
 #include "storagemanager.h"
-#include "drivers/shared/driverhelper.h"
 #include "drivers/hid/HIDDescriptors.h"
 
 #include "eventmanager.h"
 
+KeyboardDriver::~KeyboardDriver() {
+    // the handler captures this, drop it before a mode switch frees the driver
+    if (encoderHandle != 0) {
+        EventManager::getInstance().unregisterEventHandler(GP_EVENT_ENCODER_CHANGE, encoderHandle);
+    }
+}
+
 void KeyboardDriver::initialize() {
-	keyboardReport = {
-		.keycode = { 0 },
-		.multimedia = 0
+	memset(&keyboardReport, 0, sizeof(keyboardReport));
+	memset(&lastReport, 0, sizeof(lastReport));
+	lastProtocol = HID_PROTOCOL_REPORT;
+
+	// Resolve every mapped input to its bit in the report once, instead of per report
+	const KeyboardMapping& keyboardMapping = Storage::getInstance().getKeyboardMapping();
+	const struct { uint32_t mask; uint32_t code; } buttonMap[] = {
+		{ GAMEPAD_MASK_B1,  keyboardMapping.keyButtonB1 },
+		{ GAMEPAD_MASK_B2,  keyboardMapping.keyButtonB2 },
+		{ GAMEPAD_MASK_B3,  keyboardMapping.keyButtonB3 },
+		{ GAMEPAD_MASK_B4,  keyboardMapping.keyButtonB4 },
+		{ GAMEPAD_MASK_L1,  keyboardMapping.keyButtonL1 },
+		{ GAMEPAD_MASK_R1,  keyboardMapping.keyButtonR1 },
+		{ GAMEPAD_MASK_L2,  keyboardMapping.keyButtonL2 },
+		{ GAMEPAD_MASK_R2,  keyboardMapping.keyButtonR2 },
+		{ GAMEPAD_MASK_S1,  keyboardMapping.keyButtonS1 },
+		{ GAMEPAD_MASK_S2,  keyboardMapping.keyButtonS2 },
+		{ GAMEPAD_MASK_L3,  keyboardMapping.keyButtonL3 },
+		{ GAMEPAD_MASK_R3,  keyboardMapping.keyButtonR3 },
+		{ GAMEPAD_MASK_A1,  keyboardMapping.keyButtonA1 },
+		{ GAMEPAD_MASK_A2,  keyboardMapping.keyButtonA2 },
+		{ GAMEPAD_MASK_A3,  keyboardMapping.keyButtonA3 },
+		{ GAMEPAD_MASK_A4,  keyboardMapping.keyButtonA4 },
+		{ GAMEPAD_MASK_E1,  keyboardMapping.keyButtonE1 },
+		{ GAMEPAD_MASK_E2,  keyboardMapping.keyButtonE2 },
+		{ GAMEPAD_MASK_E3,  keyboardMapping.keyButtonE3 },
+		{ GAMEPAD_MASK_E4,  keyboardMapping.keyButtonE4 },
+		{ GAMEPAD_MASK_E5,  keyboardMapping.keyButtonE5 },
+		{ GAMEPAD_MASK_E6,  keyboardMapping.keyButtonE6 },
+		{ GAMEPAD_MASK_E7,  keyboardMapping.keyButtonE7 },
+		{ GAMEPAD_MASK_E8,  keyboardMapping.keyButtonE8 },
+		{ GAMEPAD_MASK_E9,  keyboardMapping.keyButtonE9 },
+		{ GAMEPAD_MASK_E10, keyboardMapping.keyButtonE10 },
+		{ GAMEPAD_MASK_E11, keyboardMapping.keyButtonE11 },
+		{ GAMEPAD_MASK_E12, keyboardMapping.keyButtonE12 },
+	};
+	const struct { uint8_t mask; uint32_t code; } dpadMap[] = {
+		{ GAMEPAD_MASK_UP,    keyboardMapping.keyDpadUp },
+		{ GAMEPAD_MASK_DOWN,  keyboardMapping.keyDpadDown },
+		{ GAMEPAD_MASK_LEFT,  keyboardMapping.keyDpadLeft },
+		{ GAMEPAD_MASK_RIGHT, keyboardMapping.keyDpadRight },
 	};
 
+	memset(buttonKeys, 0, sizeof(buttonKeys));
+	memset(dpadKeys, 0, sizeof(dpadKeys));
+	for (const auto& button : buttonMap) {
+		buttonKeys[__builtin_ctz(button.mask)] = getKeyBit(button.code);
+	}
+	for (const auto& dpad : dpadMap) {
+		dpadKeys[__builtin_ctz(dpad.mask)] = getKeyBit(dpad.code);
+	}
+
 	class_driver = {
 	#if CFG_TUSB_DEBUG >= 2
 		.name = "KEYBOARD",
@@ -24,23 +77,19 @@ void KeyboardDriver::initialize() {
 	};
 
     // Handle Volume for Rotary Encoder
-    EventManager::getInstance().registerEventHandler(GP_EVENT_ENCODER_CHANGE, GPEVENT_CALLBACK(this->handleEncoder(event)));
+    encoderHandle = EventManager::getInstance().registerEventHandler(GP_EVENT_ENCODER_CHANGE, GPEVENT_CALLBACK(this->handleEncoder(event)));
     volumeChange = 0; // no change
 }
 
-uint8_t KeyboardDriver::getModifier(uint8_t code) {
-	switch (code) {
-		case HID_KEY_CONTROL_LEFT : return KEYBOARD_MODIFIER_LEFTCTRL  ;
-		case HID_KEY_SHIFT_LEFT   : return KEYBOARD_MODIFIER_LEFTSHIFT ;
-		case HID_KEY_ALT_LEFT     : return KEYBOARD_MODIFIER_LEFTALT   ;
-		case HID_KEY_GUI_LEFT     : return KEYBOARD_MODIFIER_LEFTGUI   ;
-		case HID_KEY_CONTROL_RIGHT: return KEYBOARD_MODIFIER_RIGHTCTRL ;
-		case HID_KEY_SHIFT_RIGHT  : return KEYBOARD_MODIFIER_RIGHTSHIFT;
-		case HID_KEY_ALT_RIGHT    : return KEYBOARD_MODIFIER_RIGHTALT  ;
-		case HID_KEY_GUI_RIGHT    : return KEYBOARD_MODIFIER_RIGHTGUI  ;
+KeyboardKeyBit KeyboardDriver::getKeyBit(uint8_t code) {
+	KeyboardKeyBit key = { 0, 0, 0 };
+	if (code > HID_KEY_GUI_RIGHT) {
+		key.multimedia = getMultimedia(code);
+	} else if (code != HID_KEY_NONE) {
+		key.index = code / 8;
+		key.mask = 1 << (code % 8);
 	}
-
-	return 0;
+	return key;
 }
 
 uint8_t KeyboardDriver::getMultimedia(uint8_t code) {
@@ -56,106 +105,121 @@ uint8_t KeyboardDriver::getMultimedia(uint8_t code) {
 	return 0;
 }
 
-
 bool KeyboardDriver::process(Gamepad * gamepad) {
-	const KeyboardMapping& keyboardMapping = Storage::getInstance().getKeyboardMapping();
-	releaseAllKeys();
-	if(gamepad->pressedUp())     { pressKey(keyboardMapping.keyDpadUp); }
-	if(gamepad->pressedDown())   { pressKey(keyboardMapping.keyDpadDown); }
-	if(gamepad->pressedLeft())	{ pressKey(keyboardMapping.keyDpadLeft); }
-	if(gamepad->pressedRight()) 	{ pressKey(keyboardMapping.keyDpadRight); }
-	if(gamepad->pressedB1()) 	{ pressKey(keyboardMapping.keyButtonB1); }
-	if(gamepad->pressedB2()) 	{ pressKey(keyboardMapping.keyButtonB2); }
-	if(gamepad->pressedB3()) 	{ pressKey(keyboardMapping.keyButtonB3); }
-	if(gamepad->pressedB4()) 	{ pressKey(keyboardMapping.keyButtonB4); }
-	if(gamepad->pressedL1()) 	{ pressKey(keyboardMapping.keyButtonL1); }
-	if(gamepad->pressedR1()) 	{ pressKey(keyboardMapping.keyButtonR1); }
-	if(gamepad->pressedL2()) 	{ pressKey(keyboardMapping.keyButtonL2); }
-	if(gamepad->pressedR2()) 	{ pressKey(keyboardMapping.keyButtonR2); }
-	if(gamepad->pressedS1()) 	{ pressKey(keyboardMapping.keyButtonS1); }
-	if(gamepad->pressedS2()) 	{ pressKey(keyboardMapping.keyButtonS2); }
-	if(gamepad->pressedL3()) 	{ pressKey(keyboardMapping.keyButtonL3); }
-	if(gamepad->pressedR3()) 	{ pressKey(keyboardMapping.keyButtonR3); }
-	if(gamepad->pressedA1()) 	{ pressKey(keyboardMapping.keyButtonA1); }
-	if(gamepad->pressedA2()) 	{ pressKey(keyboardMapping.keyButtonA2); }
-	if(gamepad->pressedA3()) 	{ pressKey(keyboardMapping.keyButtonA3); }
-	if(gamepad->pressedA4()) 	{ pressKey(keyboardMapping.keyButtonA4); }
-	if(gamepad->pressedE1()) 	{ pressKey(keyboardMapping.keyButtonE1); }
-	if(gamepad->pressedE2()) 	{ pressKey(keyboardMapping.keyButtonE2); }
-	if(gamepad->pressedE3()) 	{ pressKey(keyboardMapping.keyButtonE3); }
-	if(gamepad->pressedE4()) 	{ pressKey(keyboardMapping.keyButtonE4); }
-	if(gamepad->pressedE5()) 	{ pressKey(keyboardMapping.keyButtonE5); }
-	if(gamepad->pressedE6()) 	{ pressKey(keyboardMapping.keyButtonE6); }
-	if(gamepad->pressedE7()) 	{ pressKey(keyboardMapping.keyButtonE7); }
-	if(gamepad->pressedE8()) 	{ pressKey(keyboardMapping.keyButtonE8); }
-	if(gamepad->pressedE9()) 	{ pressKey(keyboardMapping.keyButtonE9); }
-	if(gamepad->pressedE10()) 	{ pressKey(keyboardMapping.keyButtonE10); }
-	if(gamepad->pressedE11()) 	{ pressKey(keyboardMapping.keyButtonE11); }
-	if(gamepad->pressedE12()) 	{ pressKey(keyboardMapping.keyButtonE12); }
-
-    if( volumeChange > 0 ) {
-        pressKey(KEYBOARD_MULTIMEDIA_VOLUME_UP);
-    } else if ( volumeChange < 0 ) {
-        pressKey(KEYBOARD_MULTIMEDIA_VOLUME_DOWN);
-    }
+	memset(&keyboardReport, 0, sizeof(keyboardReport));
+
+	// Only visit the inputs that are held
+	uint32_t buttons = gamepad->state.buttons;
+	while (buttons) {
+		pressKey(buttonKeys[__builtin_ctz(buttons)]);
+		buttons &= buttons - 1;
+	}
+	uint8_t dpad = gamepad->state.dpadOriginal & GAMEPAD_MASK_DPAD;
+	while (dpad) {
+		pressKey(dpadKeys[__builtin_ctz(dpad)]);
+		dpad &= dpad - 1;
+	}
+
+	// Each encoder step is a volume press followed by a release
+	uint8_t volumeKey = 0;
+	if (volumeChange != 0) {
+		volumeKey = getMultimedia(volumeChange > 0 ? KEYBOARD_MULTIMEDIA_VOLUME_UP : KEYBOARD_MULTIMEDIA_VOLUME_DOWN);
+		if ((lastReport.multimedia & volumeKey) == 0)
+			keyboardReport.multimedia |= volumeKey;
+	}
 
 	// Wake up TinyUSB device
 	if (tud_suspended())
 		tud_remote_wakeup();
 
-	void *keyboard_report_payload;
-	uint16_t keyboard_report_size;
-	if ( keyboardReport.reportId == KEYBOARD_KEY_REPORT_ID ) {
-		keyboard_report_payload = (void *)keyboardReport.keycode;
-		keyboard_report_size = sizeof(KeyboardReport::keycode);
-		
-	} else {
-		keyboard_report_payload = (void *)&keyboardReport.multimedia;
-		keyboard_report_size = sizeof(KeyboardReport::multimedia);
+	// The host picks boot or report protocol with SET_PROTOCOL, the report
+	// format changes with it so the current state has to be sent again
+	uint8_t protocol = tud_hid_get_protocol();
+	if (protocol != lastProtocol) {
+		lastProtocol = protocol;
+		memset(lastReport.keycode, 0xFF, sizeof(lastReport.keycode));
 	}
 
-	// If we had a keycode but now have a multimedia key OR report is different
-	if (keyboard_report_size != last_report_size || 
-			memcmp(last_report, keyboard_report_payload, last_report_size) != 0) {
-		if (tud_hid_ready()) {
-			if ( tud_hid_report(keyboardReport.reportId, keyboard_report_payload, keyboard_report_size) ) {
-				memcpy(last_report, keyboard_report_payload, keyboard_report_size);
-				last_report_size = keyboard_report_size;
-
-                // Adjust volume on success
-                if( volumeChange > 0 ) {
-                    volumeChange--;
-                } else if ( volumeChange < 0 ) {
-                    volumeChange++;
-                }
-				return true;
-			}
+	if (!tud_hid_ready())
+		return false;
+
+	if (memcmp(keyboardReport.keycode, lastReport.keycode, sizeof(KeyboardReport::keycode)) != 0)
+		return sendKeyReport();
+
+	// Boot protocol has no consumer control report
+	if (lastProtocol == HID_PROTOCOL_REPORT && keyboardReport.multimedia != lastReport.multimedia) {
+		if (!sendMultimediaReport())
+			return false;
+
+		// Adjust volume once the press is out
+		if (keyboardReport.multimedia & volumeKey) {
+			volumeChange += (volumeChange > 0) ? -1 : 1;
 		}
+		return true;
 	}
-	
+
 	return false;
 }
 
-void KeyboardDriver::pressKey(uint8_t code) {
-	if (code > HID_KEY_GUI_RIGHT) {
-		keyboardReport.reportId = KEYBOARD_MULTIMEDIA_REPORT_ID;
-		keyboardReport.multimedia = getMultimedia(code);
-	}  else {
-		keyboardReport.reportId = KEYBOARD_KEY_REPORT_ID;
-		keyboardReport.keycode[code / 8] |= 1 << (code % 8);
+void KeyboardDriver::pressKey(const KeyboardKeyBit& key) {
+	keyboardReport.keycode[key.index] |= key.mask;
+	keyboardReport.multimedia |= key.multimedia;
+}
+
+// Boot keyboards report modifiers as a bitfield and up to six other keys,
+// with every slot set to ErrorRollOver when more are held
+uint16_t KeyboardDriver::fillBootReport(KeyboardBootReport * report) {
+	memset(report, 0, sizeof(KeyboardBootReport));
+	report->modifier = keyboardReport.keycode[KEYBOARD_MODIFIER_BYTE];
+
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < KEYBOARD_MODIFIER_BYTE; i++) {
+		uint8_t bits = keyboardReport.keycode[i];
+		while (bits) {
+			uint8_t code = (i * 8) + __builtin_ctz(bits);
+			bits &= bits - 1;
+			if (code < HID_KEY_A)
+				continue;
+			if (count == KEYBOARD_BOOT_KEYS) {
+				memset(report->keycode, 0x01, sizeof(report->keycode));
+				return sizeof(KeyboardBootReport);
+			}
+			report->keycode[count++] = code;
+		}
 	}
+	return sizeof(KeyboardBootReport);
 }
 
-void KeyboardDriver::releaseAllKeys(void) {
-	for (uint8_t i = 0; i < (sizeof(keyboardReport.keycode) / sizeof(keyboardReport.keycode[0])); i++) {
-		keyboardReport.keycode[i] = 0;
+bool KeyboardDriver::sendKeyReport() {
+	bool sent;
+	if (lastProtocol == HID_PROTOCOL_BOOT) {
+		KeyboardBootReport bootReport;
+		uint16_t size = fillBootReport(&bootReport);
+		sent = tud_hid_report(0, &bootReport, size);
+	} else {
+		sent = tud_hid_report(KEYBOARD_KEY_REPORT_ID, keyboardReport.keycode, sizeof(KeyboardReport::keycode));
 	}
-	keyboardReport.multimedia = 0;
+
+	if (sent)
+		memcpy(lastReport.keycode, keyboardReport.keycode, sizeof(KeyboardReport::keycode));
+	return sent;
+}
+
+bool KeyboardDriver::sendMultimediaReport() {
+	if (!tud_hid_report(KEYBOARD_MULTIMEDIA_REPORT_ID, &keyboardReport.multimedia, sizeof(KeyboardReport::multimedia)))
+		return false;
+
+	lastReport.multimedia = keyboardReport.multimedia;
+	return true;
 }
 
 // tud_hid_get_report_cb
 uint16_t KeyboardDriver::get_report(uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen) {
-	if ( report_id == KEYBOARD_KEY_REPORT_ID ) {
+	if ( tud_hid_get_protocol() == HID_PROTOCOL_BOOT ) {
+		if ( reqlen < sizeof(KeyboardBootReport) )
+			return 0;
+		return fillBootReport((KeyboardBootReport *)buffer);
+	} else if ( report_id == KEYBOARD_KEY_REPORT_ID ) {
 		memcpy(buffer, (void*) keyboardReport.keycode, sizeof(KeyboardReport::keycode));
 		return sizeof(KeyboardReport::keycode);
 	} else {
@@ -164,7 +228,7 @@ uint16_t KeyboardDriver::get_report(uint8_t report_id, hid_report_type_t report_
 	}
 }
 
-// Only PS4 does anything with set report
+// Keyboard LEDs arrive here as output reports, there are none to drive
 void KeyboardDriver::set_report(uint8_t report_id, hid_report_type_t report_type, uint8_t const *buffer, uint16_t bufsize) {}
 
 // Only XboxOG and Xbox One use vendor control xfer cb
@@ -173,8 +237,9 @@ bool KeyboardDriver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_
 }
 
 const uint16_t * KeyboardDriver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-	const char *value = (const char *)keyboard_string_descriptors[index];
-	return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+	if (index >= sizeof(keyboard_string_descriptors) / sizeof(keyboard_string_descriptors[0]))
+		return nullptr;
+	return keyboard_string_descriptors[index];
 }
 
 const uint8_t * KeyboardDriver::get_descriptor_device_cb() {
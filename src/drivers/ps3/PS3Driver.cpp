@@ -25,47 +25,18 @@ void PS3Driver::initialize() {
         deviceDescriptor[9] = MSB(PS3_WHEEL_VENDOR_ID);
         deviceDescriptor[10] = LSB(PS3_WHEEL_PRODUCT_ID);
         deviceDescriptor[11] = MSB(PS3_WHEEL_PRODUCT_ID);
-
-        buttonShiftUp = new GamepadButtonMapping(0);
-        buttonShiftDown = new GamepadButtonMapping(0);
-        buttonGas = new GamepadButtonMapping(0);
-        buttonBrake = new GamepadButtonMapping(0);
-        buttonSteerLeft = new GamepadButtonMapping(0);
-        buttonSteerRight = new GamepadButtonMapping(0);
-        buttonPlus = new GamepadButtonMapping(0);
-        buttonMinus = new GamepadButtonMapping(0);
-        buttonDialDown = new GamepadButtonMapping(0);
-        buttonDialUp = new GamepadButtonMapping(0);
-        buttonDialEnter = new GamepadButtonMapping(0);
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GUITAR) {
         // guitar
         deviceDescriptor[8] = LSB(PS3_GUITAR_VENDOR_ID);
         deviceDescriptor[9] = MSB(PS3_GUITAR_VENDOR_ID);
         deviceDescriptor[10] = LSB(PS3_GUITAR_PRODUCT_ID);
         deviceDescriptor[11] = MSB(PS3_GUITAR_PRODUCT_ID);
-
-        buttonFretGreen = new GamepadButtonMapping(0);
-        buttonFretRed = new GamepadButtonMapping(0);
-        buttonFretYellow = new GamepadButtonMapping(0);
-        buttonFretBlue = new GamepadButtonMapping(0);
-        buttonFretOrange = new GamepadButtonMapping(0);
-        buttonWhammy = new GamepadButtonMapping(0);
-        buttonPickup = new GamepadButtonMapping(0);
-        buttonTilt = new GamepadButtonMapping(0);
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
         // drum
         deviceDescriptor[8] = LSB(PS3_DRUM_VENDOR_ID);
         deviceDescriptor[9] = MSB(PS3_DRUM_VENDOR_ID);
         deviceDescriptor[10] = LSB(PS3_DRUM_PRODUCT_ID);
         deviceDescriptor[11] = MSB(PS3_DRUM_PRODUCT_ID);
-
-        buttonDrumPadRed = new GamepadButtonMapping(0);
-        buttonDrumPadBlue = new GamepadButtonMapping(0);
-        buttonDrumPadYellow = new GamepadButtonMapping(0);
-        buttonDrumPadGreen = new GamepadButtonMapping(0);
-        buttonCymbalYellow = new GamepadButtonMapping(0);
-        buttonCymbalBlue = new GamepadButtonMapping(0);
-        buttonCymbalGreen = new GamepadButtonMapping(0);
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GAMEPAD_ALT) {
         deviceDescriptor[8] = LSB(PS3_ALT_VENDOR_ID);
         deviceDescriptor[9] = MSB(PS3_ALT_VENDOR_ID);
@@ -123,34 +94,34 @@ void PS3Driver::initialize() {
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
     for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
         switch (pinMappings[pin].action) {
-            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_PICKUP: buttonPickup->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_TILT: buttonTilt->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_UP: buttonShiftUp->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_DOWN: buttonShiftDown->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_BUTTON_PLUS: buttonPlus->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_BUTTON_MINUS: buttonMinus->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_UP: buttonDialUp->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_DOWN: buttonDialDown->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_ENTER: buttonDialEnter->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake->pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_PICKUP: buttonPickup.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_TILT: buttonTilt.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_UP: buttonShiftUp.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_DOWN: buttonShiftDown.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_BUTTON_PLUS: buttonPlus.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_BUTTON_MINUS: buttonMinus.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_UP: buttonDialUp.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_DOWN: buttonDialDown.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_ENTER: buttonDialEnter.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake.pinMask |= 1 << pin; break;
 
             default:    break;
         }
@@ -291,18 +262,18 @@ bool PS3Driver::process(Gamepad * gamepad) {
             ps3ReportAlt.guitar.solo         = gamepad->pressedL2();
             
             // frets also activate their face button counterparts
-            if ((values & buttonFretGreen->pinMask)  || gamepad->pressedB1()) ps3ReportAlt.guitar.green  = true;
-            if ((values & buttonFretRed->pinMask)    || gamepad->pressedB2()) ps3ReportAlt.guitar.red    = true;
-            if ((values & buttonFretYellow->pinMask) || gamepad->pressedB4()) ps3ReportAlt.guitar.yellow = true;
-            if ((values & buttonFretBlue->pinMask)   || gamepad->pressedB3()) ps3ReportAlt.guitar.blue   = true;
-            if ((values & buttonFretOrange->pinMask) || gamepad->pressedL1()) ps3ReportAlt.guitar.orange = true;
-            if ((values & buttonTilt->pinMask)       || gamepad->pressedR2()) ps3ReportAlt.guitar.tilt   = true;
+            if ((values & buttonFretGreen.pinMask)  || gamepad->pressedB1()) ps3ReportAlt.guitar.green  = true;
+            if ((values & buttonFretRed.pinMask)    || gamepad->pressedB2()) ps3ReportAlt.guitar.red    = true;
+            if ((values & buttonFretYellow.pinMask) || gamepad->pressedB4()) ps3ReportAlt.guitar.yellow = true;
+            if ((values & buttonFretBlue.pinMask)   || gamepad->pressedB3()) ps3ReportAlt.guitar.blue   = true;
+            if ((values & buttonFretOrange.pinMask) || gamepad->pressedL1()) ps3ReportAlt.guitar.orange = true;
+            if ((values & buttonTilt.pinMask)       || gamepad->pressedR2()) ps3ReportAlt.guitar.tilt   = true;
 
             ps3ReportAlt.guitar.whammy = static_cast<uint8_t>(gamepad->state.rx >> 8);
             ps3ReportAlt.guitar.pickup = static_cast<uint8_t>(gamepad->state.ry >> 8);
 
-            if (values & buttonPickup->pinMask) ps3ReportAlt.guitar.pickup = PS3_JOYSTICK_MAX;
-            if (values & buttonWhammy->pinMask) ps3ReportAlt.guitar.whammy = PS3_JOYSTICK_MAX;
+            if (values & buttonPickup.pinMask) ps3ReportAlt.guitar.pickup = PS3_JOYSTICK_MAX;
+            if (values & buttonWhammy.pinMask) ps3ReportAlt.guitar.whammy = PS3_JOYSTICK_MAX;
         } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
             ps3ReportAlt.drums.padding0[0] = PS3_JOYSTICK_MID;
             ps3ReportAlt.drums.padding0[1] = PS3_JOYSTICK_MID;
@@ -334,13 +305,13 @@ bool PS3Driver::process(Gamepad * gamepad) {
             ps3ReportAlt.drums.kickPedalRight = gamepad->pressedR1();
             
             // frets also activate their face button counterparts
-            if ((values & buttonDrumPadGreen->pinMask)  || gamepad->pressedB1()) { ps3ReportAlt.drums.green  = true; ps3ReportAlt.drums.pad = true; }
-            if ((values & buttonDrumPadRed->pinMask)    || gamepad->pressedB2()) { ps3ReportAlt.drums.red    = true; ps3ReportAlt.drums.pad = true; }
-            if ((values & buttonDrumPadYellow->pinMask) || gamepad->pressedB4()) { ps3ReportAlt.drums.yellow = true; ps3ReportAlt.drums.pad = true; }
-            if ((values & buttonDrumPadBlue->pinMask)   || gamepad->pressedB3()) { ps3ReportAlt.drums.blue   = true; ps3ReportAlt.drums.pad = true; }
-            if ((values & buttonCymbalYellow->pinMask)  || gamepad->pressedL1()) { ps3ReportAlt.drums.yellow = true; ps3ReportAlt.drums.cymbal = true; ps3ReportAlt.drums.dpadDirection = PS3_HAT_UP; }
-            if ((values & buttonCymbalBlue->pinMask)    || gamepad->pressedR2()) { ps3ReportAlt.drums.blue   = true; ps3ReportAlt.drums.cymbal = true; ps3ReportAlt.drums.dpadDirection = PS3_HAT_DOWN; }
-            if ((values & buttonCymbalGreen->pinMask)   || gamepad->pressedR2()) { ps3ReportAlt.drums.green  = true; ps3ReportAlt.drums.cymbal = true; }
+            if ((values & buttonDrumPadGreen.pinMask)  || gamepad->pressedB1()) { ps3ReportAlt.drums.green  = true; ps3ReportAlt.drums.pad = true; }
+            if ((values & buttonDrumPadRed.pinMask)    || gamepad->pressedB2()) { ps3ReportAlt.drums.red    = true; ps3ReportAlt.drums.pad = true; }
+            if ((values & buttonDrumPadYellow.pinMask) || gamepad->pressedB4()) { ps3ReportAlt.drums.yellow = true; ps3ReportAlt.drums.pad = true; }
+            if ((values & buttonDrumPadBlue.pinMask)   || gamepad->pressedB3()) { ps3ReportAlt.drums.blue   = true; ps3ReportAlt.drums.pad = true; }
+            if ((values & buttonCymbalYellow.pinMask)  || gamepad->pressedL1()) { ps3ReportAlt.drums.yellow = true; ps3ReportAlt.drums.cymbal = true; ps3ReportAlt.drums.dpadDirection = PS3_HAT_UP; }
+            if ((values & buttonCymbalBlue.pinMask)    || gamepad->pressedR2()) { ps3ReportAlt.drums.blue   = true; ps3ReportAlt.drums.cymbal = true; ps3ReportAlt.drums.dpadDirection = PS3_HAT_DOWN; }
+            if ((values & buttonCymbalGreen.pinMask)   || gamepad->pressedR2()) { ps3ReportAlt.drums.green  = true; ps3ReportAlt.drums.cymbal = true; }
         } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GAMEPAD_ALT) {
             switch (gamepad->state.dpad & GAMEPAD_MASK_DPAD)
             {
@@ -442,10 +413,10 @@ bool PS3Driver::process(Gamepad * gamepad) {
             ps3ReportAlt.wheel.buttonR3     = gamepad->pressedR3();
             ps3ReportAlt.wheel.buttonPS     = gamepad->pressedA1();
 
-            if (values & buttonSteerLeft->pinMask)  { ps3ReportAlt.wheel.steeringWheel   = PS3_WHEEL_MIN; }
-            if (values & buttonSteerRight->pinMask) { ps3ReportAlt.wheel.steeringWheel   = PS3_WHEEL_MAX; }
-            if (values & buttonGas->pinMask)        { ps3ReportAlt.wheel.gasPedal        = PS3_JOYSTICK_MIN; }
-            if (values & buttonBrake->pinMask)      { ps3ReportAlt.wheel.brakePedal      = PS3_JOYSTICK_MIN; }
+            if (values & buttonSteerLeft.pinMask)  { ps3ReportAlt.wheel.steeringWheel   = PS3_WHEEL_MIN; }
+            if (values & buttonSteerRight.pinMask) { ps3ReportAlt.wheel.steeringWheel   = PS3_WHEEL_MAX; }
+            if (values & buttonGas.pinMask)        { ps3ReportAlt.wheel.gasPedal        = PS3_JOYSTICK_MIN; }
+            if (values & buttonBrake.pinMask)      { ps3ReportAlt.wheel.brakePedal      = PS3_JOYSTICK_MIN; }
         } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_HOTAS) {
 
         }
@@ -27,6 +27,12 @@ static inline int rng(void*p_rng, unsigned char* p, size_t len) {
     return 0;
 }
 
+PS4Auth::~PS4Auth() {
+    if (rsaInitialized) {
+        mbedtls_rsa_free(&ps4AuthData.rsa_context);
+    }
+}
+
 void PS4Auth::initialize() {
     if ( !available() ) {
         return;
@@ -79,6 +85,7 @@ void PS4Auth::keyModeInitialize() {
     NEW_CONFIG_MPI(P, options.rsaP.bytes, options.rsaP.size)
     NEW_CONFIG_MPI(Q, options.rsaQ.bytes, options.rsaQ.size)
     mbedtls_rsa_init(&ps4AuthData.rsa_context);
+    rsaInitialized = true;
     mbedtls_rsa_set_padding(&ps4AuthData.rsa_context, MBEDTLS_RSA_PKCS_V21, MBEDTLS_MD_SHA256);
     if (mbedtls_rsa_import(&ps4AuthData.rsa_context, &N, &P, &Q, nullptr, &E) == 0 &&
             mbedtls_rsa_complete(&ps4AuthData.rsa_context) == 0) {
@@ -1,5 +1,4 @@
 #include "drivers/ps4/PS4Driver.h"
-#include "drivers/shared/driverhelper.h"
 #include "storagemanager.h"
 #include "CRC32.h"
 #include "mbedtls/error.h"
@@ -122,27 +121,6 @@ void PS4Driver::initialize() {
             shifterPosition = 0;
 
             controllerType = PS4ControllerType::PS4_WHEEL;
-
-            buttonShiftUp = new GamepadButtonMapping(0);
-            buttonShiftDown = new GamepadButtonMapping(0);
-            buttonShift1 = new GamepadButtonMapping(0);
-            buttonShift2 = new GamepadButtonMapping(0);
-            buttonShift3 = new GamepadButtonMapping(0);
-            buttonShift4 = new GamepadButtonMapping(0);
-            buttonShift5 = new GamepadButtonMapping(0);
-            buttonShift6 = new GamepadButtonMapping(0);
-            buttonShiftR = new GamepadButtonMapping(0);
-            buttonShiftN = new GamepadButtonMapping(0);
-            buttonGas = new GamepadButtonMapping(0);
-            buttonBrake = new GamepadButtonMapping(0);
-            buttonClutch = new GamepadButtonMapping(0);
-            buttonSteerLeft = new GamepadButtonMapping(0);
-            buttonSteerRight = new GamepadButtonMapping(0);
-            buttonPlus = new GamepadButtonMapping(0);
-            buttonMinus = new GamepadButtonMapping(0);
-            buttonDialDown = new GamepadButtonMapping(0);
-            buttonDialUp = new GamepadButtonMapping(0);
-            buttonDialEnter = new GamepadButtonMapping(0);
             break;
         case InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_HOTAS:
             enableController = false;
@@ -155,17 +133,6 @@ void PS4Driver::initialize() {
             enableUnknown1 = false;
 
             controllerType = PS4ControllerType::PS4_HOTAS;
-
-            buttonRudderLeft = new GamepadButtonMapping(0);
-            buttonRudderRight = new GamepadButtonMapping(0);
-            buttonThrottleForward = new GamepadButtonMapping(0);
-            buttonThrottleReverse = new GamepadButtonMapping(0);
-            buttonRockerLeft = new GamepadButtonMapping(0);
-            buttonRockerRight = new GamepadButtonMapping(0);
-            buttonPedalLeft = new GamepadButtonMapping(0);
-            buttonPedalRight = new GamepadButtonMapping(0);
-            buttonPedalRudderLeft = new GamepadButtonMapping(0);
-            buttonPedalRudderRight = new GamepadButtonMapping(0);
             break;
         case InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GUITAR:
             enableController = true;
@@ -178,20 +145,6 @@ void PS4Driver::initialize() {
             enableUnknown1 = true;
 
             controllerType = PS4ControllerType::PS4_GUITAR;
-
-            buttonFretGreen = new GamepadButtonMapping(0);
-            buttonFretRed = new GamepadButtonMapping(0);
-            buttonFretYellow = new GamepadButtonMapping(0);
-            buttonFretBlue = new GamepadButtonMapping(0);
-            buttonFretOrange = new GamepadButtonMapping(0);
-            buttonFretSoloGreen = new GamepadButtonMapping(0);
-            buttonFretSoloRed = new GamepadButtonMapping(0);
-            buttonFretSoloYellow = new GamepadButtonMapping(0);
-            buttonFretSoloBlue = new GamepadButtonMapping(0);
-            buttonFretSoloOrange = new GamepadButtonMapping(0);
-            buttonWhammy = new GamepadButtonMapping(0);
-            buttonPickup = new GamepadButtonMapping(0);
-            buttonTilt = new GamepadButtonMapping(0);
             break;
         case InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM:
             enableController = true;
@@ -204,16 +157,6 @@ void PS4Driver::initialize() {
             enableUnknown1 = true;
 
             controllerType = PS4ControllerType::PS4_DRUMS;
-
-            buttonDrumPadRed = new GamepadButtonMapping(0);
-            buttonDrumPadBlue = new GamepadButtonMapping(0);
-            buttonDrumPadYellow = new GamepadButtonMapping(0);
-            buttonDrumPadGreen = new GamepadButtonMapping(0);
-            buttonCymbalYellow = new GamepadButtonMapping(0);
-            buttonCymbalBlue = new GamepadButtonMapping(0);
-            buttonCymbalGreen = new GamepadButtonMapping(0);
-            buttonKickPedalLeft = new GamepadButtonMapping(0);
-            buttonKickPedalRight = new GamepadButtonMapping(0);
             break;
         case InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GAMEPAD:
         default:
@@ -313,61 +256,61 @@ void PS4Driver::initialize() {
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
     for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
         switch (pinMappings[pin].action) {
-            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_GREEN: buttonFretSoloGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_RED: buttonFretSoloRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_YELLOW: buttonFretSoloYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_BLUE: buttonFretSoloBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_ORANGE: buttonFretSoloOrange->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_PICKUP: buttonPickup->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_TILT: buttonTilt->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_KICK_PEDAL_LEFT: buttonKickPedalLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_KICK_PEDAL_RIGHT: buttonKickPedalRight->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_HOTAS_RUDDER_LEFT: buttonRudderLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_RUDDER_RIGHT: buttonRudderRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_THROTTLE_FORWARD: buttonThrottleForward->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_THROTTLE_REVERSE: buttonThrottleReverse->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_ROCKER_LEFT: buttonRockerLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_ROCKER_RIGHT: buttonRockerRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_PEDAL_LEFT: buttonPedalLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_PEDAL_RIGHT: buttonPedalRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_PEDAL_RUDDER_LEFT: buttonPedalRudderLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_HOTAS_PEDAL_RUDDER_RIGHT: buttonPedalRudderRight->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_1: buttonShift1->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_2: buttonShift2->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_3: buttonShift3->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_4: buttonShift4->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_5: buttonShift5->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_6: buttonShift6->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_R: buttonShiftR->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_N: buttonShiftN->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_UP: buttonShiftUp->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_DOWN: buttonShiftDown->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_BUTTON_PLUS: buttonPlus->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_BUTTON_MINUS: buttonMinus->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_UP: buttonDialUp->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_DOWN: buttonDialDown->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_DIAL_ENTER: buttonDialEnter->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_CLUTCH: buttonClutch->pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_GREEN: buttonFretSoloGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_RED: buttonFretSoloRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_YELLOW: buttonFretSoloYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_BLUE: buttonFretSoloBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_ORANGE: buttonFretSoloOrange.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_PICKUP: buttonPickup.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_TILT: buttonTilt.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_KICK_PEDAL_LEFT: buttonKickPedalLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_KICK_PEDAL_RIGHT: buttonKickPedalRight.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_HOTAS_RUDDER_LEFT: buttonRudderLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_RUDDER_RIGHT: buttonRudderRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_THROTTLE_FORWARD: buttonThrottleForward.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_THROTTLE_REVERSE: buttonThrottleReverse.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_ROCKER_LEFT: buttonRockerLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_ROCKER_RIGHT: buttonRockerRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_PEDAL_LEFT: buttonPedalLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_PEDAL_RIGHT: buttonPedalRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_PEDAL_RUDDER_LEFT: buttonPedalRudderLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_HOTAS_PEDAL_RUDDER_RIGHT: buttonPedalRudderRight.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_1: buttonShift1.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_2: buttonShift2.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_3: buttonShift3.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_4: buttonShift4.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_5: buttonShift5.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_6: buttonShift6.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_R: buttonShiftR.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_N: buttonShiftN.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_UP: buttonShiftUp.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_SHIFTER_GEAR_DOWN: buttonShiftDown.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_BUTTON_PLUS: buttonPlus.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_BUTTON_MINUS: buttonMinus.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_UP: buttonDialUp.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_DOWN: buttonDialDown.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_DIAL_ENTER: buttonDialEnter.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_CLUTCH: buttonClutch.pinMask |= 1 << pin; break;
             default:    break;
         }
     }
@@ -471,21 +414,21 @@ bool PS4Driver::process(Gamepad * gamepad) {
         ps4Report.guitar.soloFrets.orange = false;
         
         // frets also activate their face button counterparts
-        if (values & buttonFretGreen->pinMask)      { ps4Report.guitar.frets.green      = true; ps4Report.buttonSouth |= true; }
-        if (values & buttonFretRed->pinMask)        { ps4Report.guitar.frets.red        = true; ps4Report.buttonEast  |= true; }
-        if (values & buttonFretYellow->pinMask)     { ps4Report.guitar.frets.yellow     = true; ps4Report.buttonNorth |= true; }
-        if (values & buttonFretBlue->pinMask)       { ps4Report.guitar.frets.blue       = true; ps4Report.buttonWest  |= true; }
-        if (values & buttonFretOrange->pinMask)     { ps4Report.guitar.frets.orange     = true; ps4Report.buttonL1    |= true; }
+        if (values & buttonFretGreen.pinMask)      { ps4Report.guitar.frets.green      = true; ps4Report.buttonSouth |= true; }
+        if (values & buttonFretRed.pinMask)        { ps4Report.guitar.frets.red        = true; ps4Report.buttonEast  |= true; }
+        if (values & buttonFretYellow.pinMask)     { ps4Report.guitar.frets.yellow     = true; ps4Report.buttonNorth |= true; }
+        if (values & buttonFretBlue.pinMask)       { ps4Report.guitar.frets.blue       = true; ps4Report.buttonWest  |= true; }
+        if (values & buttonFretOrange.pinMask)     { ps4Report.guitar.frets.orange     = true; ps4Report.buttonL1    |= true; }
         
-        if (values & buttonFretSoloGreen->pinMask)  { ps4Report.guitar.soloFrets.green  = true; ps4Report.buttonSouth |= true; ps4Report.buttonL3 |= true; }
-        if (values & buttonFretSoloRed->pinMask)    { ps4Report.guitar.soloFrets.red    = true; ps4Report.buttonEast  |= true; ps4Report.buttonL3 |= true; }
-        if (values & buttonFretSoloYellow->pinMask) { ps4Report.guitar.soloFrets.yellow = true; ps4Report.buttonNorth |= true; ps4Report.buttonL3 |= true; }
-        if (values & buttonFretSoloBlue->pinMask)   { ps4Report.guitar.soloFrets.blue   = true; ps4Report.buttonWest  |= true; ps4Report.buttonL3 |= true; }
-        if (values & buttonFretSoloOrange->pinMask) { ps4Report.guitar.soloFrets.orange = true; ps4Report.buttonL1    |= true; ps4Report.buttonL3 |= true; }
+        if (values & buttonFretSoloGreen.pinMask)  { ps4Report.guitar.soloFrets.green  = true; ps4Report.buttonSouth |= true; ps4Report.buttonL3 |= true; }
+        if (values & buttonFretSoloRed.pinMask)    { ps4Report.guitar.soloFrets.red    = true; ps4Report.buttonEast  |= true; ps4Report.buttonL3 |= true; }
+        if (values & buttonFretSoloYellow.pinMask) { ps4Report.guitar.soloFrets.yellow = true; ps4Report.buttonNorth |= true; ps4Report.buttonL3 |= true; }
+        if (values & buttonFretSoloBlue.pinMask)   { ps4Report.guitar.soloFrets.blue   = true; ps4Report.buttonWest  |= true; ps4Report.buttonL3 |= true; }
+        if (values & buttonFretSoloOrange.pinMask) { ps4Report.guitar.soloFrets.orange = true; ps4Report.buttonL1    |= true; ps4Report.buttonL3 |= true; }
         
-        if (values & buttonPickup->pinMask) ps4Report.guitar.pickup = PS4_JOYSTICK_MID;
-        if (values & buttonWhammy->pinMask) ps4Report.guitar.whammy = PS4_JOYSTICK_MAX;
-        if (values & buttonTilt->pinMask) ps4Report.guitar.tilt = PS4_JOYSTICK_MAX;
+        if (values & buttonPickup.pinMask) ps4Report.guitar.pickup = PS4_JOYSTICK_MID;
+        if (values & buttonWhammy.pinMask) ps4Report.guitar.whammy = PS4_JOYSTICK_MAX;
+        if (values & buttonTilt.pinMask) ps4Report.guitar.tilt = PS4_JOYSTICK_MAX;
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
         ps4Report.drums.velocityDrumRed = PS4_JOYSTICK_MIN;
         ps4Report.drums.velocityDrumBlue = PS4_JOYSTICK_MIN;
@@ -495,16 +438,16 @@ bool PS4Driver::process(Gamepad * gamepad) {
         ps4Report.drums.velocityCymbalBlue = PS4_JOYSTICK_MIN;
         ps4Report.drums.velocityCymbalGreen = PS4_JOYSTICK_MIN;
 
-        if (values & buttonDrumPadRed->pinMask)    { ps4Report.drums.velocityDrumRed      = PS4_JOYSTICK_MAX; ps4Report.buttonEast  |= true; }
-        if (values & buttonDrumPadBlue->pinMask)   { ps4Report.drums.velocityDrumBlue     = PS4_JOYSTICK_MAX; ps4Report.buttonWest  |= true; }
-        if (values & buttonDrumPadYellow->pinMask) { ps4Report.drums.velocityDrumYellow   = PS4_JOYSTICK_MAX; ps4Report.buttonNorth |= true; }
-        if (values & buttonDrumPadGreen->pinMask)  { ps4Report.drums.velocityDrumGreen    = PS4_JOYSTICK_MAX; ps4Report.buttonSouth |= true; }
-        if (values & buttonCymbalYellow->pinMask)  { ps4Report.drums.velocityCymbalYellow = PS4_JOYSTICK_MAX; ps4Report.buttonNorth |= true; }
-        if (values & buttonCymbalBlue->pinMask)    { ps4Report.drums.velocityCymbalBlue   = PS4_JOYSTICK_MAX; ps4Report.buttonWest  |= true; }
-        if (values & buttonCymbalGreen->pinMask)   { ps4Report.drums.velocityCymbalGreen  = PS4_JOYSTICK_MAX; ps4Report.buttonSouth |= true; }
+        if (values & buttonDrumPadRed.pinMask)    { ps4Report.drums.velocityDrumRed      = PS4_JOYSTICK_MAX; ps4Report.buttonEast  |= true; }
+        if (values & buttonDrumPadBlue.pinMask)   { ps4Report.drums.velocityDrumBlue     = PS4_JOYSTICK_MAX; ps4Report.buttonWest  |= true; }
+        if (values & buttonDrumPadYellow.pinMask) { ps4Report.drums.velocityDrumYellow   = PS4_JOYSTICK_MAX; ps4Report.buttonNorth |= true; }
+        if (values & buttonDrumPadGreen.pinMask)  { ps4Report.drums.velocityDrumGreen    = PS4_JOYSTICK_MAX; ps4Report.buttonSouth |= true; }
+        if (values & buttonCymbalYellow.pinMask)  { ps4Report.drums.velocityCymbalYellow = PS4_JOYSTICK_MAX; ps4Report.buttonNorth |= true; }
+        if (values & buttonCymbalBlue.pinMask)    { ps4Report.drums.velocityCymbalBlue   = PS4_JOYSTICK_MAX; ps4Report.buttonWest  |= true; }
+        if (values & buttonCymbalGreen.pinMask)   { ps4Report.drums.velocityCymbalGreen  = PS4_JOYSTICK_MAX; ps4Report.buttonSouth |= true; }
 
-        if (values & buttonKickPedalLeft->pinMask)  { ps4Report.buttonL1 |= true; }
-        if (values & buttonKickPedalRight->pinMask) { ps4Report.buttonR1 |= true; }
+        if (values & buttonKickPedalLeft.pinMask)  { ps4Report.buttonL1 |= true; }
+        if (values & buttonKickPedalRight.pinMask) { ps4Report.buttonR1 |= true; }
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_WHEEL) {
         ps4Report.wheel.steeringWheel = PS4_NAV_JOYSTICK_MID;
         ps4Report.wheel.gasPedal = PS4_NAV_JOYSTICK_MAX;
@@ -517,43 +460,43 @@ bool PS4Driver::process(Gamepad * gamepad) {
         ps4Report.wheel.buttonDialUp = 0;
         ps4Report.wheel.buttonDialEnter = 0;
 
-        if ((values & buttonShiftUp->pinMask) && idleShifter) {
+        if ((values & buttonShiftUp.pinMask) && idleShifter) {
             if (shifterPosition < sizeof(shifterValues)-1) {
                 shifterPosition++;
                 idleShifter = false;
             }
         }
-        if ((values & buttonShiftDown->pinMask) && idleShifter) {
+        if ((values & buttonShiftDown.pinMask) && idleShifter) {
             if (shifterPosition > 0) {
                 shifterPosition--;
                 idleShifter = false;
             }
         }
-        if (!(values & buttonShiftUp->pinMask) && !(values & buttonShiftDown->pinMask) && !idleShifter) {
+        if (!(values & buttonShiftUp.pinMask) && !(values & buttonShiftDown.pinMask) && !idleShifter) {
             idleShifter = true;
         }
-        if (values & buttonShiftN->pinMask) shifterPosition = 0;
-        if (values & buttonShift1->pinMask) shifterPosition = 1;
-        if (values & buttonShift2->pinMask) shifterPosition = 2;
-        if (values & buttonShift3->pinMask) shifterPosition = 3;
-        if (values & buttonShift4->pinMask) shifterPosition = 4;
-        if (values & buttonShift5->pinMask) shifterPosition = 5;
-        if (values & buttonShift6->pinMask) shifterPosition = 6;
-        if (values & buttonShiftR->pinMask) shifterPosition = 7;
+        if (values & buttonShiftN.pinMask) shifterPosition = 0;
+        if (values & buttonShift1.pinMask) shifterPosition = 1;
+        if (values & buttonShift2.pinMask) shifterPosition = 2;
+        if (values & buttonShift3.pinMask) shifterPosition = 3;
+        if (values & buttonShift4.pinMask) shifterPosition = 4;
+        if (values & buttonShift5.pinMask) shifterPosition = 5;
+        if (values & buttonShift6.pinMask) shifterPosition = 6;
+        if (values & buttonShiftR.pinMask) shifterPosition = 7;
 
         ps4Report.wheel.shifterValue = shifterValues[shifterPosition];
 
-        if (values & buttonSteerLeft->pinMask) ps4Report.wheel.steeringWheel = PS4_NAV_JOYSTICK_MIN;
-        if (values & buttonSteerRight->pinMask) ps4Report.wheel.steeringWheel = PS4_NAV_JOYSTICK_MAX;
-        if (values & buttonBrake->pinMask) ps4Report.wheel.brakePedal = PS4_NAV_JOYSTICK_MIN;
-        if (values & buttonClutch->pinMask) ps4Report.wheel.clutchPedal = PS4_NAV_JOYSTICK_MIN;
-        if (values & buttonGas->pinMask) ps4Report.wheel.gasPedal = PS4_NAV_JOYSTICK_MIN;
-
-        if (values & buttonPlus->pinMask) ps4Report.wheel.buttonPlus = 1;
-        if (values & buttonMinus->pinMask) ps4Report.wheel.buttonMinus = 1;
-        if (values & buttonDialDown->pinMask) ps4Report.wheel.buttonDialDown = 1;
-        if (values & buttonDialUp->pinMask) ps4Report.wheel.buttonDialUp = 1;
-        if (values & buttonDialEnter->pinMask) ps4Report.wheel.buttonDialEnter = 1;
+        if (values & buttonSteerLeft.pinMask) ps4Report.wheel.steeringWheel = PS4_NAV_JOYSTICK_MIN;
+        if (values & buttonSteerRight.pinMask) ps4Report.wheel.steeringWheel = PS4_NAV_JOYSTICK_MAX;
+        if (values & buttonBrake.pinMask) ps4Report.wheel.brakePedal = PS4_NAV_JOYSTICK_MIN;
+        if (values & buttonClutch.pinMask) ps4Report.wheel.clutchPedal = PS4_NAV_JOYSTICK_MIN;
+        if (values & buttonGas.pinMask) ps4Report.wheel.gasPedal = PS4_NAV_JOYSTICK_MIN;
+
+        if (values & buttonPlus.pinMask) ps4Report.wheel.buttonPlus = 1;
+        if (values & buttonMinus.pinMask) ps4Report.wheel.buttonMinus = 1;
+        if (values & buttonDialDown.pinMask) ps4Report.wheel.buttonDialDown = 1;
+        if (values & buttonDialUp.pinMask) ps4Report.wheel.buttonDialUp = 1;
+        if (values & buttonDialEnter.pinMask) ps4Report.wheel.buttonDialEnter = 1;
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_HOTAS) {
         ps4Report.hotas.joystickX = PS4_NAV_JOYSTICK_MID;
         ps4Report.hotas.joystickY = PS4_NAV_JOYSTICK_MID;
@@ -566,16 +509,16 @@ bool PS4Driver::process(Gamepad * gamepad) {
         ps4Report.hotas.pedalLeft = PS4_JOYSTICK_MIN;
         ps4Report.hotas.pedalRight = PS4_JOYSTICK_MIN;
 
-        if (values & buttonRudderLeft->pinMask) ps4Report.hotas.twistRudder = PS4_JOYSTICK_MIN;
-        if (values & buttonRudderRight->pinMask) ps4Report.hotas.twistRudder = PS4_JOYSTICK_MAX;
-        if (values & buttonThrottleForward->pinMask) ps4Report.hotas.throttle = PS4_JOYSTICK_MIN;
-        if (values & buttonThrottleReverse->pinMask) ps4Report.hotas.throttle = PS4_JOYSTICK_MAX;
-        if (values & buttonRockerLeft->pinMask) ps4Report.hotas.rockerSwitch = PS4_JOYSTICK_MIN;
-        if (values & buttonRockerRight->pinMask) ps4Report.hotas.rockerSwitch = PS4_JOYSTICK_MAX;
-        if (values & buttonPedalLeft->pinMask) ps4Report.hotas.pedalLeft = PS4_JOYSTICK_MAX;
-        if (values & buttonPedalRight->pinMask) ps4Report.hotas.pedalRight = PS4_JOYSTICK_MAX;
-        if (values & buttonPedalRudderLeft->pinMask) ps4Report.hotas.pedalRudder = PS4_JOYSTICK_MAX;
-        if (values & buttonPedalRudderRight->pinMask) ps4Report.hotas.pedalRudder = PS4_JOYSTICK_MIN;
+        if (values & buttonRudderLeft.pinMask) ps4Report.hotas.twistRudder = PS4_JOYSTICK_MIN;
+        if (values & buttonRudderRight.pinMask) ps4Report.hotas.twistRudder = PS4_JOYSTICK_MAX;
+        if (values & buttonThrottleForward.pinMask) ps4Report.hotas.throttle = PS4_JOYSTICK_MIN;
+        if (values & buttonThrottleReverse.pinMask) ps4Report.hotas.throttle = PS4_JOYSTICK_MAX;
+        if (values & buttonRockerLeft.pinMask) ps4Report.hotas.rockerSwitch = PS4_JOYSTICK_MIN;
+        if (values & buttonRockerRight.pinMask) ps4Report.hotas.rockerSwitch = PS4_JOYSTICK_MAX;
+        if (values & buttonPedalLeft.pinMask) ps4Report.hotas.pedalLeft = PS4_JOYSTICK_MAX;
+        if (values & buttonPedalRight.pinMask) ps4Report.hotas.pedalRight = PS4_JOYSTICK_MAX;
+        if (values & buttonPedalRudderLeft.pinMask) ps4Report.hotas.pedalRudder = PS4_JOYSTICK_MAX;
+        if (values & buttonPedalRudderRight.pinMask) ps4Report.hotas.pedalRudder = PS4_JOYSTICK_MIN;
 
         ps4Report.hotas.joystickX = PS4_NAV_JOYSTICK_MID;
         ps4Report.hotas.joystickY = PS4_NAV_JOYSTICK_MID;
@@ -922,8 +865,9 @@ bool PS4Driver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_contr
 }
 
 const uint16_t * PS4Driver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-    const char *value = (const char *)ps4_string_descriptors[index];
-    return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+    if (index >= sizeof(ps4_string_descriptors) / sizeof(ps4_string_descriptors[0]))
+        return nullptr;
+    return ps4_string_descriptors[index];
 }
 
 const uint8_t * PS4Driver::get_descriptor_device_cb() {
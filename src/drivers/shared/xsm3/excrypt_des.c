@@ -2,9 +2,6 @@
 #include "xsm3/excrypt_des_data.h"
 #include <string.h>
 
-#define LODWORD(_qw)    ((uint32_t)(_qw))
-#define HIDWORD(_qw)    ((uint32_t)(((_qw) >> 32) & 0xffffffff))
-
 // DES code based on https://github.com/fffaraz/cppDES
 
 void ExCryptDesParity(const uint8_t* input, uint32_t input_size, uint8_t* output)
@@ -59,95 +56,83 @@ void ExCryptDesKey(EXCRYPT_DES_STATE* state, const uint8_t* key)
       sub_key <<= 1;
       sub_key |= (permuted_choice_2 >> (56 - PC2[j])) & LB64_MASK;
     }
-    state->keytab[i] = sub_key;
-  }
-}
-
-uint32_t f(uint32_t R, uint64_t k)
-{
-  // applying expansion permutation and returning 48-bit data
-  uint64_t s_input = 0;
-  for (int i = 0; i < 48; i++)
-  {
-    s_input <<= 1;
-    s_input |= (uint64_t)((R >> (32 - EXPANSION[i])) & LB32_MASK);
-  }
-
-  // XORing expanded Ri with Ki, the round key
-  s_input = s_input ^ k;
 
-  // applying S-Boxes function and returning 32-bit data
-  uint32_t s_output = 0;
-  for (int i = 0; i < 8; i++)
-  {
-    // Outer bits
-    char row = (char)((s_input & (0x0000840000000000 >> 6 * i)) >> (42 - 6 * i));
-    row = (row >> 4) | (row & 0x01);
-
-    // Middle 4 bits of input
-    char column = (char)((s_input & (0x0000780000000000 >> 6 * i)) >> (43 - 6 * i));
-
-    s_output <<= 4;
-    s_output |= (uint32_t)(SBOX[i][16 * row + column] & 0x0f);
+    // split into the 6-bit groups consumed by each S-Box
+    for (int j = 0; j < 8; j++)
+    {
+      state->keytab[i][j] = (uint8_t)((sub_key >> (42 - 6 * j)) & 0x3F);
+    }
   }
+}
 
-  // applying the round permutation
-  uint32_t f_result = 0;
-  for (int i = 0; i < 32; i++)
-  {
-    f_result <<= 1;
-    f_result |= (s_output >> (32 - PBOX[i])) & LB32_MASK;
-  }
+// swaps the bits of a selected by mask m with the bits of b shifted by n
+#define PERM_OP(a, b, n, m) \
+  do { uint32_t t = (((a) >> (n)) ^ (b)) & (m); (b) ^= t; (a) ^= (t << (n)); } while (0)
 
-  return f_result;
+static inline uint32_t rotr32(uint32_t x, uint32_t n)
+{
+  return (x >> n) | (x << (32 - n));
 }
 
-void feistel(uint32_t* L, uint32_t* R, uint32_t F)
+// Round function: the expansion is done by rotating R so each 6-bit group
+// lands in the low bits, the S-Box and P permutation by the SPBOX lookup
+static inline uint32_t f(uint32_t R, const uint8_t* k)
 {
-  uint32_t temp = *R;
-  *R = *L ^ F;
-  *L = temp;
+  return SPBOX[0][(rotr32(R, 27) & 0x3F) ^ k[0]]
+       | SPBOX[1][(rotr32(R, 23) & 0x3F) ^ k[1]]
+       | SPBOX[2][(rotr32(R, 19) & 0x3F) ^ k[2]]
+       | SPBOX[3][(rotr32(R, 15) & 0x3F) ^ k[3]]
+       | SPBOX[4][(rotr32(R, 11) & 0x3F) ^ k[4]]
+       | SPBOX[5][(rotr32(R,  7) & 0x3F) ^ k[5]]
+       | SPBOX[6][(rotr32(R,  3) & 0x3F) ^ k[6]]
+       | SPBOX[7][(rotr32(R, 31) & 0x3F) ^ k[7]];
 }
 
 void ExCryptDesEcb(const EXCRYPT_DES_STATE* state, const uint8_t* input, uint8_t* output, uint8_t encrypt)
 {
-  uint64_t block;
-  memcpy(&block, input, sizeof(uint64_t));
-  block = SWAP64(block);
-
-  //uint64_t block = SWAP64(*(uint64_t*)input)
+  uint32_t L = ((uint32_t)input[0] << 24) | ((uint32_t)input[1] << 16) | ((uint32_t)input[2] << 8) | input[3];
+  uint32_t R = ((uint32_t)input[4] << 24) | ((uint32_t)input[5] << 16) | ((uint32_t)input[6] << 8) | input[7];
 
   // initial permutation
-  uint64_t result = 0;
-  for (int i = 0; i < 64; i++)
-  {
-    result <<= 1;
-    result |= (block >> (64 - IP[i])) & LB64_MASK;
-  }
+  PERM_OP(L, R, 4, 0x0F0F0F0F);
+  PERM_OP(L, R, 16, 0x0000FFFF);
+  PERM_OP(R, L, 2, 0x33333333);
+  PERM_OP(R, L, 8, 0x00FF00FF);
+  PERM_OP(L, R, 1, 0x55555555);
 
-  // dividing T' into two 32-bit parts
-  uint32_t L = HIDWORD(result);
-  uint32_t R = LODWORD(result);
-
-  // 16 rounds
-  for (int i = 0; i < 16; i++)
+  // 16 rounds, two per iteration so the halves never need swapping
+  if (encrypt)
   {
-    uint32_t F = !encrypt ? f(R, state->keytab[15 - i]) : f(R, state->keytab[i]);
-    feistel(&L, &R, F);
+    for (int i = 0; i < 16; i += 2)
+    {
+      L ^= f(R, state->keytab[i]);
+      R ^= f(L, state->keytab[i + 1]);
+    }
   }
-
-  // swapping the two parts
-  block = (((uint64_t)R) << 32) | (uint64_t)L;
-
-  // inverse initial permutation
-  result = 0;
-  for (int i = 0; i < 64; i++)
+  else
   {
-    result <<= 1;
-    result |= (block >> (64 - FP[i])) & LB64_MASK;
+    for (int i = 15; i > 0; i -= 2)
+    {
+      L ^= f(R, state->keytab[i]);
+      R ^= f(L, state->keytab[i - 1]);
+    }
   }
-  result = SWAP64(result);
-  memcpy(output, &result, sizeof(result));
+
+  // inverse initial permutation (on the swapped halves)
+  PERM_OP(R, L, 1, 0x55555555);
+  PERM_OP(L, R, 8, 0x00FF00FF);
+  PERM_OP(L, R, 2, 0x33333333);
+  PERM_OP(R, L, 16, 0x0000FFFF);
+  PERM_OP(R, L, 4, 0x0F0F0F0F);
+
+  output[0] = (uint8_t)(R >> 24);
+  output[1] = (uint8_t)(R >> 16);
+  output[2] = (uint8_t)(R >> 8);
+  output[3] = (uint8_t)R;
+  output[4] = (uint8_t)(L >> 24);
+  output[5] = (uint8_t)(L >> 16);
+  output[6] = (uint8_t)(L >> 8);
+  output[7] = (uint8_t)L;
 }
 
 void ExCryptDes3Key(EXCRYPT_DES3_STATE* state, const uint64_t* keys)
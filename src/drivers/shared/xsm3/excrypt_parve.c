@@ -44,35 +44,45 @@ void ExCryptParveCbcMac(const uint8_t* key, const uint8_t* sbox, const uint8_t*
   memcpy(output, &block, 8);
 }
 
+// x % 0x7FFFFFFF without a 64-bit division, 2^31 - 1 is a Mersenne prime so
+// the high bits can be folded back onto the low bits
+static inline uint32_t mod_mersenne31(uint64_t x)
+{
+  x = (x & 0x7FFFFFFF) + (x >> 31);
+  x = (x & 0x7FFFFFFF) + (x >> 31);
+  uint32_t r = (uint32_t)((x & 0x7FFFFFFF) + (x >> 31));
+  return (r >= 0x7FFFFFFF) ? r - 0x7FFFFFFF : r;
+}
+
 void ExCryptChainAndSumMac(const uint32_t* cd, const uint32_t* ab, const uint32_t* input, uint32_t input_dwords, uint32_t* output)
 {
   uint64_t out0 = 0;
   uint64_t out1 = 0;
 
-  uint32_t ab0 = SWAP32(ab[0]) % 0x7FFFFFFF;
-  uint32_t ab1 = SWAP32(ab[1]) % 0x7FFFFFFF;
-  uint32_t cd0 = SWAP32(cd[0]) % 0x7FFFFFFF;
-  uint32_t cd1 = SWAP32(cd[1]) % 0x7FFFFFFF;
+  uint32_t ab0 = mod_mersenne31(SWAP32(ab[0]));
+  uint32_t ab1 = mod_mersenne31(SWAP32(ab[1]));
+  uint32_t cd0 = mod_mersenne31(SWAP32(cd[0]));
+  uint32_t cd1 = mod_mersenne31(SWAP32(cd[1]));
 
   for (uint32_t i = 0; i < input_dwords / 2; i++)
   {
     out0 += (uint64_t)SWAP32(input[0]) * 0xE79A9C1;
-    out0 = (out0 % 0x7FFFFFFF) * ab0;
+    out0 = (uint64_t)mod_mersenne31(out0) * ab0;
     out0 += ab1;
-    out0 = out0 % 0x7FFFFFFF;
+    out0 = mod_mersenne31(out0);
 
     out1 += out0;
 
     out0 = (uint64_t)(SWAP32(input[1]) + out0) * cd0;
-    out0 = (out0 % 0x7FFFFFFF) + cd1;
-    out0 = out0 % 0x7FFFFFFF;
+    out0 = (uint64_t)mod_mersenne31(out0) + cd1;
+    out0 = mod_mersenne31(out0);
 
     out1 += out0;
 
     input += 2;
   }
-  out0 = SWAP32((out0 + ab1) % 0x7FFFFFFF);
-  out1 = SWAP32((out1 + cd1) % 0x7FFFFFFF);
+  out0 = SWAP32(mod_mersenne31(out0 + ab1));
+  out1 = SWAP32(mod_mersenne31(out1 + cd1));
   memcpy(output, &out0,  sizeof(uint32_t));
   memcpy(output+1, &out1,  sizeof(uint32_t));
   // output[0] = SWAP32((out0 + ab1) % 0x7FFFFFFF);
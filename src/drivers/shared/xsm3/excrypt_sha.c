@@ -5,17 +5,35 @@
 
 // SHA1 code based on https://github.com/mohaps/TinySHA1
 
-void sha1_process_block(EXCRYPT_SHA_STATE* state)
+#define SHA1_F0(b, c, d) ((d) ^ ((b) & ((c) ^ (d))))
+#define SHA1_F1(b, c, d) ((b) ^ (c) ^ (d))
+#define SHA1_F2(b, c, d) (((b) & (c)) | ((d) & ((b) | (c))))
+#define SHA1_F3(b, c, d) ((b) ^ (c) ^ (d))
+
+// message schedule kept as a 16 word ring instead of the full 80 words
+#define SHA1_W(i) (w[(i) & 15] = ROTL32(w[((i) + 13) & 15] ^ w[((i) + 8) & 15] ^ w[((i) + 2) & 15] ^ w[(i) & 15], 1))
+
+// one round, with the variable rotation done by renaming instead of moving values
+#define SHA1_ROUND(a, b, c, d, e, fn, k, wi) \
+  do { (e) += ROTL32((a), 5) + fn((b), (c), (d)) + (k) + (wi); (b) = ROTL32((b), 30); } while (0)
+
+#define SHA1_R5(i, fn, k, wfn) \
+  SHA1_ROUND(a, b, c, d, e, fn, k, wfn((i) + 0)); \
+  SHA1_ROUND(e, a, b, c, d, fn, k, wfn((i) + 1)); \
+  SHA1_ROUND(d, e, a, b, c, fn, k, wfn((i) + 2)); \
+  SHA1_ROUND(c, d, e, a, b, fn, k, wfn((i) + 3)); \
+  SHA1_ROUND(b, c, d, e, a, fn, k, wfn((i) + 4))
+
+#define SHA1_W0(i) (w[(i)])
+
+static void sha1_process_block(EXCRYPT_SHA_STATE* state, const uint8_t* block)
 {
-  uint32_t w[80];
+  uint32_t w[16];
   for (size_t i = 0; i < 16; i++) {
-    w[i] = ((uint32_t)state->buffer[i * 4 + 0] << 24);
-    w[i] |= ((uint32_t)state->buffer[i * 4 + 1] << 16);
-    w[i] |= ((uint32_t)state->buffer[i * 4 + 2] << 8);
-    w[i] |= ((uint32_t)state->buffer[i * 4 + 3]);
-  }
-  for (size_t i = 16; i < 80; i++) {
-    w[i] = ROTL32((w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16]), 1);
+    w[i] = ((uint32_t)block[i * 4 + 0] << 24);
+    w[i] |= ((uint32_t)block[i * 4 + 1] << 16);
+    w[i] |= ((uint32_t)block[i * 4 + 2] << 8);
+    w[i] |= ((uint32_t)block[i * 4 + 3]);
   }
 
   uint32_t a = state->state[0];
@@ -24,33 +42,29 @@ void sha1_process_block(EXCRYPT_SHA_STATE* state)
   uint32_t d = state->state[3];
   uint32_t e = state->state[4];
 
-  for (int i = 0; i < 80; ++i) {
-    uint32_t f = 0;
-    uint32_t k = 0;
-
-    if (i < 20) {
-      f = (b & c) | (~b & d);
-      k = 0x5A827999;
-    }
-    else if (i < 40) {
-      f = b ^ c ^ d;
-      k = 0x6ED9EBA1;
-    }
-    else if (i < 60) {
-      f = (b & c) | (b & d) | (c & d);
-      k = 0x8F1BBCDC;
-    }
-    else {
-      f = b ^ c ^ d;
-      k = 0xCA62C1D6;
-    }
-    uint32_t temp = ROTL32(a, 5) + f + e + k + w[i];
-    e = d;
-    d = c;
-    c = ROTL32(b, 30);
-    b = a;
-    a = temp;
-  }
+  SHA1_R5( 0, SHA1_F0, 0x5A827999, SHA1_W0);
+  SHA1_R5( 5, SHA1_F0, 0x5A827999, SHA1_W0);
+  SHA1_R5(10, SHA1_F0, 0x5A827999, SHA1_W0);
+  SHA1_ROUND(a, b, c, d, e, SHA1_F0, 0x5A827999, w[15]);
+  SHA1_ROUND(e, a, b, c, d, SHA1_F0, 0x5A827999, SHA1_W(16));
+  SHA1_ROUND(d, e, a, b, c, SHA1_F0, 0x5A827999, SHA1_W(17));
+  SHA1_ROUND(c, d, e, a, b, SHA1_F0, 0x5A827999, SHA1_W(18));
+  SHA1_ROUND(b, c, d, e, a, SHA1_F0, 0x5A827999, SHA1_W(19));
+
+  SHA1_R5(20, SHA1_F1, 0x6ED9EBA1, SHA1_W);
+  SHA1_R5(25, SHA1_F1, 0x6ED9EBA1, SHA1_W);
+  SHA1_R5(30, SHA1_F1, 0x6ED9EBA1, SHA1_W);
+  SHA1_R5(35, SHA1_F1, 0x6ED9EBA1, SHA1_W);
+
+  SHA1_R5(40, SHA1_F2, 0x8F1BBCDC, SHA1_W);
+  SHA1_R5(45, SHA1_F2, 0x8F1BBCDC, SHA1_W);
+  SHA1_R5(50, SHA1_F2, 0x8F1BBCDC, SHA1_W);
+  SHA1_R5(55, SHA1_F2, 0x8F1BBCDC, SHA1_W);
+
+  SHA1_R5(60, SHA1_F3, 0xCA62C1D6, SHA1_W);
+  SHA1_R5(65, SHA1_F3, 0xCA62C1D6, SHA1_W);
+  SHA1_R5(70, SHA1_F3, 0xCA62C1D6, SHA1_W);
+  SHA1_R5(75, SHA1_F3, 0xCA62C1D6, SHA1_W);
 
   state->state[0] += a;
   state->state[1] += b;
@@ -59,16 +73,6 @@ void sha1_process_block(EXCRYPT_SHA_STATE* state)
   state->state[4] += e;
 }
 
-void sha1_process_byte(EXCRYPT_SHA_STATE* state, uint8_t octet)
-{
-  uint32_t offset = state->count++ & 0x3F;
-  state->buffer[offset] = octet;
-  if ((state->count & 0x3F) == 0)
-  {
-    sha1_process_block(state);
-  }
-}
-
 void ExCryptShaInit(EXCRYPT_SHA_STATE* state)
 {
   state->count = 0;
@@ -81,55 +85,67 @@ void ExCryptShaInit(EXCRYPT_SHA_STATE* state)
 
 void ExCryptShaUpdate(EXCRYPT_SHA_STATE* state, const uint8_t* input, uint32_t input_size)
 {
-  for (uint32_t i = 0; i < input_size; i++)
+  uint32_t offset = state->count & 0x3F;
+  state->count += input_size;
+
+  // top up a partially filled buffer first
+  if (offset)
   {
-    sha1_process_byte(state, input[i]);
+    uint32_t fill = 0x40 - offset;
+    if (input_size < fill)
+    {
+      memcpy(state->buffer + offset, input, input_size);
+      return;
+    }
+    memcpy(state->buffer + offset, input, fill);
+    sha1_process_block(state, state->buffer);
+    input += fill;
+    input_size -= fill;
+  }
+
+  // whole blocks are hashed straight from the input
+  while (input_size >= 0x40)
+  {
+    sha1_process_block(state, input);
+    input += 0x40;
+    input_size -= 0x40;
+  }
+
+  if (input_size)
+  {
+    memcpy(state->buffer, input, input_size);
   }
 }
 
 void ExCryptShaFinal(EXCRYPT_SHA_STATE* state, uint8_t* output, uint32_t output_size)
 {
   uint64_t bit_count = (uint64_t)state->count * 8;
+  uint32_t offset = state->count & 0x3F;
 
-  sha1_process_byte(state, 0x80);
+  state->buffer[offset++] = 0x80;
 
-  if ((state->count & 0x3F) > 56)
+  if (offset > 56)
   {
-    while ((state->count & 0x3F) != 0)
-    {
-      sha1_process_byte(state, 0);
-    }
-    while ((state->count & 0x3F) < 56)
-    {
-      sha1_process_byte(state, 0);
-    }
-  }
-  else
-  {
-    while ((state->count & 0x3F) < 56)
-    {
-      sha1_process_byte(state, 0);
-    }
+    memset(state->buffer + offset, 0, 0x40 - offset);
+    sha1_process_block(state, state->buffer);
+    offset = 0;
   }
+  memset(state->buffer + offset, 0, 60 - offset);
 
-  sha1_process_byte(state, 0);
-  sha1_process_byte(state, 0);
-  sha1_process_byte(state, 0);
-  sha1_process_byte(state, 0);
-
-  sha1_process_byte(state, (uint8_t)((bit_count >> 24) & 0xFF));
-  sha1_process_byte(state, (uint8_t)((bit_count >> 16) & 0xFF));
-  sha1_process_byte(state, (uint8_t)((bit_count >> 8) & 0xFF));
-  sha1_process_byte(state, (uint8_t)((bit_count) & 0xFF));
+  // only the low 32 bits of the length are tracked
+  state->buffer[60] = (uint8_t)((bit_count >> 24) & 0xFF);
+  state->buffer[61] = (uint8_t)((bit_count >> 16) & 0xFF);
+  state->buffer[62] = (uint8_t)((bit_count >> 8) & 0xFF);
+  state->buffer[63] = (uint8_t)((bit_count) & 0xFF);
+  sha1_process_block(state, state->buffer);
 
-  //sha1_process_block(state);
   uint32_t result[5];
   result[0] = SWAP32(state->state[0]);
   result[1] = SWAP32(state->state[1]);
   result[2] = SWAP32(state->state[2]);
   result[3] = SWAP32(state->state[3]);
   result[4] = SWAP32(state->state[4]);
-  memcpy(output, result, 0x14);
+  memcpy(output, result, output_size < sizeof(result) ? output_size : sizeof(result));
 }
 
 void ExCryptSha(const uint8_t* input1, uint32_t input1_size, const uint8_t* input2, uint32_t input2_size,
@@ -76,44 +76,75 @@ static uint8_t UsbdSecPlainTextData[128] __attribute__ ((aligned(4))) = {
 	0x66, 0xFA, 0x47, 0x55, 0x6C, 0x8D, 0x40, 0x08
 };
 
-void UsbdSecXSM3AuthenticationCrypt(const uint8_t *key, const uint8_t *input, size_t length, uint8_t *output, uint8_t encrypt) {
-	EXCRYPT_DES3_STATE des;
+// A challenge round runs the crypt and MAC steps over the same handful of
+// keys (and the static keyvault keys are reused by every handshake), so the
+// parity fixup and key schedule are cached instead of redone on every call.
+#define USBDSEC_KEY_CACHE_SIZE 8
+
+typedef struct _USBDSEC_KEY_CACHE_ENTRY {
+	uint8_t key[0x10];
+	uint32_t last_used;
+	EXCRYPT_DES3_STATE des3;
+} USBDSEC_KEY_CACHE_ENTRY;
+
+static USBDSEC_KEY_CACHE_ENTRY UsbdSecKeyCache[USBDSEC_KEY_CACHE_SIZE];
+static uint32_t UsbdSecKeyCacheClock = 0;
+
+static const EXCRYPT_DES3_STATE *UsbdSecGetKeySchedule(const uint8_t *key) {
+	USBDSEC_KEY_CACHE_ENTRY *entry = &UsbdSecKeyCache[0];
 	uint64_t sk[3];
-	uint8_t iv[8];
+	int i;
 
-	// clear local variables
-    memset(iv, 0, sizeof(iv));
+	for (i = 0; i < USBDSEC_KEY_CACHE_SIZE; i++) {
+		// last_used of zero marks an empty slot
+		if (UsbdSecKeyCache[i].last_used && memcmp(UsbdSecKeyCache[i].key, key, 0x10) == 0) {
+			UsbdSecKeyCache[i].last_used = ++UsbdSecKeyCacheClock;
+			return &UsbdSecKeyCache[i].des3;
+		}
+		if (UsbdSecKeyCache[i].last_used < entry->last_used)
+			entry = &UsbdSecKeyCache[i];
+	}
+
+	// miss: replace the least recently used slot
 	// run parity on the key
 	ExCryptDesParity(key, 0x10, (uint8_t *)sk);
 	sk[2] = sk[0];
-	// set the key in the state and run triple-des cbc en/decryption on it
-	ExCryptDes3Key(&des, sk);
-	ExCryptDes3Cbc(&des, input, length, output, iv, encrypt);
+	// set the key in the state, the third key is the same as the first so only two schedules are calculated
+	ExCryptDesKey(&entry->des3.des_state[0], (const uint8_t *)&sk[0]);
+	ExCryptDesKey(&entry->des3.des_state[1], (const uint8_t *)&sk[1]);
+	entry->des3.des_state[2] = entry->des3.des_state[0];
+	memcpy(entry->key, key, 0x10);
+	entry->last_used = ++UsbdSecKeyCacheClock;
+	return &entry->des3;
+}
+
+void UsbdSecXSM3AuthenticationCrypt(const uint8_t *key, const uint8_t *input, size_t length, uint8_t *output, uint8_t encrypt) {
+	uint8_t iv[8];
+
+	// clear local variables
+	memset(iv, 0, sizeof(iv));
+	// run triple-des cbc en/decryption with the cached key schedule
+	ExCryptDes3Cbc(UsbdSecGetKeySchedule(key), input, length, output, iv, encrypt);
 }
 
 void UsbdSecXSM3AuthenticationMac(const uint8_t *key, uint8_t *salt, uint8_t *input, size_t length, uint8_t *output) {
-	EXCRYPT_DES3_STATE des3;
-	EXCRYPT_DES_STATE des;
-	uint64_t sk[3];
+	const EXCRYPT_DES3_STATE *des3 = UsbdSecGetKeySchedule(key);
+	// the single des state is the first key of the triple-des state
+	const EXCRYPT_DES_STATE *des = &des3->des_state[0];
 	uint8_t iv[8];
 	uint8_t temp[8];
 	uint64_t input_temp;
-	int i;
+	size_t i;
 
 	// clear iv + temp value of stack junk
 	memset(iv, 0, sizeof(iv));
 	memset(temp, 0, sizeof(temp));
-	// run parity on the key
-	ExCryptDesParity(key, 0x10, (uint8_t *)sk);
-	sk[2] = sk[0];
-	// set the key in our initial des state
-	ExCryptDesKey(&des, (uint8_t *)&sk[0]);
 	// if we have a salt, encrypt it into the temp value
 	if (salt) {
 		memcpy(&input_temp, salt, sizeof(input_temp));
 		input_temp = SWAP64(SWAP64(input_temp) + 1);
 		memcpy(salt, &input_temp, sizeof(input_temp)); // no idea what this does
-		ExCryptDesEcb(&des, salt, temp, 1);
+		ExCryptDesEcb(des, salt, temp, 1);
 	}
 	// for every 8 byte input block, xor the temp value with it and encrypt over itself
 	for (i = 0; i < length; i += 8) {
@@ -124,13 +155,12 @@ void UsbdSecXSM3AuthenticationMac(const uint8_t *key, uint8_t *salt, uint8_t *in
 		xor_temp ^= input_temp;
 		memcpy(temp, &xor_temp, sizeof(xor_temp));
 		
-		ExCryptDesEcb(&des, temp, temp, 1);
+		ExCryptDesEcb(des, temp, temp, 1);
 	}
 	// xor the highest bit of the temp value
 	temp[0] ^= 0x80;
-	// set the key and perform the final triple-des encryption
-	ExCryptDes3Key(&des3, sk);
-	ExCryptDes3Cbc(&des3, temp, 8, output, iv, 1);
+	// perform the final triple-des encryption
+	ExCryptDes3Cbc(des3, temp, 8, output, iv, 1);
 	// real kernel does the following, but the above works:
 	// XeCryptDesEcb(des_state_1, temp, temp, 1);
 	// XeCryptDesEcb(des_state_2, temp, temp, 0);
@@ -1,5 +1,4 @@
 #include "drivers/switch/SwitchDriver.h"
-#include "drivers/shared/driverhelper.h"
 
 void SwitchDriver::initialize() {
 	switchReport = {
@@ -100,8 +99,9 @@ bool SwitchDriver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_co
 }
 
 const uint16_t * SwitchDriver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-	const char *value = (const char *)switch_string_descriptors[index];
-	return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+	if (index >= sizeof(switch_string_descriptors) / sizeof(switch_string_descriptors[0]))
+		return nullptr;
+	return switch_string_descriptors[index];
 }
 
 const uint8_t * SwitchDriver::get_descriptor_device_cb() {
@@ -1,5 +1,4 @@
 #include "drivers/switchpro/SwitchProDriver.h"
-#include "drivers/shared/driverhelper.h"
 #include "storagemanager.h"
 #include "pico/rand.h"
 
@@ -13,6 +12,8 @@ void SwitchProDriver::initialize() {
     last_report_counter = 0;
     handshakeCounter = 0;
     isReady = false;
+    replyHead = 0;
+    replyCount = 0;
 
     deviceInfo = {
         .majorVersion = 0x04,
@@ -144,13 +145,10 @@ bool SwitchProDriver::process(Gamepad * gamepad) {
 	if (tud_suspended())
 		tud_remote_wakeup();
 
-    if (isReportQueued) {
-        if ((now - last_report_timer) > SWITCH_PRO_KEEPALIVE_TIMER) {
-            if (tud_hid_ready() && sendReport(queuedReportID, report, 64) == true ) {
-            }
-            isReportQueued = false;
-            last_report_timer = now;
-        }
+    // subcommand replies go out as soon as the endpoint is free, anything
+    // left behind is drained from report_complete as each transfer finishes
+    if (replyCount > 0) {
+        if (tud_hid_ready()) sendQueuedReply();
         reportSent = true;
     }
 
@@ -177,7 +175,7 @@ bool SwitchProDriver::process(Gamepad * gamepad) {
     } else {
         if (!isInitialized) {
             // send identification
-            sendIdentify();
+            sendIdentify(report);
             if (tud_hid_ready() && tud_hid_report(0, report, 64) == true) {
                 isInitialized = true;
                 reportSent = true;
@@ -201,15 +199,15 @@ uint16_t SwitchProDriver::get_report(uint8_t report_id, hid_report_type_t report
     return 0;
 }
 
-void SwitchProDriver::sendIdentify() {
-    memset(report, 0x00, 64);
-    report[0] = SwitchReportID::REPORT_USB_INPUT_81;
-    report[1] = SwitchOutputSubtypes::IDENTIFY;
-    report[2] = 0x00;
-    report[3] = deviceInfo.controllerType;
+void SwitchProDriver::sendIdentify(uint8_t* reply) {
+    memset(reply, 0x00, 64);
+    reply[0] = SwitchReportID::REPORT_USB_INPUT_81;
+    reply[1] = SwitchOutputSubtypes::IDENTIFY;
+    reply[2] = 0x00;
+    reply[3] = deviceInfo.controllerType;
     // MAC address
     for (uint8_t i = 0; i < 6; i++) {
-        report[4+i] = deviceInfo.macAddress[5-i];
+        reply[4+i] = deviceInfo.macAddress[5-i];
     }
 }
 
@@ -227,31 +225,31 @@ bool SwitchProDriver::sendReport(uint8_t reportID, void const* reportData, uint1
     return result;
 }
 
-void SwitchProDriver::handleConfigReport(uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength) {
+bool SwitchProDriver::handleConfigReport(uint8_t* reply, uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength) {
     bool canSend = false;
 
     switch (switchReportSubID) {
         case SwitchOutputSubtypes::IDENTIFY:
             //printf("SwitchProDriver::set_report: IDENTIFY\n");
-            sendIdentify();
+            sendIdentify(reply);
             canSend = true;
             break;
         case SwitchOutputSubtypes::HANDSHAKE:
             //printf("SwitchProDriver::set_report: HANDSHAKE\n");
-            report[0] = SwitchReportID::REPORT_USB_INPUT_81;
-            report[1] = SwitchOutputSubtypes::HANDSHAKE;
+            reply[0] = SwitchReportID::REPORT_USB_INPUT_81;
+            reply[1] = SwitchOutputSubtypes::HANDSHAKE;
             canSend = true;
             break;
         case SwitchOutputSubtypes::BAUD_RATE:
             //printf("SwitchProDriver::set_report: BAUD_RATE\n");
-            report[0] = SwitchReportID::REPORT_USB_INPUT_81;
-            report[1] = SwitchOutputSubtypes::BAUD_RATE;
+            reply[0] = SwitchReportID::REPORT_USB_INPUT_81;
+            reply[1] = SwitchOutputSubtypes::BAUD_RATE;
             canSend = true;
             break;
         case SwitchOutputSubtypes::DISABLE_USB_TIMEOUT:
             //printf("SwitchProDriver::set_report: DISABLE_USB_TIMEOUT\n");
-            report[0] = SwitchReportID::REPORT_OUTPUT_30;
-            report[1] = switchReportSubID;
+            reply[0] = SwitchReportID::REPORT_OUTPUT_30;
+            reply[1] = switchReportSubID;
             //if (handshakeCounter < 4) {
             //    handshakeCounter++;
             //} else {
@@ -261,22 +259,22 @@ void SwitchProDriver::handleConfigReport(uint8_t switchReportID, uint8_t switchR
             break;
         case SwitchOutputSubtypes::ENABLE_USB_TIMEOUT:
             //printf("SwitchProDriver::set_report: ENABLE_USB_TIMEOUT\n");
-            report[0] = SwitchReportID::REPORT_OUTPUT_30;
-            report[1] = switchReportSubID;
+            reply[0] = SwitchReportID::REPORT_OUTPUT_30;
+            reply[1] = switchReportSubID;
             canSend = true;
             break;
         default:
             //printf("SwitchProDriver::set_report: Unknown Sub ID %02x\n", switchReportSubID);
-            report[0] = SwitchReportID::REPORT_OUTPUT_30;
-            report[1] = switchReportSubID;
+            reply[0] = SwitchReportID::REPORT_OUTPUT_30;
+            reply[1] = switchReportSubID;
             canSend = true;
             break;
     }
 
-    if (canSend) isReportQueued = true;
+    return canSend;
 }
 
-void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength) {
+bool SwitchProDriver::handleFeatureReport(uint8_t* reply, uint8_t switchReportID, uint8_t switchReportSubID, const uint8_t *reportData, uint16_t reportLength) {
     uint8_t commandID = reportData[10];
     uint32_t spiReadAddress = 0;
     uint8_t spiReadSize = 0;
@@ -285,38 +283,38 @@ void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switch
     //uint8_t inputReportSize = sizeof(SwitchInputReport);
     //printf("inputReportSize: %d\n", inputReportSize);
 
-    report[0] = SwitchReportID::REPORT_OUTPUT_21;
-    report[1] = last_report_counter;
-    memcpy(report+2,&switchReport.inputs,sizeof(SwitchInputReport));
+    reply[0] = SwitchReportID::REPORT_OUTPUT_21;
+    reply[1] = last_report_counter;
+    memcpy(reply+2,&switchReport.inputs,sizeof(SwitchInputReport));
 
     switch (commandID) {
         case SwitchCommands::GET_CONTROLLER_STATE:
             //printf("SwitchProDriver::set_report: Rpt 0x01 GET_CONTROLLER_STATE\n");
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x03;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x03;
             canSend = true;
             break;
         case SwitchCommands::BLUETOOTH_PAIR_REQUEST:
             //printf("SwitchProDriver::set_report: Rpt 0x01 BLUETOOTH_PAIR_REQUEST\n");
-            report[13] = 0x81;
-            report[14] = commandID;
-            report[15] = 0x03;
+            reply[13] = 0x81;
+            reply[14] = commandID;
+            reply[15] = 0x03;
             canSend = true;
             break;
         case SwitchCommands::REQUEST_DEVICE_INFO:
             //printf("SwitchProDriver::set_report: Rpt 0x01 REQUEST_DEVICE_INFO\n");
-            report[13] = 0x82;
-            report[14] = 0x02;
-            memcpy(&report[15], &deviceInfo, sizeof(deviceInfo));
+            reply[13] = 0x82;
+            reply[14] = 0x02;
+            memcpy(&reply[15], &deviceInfo, sizeof(deviceInfo));
             canSend = true;
             break;
         case SwitchCommands::SET_MODE:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_MODE\n");
             inputMode = reportData[11];
-            report[13] = 0x80;
-            report[14] = 0x03;
-            report[15] = inputMode;
+            reply[13] = 0x80;
+            reply[14] = 0x03;
+            reply[15] = inputMode;
             canSend = true;
             //printf("Input Mode set to ");
             switch (inputMode) {
@@ -354,14 +352,14 @@ void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switch
             break;
         case SwitchCommands::TRIGGER_BUTTONS:
             //printf("SwitchProDriver::set_report: Rpt 0x01 TRIGGER_BUTTONS\n");
-            report[13] = 0x83;
-            report[14] = 0x04;
+            reply[13] = 0x83;
+            reply[14] = 0x04;
             canSend = true;
             break;
         case SwitchCommands::SET_SHIPMENT:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_SHIPMENT\n");
-            report[13] = 0x80;
-            report[14] = commandID;
+            reply[13] = 0x80;
+            reply[14] = commandID;
             canSend = true;
             //for (uint8_t i = 2; i < bufsize; i++) {
             //    //printf("%02x ", reportData[i]);
@@ -371,36 +369,36 @@ void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switch
         case SwitchCommands::SPI_READ:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SPI_READ\n");
             spiReadAddress = (reportData[14] << 24) | (reportData[13] << 16) | (reportData[12] << 8) | (reportData[11]);
-            spiReadSize = reportData[15];
+            spiReadSize = std::min<uint8_t>(reportData[15], SWITCH_PRO_ENDPOINT_SIZE - 20);
             //printf("Read From: 0x%08x Size %d\n", spiReadAddress, spiReadSize);
-            report[13] = 0x90;
-            report[14] = reportData[10];
-            report[15] = reportData[11];
-            report[16] = reportData[12];
-            report[17] = reportData[13];
-            report[18] = reportData[14];
-            report[19] = reportData[15];
-            readSPIFlash(&report[20], spiReadAddress, spiReadSize);
+            reply[13] = 0x90;
+            reply[14] = reportData[10];
+            reply[15] = reportData[11];
+            reply[16] = reportData[12];
+            reply[17] = reportData[13];
+            reply[18] = reportData[14];
+            reply[19] = reportData[15];
+            readSPIFlash(&reply[20], spiReadAddress, spiReadSize);
             canSend = true;
             //printf("----------------------------------------------\n");
             break;
         case SwitchCommands::SET_NFC_IR_CONFIG:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_NFC_IR_CONFIG\n");
-            report[13] = 0x80;
-            report[14] = commandID;
+            reply[13] = 0x80;
+            reply[14] = commandID;
             canSend = true;
             break;
         case SwitchCommands::SET_NFC_IR_STATE:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_NFC_IR_STATE\n");
-            report[13] = 0x80;
-            report[14] = commandID;
+            reply[13] = 0x80;
+            reply[14] = commandID;
             canSend = true;
             break;
         case SwitchCommands::SET_PLAYER_LIGHTS:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_PLAYER_LIGHTS\n");
             playerID = reportData[11];
-            report[13] = 0x80;
-            report[14] = commandID;
+            reply[13] = 0x80;
+            reply[14] = commandID;
             canSend = true;
             //printf("Player set to %d\n", playerID);
             //printf("----------------------------------------------\n");
@@ -408,9 +406,9 @@ void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switch
         case SwitchCommands::GET_PLAYER_LIGHTS:
             //printf("SwitchProDriver::set_report: Rpt 0x01 GET_PLAYER_LIGHTS\n");
             playerID = reportData[11];
-            report[13] = 0xB0;
-            report[14] = commandID;
-            report[15] = playerID;
+            reply[13] = 0xB0;
+            reply[14] = commandID;
+            reply[15] = playerID;
             canSend = true;
             //printf("Player is %d\n", playerID);
             //printf("----------------------------------------------\n");
@@ -418,112 +416,149 @@ void SwitchProDriver::handleFeatureReport(uint8_t switchReportID, uint8_t switch
         case SwitchCommands::COMMAND_UNKNOWN_33:
             //printf("SwitchProDriver::set_report: Rpt 0x01 COMMAND_UNKNOWN_33\n");
             // Command typically thrown by Chromium to detect if a Switch controller exists. Can ignore.
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x03;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x03;
             canSend = true;
             break;
         case SwitchCommands::SET_HOME_LIGHT:
             //printf("SwitchProDriver::set_report: Rpt 0x01 SET_HOME_LIGHT\n");
             // NYI
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x00;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x00;
             canSend = true;
             break;
         case SwitchCommands::TOGGLE_IMU:
             //printf("SwitchProDriver::set_report: Rpt 0x01 TOGGLE_IMU\n");
             isIMUEnabled = reportData[11];
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x00;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x00;
             canSend = true;
             //printf("IMU set to %d\n", isIMUEnabled);
             //printf("----------------------------------------------\n");
             break;
         case SwitchCommands::IMU_SENSITIVITY:
             //printf("SwitchProDriver::set_report: Rpt 0x01 IMU_SENSITIVITY\n");
-            report[13] = 0x80;
-            report[14] = commandID;
+            reply[13] = 0x80;
+            reply[14] = commandID;
             canSend = true;
             break;
         case SwitchCommands::ENABLE_VIBRATION:
             //printf("SwitchProDriver::set_report: Rpt 0x01 ENABLE_VIBRATION\n");
             isVibrationEnabled = reportData[11];
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x00;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x00;
             canSend = true;
             //printf("Vibration set to %d\n", isVibrationEnabled);
             //printf("----------------------------------------------\n");
             break;
         case SwitchCommands::READ_IMU:
             //printf("SwitchProDriver::set_report: Rpt 0x01 READ_IMU\n");
-            report[13] = 0xC0;
-            report[14] = commandID;
-            report[15] = reportData[11];
-            report[16] = reportData[12];
+            reply[13] = 0xC0;
+            reply[14] = commandID;
+            reply[15] = reportData[11];
+            reply[16] = reportData[12];
             canSend = true;
             //printf("IMU Addr: %02x, Size: %02x\n", reportData[11], reportData[12]);
             //printf("----------------------------------------------\n");
             break;
         case SwitchCommands::GET_VOLTAGE:
             //printf("SwitchProDriver::set_report: Rpt 0x01 GET_VOLTAGE\n");
-            report[13] = 0xD0;
-            report[14] = 0x50;
-            report[15] = 0x83;
-            report[16] = 0x06;
+            reply[13] = 0xD0;
+            reply[14] = 0x50;
+            reply[15] = 0x83;
+            reply[16] = 0x06;
             canSend = true;
             break;
         default:
             //printf("SwitchProDriver::set_report: Rpt 0x01 Unknown 0x%02x\n", commandID);
-            report[13] = 0x80;
-            report[14] = commandID;
-            report[15] = 0x03;
+            reply[13] = 0x80;
+            reply[14] = commandID;
+            reply[15] = 0x03;
             canSend = true;
             break;
     }
 
-    if (canSend) isReportQueued = true;
+    return canSend;
 }
 
 void SwitchProDriver::set_report(uint8_t report_id, hid_report_type_t report_type, const uint8_t *buffer, uint16_t bufsize) {
     if (report_type != HID_REPORT_TYPE_OUTPUT) return;
 
-    memset(report, 0x00, bufsize);
-
     uint8_t switchReportID = buffer[0];
     uint8_t switchReportSubID = buffer[1];
     //printf("SwitchProDriver::set_report Rpt: %02x, Type: %d, Len: %d :: SID: %02x, SSID: %02x\n", report_id, report_type, bufsize, switchReportID, switchReportSubID);
     if (switchReportID == SwitchReportID::REPORT_OUTPUT_00) {
     } else if (switchReportID == SwitchReportID::REPORT_FEATURE) {
-        queuedReportID = report_id;
-        handleFeatureReport(switchReportID, switchReportSubID, buffer, bufsize);
+        uint8_t* reply = nextReply();
+        if (reply != nullptr && handleFeatureReport(reply, switchReportID, switchReportSubID, buffer, bufsize))
+            pushReply(report_id);
     } else if (switchReportID == SwitchReportID::REPORT_CONFIGURATION) {
-        queuedReportID = report_id;
-        handleConfigReport(switchReportID, switchReportSubID, buffer, bufsize);
+        uint8_t* reply = nextReply();
+        if (reply != nullptr && handleConfigReport(reply, switchReportID, switchReportSubID, buffer, bufsize))
+            pushReply(report_id);
     } else {
         //printf("SwitchProDriver::set_report Rpt: %02x, Type: %d, Len: %d :: SID: %02x, SSID: %02x\n", report_id, report_type, bufsize, switchReportID, switchReportSubID);
     }
+
+    // the console sends its init subcommands back to back, reply straight away if the endpoint is idle
+    if (tud_hid_ready()) sendQueuedReply();
+}
+
+// Invoked once an IN report has gone out, keeps the reply queue moving without waiting on process()
+void SwitchProDriver::report_complete(uint8_t itf, uint8_t const *report, uint16_t len) {
+    sendQueuedReply();
+}
+
+// Returns the cleared slot at the back of the reply queue, or nullptr if the queue is full.
+// The slot only becomes part of the queue once pushReply() is called.
+uint8_t* SwitchProDriver::nextReply() {
+    if (replyCount >= SWITCH_PRO_REPLY_QUEUE_SIZE) return nullptr;
+
+    SwitchProReply& reply = replyQueue[(replyHead + replyCount) % SWITCH_PRO_REPLY_QUEUE_SIZE];
+    memset(reply.data, 0x00, sizeof(reply.data));
+    return reply.data;
+}
+
+void SwitchProDriver::pushReply(uint8_t reportID) {
+    replyQueue[(replyHead + replyCount) % SWITCH_PRO_REPLY_QUEUE_SIZE].reportID = reportID;
+    replyCount++;
+}
+
+bool SwitchProDriver::sendQueuedReply() {
+    if (replyCount == 0) return false;
+
+    SwitchProReply& reply = replyQueue[replyHead];
+    if (!sendReport(reply.reportID, reply.data, sizeof(reply.data))) return false;
+
+    replyHead = (replyHead + 1) % SWITCH_PRO_REPLY_QUEUE_SIZE;
+    replyCount--;
+
+    // hold off the next input report for a keepalive period, as before
+    last_report_timer = to_ms_since_boot(get_absolute_time());
+    return true;
 }
 
 void SwitchProDriver::readSPIFlash(uint8_t* dest, uint32_t address, uint8_t size) {
-    uint32_t addressBank = address & 0xFFFFFF00;
-    uint32_t addressOffset = address & 0x000000FF;
+    uint32_t addressBank = address & ~(uint32_t)(SWITCH_PRO_SPI_BANK_SIZE - 1);
+    uint32_t addressOffset = address & (SWITCH_PRO_SPI_BANK_SIZE - 1);
     //printf("Address: %08x, Bank: %04x, Offset: %04x, Size: %d\n", address, addressBank, addressOffset, size);
-    std::map<uint32_t, const uint8_t*>::iterator it = spiFlashData.find(addressBank);
-
-    if (it != spiFlashData.end()) {
-        // address found
-        const uint8_t* data = it->second;
-        memcpy(dest, data+addressOffset, size);
-        //for (uint8_t i = 0; i < size; i++) printf("%02x ", dest[i]);
-        //printf("\n---\n");
-    } else {
-        // could not find defined address
-        //printf("Not Found\n");
-        memset(dest, 0xFF, size);
+
+    for (const SwitchSPIFlashBank& bank : spiFlashImage) {
+        if (bank.address == addressBank) {
+            // reads running off the end of the bank see more padding
+            uint32_t length = std::min<uint32_t>(size, SWITCH_PRO_SPI_BANK_SIZE - addressOffset);
+            memcpy(dest, bank.data + addressOffset, length);
+            memset(dest + length, 0x00, size - length);
+            return;
+        }
     }
+
+    // could not find defined address
+    memset(dest, 0xFF, size);
 }
 
 // Only XboxOG and Xbox One use vendor control xfer cb
@@ -532,8 +567,9 @@ bool SwitchProDriver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb
 }
 
 const uint16_t * SwitchProDriver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-	const char *value = (const char *)switch_pro_string_descriptors[index];
-	return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+	if (index >= sizeof(switch_pro_string_descriptors) / sizeof(switch_pro_string_descriptors[0]))
+		return nullptr;
+	return switch_pro_string_descriptors[index];
 }
 
 const uint8_t * SwitchProDriver::get_descriptor_device_cb() {
@@ -315,6 +315,16 @@ bool xbone_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
     return true;
 }
 
+XBOneDriver::~XBOneDriver() {
+    delete authDriver;
+
+    // the XGIP buffers are file statics shared with the TinyUSB callbacks
+    delete incomingXGIP;
+    incomingXGIP = nullptr;
+    delete outgoingXGIP;
+    outgoingXGIP = nullptr;
+}
+
 void XBOneDriver::initialize() {
     xboneReport = {
         .sync = 0,
@@ -593,8 +603,22 @@ bool XBOneDriver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_con
 }
 
 const uint16_t * XBOneDriver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-    const char *value = (const char *)xbone_get_string_descriptor(index);
-    return getStringDescriptor(value, index); // getStringDescriptor returns a static array
+    if ( index == XBONE_STRING_INDEX_SERIAL ) {
+        // Generate a serial number from the pico's unique ID
+        static char xbone_string_serial[] = "012345678ABCDEFGH";
+        pico_unique_board_id_t id;
+        pico_get_unique_board_id(&id);
+        for(int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++) {
+            xbone_string_serial[i] = 'A' + (id.id[i]%26); // some alphanumeric from 'A' to 'Z'
+        }
+        return getStringDescriptor(xbone_string_serial, index); // getStringDescriptor returns a static array
+    } else if ( index == XBONE_STRING_INDEX_OS ) { // only Windows asks for this
+        return xbone_string_os;
+    }
+
+    if ( index >= sizeof(xbone_string_descriptors) / sizeof(xbone_string_descriptors[0]) )
+        return nullptr;
+    return xbone_string_descriptors[index];
 }
 
 const uint8_t * XBOneDriver::get_descriptor_device_cb() {
@@ -2,6 +2,8 @@
 #include "drivers/xinput/XInputAuthUSBListener.h"
 #include "peripheralmanager.h"
 
+#include <pico/unique_id.h>
+
 #include "xsm3/xsm3.h"
 
 void XInputAuth::initialize() {
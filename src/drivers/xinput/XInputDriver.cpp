@@ -7,6 +7,8 @@
 #include "drivers/shared/driverhelper.h"
 #include "storagemanager.h"
 
+#include <pico/unique_id.h>
+
 #define USB_SETUP_DEVICE_TO_HOST 0x80
 #define USB_SETUP_HOST_TO_DEVICE 0x00
 #define USB_SETUP_TYPE_VENDOR    0x40
@@ -141,72 +143,36 @@ void XInputDriver::initialize() {
     GamepadOptions & gamepadOptions = Storage::getInstance().getGamepadOptions();
     deviceType = gamepadOptions.inputDeviceType;
 
-    // controller type bindings
-    if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_WHEEL) {
-        // wheel
-        buttonGas = new GamepadButtonMapping(0);
-        buttonBrake = new GamepadButtonMapping(0);
-        buttonSteerLeft = new GamepadButtonMapping(0);
-        buttonSteerRight = new GamepadButtonMapping(0);
-    } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GUITAR) {
-        // guitar
-        buttonFretGreen = new GamepadButtonMapping(0);
-        buttonFretRed = new GamepadButtonMapping(0);
-        buttonFretYellow = new GamepadButtonMapping(0);
-        buttonFretBlue = new GamepadButtonMapping(0);
-        buttonFretOrange = new GamepadButtonMapping(0);
-        buttonFretSoloGreen = new GamepadButtonMapping(0);
-        buttonFretSoloRed = new GamepadButtonMapping(0);
-        buttonFretSoloYellow = new GamepadButtonMapping(0);
-        buttonFretSoloBlue = new GamepadButtonMapping(0);
-        buttonFretSoloOrange = new GamepadButtonMapping(0);
-        buttonWhammy = new GamepadButtonMapping(0);
-        buttonTilt = new GamepadButtonMapping(0);
-    } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
-        // drum
-        buttonDrumPadRed = new GamepadButtonMapping(0);
-        buttonDrumPadBlue = new GamepadButtonMapping(0);
-        buttonDrumPadYellow = new GamepadButtonMapping(0);
-        buttonDrumPadGreen = new GamepadButtonMapping(0);
-        buttonCymbalYellow = new GamepadButtonMapping(0);
-        buttonCymbalBlue = new GamepadButtonMapping(0);
-        buttonCymbalGreen = new GamepadButtonMapping(0);
-        buttonKickPedalLeft = new GamepadButtonMapping(0);
-        buttonKickPedalRight = new GamepadButtonMapping(0);
-    } else {
-        // assume gamepad if not special cased
-    }
-
     GpioMappingInfo* pinMappings = Storage::getInstance().getProfilePinMappings();
     for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
         switch (pinMappings[pin].action) {
-            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_GREEN: buttonFretSoloGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_RED: buttonFretSoloRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_YELLOW: buttonFretSoloYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_BLUE: buttonFretSoloBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_FRET_SOLO_ORANGE: buttonFretSoloOrange->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_GUITAR_TILT: buttonTilt->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_KICK_PEDAL_LEFT: buttonKickPedalLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_DRUM_KICK_PEDAL_RIGHT: buttonKickPedalRight->pinMask |= 1 << pin; break;
-
-            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas->pinMask |= 1 << pin; break;
-            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake->pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_GREEN: buttonFretGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_RED: buttonFretRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_YELLOW: buttonFretYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_BLUE: buttonFretBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_ORANGE: buttonFretOrange.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_GREEN: buttonFretSoloGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_RED: buttonFretSoloRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_YELLOW: buttonFretSoloYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_BLUE: buttonFretSoloBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_FRET_SOLO_ORANGE: buttonFretSoloOrange.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_WHAMMY: buttonWhammy.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_GUITAR_TILT: buttonTilt.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_DRUM_RED_DRUMPAD: buttonDrumPadRed.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_DRUMPAD: buttonDrumPadBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_DRUMPAD: buttonDrumPadYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_DRUMPAD: buttonDrumPadGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_YELLOW_CYMBAL: buttonCymbalYellow.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_BLUE_CYMBAL: buttonCymbalBlue.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_GREEN_CYMBAL: buttonCymbalGreen.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_KICK_PEDAL_LEFT: buttonKickPedalLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_DRUM_KICK_PEDAL_RIGHT: buttonKickPedalRight.pinMask |= 1 << pin; break;
+
+            case GpioAction::MODE_WHEEL_STEERING_LEFT: buttonSteerLeft.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_STEERING_RIGHT: buttonSteerRight.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_GAS: buttonGas.pinMask |= 1 << pin; break;
+            case GpioAction::MODE_WHEEL_PEDAL_BRAKE: buttonBrake.pinMask |= 1 << pin; break;
 
             default:    break;
         }
@@ -294,38 +260,38 @@ bool XInputDriver::process(Gamepad * gamepad) {
     // map to Xinput for special buttons
     if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_WHEEL) {
         // wheel
-        if (values & buttonSteerLeft->pinMask)      { xinputReport.lx = GAMEPAD_JOYSTICK_MIN; }
-        if (values & buttonSteerRight->pinMask)     { xinputReport.lx = GAMEPAD_JOYSTICK_MAX; }
-        if (values & buttonBrake->pinMask)          { xinputReport.lt = INT8_MAX; }
-        if (values & buttonGas->pinMask)            { xinputReport.rt = INT8_MAX; }
+        if (values & buttonSteerLeft.pinMask)      { xinputReport.lx = GAMEPAD_JOYSTICK_MIN; }
+        if (values & buttonSteerRight.pinMask)     { xinputReport.lx = GAMEPAD_JOYSTICK_MAX; }
+        if (values & buttonBrake.pinMask)          { xinputReport.lt = INT8_MAX; }
+        if (values & buttonGas.pinMask)            { xinputReport.rt = INT8_MAX; }
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GUITAR) {
         // guitar
-        if (values & buttonFretGreen->pinMask)      { xinputReport.buttons2 |= XBOX_MASK_A; }
-        if (values & buttonFretRed->pinMask)        { xinputReport.buttons2 |= XBOX_MASK_B; }
-        if (values & buttonFretYellow->pinMask)     { xinputReport.buttons2 |= XBOX_MASK_Y; }
-        if (values & buttonFretBlue->pinMask)       { xinputReport.buttons2 |= XBOX_MASK_X; }
-        if (values & buttonFretOrange->pinMask)     { xinputReport.buttons2 |= XBOX_MASK_LB; }
+        if (values & buttonFretGreen.pinMask)      { xinputReport.buttons2 |= XBOX_MASK_A; }
+        if (values & buttonFretRed.pinMask)        { xinputReport.buttons2 |= XBOX_MASK_B; }
+        if (values & buttonFretYellow.pinMask)     { xinputReport.buttons2 |= XBOX_MASK_Y; }
+        if (values & buttonFretBlue.pinMask)       { xinputReport.buttons2 |= XBOX_MASK_X; }
+        if (values & buttonFretOrange.pinMask)     { xinputReport.buttons2 |= XBOX_MASK_LB; }
         
-        if (values & buttonFretSoloGreen->pinMask)  { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_A; }
-        if (values & buttonFretSoloRed->pinMask)    { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_B; }
-        if (values & buttonFretSoloYellow->pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_Y; }
-        if (values & buttonFretSoloBlue->pinMask)   { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_X; }
-        if (values & buttonFretSoloOrange->pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_LB; }
+        if (values & buttonFretSoloGreen.pinMask)  { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_A; }
+        if (values & buttonFretSoloRed.pinMask)    { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_B; }
+        if (values & buttonFretSoloYellow.pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_Y; }
+        if (values & buttonFretSoloBlue.pinMask)   { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_X; }
+        if (values & buttonFretSoloOrange.pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; xinputReport.buttons2 |= XBOX_MASK_LB; }
         
-        if (values & buttonWhammy->pinMask)         { xinputReport.rx = GAMEPAD_JOYSTICK_MAX; }
-        if (values & buttonTilt->pinMask)           { xinputReport.ry = GAMEPAD_JOYSTICK_MAX; }
+        if (values & buttonWhammy.pinMask)         { xinputReport.rx = GAMEPAD_JOYSTICK_MAX; }
+        if (values & buttonTilt.pinMask)           { xinputReport.ry = GAMEPAD_JOYSTICK_MAX; }
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
         // drum
-        if (values & buttonDrumPadRed->pinMask)     { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_B; }
-        if (values & buttonDrumPadBlue->pinMask)    { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_X; }
-        if (values & buttonDrumPadYellow->pinMask)  { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_Y; }
-        if (values & buttonDrumPadGreen->pinMask)   { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_A; }
-        if (values & buttonCymbalYellow->pinMask)   { xinputReport.buttons1 |= XBOX_MASK_UP; xinputReport.buttons2 |= XBOX_MASK_Y|XBOX_MASK_RB; }
-        if (values & buttonCymbalBlue->pinMask)     { xinputReport.buttons1 |= XBOX_MASK_DOWN; xinputReport.buttons2 |= XBOX_MASK_X|XBOX_MASK_RB; }
-        if (values & buttonCymbalGreen->pinMask)    { xinputReport.buttons2 |= XBOX_MASK_A|XBOX_MASK_RB; }
-
-        if (values & buttonKickPedalLeft->pinMask)  { xinputReport.buttons2 |= XBOX_MASK_LB; }
-        if (values & buttonKickPedalRight->pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; }
+        if (values & buttonDrumPadRed.pinMask)     { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_B; }
+        if (values & buttonDrumPadBlue.pinMask)    { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_X; }
+        if (values & buttonDrumPadYellow.pinMask)  { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_Y; }
+        if (values & buttonDrumPadGreen.pinMask)   { xinputReport.buttons1 |= XBOX_MASK_RS; xinputReport.buttons2 |= XBOX_MASK_A; }
+        if (values & buttonCymbalYellow.pinMask)   { xinputReport.buttons1 |= XBOX_MASK_UP; xinputReport.buttons2 |= XBOX_MASK_Y|XBOX_MASK_RB; }
+        if (values & buttonCymbalBlue.pinMask)     { xinputReport.buttons1 |= XBOX_MASK_DOWN; xinputReport.buttons2 |= XBOX_MASK_X|XBOX_MASK_RB; }
+        if (values & buttonCymbalGreen.pinMask)    { xinputReport.buttons2 |= XBOX_MASK_A|XBOX_MASK_RB; }
+
+        if (values & buttonKickPedalLeft.pinMask)  { xinputReport.buttons2 |= XBOX_MASK_LB; }
+        if (values & buttonKickPedalRight.pinMask) { xinputReport.buttons1 |= XBOX_MASK_LS; }
     } else {
         // assume gamepad if not special cased
     }
@@ -487,7 +453,7 @@ bool XInputDriver::vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_co
 }
 
 const uint16_t * XInputDriver::get_descriptor_string_cb(uint8_t index, uint16_t langid) {
-    char *value;
+    char *value = nullptr;
     // Check for override settings
     GamepadOptions & gamepadOptions = Storage::getInstance().getGamepadOptions();
     if ( gamepadOptions.usbDescOverride == true ) {
@@ -502,13 +468,27 @@ const uint16_t * XInputDriver::get_descriptor_string_cb(uint8_t index, uint16_t
                 value = gamepadOptions.usbDescVersion;
                 break;
             default:
-                value = (char *)xinput_get_string_descriptor(index);
                 break;
         }
-    } else {
-        value = (char *)xinput_get_string_descriptor(index);
     }
-    return getStringDescriptor((const char*)value, index); // getStringDescriptor returns a static array
+
+    if ( value == nullptr && index == XINPUT_STRING_INDEX_VERSION ) {
+        // Generate a serial number of hex bytes from the pico's unique ID
+        static char xinput_string_version[] = "08FEC93";
+        pico_unique_board_id_t unique_id;
+        pico_get_unique_board_id(&unique_id);
+        for(int i = 0; i < 3; i++) {
+            sprintf(&xinput_string_version[i*2+1], "%02X", (uint8_t)unique_id.id[i+5]);
+        }
+        value = xinput_string_version;
+    }
+
+    if ( value != nullptr )
+        return getStringDescriptor((const char*)value, index); // getStringDescriptor returns a static array
+
+    if ( index >= sizeof(xinput_string_descriptors) / sizeof(xinput_string_descriptors[0]) )
+        return nullptr;
+    return xinput_string_descriptors[index];
 }
 
 const uint8_t * XInputDriver::get_descriptor_device_cb() {
@@ -537,16 +517,16 @@ const uint8_t * XInputDriver::get_descriptor_configuration_cb(uint8_t index) {
     deviceType = gamepadOptions.inputDeviceType;
     if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_WHEEL) {
         // wheel
-        configDescriptor[22] = XInputSubtype::XINPUT_SUBTYPE_WHEEL;
+        configDescriptor[XINPUT_CONFIG_SUBTYPE_OFFSET] = XInputSubtype::XINPUT_SUBTYPE_WHEEL;
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_GUITAR) {
         // guitar
-        configDescriptor[22] = XInputSubtype::XINPUT_SUBTYPE_GUITAR;
+        configDescriptor[XINPUT_CONFIG_SUBTYPE_OFFSET] = XInputSubtype::XINPUT_SUBTYPE_GUITAR;
     } else if (deviceType == InputModeDeviceType::INPUT_MODE_DEVICE_TYPE_DRUM) {
         // drum
-        configDescriptor[22] = XInputSubtype::XINPUT_SUBTYPE_DRUMS;
+        configDescriptor[XINPUT_CONFIG_SUBTYPE_OFFSET] = XInputSubtype::XINPUT_SUBTYPE_DRUMS;
     } else {
         // assume gamepad if not special cased
-        configDescriptor[22] = XInputSubtype::XINPUT_SUBTYPE_GAMEPAD;
+        configDescriptor[XINPUT_CONFIG_SUBTYPE_OFFSET] = XInputSubtype::XINPUT_SUBTYPE_GAMEPAD;
     }
 
     return configDescriptor;
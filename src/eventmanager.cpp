@@ -6,26 +6,28 @@ void EventManager::init() {
     clearEventHandlers();
 }
 
-void EventManager::registerEventHandler(GPEventType eventType, EventFunction handler) {
+EventManager::EventHandle EventManager::registerEventHandler(GPEventType eventType, EventFunction handler) {
     typename std::vector<EventEntry>::iterator it = std::find_if(eventList.begin(), eventList.end(), [&eventType](const EventEntry& entry) { return entry.first == eventType; });
 
+    EventHandle handle = nextHandle++;
     if (it != eventList.end()) {
         // If the event already exists, add the handler to its vector
-        it->second.push_back(handler);
+        it->second.emplace_back(handle, handler);
     } else {
         // If the event does not exist, create a new entry with the handler
-        eventList.emplace_back(eventType, std::vector<EventFunction>{handler});
+        eventList.emplace_back(eventType, std::vector<EventHandler>{EventHandler(handle, handler)});
     }
+    return handle;
 }
 
-void EventManager::unregisterEventHandler(GPEventType eventType, EventFunction handler) {
+void EventManager::unregisterEventHandler(GPEventType eventType, EventHandle handle) {
     typename std::vector<EventEntry>::iterator it = std::find_if(eventList.begin(), eventList.end(), [&eventType](const EventEntry& entry) { return entry.first == eventType; });
 
     // Verify we have this event in our pair list
     if (it != eventList.end()) {
-        // Verify we have this function in our function vector
-        for(std::vector<EventFunction>::iterator funcIt = it->second.begin(); funcIt != it->second.end(); it++){
-            if(*(uint32_t *)(uint8_t *)&handler == *(uint32_t *)(uint8_t *)&(*funcIt)) {
+        // Verify we have this handle in our handler vector
+        for (typename std::vector<EventHandler>::iterator funcIt = it->second.begin(); funcIt != it->second.end(); ++funcIt) {
+            if (funcIt->first == handle) {
                 it->second.erase(funcIt);
                 break;
             }
@@ -38,9 +40,9 @@ void EventManager::triggerEvent(GPEvent* event) {
     for (typename std::vector<EventEntry>::const_iterator it = eventList.begin(); it != eventList.end(); ++it) {
         if (it->first == eventType) {
             // Call all event handlers for the specified event
-            const std::vector<EventFunction>& handlers = it->second;
-            for (typename std::vector<EventFunction>::const_iterator handler = handlers.begin(); handler != handlers.end(); ++handler) {
-                (*handler)(event);
+            const std::vector<EventHandler>& handlers = it->second;
+            for (typename std::vector<EventHandler>::const_iterator handler = handlers.begin(); handler != handlers.end(); ++handler) {
+                handler->second(event);
             }
         }
     }
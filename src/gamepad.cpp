@@ -170,23 +170,7 @@ void Gamepad::setup()
 		}
 	}
 
-	// Define our hotkey array
-	hotkeys[0] = hotkeyOptions.hotkey01;
-	hotkeys[1] = hotkeyOptions.hotkey02;
-	hotkeys[2] = hotkeyOptions.hotkey03;
-	hotkeys[3] = hotkeyOptions.hotkey04;
-	hotkeys[4] = hotkeyOptions.hotkey05;
-	hotkeys[5] = hotkeyOptions.hotkey06;
-	hotkeys[6] = hotkeyOptions.hotkey07;
-	hotkeys[7] = hotkeyOptions.hotkey08;
-	hotkeys[8] = hotkeyOptions.hotkey09;
-	hotkeys[9] = hotkeyOptions.hotkey10;
-	hotkeys[10] = hotkeyOptions.hotkey11;
-	hotkeys[11] = hotkeyOptions.hotkey12;
-	hotkeys[12] = hotkeyOptions.hotkey13;
-	hotkeys[13] = hotkeyOptions.hotkey14;
-	hotkeys[14] = hotkeyOptions.hotkey15;
-	hotkeys[15] = hotkeyOptions.hotkey16;
+	compileHotkeys();
 }
 
 /**
@@ -274,7 +258,7 @@ void Gamepad::process()
 
 	// 4-way before SOCD, might have better history without losing any coherent functionality
 	if (options.fourWayMode ^ map48WayModeToggle) {
-		state.dpad = filterToFourWayMode(state.dpad);
+		state.dpad = dpadFilter.filterToFourWayMode(state.dpad);
 	}
 
 	// stash digital-only dpad state for later
@@ -293,7 +277,7 @@ void Gamepad::process()
 	}
 
 	// clean up after yourself. nobody likes bad inputs.
-	state.dpad = runSOCDCleaner(resolveSOCDMode(options), state.dpad);
+	state.dpad = dpadFilter.runSOCDCleaner(resolveSOCDMode(options), state.dpad);
 
 	// since analog modes only care about the dpad mode inputs, set the dpad state to digital only dpad values
 	switch (activeDpadMode)
@@ -415,15 +399,141 @@ void Gamepad::read()
 	state.rt = 0;
 }
 
+/**
+ * @brief Keep the hotkeys that have an action and a combination, in config order.
+ */
+void Gamepad::compileHotkeys()
+{
+	const HotkeyEntry * entries[HOTKEY_COUNT] = {
+		&hotkeyOptions.hotkey01, &hotkeyOptions.hotkey02, &hotkeyOptions.hotkey03, &hotkeyOptions.hotkey04,
+		&hotkeyOptions.hotkey05, &hotkeyOptions.hotkey06, &hotkeyOptions.hotkey07, &hotkeyOptions.hotkey08,
+		&hotkeyOptions.hotkey09, &hotkeyOptions.hotkey10, &hotkeyOptions.hotkey11, &hotkeyOptions.hotkey12,
+		&hotkeyOptions.hotkey13, &hotkeyOptions.hotkey14, &hotkeyOptions.hotkey15, &hotkeyOptions.hotkey16,
+	};
+
+	hotkeyCount = 0;
+	armedHotkeys = 0;
+	hotkeyButtonsMask = 0;
+	hotkeyDpadMask = 0;
+	hotkeyAuxMask = 0;
+	for (uint8_t i = 0; i < HOTKEY_COUNT; i++) {
+		const HotkeyEntry & entry = *entries[i];
+		// a hotkey without a combination would be held all the time
+		if (entry.action == HOTKEY_NONE || (entry.buttonsMask | entry.dpadMask | entry.auxMask) == 0)
+			continue;
+
+		GamepadCompiledHotkey & hotkey = hotkeys[hotkeyCount++];
+		hotkey.entry = entry;
+		hotkey.holdDuration = entry.holdDuration;
+		hotkey.armedAt = 0;
+
+		// Ordered hotkeys go down last part last: the directions, else the buttons after Fn
+		hotkey.leadButtonsMask = 0;
+		hotkey.leadAuxMask = 0;
+		if (entry.ordered) {
+			if (entry.dpadMask && (entry.buttonsMask | entry.auxMask)) {
+				hotkey.leadButtonsMask = entry.buttonsMask;
+				hotkey.leadAuxMask = entry.auxMask;
+			} else if (entry.buttonsMask && entry.auxMask) {
+				hotkey.leadAuxMask = entry.auxMask;
+			}
+		}
+
+		hotkeyButtonsMask |= entry.buttonsMask;
+		hotkeyDpadMask |= entry.dpadMask;
+		hotkeyAuxMask |= entry.auxMask;
+	}
+
+	// The same combination can hold for different durations. All but the longest
+	// run on release, and only if it comes before the next longer hold is reached,
+	// so a long press does not run the short ones on its way.
+	releaseHotkeys = 0;
+	sharedHotkeys = 0;
+	for (uint8_t i = 0; i < hotkeyCount; i++) {
+		GamepadCompiledHotkey & hotkey = hotkeys[i];
+		hotkey.releaseBefore = 0;
+		for (uint8_t j = 0; j < hotkeyCount; j++) {
+			const GamepadCompiledHotkey & other = hotkeys[j];
+			if (j == i ||
+				other.entry.buttonsMask != hotkey.entry.buttonsMask ||
+				other.entry.dpadMask != hotkey.entry.dpadMask ||
+				other.entry.auxMask != hotkey.entry.auxMask)
+				continue;
+			sharedHotkeys |= 1 << i;
+			if (other.holdDuration > hotkey.holdDuration &&
+				(hotkey.releaseBefore == 0 || other.holdDuration < hotkey.releaseBefore))
+				hotkey.releaseBefore = other.holdDuration;
+		}
+		if (hotkey.releaseBefore != 0)
+			releaseHotkeys |= 1 << i;
+	}
+}
+
 void Gamepad::hotkey() {
 	if (options.lockHotkeys)
 		return;
 
+	uint32_t buttons = state.buttons;
+	uint8_t dpad = state.dpadOriginal;
+	uint16_t aux = state.aux;
+	uint32_t prevButtons = lastHotkeyButtons;
+	uint8_t prevDpad = lastHotkeyDpad;
+	uint16_t prevAux = lastHotkeyAux;
+	lastHotkeyButtons = buttons;
+	lastHotkeyDpad = dpad;
+	lastHotkeyAux = aux;
+
+	// Nothing any hotkey uses is held, so no combination can be either,
+	// unless one that runs on release has just come up
+	if (!((buttons & hotkeyButtonsMask) | (dpad & hotkeyDpadMask) | (aux & hotkeyAuxMask)) &&
+		!(armedHotkeys & releaseHotkeys)) {
+		armedHotkeys = 0;
+		lastAction = HOTKEY_NONE;
+		return;
+	}
+
 	// Look for a hot-key
+	uint32_t now = getMillis();
 	bool hasHotkey = false;
-	for(int i = 0; i < 16; i++) {
-		if (pressedHotkey(hotkeys[i])) {
-			processHotkeyAction(selectHotkey(hotkeys[i]));
+	for (uint8_t i = 0; i < hotkeyCount; i++) {
+		GamepadCompiledHotkey & hotkey = hotkeys[i];
+		uint16_t hotkeyBit = 1 << i;
+		// An earlier entry with the same combination has already taken its buttons
+		// out of the state, look at what was held instead
+		bool pressed = (sharedHotkeys & hotkeyBit) ?
+			(hotkey.entry.action != 0 &&
+			 (buttons & hotkey.entry.buttonsMask) == hotkey.entry.buttonsMask &&
+			 (dpad & hotkey.entry.dpadMask) == hotkey.entry.dpadMask &&
+			 (aux & hotkey.entry.auxMask) == hotkey.entry.auxMask) :
+			pressedHotkey(hotkey.entry);
+		if (!pressed) {
+			if ((armedHotkeys & releaseHotkeys & hotkeyBit) &&
+				(now - hotkey.armedAt) >= hotkey.holdDuration &&
+				(now - hotkey.armedAt) < hotkey.releaseBefore) {
+				processHotkeyAction(static_cast<GamepadHotkey>(hotkey.entry.action));
+				hasHotkey = true;
+			}
+			armedHotkeys &= ~hotkeyBit;
+			continue;
+		}
+
+		if (!(armedHotkeys & hotkeyBit)) {
+			// The lead part must have been held on its own before the rest went down
+			if ((hotkey.leadButtonsMask | hotkey.leadAuxMask) &&
+				((prevButtons & hotkey.leadButtonsMask) != hotkey.leadButtonsMask ||
+				 (prevAux & hotkey.leadAuxMask) != hotkey.leadAuxMask ||
+				 ((prevButtons & hotkey.entry.buttonsMask) == hotkey.entry.buttonsMask &&
+				  (prevDpad & hotkey.entry.dpadMask) == hotkey.entry.dpadMask &&
+				  (prevAux & hotkey.entry.auxMask) == hotkey.entry.auxMask)))
+				continue;
+			armedHotkeys |= hotkeyBit;
+			hotkey.armedAt = now;
+		}
+
+		// The combination stays out of the report while its hold runs too
+		GamepadHotkey action = selectHotkey(hotkey.entry);
+		if (!(releaseHotkeys & hotkeyBit) && (now - hotkey.armedAt) >= hotkey.holdDuration) {
+			processHotkeyAction(action);
 			hasHotkey = true;
 		}
 	}
@@ -736,6 +846,11 @@ void Gamepad::processHotkeyAction(GamepadHotkey action) {
 				EventManager::getInstance().triggerEvent(new GPMenuNavigateEvent(GpioAction::MENU_NAVIGATION_TOGGLE));
 			}
 			break;
+		case HOTKEY_RECORD_MACRO:
+			if (action != lastAction) {
+				EventManager::getInstance().triggerEvent(new GPMacroRecordEvent());
+			}
+			break;
 		case HOTKEY_FOCUS_MODE_TOGGLE:
 		{
 			auto &focusModeOptions = Storage::getInstance().getAddonOptions().focusModeOptions;
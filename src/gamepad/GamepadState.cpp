@@ -44,125 +44,94 @@ uint8_t getMaskFromDirection(DpadDirection direction)
 	return dpadMasks[direction-1];
 }
 
-uint8_t updateDpad(uint8_t dpad, DpadDirection direction)
-{
-	static bool inList[] = {false, false, false, false, false}; // correspond to DpadDirection: none, up, down, left, right
-	static list<DpadDirection> dpadList;
-
-	if(dpad & getMaskFromDirection(direction))
-	{
-		if(!inList[direction])
-		{
-			dpadList.push_back(direction);
-			inList[direction] = true;
-		}
-	}
-	else
-	{
-		if(inList[direction])
-		{
-			dpadList.remove(direction);
-			inList[direction] = false;
-		}
-	}
-
-	if(dpadList.empty()) {
-		return 0;
-	}
-	else {
-		return getMaskFromDirection(dpadList.back());
-	}
-}
+// Axis values and last directions: 0 none, 1 up/left, 2 down/right, 3 both
+#define SOCD_AXIS_BOTH 3
+#define SOCD_TABLE_MODES SOCD_MODE_BYPASS // bypass never touches the dpad
 
 /**
- * @brief Filter diagonals out of the dpad, making the device work as a 4-way lever.
+ * @brief SOCD cleaning of one axis, the reference the lookup table is built from.
  *
- * The most recent cardinal direction wins.
- *
- * @param dpad The GameState.dpad value.
- * @return uint8_t The new dpad value.
+ * Up priority only applies to up + down, left + right goes neutral.
  */
-uint8_t filterToFourWayMode(uint8_t dpad)
+static constexpr uint8_t cleanSOCDAxis(SOCDMode mode, bool isUpDown, uint8_t held, uint8_t & last)
 {
-	updateDpad(dpad, DIRECTION_UP);
-	updateDpad(dpad, DIRECTION_DOWN);
-	updateDpad(dpad, DIRECTION_LEFT);
-	return updateDpad(dpad, DIRECTION_RIGHT);
-}
-
-/**
- * @brief Run SOCD cleaning against a D-pad value.
- *
- * @param mode The SOCD cleaning mode.
- * @param dpad The GamepadState.dpad value.
- * @return uint8_t The clean D-pad value.
- */
-uint8_t runSOCDCleaner(SOCDMode mode, uint8_t dpad)
-{
-	if (mode == SOCD_MODE_BYPASS) {
-		return dpad;
+	if (held != SOCD_AXIS_BOTH) {
+		last = held;
+		return held;
 	}
 
-	static DpadDirection lastUD = DIRECTION_NONE;
-	static DpadDirection lastLR = DIRECTION_NONE;
-	uint8_t newDpad = 0;
+	if (mode == SOCD_MODE_UP_PRIORITY && isUpDown) {
+		last = 1;
+		return 1;
+	} else if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && last != 0) {
+		return last ^ SOCD_AXIS_BOTH;
+	} else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && last != 0) {
+		return last;
+	}
+	last = 0;
+	return 0;
+}
 
-	switch (dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN))
-	{
-		case (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN):
-			if (mode == SOCD_MODE_UP_PRIORITY)
-			{
-				newDpad |= GAMEPAD_MASK_UP;
-				lastUD = DIRECTION_UP;
+// Entry per mode, previous state and dpad: clean dpad in the low nibble, next state in the high nibble
+struct SOCDTable {
+	uint8_t entries[SOCD_TABLE_MODES][16][16];
+
+	constexpr SOCDTable() : entries() {
+		for (uint8_t mode = 0; mode < SOCD_TABLE_MODES; mode++) {
+			for (uint8_t state = 0; state < 16; state++) {
+				for (uint8_t dpad = 0; dpad < 16; dpad++) {
+					uint8_t lastUD = state & 0x03;
+					uint8_t lastLR = (state >> 2) & 0x03;
+					uint8_t ud = cleanSOCDAxis((SOCDMode)mode, true, dpad & 0x03, lastUD);
+					uint8_t lr = cleanSOCDAxis((SOCDMode)mode, false, (dpad >> 2) & 0x03, lastLR);
+					entries[mode][state][dpad] = (ud | (lr << 2)) | ((lastUD | (lastLR << 2)) << 4);
+				}
 			}
-			else if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
-				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP;
-			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastUD != DIRECTION_NONE)
-				newDpad |= (lastUD == DIRECTION_UP) ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN;
-			else
-				lastUD = DIRECTION_NONE;
-			break;
+		}
+	}
+};
 
-		case GAMEPAD_MASK_UP:
-			newDpad |= GAMEPAD_MASK_UP;
-			lastUD = DIRECTION_UP;
-			break;
+static constexpr SOCDTable socdTable;
 
-		case GAMEPAD_MASK_DOWN:
-			newDpad |= GAMEPAD_MASK_DOWN;
-			lastUD = DIRECTION_DOWN;
-			break;
+void DpadFilter::reset()
+{
+	socdState = 0;
+	fourWayHeld = 0;
+	fourWayCount = 0;
+}
 
-		default:
-			lastUD = DIRECTION_NONE;
-			break;
+uint8_t DpadFilter::filterToFourWayMode(uint8_t dpad)
+{
+	dpad &= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN | GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
+
+	uint8_t released = fourWayHeld & ~dpad;
+	if (released) {
+		uint8_t kept = 0;
+		for (uint8_t i = 0; i < fourWayCount; i++) {
+			if (!(fourWayOrder[i] & released))
+				fourWayOrder[kept++] = fourWayOrder[i];
+		}
+		fourWayCount = kept;
 	}
 
-	switch (dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT))
-	{
-		case (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT):
-			if (mode == SOCD_MODE_SECOND_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
-				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_RIGHT : GAMEPAD_MASK_LEFT;
-			else if (mode == SOCD_MODE_FIRST_INPUT_PRIORITY && lastLR != DIRECTION_NONE)
-				newDpad |= (lastLR == DIRECTION_LEFT) ? GAMEPAD_MASK_LEFT : GAMEPAD_MASK_RIGHT;
-			else
-				lastLR = DIRECTION_NONE;
-			break;
-
-		case GAMEPAD_MASK_LEFT:
-			newDpad |= GAMEPAD_MASK_LEFT;
-			lastLR = DIRECTION_LEFT;
-			break;
+	// Directions pressed together are ordered up, down, left, right
+	uint8_t pressed = dpad & ~fourWayHeld;
+	for (uint8_t i = 0; i < 4; i++) {
+		if (pressed & dpadMasks[i])
+			fourWayOrder[fourWayCount++] = dpadMasks[i];
+	}
+	fourWayHeld = dpad;
 
-		case GAMEPAD_MASK_RIGHT:
-			newDpad |= GAMEPAD_MASK_RIGHT;
-			lastLR = DIRECTION_RIGHT;
-			break;
+	return fourWayCount ? fourWayOrder[fourWayCount - 1] : 0;
+}
 
-		default:
-			lastLR = DIRECTION_NONE;
-			break;
+uint8_t DpadFilter::runSOCDCleaner(SOCDMode mode, uint8_t dpad)
+{
+	if (mode >= SOCD_TABLE_MODES) {
+		return dpad;
 	}
 
-	return newDpad;
+	uint8_t entry = socdTable.entries[mode][socdState][dpad & 0x0F];
+	socdState = entry >> 4;
+	return entry & 0x0F;
 }
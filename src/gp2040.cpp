@@ -12,6 +12,7 @@
 #include "addonmanager.h"
 #include "types.h"
 #include "usbhostmanager.h"
+#include "usbhostlatency.h"
 
 // Inputs for Core0
 #include "addons/analog.h"
@@ -157,6 +158,7 @@ void GP2040::setup() {
 	// register system event handlers
 	EventManager::getInstance().registerEventHandler(GP_EVENT_STORAGE_SAVE, GPEVENT_CALLBACK(this->handleStorageSave(event)));
 	EventManager::getInstance().registerEventHandler(GP_EVENT_RESTART, GPEVENT_CALLBACK(this->handleSystemReboot(event)));
+	EventManager::getInstance().registerEventHandler(GP_EVENT_INPUT_MODE_CHANGE, GPEVENT_CALLBACK(this->handleInputModeChange(event)));
 }
 
 /**
@@ -216,19 +218,7 @@ void GP2040::debounceGpioGetAll() {
 		return;
 	}
 
-	uint32_t now = getMillis();
-	// check each button use case GPIO for state
-	for (Pin_t pin = 0; pin < (Pin_t)NUM_BANK0_GPIOS; pin++) {
-		Mask_t pin_mask = 1 << pin;
-		if (buttonGpios & pin_mask) {
-			// Allow debouncer to change state if button state changed and debounce delay threshold met
-			if ((gamepad->debouncedGpio & pin_mask) != \
-					(raw_gpio & pin_mask) && ((now - gpioDebounceTime[pin]) > debounceDelay)) {
-				gamepad->debouncedGpio ^= pin_mask;
-				gpioDebounceTime[pin] = now;
-			}
-		}
-	}
+	gamepad->debouncedGpio = debounceMask(gamepad->debouncedGpio, raw_gpio, buttonGpios, gpioDebounceTime, debounceDelay, getMillis());
 }
 
 void GP2040::run() {
@@ -241,13 +231,19 @@ void GP2040::run() {
 	// Start the TinyUSB Device functionality
 	tud_init(TUD_OPT_RHPORT);
 
-	// Initialize our USB manager
+	// Request USB Host, Core1 runs the host stack
+	USBHostLatency::getInstance().init(configMode);
 	USBHostManager::getInstance().start();
 
 	if (configMode == true ) {
 		rndis_init(WEB_CONFIG_HOSTNAME);
 	}
 
+#if USB_TELEMETRY_ENABLED
+	USBTelemetry& telemetry = USBTelemetry::getInstance();
+	uint32_t loopStart = time_us_32();
+#endif
+
 	while (1) { // LOOP
 		this->getReinitGamepad(gamepad);
 
@@ -260,9 +256,6 @@ void GP2040::run() {
 
 		checkRawState(prevState, gamepad->state);
 
-		// Process USB Host on Core0
-		USBHostManager::getInstance().process();
-
 		// Config Loop (Web-Config skips Core0 add-ons)
 		if (configMode == true) {
 			inputDriver->process(gamepad);
@@ -289,6 +282,7 @@ void GP2040::run() {
 
 		// Process Input Driver
 		bool processed = inputDriver->process(gamepad);
+		USBHostLatency::getInstance().reportProcessed(processed);
 
 		// TinyUSB Task update
 		tud_task();
@@ -298,6 +292,19 @@ void GP2040::run() {
 
 		// Check if we have a pending save
 		checkSaveRebootState();
+
+#if USB_TELEMETRY_ENABLED
+		uint32_t loopEnd = time_us_32();
+		telemetry.recordLoop(loopEnd - loopStart);
+		loopStart = loopEnd;
+		telemetry.recordInput(gamepad->state);
+		telemetry.process(addons);
+#endif
+
+		// Swap the input driver if a new input mode was requested
+		if (checkInputModeSwitch()) {
+			inputDriver = DriverManager::getInstance().getDriver();
+		}
 	}
 }
 
@@ -594,3 +601,15 @@ void GP2040::handleSystemReboot(GPEvent* e) {
 	rebootRequested = true;
 	rebootMode = ((GPRestartEvent*)e)->bootMode;
 }
+
+bool GP2040::checkInputModeSwitch() {
+	if (!inputModeSwitchRequested) return false;
+	inputModeSwitchRequested = false;
+
+	return DriverManager::getInstance().switchInputMode(requestedInputMode);
+}
+
+void GP2040::handleInputModeChange(GPEvent* e) {
+	inputModeSwitchRequested = true;
+	requestedInputMode = ((GPInputModeChangeEvent*)e)->inputMode;
+}
@@ -52,6 +52,15 @@ void GP2040Aux::setup() {
 
 void GP2040Aux::run() {
 	while (1) {
+		// Hold off while core0 swaps the input driver, then pick up the new one
+		if (inputDriver != nullptr) {
+			DriverManager::getInstance().checkAuxPause();
+			inputDriver = DriverManager::getInstance().getDriver();
+		}
+
+		// USB Host stack and listener parsing, inputs are handed to Core0 through per-device queues
+		USBHostManager::getInstance().process();
+
 		// Pre, Process, and Post
 		addons.PreprocessAddons();
 		addons.ProcessAddons();
@@ -14,7 +14,7 @@ void PCF8575::send(uint16_t value) {
     dataSent = value;
     uc[0] = ((dataSent >> 0) & 0x00FF);
     uc[1] = ((dataSent >> 8) & 0x00FF);
-    i2c->write(address, uc, 2);
+    i2c->write(address, uc, 2, false);
 }
 
 uint16_t PCF8575::receive() {
@@ -24,6 +24,28 @@ uint16_t PCF8575::receive() {
     return dataReceived;
 }
 
+bool PCF8575::requestReceive() {
+    if (readQueued) return false;
+
+    readTransaction.address = address;
+    readTransaction.rx = readBuffer;
+    readTransaction.rxLen = 2;
+    readTransaction.priority = I2C_PRIORITY_INPUT;
+    readQueued = i2c->submit(&readTransaction);
+    return readQueued;
+}
+
+bool PCF8575::receivePending() {
+    if (!readQueued) return false;
+    if (!readTransaction.done) return true;
+
+    readQueued = false;
+    if (readTransaction.result >= 0) {
+        dataReceived = ((readBuffer[0] << 0) | (readBuffer[1] << 8));
+    }
+    return false;
+}
+
 void PCF8575::setPin(uint8_t pinNumber, uint8_t value) {
     if (pinNumber < 16) {
         if (value == 0) {
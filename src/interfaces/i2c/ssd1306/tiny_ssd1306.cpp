@@ -543,41 +543,36 @@ void GPGFX_TinySSD1306::drawSprite(uint8_t* image, uint16_t width, uint16_t heig
 }
 
 void GPGFX_TinySSD1306::drawBuffer(uint8_t* pBuffer) {
-	uint16_t bufferSize = MAX_SCREEN_SIZE;
-	uint8_t buffer[bufferSize+1] = {SET_START_LINE};
+	const uint8_t* source = (pBuffer == NULL) ? frameBuffer : pBuffer;
+
+	// the stage still belongs to the bus until the previous frame is out
+	for (uint8_t i = 0; i < frameTransactionCount; i++) {
+		_options.i2c->wait(&frameTransactions[i]);
+	}
+	frameTransactionCount = 0;
+	frameStageUsed = 0;
 
 	if (this->screenType == ScreenAlternatives::SCREEN_132x64) {
         uint16_t x = 0;
         uint16_t y = 0;
+        uint8_t pageData[MAX_SCREEN_WIDTH+2] = {0};
         for (y = 0; y < (MAX_SCREEN_HEIGHT/8); y++) {
-            sendCommand(0xB0 + y);
-            sendCommand(x & 0x0F);
-            sendCommand(0x10 | (x >> 4));
-        
-            if (pBuffer == NULL) {
-                memcpy(&buffer[1],&frameBuffer[y*MAX_SCREEN_WIDTH],MAX_SCREEN_WIDTH);
-            } else {
-                memcpy(&buffer[1],&pBuffer[y*MAX_SCREEN_WIDTH],MAX_SCREEN_WIDTH);
-            }
-        
-            _options.i2c->write(_options.address, buffer, MAX_SCREEN_WIDTH+3, false);
+            uint8_t commands[] = {(uint8_t)(0xB0 + y), (uint8_t)(x & 0x0F), (uint8_t)(0x10 | (x >> 4))};
+            stageFrameData(commands, sizeof(commands), 0x00);
+
+            memcpy(pageData,&source[y*MAX_SCREEN_WIDTH],MAX_SCREEN_WIDTH);
+            stageFrameData(pageData, sizeof(pageData), SET_START_LINE);
         }
     } else {
-        sendCommand(CommandOps::PAGE_ADDRESS);
-        sendCommand(0x00);
-        sendCommand(0x07);
-        sendCommand(CommandOps::COLUMN_ADDRESS);
-        sendCommand(0x00);
-        sendCommand(0x7F);
-
-        if (pBuffer == NULL) {
-            memcpy(&buffer[1],frameBuffer,bufferSize);
-        } else {
-            memcpy(&buffer[1],pBuffer,bufferSize);
-        }
-        _options.i2c->write(_options.address, buffer, sizeof(buffer), false);
+        uint8_t commands[] = {CommandOps::PAGE_ADDRESS, 0x00, 0x07, CommandOps::COLUMN_ADDRESS, 0x00, 0x7F};
+        stageFrameData(commands, sizeof(commands), 0x00);
+        stageFrameData(source, MAX_SCREEN_SIZE, SET_START_LINE);
     }
 
+	for (uint8_t i = 0; i < frameTransactionCount; i++) {
+		_options.i2c->submit(&frameTransactions[i]);
+	}
+
 	if (framePage < MAX_SCREEN_HEIGHT/8) {
 		framePage++;
 	} else {
@@ -592,6 +587,27 @@ void GPGFX_TinySSD1306::rotatePoint(double cx, double cy, double &x, double &y,
     y = yr;
 }
 
+void GPGFX_TinySSD1306::stageFrameData(const uint8_t* data, uint16_t length, uint8_t control) {
+	// commands go out in one piece, data is split and every chunk gets its own control byte
+	uint16_t chunkSize = (control == 0x00) ? length : FRAME_CHUNK_SIZE;
+
+	for (uint16_t pos = 0; pos < length; pos += chunkSize) {
+		uint16_t size = ((length - pos) < chunkSize) ? (length - pos) : chunkSize;
+		uint8_t* chunk = &frameStage[frameStageUsed];
+		chunk[0] = control;
+		memcpy(&chunk[1], &data[pos], size);
+		frameStageUsed += size + 1;
+
+		I2CTransaction& transaction = frameTransactions[frameTransactionCount++];
+		transaction.address = _options.address;
+		transaction.tx = chunk;
+		transaction.txLen = size + 1;
+		transaction.rx = nullptr;
+		transaction.rxLen = 0;
+		transaction.priority = I2C_PRIORITY_DISPLAY;
+	}
+}
+
 void GPGFX_TinySSD1306::sendCommand(uint8_t command){ 
 	uint8_t commandData[] = {0x00, command};
 	sendCommands(commandData, 2);
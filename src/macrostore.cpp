@@ -0,0 +1,128 @@
+#include "macrostore.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "CRC32.h"
+#include "pico/platform.h"
+
+extern char __flash_binary_end;
+
+// Flash is programmed in whole pages
+#define MACRO_STORE_WRITE_BYTES ((sizeof(MacroStoreData) + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1))
+
+static uint8_t writeCache[MACRO_STORE_WRITE_BYTES] __attribute__((aligned(4)));
+volatile static alarm_id_t macroWriteAlarm = 0;
+volatile static spin_lock_t *macroLock = nullptr;
+
+static int64_t writeMacroStore(alarm_id_t id, void *cache)
+{
+    while (is_spin_locked(macroLock));
+
+    multicore_lockout_start_blocking();
+    uint32_t interrupts = spin_lock_blocking(macroLock);
+
+    flash_range_erase((intptr_t)MACRO_STORE_ADDRESS_START - (intptr_t)XIP_BASE, MACRO_STORE_SIZE_BYTES);
+    flash_range_program((intptr_t)MACRO_STORE_ADDRESS_START - (intptr_t)XIP_BASE, reinterpret_cast<uint8_t *>(cache), MACRO_STORE_WRITE_BYTES);
+
+    macroWriteAlarm = 0;
+
+    multicore_lockout_end_blocking();
+    spin_unlock(macroLock, interrupts);
+
+    return 0;
+}
+
+static inline uint32_t payloadCrc(const MacroStoreData * data) {
+    return CRC32::calculate(reinterpret_cast<const uint8_t *>(data) + offsetof(MacroStoreData, inputCount),
+        sizeof(MacroStoreData) - offsetof(MacroStoreData, inputCount));
+}
+
+const MacroStoreData * MacroStore::get() const {
+    const MacroStoreData * data = reinterpret_cast<const MacroStoreData *>(MACRO_STORE_ADDRESS_START);
+    if (data->magic != MACRO_STORE_MAGIC || data->size != sizeof(MacroStoreData) ||
+        data->inputCount > MACRO_STORE_MAX_INPUTS || payloadCrc(data) != data->crc)
+        return nullptr;
+    return data;
+}
+
+MacroStoreData & MacroStore::beginEdit() {
+    while (macroLock != nullptr && is_spin_locked(macroLock));
+    if (macroWriteAlarm != 0) {
+        cancel_alarm(macroWriteAlarm);
+        macroWriteAlarm = 0;
+    }
+    return *reinterpret_cast<MacroStoreData *>(writeCache);
+}
+
+MacroStoreData & MacroStore::create() {
+    MacroStoreData & data = beginEdit();
+    memset(writeCache, 0, sizeof(writeCache));
+    cacheValid = true;
+    return data;
+}
+
+MacroStoreData & MacroStore::edit(const MacroOptions & options) {
+    MacroStoreData & data = beginEdit();
+    if (!cacheValid) {
+        const MacroStoreData * stored = get();
+        memset(writeCache, 0, sizeof(writeCache));
+        if (stored != nullptr)
+            memcpy(writeCache, stored, sizeof(MacroStoreData));
+        cacheValid = true;
+    }
+    if (data.magic != MACRO_STORE_MAGIC)
+        importOptions(data, options);
+    return data;
+}
+
+void MacroStore::importOptions(MacroStoreData & data, const MacroOptions & options) {
+    memset(&data, 0, sizeof(MacroStoreData));
+    data.magic = MACRO_STORE_MAGIC;
+    for (pb_size_t i = 0; i < MACRO_STORE_MAX_MACROS; i++) {
+        const Macro & macro = options.macroList[i];
+        MacroStoreMacro & storeMacro = data.macros[i];
+        storeMacro.macroType = macro.macroType;
+        storeMacro.enabled = macro.enabled;
+        storeMacro.useMacroTriggerButton = macro.useMacroTriggerButton;
+        storeMacro.exclusive = macro.exclusive;
+        storeMacro.interruptible = macro.interruptible;
+        storeMacro.showFrames = macro.showFrames;
+        storeMacro.macroTriggerButton = macro.macroTriggerButton;
+        memcpy(storeMacro.macroLabel, macro.macroLabel, sizeof(storeMacro.macroLabel));
+        for (pb_size_t j = 0; j < macro.macroInputs_count && data.inputCount < MACRO_STORE_MAX_INPUTS; j++) {
+            MacroStoreInput & input = data.inputs[data.inputCount++];
+            input.buttonMask = macro.macroInputs[j].buttonMask;
+            input.duration = macro.macroInputs[j].duration;
+            input.waitDuration = macro.macroInputs[j].waitDuration;
+            storeMacro.inputCount++;
+        }
+    }
+}
+
+bool MacroStore::commit() {
+    // Nothing keeps the linker from placing a big enough firmware here
+    if ((uintptr_t)&__flash_binary_end > MACRO_STORE_ADDRESS_START)
+        return false;
+
+    if (macroLock == nullptr)
+        macroLock = spin_lock_instance(spin_lock_claim_unused(true));
+
+    MacroStoreData * data = reinterpret_cast<MacroStoreData *>(writeCache);
+    if (data->magic == MACRO_STORE_MAGIC) {
+        data->size = sizeof(MacroStoreData);
+        data->crc = payloadCrc(data);
+    }
+
+    while (is_spin_locked(macroLock));
+    if (macroWriteAlarm != 0)
+        cancel_alarm(macroWriteAlarm);
+    macroWriteAlarm = add_alarm_in_ms(EEPROM_WRITE_WAIT, writeMacroStore, writeCache, true);
+    return true;
+}
+
+void MacroStore::reset() {
+    // an image without the magic reads as empty
+    create();
+    commit();
+}
@@ -7,6 +7,7 @@
 
 #include "BoardConfig.h"
 #include "FlashPROM.h"
+#include "macrostore.h"
 #include "drivermanager.h"
 #include "eventmanager.h"
 #include "peripheralmanager.h"
@@ -56,6 +57,7 @@ bool Storage::save(const bool force) {
 void Storage::ResetSettings()
 {
 	EEPROM.reset();
+	MacroStore::getInstance().reset();
 	watchdog_reboot(0, SRAM_END, 2000);
 }
 
@@ -59,13 +59,13 @@ uint32_t System::getUsedHeap() {
 }
 
 void System::reboot(BootMode bootMode) {
-    // Halt all running USB instances
-    USBHostManager::getInstance().shutdown();
-
     // Make sure that the other core is halted
     // We do not want it to be talking to devices (e.g. OLED display) while we reboot
 	multicore_lockout_start_timeout_us(0xfffffffffffffff);
 
+    // Halt all running USB instances, the host stack runs on the other core so it has to be parked first
+    USBHostManager::getInstance().shutdown();
+
 	watchdog_hw->scratch[5] = static_cast<uint32_t>(bootMode);
 
     // This is based on MicroPythons machine.reset()
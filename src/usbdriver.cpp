@@ -21,8 +21,7 @@ bool get_usb_suspended(void) {
 }
 
 const usbd_class_driver_t *usbd_app_driver_get_cb(uint8_t *driver_count) {
-	*driver_count = 1;
-	return DriverManager::getInstance().getDriver()->get_class_driver();
+	return DriverManager::getInstance().getClassDrivers(driver_count);
 }
 
 uint16_t tud_hid_get_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t report_type, uint8_t *buffer, uint16_t reqlen) {
@@ -35,6 +34,11 @@ void tud_hid_set_report_cb(uint8_t itf, uint8_t report_id, hid_report_type_t rep
 	DriverManager::getInstance().getDriver()->set_report(report_id, report_type, buffer, bufsize);
 }
 
+// Invoked when sent REPORT successfully to host
+void tud_hid_report_complete_cb(uint8_t itf, uint8_t const *report, uint16_t len) {
+	DriverManager::getInstance().getDriver()->report_complete(itf, report, len);
+}
+
 // Invoked when device is mounted
 void tud_mount_cb(void)
 {
@@ -92,7 +96,12 @@ uint8_t const *tud_hid_descriptor_report_cb(uint8_t itf) {
 // Application return pointer to descriptor
 // Descriptor contents must exist long enough for transfer to complete
 uint8_t const *tud_descriptor_configuration_cb(uint8_t index) {
-	return DriverManager::getInstance().getDriver()->get_descriptor_configuration_cb(index);
+	const uint8_t * descriptor = DriverManager::getInstance().getDriver()->get_descriptor_configuration_cb(index);
+#if USB_TELEMETRY_ENABLED
+	if (USBTelemetry::supportsInputMode(DriverManager::getInstance().getInputMode()))
+		descriptor = USBTelemetry::getInstance().getConfigurationDescriptor(descriptor);
+#endif
+	return descriptor;
 }
 
 uint8_t const* tud_descriptor_device_qualifier_cb() {
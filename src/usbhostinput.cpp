@@ -0,0 +1,84 @@
+#include "usbhostinput.h"
+
+#include <algorithm>
+#include <string.h>
+
+static int16_t addMouseMovement(int16_t a, int16_t b) {
+    return std::clamp<int32_t>((int32_t)a + b, INT16_MIN, INT16_MAX);
+}
+
+USBHostInputSlot::USBHostInputSlot() : hasPending(false) {
+    memset(&pending, 0, sizeof(pending));
+    memset(&newest, 0, sizeof(newest));
+    memset(&latest, 0, sizeof(latest));
+}
+
+void USBHostInputSlot::publish(const USBHostInput& input) {
+    flush();
+
+    if (hasPending) {
+        // core0 has fallen behind, only the newest state matters but keep the movement
+        int16_t x = addMouseMovement(pending.mouseX, input.mouseX);
+        int16_t y = addMouseMovement(pending.mouseY, input.mouseY);
+        int16_t z = addMouseMovement(pending.mouseZ, input.mouseZ);
+        uint32_t timestamp = pending.timestamp;
+        pending = input;
+        pending.timestamp = timestamp;
+        pending.mouseX = x;
+        pending.mouseY = y;
+        pending.mouseZ = z;
+    } else if (!queue.push(input)) {
+        pending = input;
+        hasPending = true;
+    }
+}
+
+void USBHostInputSlot::flush() {
+    if (hasPending && queue.push(pending)) {
+        hasPending = false;
+    }
+}
+
+bool USBHostInputSlot::collect() {
+    USBHostInput next;
+    bool received = false;
+    uint32_t timestamp = 0;
+    uint32_t buttons = 0;
+    uint8_t dpad = 0;
+    int16_t mouseX = 0;
+    int16_t mouseY = 0;
+    int16_t mouseZ = 0;
+
+    while (queue.pop(next)) {
+        // the queue is in arrival order
+        if (!received)
+            timestamp = next.timestamp;
+        received = true;
+        buttons |= next.buttons;
+        dpad |= next.dpad;
+        mouseX = addMouseMovement(mouseX, next.mouseX);
+        mouseY = addMouseMovement(mouseY, next.mouseY);
+        mouseZ = addMouseMovement(mouseZ, next.mouseZ);
+        newest = next;
+    }
+
+    latest = newest;
+    if (received)
+        latest.timestamp = timestamp;
+    if (latest.flags & USB_HOST_INPUT_CONNECTED) {
+        latest.buttons |= buttons;
+        latest.dpad |= dpad;
+    }
+
+    // movement is only reported once
+    latest.mouseX = mouseX;
+    latest.mouseY = mouseY;
+    latest.mouseZ = mouseZ;
+    return received;
+}
+
+uint16_t mergeUSBHostAxis(uint16_t current, uint16_t value, uint16_t center) {
+    int32_t currentOffset = std::abs((int32_t)current - center);
+    int32_t valueOffset = std::abs((int32_t)value - center);
+    return valueOffset > currentOffset ? value : current;
+}
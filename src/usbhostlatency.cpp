@@ -0,0 +1,131 @@
+#include "usbhostlatency.h"
+
+#include <string.h>
+
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "host/usbh.h"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t size;
+    USBHostLatencyDevice devices[USB_HOST_LATENCY_MAX_DEVICES];
+} USBHostLatencyData;
+
+// Left alone by the runtime so a reboot into web config keeps the last session
+static USBHostLatencyData __uninitialized_ram(latencyData);
+
+static inline USBHostLatencyDevice * deviceAt(uint8_t dev_addr) {
+    if (dev_addr == 0 || dev_addr > USB_HOST_LATENCY_MAX_DEVICES)
+        return nullptr;
+    return &latencyData.devices[dev_addr - 1];
+}
+
+void USBHostLatency::init(bool configMode) {
+    bool valid = latencyData.magic == USB_HOST_LATENCY_MAGIC && latencyData.size == sizeof(latencyData);
+
+    // Web config shows what the previous session recorded, anything else starts over
+    enabled = !configMode;
+    if (!valid || enabled) {
+        memset(&latencyData, 0, sizeof(latencyData));
+        latencyData.magic = USB_HOST_LATENCY_MAGIC;
+        latencyData.size = sizeof(latencyData);
+    }
+    pendingMask = 0;
+}
+
+void USBHostLatency::record(USBHostLatencyHistogram & histogram, uint32_t us) {
+    uint8_t bin = (us == 0) ? 0 : (32 - __builtin_clz(us));
+    if (bin >= USB_HOST_LATENCY_BINS)
+        bin = USB_HOST_LATENCY_BINS - 1;
+
+    histogram.bins[bin]++;
+    histogram.count++;
+    histogram.totalUs += us;
+    if (us > histogram.maxUs)
+        histogram.maxUs = us;
+}
+
+void USBHostLatency::mount(uint8_t dev_addr) {
+    USBHostLatencyDevice * device = deviceAt(dev_addr);
+    if (!enabled || device == nullptr)
+        return;
+
+    uint16_t vid, pid;
+    if (!tuh_vid_pid_get(dev_addr, &vid, &pid))
+        return;
+
+    // the same device plugged back in keeps adding to its histograms
+    if (device->vid != vid || device->pid != pid) {
+        memset(device, 0, sizeof(USBHostLatencyDevice));
+        device->vid = vid;
+        device->pid = pid;
+    }
+    device->lastReportUs = 0;
+}
+
+uint32_t USBHostLatency::beginReport(uint8_t dev_addr) {
+    uint32_t now = time_us_32();
+    currentReportUs = now;
+    inReport = true;
+
+    USBHostLatencyDevice * device = deviceAt(dev_addr);
+    if (enabled && device != nullptr) {
+        if (device->lastReportUs != 0)
+            record(device->pollInterval, now - device->lastReportUs);
+        device->lastReportUs = now;
+    }
+    return now;
+}
+
+void USBHostLatency::endReport(uint8_t dev_addr, uint32_t arrivalUs) {
+    inReport = false;
+
+    USBHostLatencyDevice * device = deviceAt(dev_addr);
+    if (enabled && device != nullptr)
+        record(device->decode, time_us_32() - arrivalUs);
+}
+
+uint32_t USBHostLatency::reportTimestamp() const {
+    return inReport ? currentReportUs : time_us_32();
+}
+
+void USBHostLatency::markInput(uint8_t dev_addr, uint32_t arrivalUs) {
+    if (!enabled || deviceAt(dev_addr) == nullptr)
+        return;
+
+    // keep the oldest input the outgoing report has not carried yet
+    uint32_t bit = 1UL << (dev_addr - 1);
+    if ((pendingMask & bit) == 0) {
+        pendingUs[dev_addr - 1] = arrivalUs;
+        pendingMask |= bit;
+    }
+}
+
+void USBHostLatency::reportProcessed(bool sent) {
+    if (pendingMask == 0)
+        return;
+
+    uint32_t now = time_us_32();
+    for (uint8_t i = 0; i < USB_HOST_LATENCY_MAX_DEVICES; i++) {
+        uint32_t bit = 1UL << i;
+        if ((pendingMask & bit) == 0)
+            continue;
+
+        uint32_t age = now - pendingUs[i];
+        if (sent) {
+            record(latencyData.devices[i].passthrough, age);
+            pendingMask &= ~bit;
+        } else if (age > USB_HOST_LATENCY_STALE_US) {
+            latencyData.devices[i].unchanged++;
+            pendingMask &= ~bit;
+        }
+    }
+}
+
+const USBHostLatencyDevice * USBHostLatency::getDevice(uint8_t dev_addr) const {
+    USBHostLatencyDevice * device = deviceAt(dev_addr);
+    if (device == nullptr || (device->vid == 0 && device->pid == 0))
+        return nullptr;
+    return device;
+}
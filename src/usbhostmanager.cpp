@@ -1,4 +1,5 @@
 #include "usbhostmanager.h"
+#include "usbhostlatency.h"
 #include "storagemanager.h"
 #include "peripheralmanager.h"
 #include "eventmanager.h"
@@ -11,23 +12,24 @@
 
 #include "drivers/shared/xinput_host.h"
 
+#include <algorithm>
+
 void USBHostManager::start() {
-    // This will happen after Gamepad has initialized
+    // Already running, an input mode switch may call this again for its auth listener
+    if (tuh_ready || tuh_requested) return;
+
+    // This will happen after Gamepad has initialized, Core1 picks the request up in process()
     if (PeripheralManager::getInstance().isUSBEnabled(0) && listeners.size() > 0) {
-        pio_usb_configuration_t* pio_cfg = PeripheralManager::getInstance().getUSB(0)->getController();
-        tuh_configure(1, TUH_CFGID_RPI_PIO_USB_CONFIGURATION, pio_cfg);
-        tuh_init(BOARD_TUH_RHPORT);
-        sleep_us(10); // ensure we are ready
-        tuh_ready = true;
-    } else {
-        tuh_ready = false;
+        tuh_requested = true;
     }
 }
 
 // Shut down the USB bus if we are running USB right now
 void USBHostManager::shutdown() {
+    tuh_requested = false;
     if ( tuh_ready ) {
         tuh_deinit(BOARD_TUH_RHPORT);
+        tuh_ready = false;
     }
 }
 
@@ -35,15 +37,34 @@ void USBHostManager::pushListener(USBListener * usbListener) { // If anything ne
     listeners.push_back(usbListener);
 }
 
+void USBHostManager::removeListener(USBListener * usbListener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), usbListener), listeners.end());
+}
+
 // Host manager should call tuh_task as fast as possible
+// PIO-USB runs its SOF timer on the core that initializes it, so the host stack
+// and every listener callback live on Core1 and stay out of the input loop
 void USBHostManager::process() {
-    if ( tuh_ready ){
-        tuh_task();
+    if ( !tuh_ready ) {
+        if ( !tuh_requested ) return;
+
+        pio_usb_configuration_t* pio_cfg = PeripheralManager::getInstance().getUSB(0)->getController();
+        tuh_configure(1, TUH_CFGID_RPI_PIO_USB_CONFIGURATION, pio_cfg);
+        tuh_init(BOARD_TUH_RHPORT);
+        sleep_us(10); // ensure we are ready
+        tuh_ready = true;
+    }
+
+    tuh_task();
+
+    for( std::vector<USBListener*>::iterator it = listeners.begin(); it != listeners.end(); it++ ){
+        (*it)->host_task();
     }
 }
 
 void USBHostManager::hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len) {
     if ( listeners.size() == 0 ) return;
+    USBHostLatency::getInstance().mount(dev_addr);
     for( std::vector<USBListener*>::iterator it = listeners.begin(); it != listeners.end(); it++ ){
         (*it)->mount(dev_addr, instance, desc_report, desc_len);
     }
@@ -58,9 +79,12 @@ void USBHostManager::hid_umount_cb(uint8_t dev_addr, uint8_t instance) {
 
 void USBHostManager::hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
     if ( listeners.size() == 0 ) return;
+    // Listeners stamp what they publish with the arrival time, see USBHostLatency
+    uint32_t arrival = USBHostLatency::getInstance().beginReport(dev_addr);
     for( std::vector<USBListener*>::iterator it = listeners.begin(); it != listeners.end(); it++ ){
         (*it)->report_received(dev_addr, instance, report, len);
     }
+    USBHostLatency::getInstance().endReport(dev_addr, arrival);
 }
 
 void USBHostManager::hid_set_report_complete_cb(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t report_type, uint16_t len) {
@@ -79,6 +103,7 @@ void USBHostManager::hid_get_report_complete_cb(uint8_t dev_addr, uint8_t instan
 
 void USBHostManager::xinput_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t controllerType, uint8_t subtype) {
     if ( listeners.size() == 0 ) return;
+    USBHostLatency::getInstance().mount(dev_addr);
     for( std::vector<USBListener*>::iterator it = listeners.begin(); it != listeners.end(); it++ ){
         (*it)->xmount(dev_addr, instance, controllerType, subtype);
     }
@@ -93,9 +118,12 @@ void USBHostManager::xinput_umount_cb(uint8_t dev_addr) {
 
 void USBHostManager::xinput_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
     if ( listeners.size() == 0 ) return;
+    // Listeners stamp what they publish with the arrival time, see USBHostLatency
+    uint32_t arrival = USBHostLatency::getInstance().beginReport(dev_addr);
     for( std::vector<USBListener*>::iterator it = listeners.begin(); it != listeners.end(); it++ ){
         (*it)->report_received(dev_addr, instance, report, len);
     }
+    USBHostLatency::getInstance().endReport(dev_addr, arrival);
 }
 
 void USBHostManager::xinput_report_sent_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
@@ -0,0 +1,251 @@
+#include "usbtelemetry.h"
+#include "descriptorbuilder.h"
+
+#include <string.h>
+
+#include "pico/time.h"
+
+// Vendor interface with a single bulk IN endpoint, the interface number is patched in when appended
+static constexpr auto usb_telemetry_interface_descriptor = USBDescriptor::concat(
+    USBDescriptor::interface(0, 0, 1, TUSB_CLASS_VENDOR_SPECIFIC, USB_TELEMETRY_SUBCLASS, USB_TELEMETRY_PROTOCOL, 0),
+    USBDescriptor::endpoint(USB_TELEMETRY_ENDPOINT, TUSB_XFER_BULK, USB_TELEMETRY_PACKET_SIZE, 0)
+);
+
+CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN static uint8_t telemetry_packet[USB_TELEMETRY_PACKET_SIZE];
+
+static void telemetry_init(void) {
+    USBTelemetry::getInstance().reset();
+}
+
+static void telemetry_reset(uint8_t rhport) {
+    (void)rhport;
+    USBTelemetry::getInstance().reset();
+}
+
+static uint16_t telemetry_open(uint8_t rhport, tusb_desc_interface_t const *itf_descriptor, uint16_t max_length) {
+    // Only claim our own interface, the gamepad driver gets everything else
+    TU_VERIFY(itf_descriptor->bInterfaceClass == TUSB_CLASS_VENDOR_SPECIFIC &&
+              itf_descriptor->bInterfaceSubClass == USB_TELEMETRY_SUBCLASS &&
+              itf_descriptor->bInterfaceProtocol == USB_TELEMETRY_PROTOCOL &&
+              itf_descriptor->bNumEndpoints == 1, 0);
+
+    uint16_t driver_length = sizeof(tusb_desc_interface_t) + sizeof(tusb_desc_endpoint_t);
+    TU_VERIFY(max_length >= driver_length, 0);
+
+    tusb_desc_endpoint_t const *endpoint = (tusb_desc_endpoint_t const *)tu_desc_next(itf_descriptor);
+    TU_ASSERT(TUSB_DESC_ENDPOINT == endpoint->bDescriptorType, 0);
+    TU_ASSERT(usbd_edpt_open(rhport, endpoint), 0);
+
+    USBTelemetry::getInstance().open(rhport, endpoint->bEndpointAddress);
+    return driver_length;
+}
+
+static bool telemetry_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const *request) {
+    return false;
+}
+
+static bool telemetry_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes) {
+    if (!USBTelemetry::getInstance().owns(ep_addr))
+        return false;
+
+    // keep the endpoint busy while there is something to send
+    USBTelemetry::getInstance().flush();
+    return true;
+}
+
+USBTelemetry::USBTelemetry() {
+    classDriver = {
+    #if CFG_TUSB_DEBUG >= 2
+        .name = "TELEMETRY",
+    #endif
+        .init = telemetry_init,
+        .reset = telemetry_reset,
+        .open = telemetry_open,
+        .control_xfer_cb = telemetry_control_xfer_cb,
+        .xfer_cb = telemetry_xfer_cb,
+        .sof = NULL
+    };
+
+    memset(&loopFrame, 0, sizeof(loopFrame));
+}
+
+// Drivers with a plain interrupt endpoint gamepad interface that hosts bind per interface
+bool USBTelemetry::supportsInputMode(InputMode mode) {
+    switch (mode) {
+        case INPUT_MODE_GENERIC:
+        case INPUT_MODE_SWITCH:
+        case INPUT_MODE_XINPUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Returns the gamepad configuration with the telemetry interface appended
+const uint8_t * USBTelemetry::getConfigurationDescriptor(const uint8_t * descriptor) {
+    uint16_t length = descriptor[2] | (descriptor[3] << 8);
+    uint16_t totalLength = length + usb_telemetry_interface_descriptor.size();
+    if (totalLength > sizeof(configDescriptor))
+        return descriptor;
+
+    uint8_t numInterfaces = descriptor[4];
+
+    memcpy(configDescriptor, descriptor, length);
+    memcpy(configDescriptor + length, usb_telemetry_interface_descriptor, usb_telemetry_interface_descriptor.size());
+    configDescriptor[2] = totalLength & 0xFF;
+    configDescriptor[3] = (totalLength >> 8) & 0xFF;
+    configDescriptor[4] = numInterfaces + 1;
+    configDescriptor[length + 2] = numInterfaces; // bInterfaceNumber
+    return configDescriptor;
+}
+
+void USBTelemetry::reset() {
+    endpointIn = 0;
+    head = tail = 0;
+    traceCount = 0;
+}
+
+void USBTelemetry::open(uint8_t rhport, uint8_t endpoint) {
+    this->rhport = rhport;
+    endpointIn = endpoint;
+    head = tail = 0;
+    periodsUntilNames = 0;
+}
+
+void USBTelemetry::recordLoop(uint32_t loopUs) {
+    uint8_t bin = (loopUs == 0) ? 0 : (32 - __builtin_clz(loopUs));
+    if (bin >= USB_TELEMETRY_HISTOGRAM_BINS)
+        bin = USB_TELEMETRY_HISTOGRAM_BINS - 1;
+
+    if (loopFrame.bins[bin] != UINT16_MAX)
+        loopFrame.bins[bin]++;
+    loopFrame.loops++;
+    if (loopUs > loopFrame.maxLoopUs)
+        loopFrame.maxLoopUs = loopUs;
+}
+
+void USBTelemetry::recordInput(const GamepadState& state) {
+    if (state.buttons == lastState.buttons && state.dpad == lastState.dpad && state.aux == lastState.aux)
+        return;
+
+    lastState.buttons = state.buttons;
+    lastState.dpad = state.dpad;
+    lastState.aux = state.aux;
+
+    // nobody is listening, don't bother queuing
+    if (endpointIn == 0)
+        return;
+
+    USBTelemetryInputEntry& entry = trace[traceCount++];
+    entry.timestamp = time_us_32();
+    entry.buttons = state.buttons;
+    entry.aux = state.aux;
+    entry.dpad = state.dpad;
+    entry.reserved = 0;
+
+    if (traceCount == USB_TELEMETRY_TRACE_BATCH)
+        writeInputFrame();
+}
+
+void USBTelemetry::process(const AddonManager& addons) {
+    if (endpointIn == 0)
+        return;
+
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if ((now - lastPeriod) >= USB_TELEMETRY_PERIOD_MS) {
+        lastPeriod = now;
+
+        bool withNames = (periodsUntilNames == 0);
+        periodsUntilNames = withNames ? USB_TELEMETRY_NAMES_PERIODS : periodsUntilNames - 1;
+
+        writeLoopFrame();
+        writeInputFrame();
+        writeAddonFrames(addons, withNames);
+    }
+
+    flush();
+}
+
+// Frames are written whole or not at all so the stream never needs resyncing
+bool USBTelemetry::writeFrame(uint8_t type, const void * payload, uint16_t length) {
+    uint32_t frameLength = sizeof(USBTelemetryFrameHeader) + length;
+    if ((USB_TELEMETRY_BUFFER_SIZE - (head - tail)) < frameLength) {
+        dropped++;
+        return false;
+    }
+
+    USBTelemetryFrameHeader header = { USB_TELEMETRY_FRAME_MAGIC, type, length };
+    const uint8_t * bytes = (const uint8_t *)&header;
+    for (uint32_t i = 0; i < sizeof(header); i++)
+        buffer[(head++) & (USB_TELEMETRY_BUFFER_SIZE - 1)] = bytes[i];
+
+    bytes = (const uint8_t *)payload;
+    for (uint32_t i = 0; i < length; i++)
+        buffer[(head++) & (USB_TELEMETRY_BUFFER_SIZE - 1)] = bytes[i];
+
+    return true;
+}
+
+void USBTelemetry::writeLoopFrame() {
+    loopFrame.timestamp = time_us_32();
+    loopFrame.dropped = dropped;
+    writeFrame(USB_TELEMETRY_FRAME_LOOP, &loopFrame, sizeof(loopFrame));
+
+    memset(&loopFrame, 0, sizeof(loopFrame));
+}
+
+void USBTelemetry::writeInputFrame() {
+    if (traceCount == 0)
+        return;
+
+    writeFrame(USB_TELEMETRY_FRAME_INPUT, trace, traceCount * sizeof(USBTelemetryInputEntry));
+    traceCount = 0;
+}
+
+void USBTelemetry::writeAddonFrames(const AddonManager& addons, bool withNames) {
+    const std::vector<AddonBlock*>& blocks = addons.GetAddonBlocks();
+    uint16_t length = 0;
+
+    for (size_t i = 0; i < blocks.size() && (length + sizeof(USBTelemetryAddonEntry)) <= sizeof(addonPayload); i++) {
+        USBTelemetryAddonEntry entry = { (uint8_t)i, { 0, 0, 0 }, blocks[i]->calls, blocks[i]->busyUs };
+        memcpy(addonPayload + length, &entry, sizeof(entry));
+        length += sizeof(entry);
+    }
+    writeFrame(USB_TELEMETRY_FRAME_ADDONS, addonPayload, length);
+
+    if (!withNames)
+        return;
+
+    length = 0;
+    for (size_t i = 0; i < blocks.size(); i++) {
+        std::string name = blocks[i]->ptr->name();
+        uint8_t nameLength = name.size() > 32 ? 32 : name.size();
+        if ((size_t)(length + 2 + nameLength) > sizeof(addonPayload))
+            break;
+        addonPayload[length++] = i;
+        addonPayload[length++] = nameLength;
+        memcpy(addonPayload + length, name.data(), nameLength);
+        length += nameLength;
+    }
+    writeFrame(USB_TELEMETRY_FRAME_ADDON_NAMES, addonPayload, length);
+}
+
+void USBTelemetry::flush() {
+    if (endpointIn == 0 || head == tail || usbd_edpt_busy(rhport, endpointIn))
+        return;
+
+    if (!usbd_edpt_claim(rhport, endpointIn))
+        return;
+
+    uint32_t count = head - tail;
+    if (count > USB_TELEMETRY_PACKET_SIZE)
+        count = USB_TELEMETRY_PACKET_SIZE;
+    for (uint32_t i = 0; i < count; i++)
+        telemetry_packet[i] = buffer[(tail + i) & (USB_TELEMETRY_BUFFER_SIZE - 1)];
+
+    if (usbd_edpt_xfer(rhport, endpointIn, telemetry_packet, count)) {
+        tail += count;
+    } else {
+        usbd_edpt_release(rhport, endpointIn);
+    }
+}
@@ -9,6 +9,8 @@
 #include "layoutmanager.h"
 #include "peripheralmanager.h"
 #include "system.h"
+#include "usbhostlatency.h"
+#include "macrostore.h"
 #include "config_utils.h"
 #include "types.h"
 #include "version.h"
@@ -36,10 +38,11 @@
 #include "lwip/def.h"
 #include "lwip/mem.h"
 #include "addons/input_macro.h"
+#include "addons/analog.h"
 
 #define PATH_CGI_ACTION "/cgi/action"
 
-#define LWIP_HTTPD_POST_MAX_PAYLOAD_LEN (1024 * 16)
+#define LWIP_HTTPD_POST_MAX_PAYLOAD_LEN (1024 * 20)
 
 #define MAX_MAPPED_INPUT_MODES 8
 
@@ -309,6 +312,8 @@ void save_hotkey(HotkeyEntry* hotkey, const DynamicJsonDocument& doc, const stri
     hotkey->dpadMask = dpadMask;
     hotkey->buttonsMask = buttonsMask;
     readDoc(hotkey->action, doc, hotkey_key, "action");
+    readDoc(hotkey->holdDuration, doc, hotkey_key, "holdDuration");
+    readDoc(hotkey->ordered, doc, hotkey_key, "ordered");
 }
 
 void load_hotkey(const HotkeyEntry* hotkey, DynamicJsonDocument& doc, const string hotkey_key)
@@ -329,6 +334,8 @@ void load_hotkey(const HotkeyEntry* hotkey, DynamicJsonDocument& doc, const stri
     }
     writeDoc(doc, hotkey_key, "buttonsMask", buttonsMask);
     writeDoc(doc, hotkey_key, "action", hotkey->action);
+    writeDoc(doc, hotkey_key, "holdDuration", hotkey->holdDuration);
+    writeDoc(doc, hotkey_key, "ordered", hotkey->ordered);
 }
 
 // LWIP callback on HTTP POST to validate the URI
@@ -359,23 +366,21 @@ err_t httpd_post_receive_data(void *connection, struct pbuf *p)
     LWIP_UNUSED_ARG(connection);
 
     // Cache the received data to http_post_payload
-    while (p != NULL)
+    for (struct pbuf *q = p; q != NULL; q = q->next)
     {
-        if (http_post_payload_len + p->len <= LWIP_HTTPD_POST_MAX_PAYLOAD_LEN)
+        if (http_post_payload_len + q->len <= LWIP_HTTPD_POST_MAX_PAYLOAD_LEN)
         {
-            MEMCPY(http_post_payload + http_post_payload_len, p->payload, p->len);
-            http_post_payload_len += p->len;
+            MEMCPY(http_post_payload + http_post_payload_len, q->payload, q->len);
+            http_post_payload_len += q->len;
         }
         else // Buffer overflow
         {
             http_post_payload_len = 0xffff;
             break;
         }
-
-        p = p->next;
     }
 
-    // Need to release memory here or will leak
+    // Need to release memory here or will leak, the whole chain from its head
     pbuf_free(p);
 
     // If the buffer overflows, error out
@@ -2091,6 +2096,12 @@ std::string setAddonOptions()
     docToValue(analogOptions.smoothing_factor2, doc, "smoothing_factor2");
     docToValue(analogOptions.analog_error, doc, "analog_error");
     docToValue(analogOptions.analog_error2, doc, "analog_error2");
+    docToValue(analogOptions.analog_curve, doc, "analog_curve");
+    docToValue(analogOptions.analog_curve2, doc, "analog_curve2");
+    docToValue(analogOptions.analog_curve_points, doc, "analog_curve_points");
+    docToValue(analogOptions.analog_curve_points2, doc, "analog_curve_points2");
+    docToValue(analogOptions.analog_oversample, doc, "analog_oversample");
+    docToValue(analogOptions.analog_oversample2, doc, "analog_oversample2");
     docToValue(analogOptions.enabled, doc, "AnalogInputEnabled");
 
     BootselButtonOptions& bootselButtonOptions = Storage::getInstance().getAddonOptions().bootselButtonOptions;
@@ -2149,6 +2160,14 @@ std::string setAddonOptions()
     TurboOptions& turboOptions = Storage::getInstance().getAddonOptions().turboOptions;
     docToPin(turboOptions.ledPin, doc, "turboPinLED");
     docToValue(turboOptions.shotCount, doc, "turboShotCount");
+    docToValue(turboOptions.shotCountB1, doc, "turboShotCountB1");
+    docToValue(turboOptions.shotCountB2, doc, "turboShotCountB2");
+    docToValue(turboOptions.shotCountB3, doc, "turboShotCountB3");
+    docToValue(turboOptions.shotCountB4, doc, "turboShotCountB4");
+    docToValue(turboOptions.shotCountL1, doc, "turboShotCountL1");
+    docToValue(turboOptions.shotCountR1, doc, "turboShotCountR1");
+    docToValue(turboOptions.shotCountL2, doc, "turboShotCountL2");
+    docToValue(turboOptions.shotCountR2, doc, "turboShotCountR2");
     docToValue(turboOptions.shmupModeEnabled, doc, "shmupMode");
     docToValue(turboOptions.shmupMixMode, doc, "shmupMixMode");
     docToValue(turboOptions.shmupAlwaysOn1, doc, "shmupAlwaysOn1");
@@ -2236,6 +2255,7 @@ std::string setAddonOptions()
 
     PCF8575Options& pcf8575Options = Storage::getInstance().getAddonOptions().pcf8575Options;
     docToValue(pcf8575Options.enabled, doc, "PCF8575AddonEnabled");
+    docToPin(pcf8575Options.interruptPin, doc, "PCF8575InterruptPin");
 
     ReactiveLEDOptions& reactiveLEDOptions = Storage::getInstance().getAddonOptions().reactiveLEDOptions;
     docToValue(reactiveLEDOptions.enabled, doc, "ReactiveLEDAddonEnabled");
@@ -2547,6 +2567,12 @@ std::string getAddonOptions()
     writeDoc(doc, "smoothing_factor2", analogOptions.smoothing_factor2);
     writeDoc(doc, "analog_error", analogOptions.analog_error);
     writeDoc(doc, "analog_error2", analogOptions.analog_error2);
+    writeDoc(doc, "analog_curve", analogOptions.analog_curve);
+    writeDoc(doc, "analog_curve2", analogOptions.analog_curve2);
+    writeDoc(doc, "analog_curve_points", analogOptions.analog_curve_points);
+    writeDoc(doc, "analog_curve_points2", analogOptions.analog_curve_points2);
+    writeDoc(doc, "analog_oversample", analogOptions.analog_oversample);
+    writeDoc(doc, "analog_oversample2", analogOptions.analog_oversample2);
     writeDoc(doc, "AnalogInputEnabled", analogOptions.enabled);
 
     const BootselButtonOptions& bootselButtonOptions = Storage::getInstance().getAddonOptions().bootselButtonOptions;
@@ -2599,6 +2625,14 @@ std::string getAddonOptions()
     const TurboOptions& turboOptions = Storage::getInstance().getAddonOptions().turboOptions;
     writeDoc(doc, "turboPinLED", cleanPin(turboOptions.ledPin));
     writeDoc(doc, "turboShotCount", turboOptions.shotCount);
+    writeDoc(doc, "turboShotCountB1", turboOptions.shotCountB1);
+    writeDoc(doc, "turboShotCountB2", turboOptions.shotCountB2);
+    writeDoc(doc, "turboShotCountB3", turboOptions.shotCountB3);
+    writeDoc(doc, "turboShotCountB4", turboOptions.shotCountB4);
+    writeDoc(doc, "turboShotCountL1", turboOptions.shotCountL1);
+    writeDoc(doc, "turboShotCountR1", turboOptions.shotCountR1);
+    writeDoc(doc, "turboShotCountL2", turboOptions.shotCountL2);
+    writeDoc(doc, "turboShotCountR2", turboOptions.shotCountR2);
     writeDoc(doc, "shmupMode", turboOptions.shmupModeEnabled);
     writeDoc(doc, "shmupMixMode", turboOptions.shmupMixMode);
     writeDoc(doc, "shmupAlwaysOn1", turboOptions.shmupAlwaysOn1);
@@ -2692,6 +2726,7 @@ std::string getAddonOptions()
 
     PCF8575Options& pcf8575Options = Storage::getInstance().getAddonOptions().pcf8575Options;
     writeDoc(doc, "PCF8575AddonEnabled", pcf8575Options.enabled);
+    writeDoc(doc, "PCF8575InterruptPin", cleanPin(pcf8575Options.interruptPin));
 
     ReactiveLEDOptions& reactiveLEDOptions = Storage::getInstance().getAddonOptions().reactiveLEDOptions;
     writeDoc(doc, "ReactiveLEDAddonEnabled", reactiveLEDOptions.enabled);
@@ -2738,11 +2773,15 @@ std::string setMacroAddonOptions()
     MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
     docToValue(macroOptions.macroBoardLedEnabled, doc, "macroBoardLedEnabled");
 
+    MacroStoreData& store = MacroStore::getInstance().create();
+    store.magic = MACRO_STORE_MAGIC;
+
     JsonObject options = doc.as<JsonObject>();
     JsonArray macros = options["macroList"];
     int macrosIndex = 0;
 
     for (JsonObject macro : macros) {
+        MacroStoreMacro& storeMacro = store.macros[macrosIndex];
         size_t macroLabelSize = sizeof(macroOptions.macroList[macrosIndex].macroLabel);
         strncpy(macroOptions.macroList[macrosIndex].macroLabel, macro["macroLabel"], macroLabelSize - 1);
         macroOptions.macroList[macrosIndex].macroLabel[macroLabelSize - 1] = '\0';
@@ -2753,16 +2792,35 @@ std::string setMacroAddonOptions()
         macroOptions.macroList[macrosIndex].exclusive = macro["exclusive"] == true;
         macroOptions.macroList[macrosIndex].interruptible = macro["interruptible"] == true;
         macroOptions.macroList[macrosIndex].showFrames = macro["showFrames"] == true;
+
+        memcpy(storeMacro.macroLabel, macroOptions.macroList[macrosIndex].macroLabel, sizeof(storeMacro.macroLabel));
+        storeMacro.macroType = macroOptions.macroList[macrosIndex].macroType;
+        storeMacro.useMacroTriggerButton = macroOptions.macroList[macrosIndex].useMacroTriggerButton;
+        storeMacro.macroTriggerButton = macroOptions.macroList[macrosIndex].macroTriggerButton;
+        storeMacro.enabled = macroOptions.macroList[macrosIndex].enabled;
+        storeMacro.exclusive = macroOptions.macroList[macrosIndex].exclusive;
+        storeMacro.interruptible = macroOptions.macroList[macrosIndex].interruptible;
+        storeMacro.showFrames = macroOptions.macroList[macrosIndex].showFrames;
+
+        // All inputs go to the macro store, the config keeps as many as it has room for
         JsonArray macroInputs = macro["macroInputs"];
         int macroInputsIndex = 0;
 
         for (JsonObject input: macroInputs) {
-            macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].duration = input["duration"].as<uint32_t>();
-            macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].waitDuration = input["waitDuration"].as<uint32_t>();
-            macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].buttonMask = input["buttonMask"].as<uint32_t>();
-            if (++macroInputsIndex >= MAX_MACRO_INPUT_LIMIT) break;
+            if (macroInputsIndex >= MACRO_STORE_MAX_MACRO_INPUTS || store.inputCount >= MACRO_STORE_MAX_INPUTS) break;
+            MacroStoreInput& storeInput = store.inputs[store.inputCount++];
+            storeInput.duration = input["duration"].as<uint32_t>();
+            storeInput.waitDuration = input["waitDuration"].as<uint32_t>();
+            storeInput.buttonMask = input["buttonMask"].as<uint32_t>();
+            if (macroInputsIndex < MAX_MACRO_INPUT_LIMIT) {
+                macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].duration = storeInput.duration;
+                macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].waitDuration = storeInput.waitDuration;
+                macroOptions.macroList[macrosIndex].macroInputs[macroInputsIndex].buttonMask = storeInput.buttonMask;
+            }
+            macroInputsIndex++;
         }
-        macroOptions.macroList[macrosIndex].macroInputs_count = macroInputsIndex;
+        storeMacro.inputCount = macroInputsIndex;
+        macroOptions.macroList[macrosIndex].macroInputs_count = std::min(macroInputsIndex, MAX_MACRO_INPUT_LIMIT);
 
         if (++macrosIndex >= MAX_MACRO_LIMIT)
             break;
@@ -2770,22 +2828,47 @@ std::string setMacroAddonOptions()
 
     macroOptions.macroList_count = MAX_MACRO_LIMIT;
 
+    MacroStore::getInstance().commit();
     EventManager::getInstance().triggerEvent(new GPStorageSaveEvent(true));
     return serialize_json(doc);
 }
 
 std::string getMacroAddonOptions()
 {
-    const size_t capacity = JSON_OBJECT_SIZE(500);
+    const size_t capacity = JSON_OBJECT_SIZE(500) + JSON_OBJECT_SIZE(3) * MACRO_STORE_MAX_INPUTS;
     DynamicJsonDocument doc(capacity);
 
     MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
+    const MacroStoreData* store = MacroStore::getInstance().get();
     JsonArray macroList = doc.createNestedArray("macroList");
 
     writeDoc(doc, "macroBoardLedEnabled", macroOptions.macroBoardLedEnabled);
 
+    uint32_t storeIndex = 0;
     for (int i = 0; i < MAX_MACRO_LIMIT; i++) {
         JsonObject macro = macroList.createNestedObject();
+        if (store != nullptr) {
+            // Macros recorded on the device only exist in the store
+            const MacroStoreMacro& storeMacro = store->macros[i];
+            macro["enabled"] = storeMacro.enabled ? 1 : 0;
+            macro["exclusive"] = storeMacro.exclusive ? 1 : 0;
+            macro["interruptible"] = storeMacro.interruptible ? 1 : 0;
+            macro["showFrames"] = storeMacro.showFrames ? 1 : 0;
+            macro["macroType"] = storeMacro.macroType;
+            macro["useMacroTriggerButton"] = storeMacro.useMacroTriggerButton ? 1 : 0;
+            macro["macroTriggerButton"] = storeMacro.macroTriggerButton;
+            macro["macroLabel"] = storeMacro.macroLabel;
+
+            JsonArray macroInputs = macro.createNestedArray("macroInputs");
+            for (uint16_t j = 0; j < storeMacro.inputCount && storeIndex < store->inputCount; j++, storeIndex++) {
+                JsonObject macroInput = macroInputs.createNestedObject();
+                macroInput["buttonMask"] = store->inputs[storeIndex].buttonMask;
+                macroInput["duration"] = store->inputs[storeIndex].duration;
+                macroInput["waitDuration"] = store->inputs[storeIndex].waitDuration;
+            }
+            continue;
+        }
+
         macro["enabled"] = macroOptions.macroList[i].enabled ? 1 : 0;
         macro["exclusive"] = macroOptions.macroList[i].exclusive ? 1 : 0;
         macro["interruptible"] = macroOptions.macroList[i].interruptible ? 1 : 0;
@@ -2834,6 +2917,45 @@ std::string getMemoryReport()
     return serialize_json(doc);
 }
 
+static void writeLatencyHistogram(JsonObject parent, const char * key, const USBHostLatencyHistogram & histogram)
+{
+    JsonObject object = parent.createNestedObject(key);
+    object["count"] = histogram.count;
+    object["maxUs"] = histogram.maxUs;
+    object["meanUs"] = histogram.count ? (uint32_t)(histogram.totalUs / histogram.count) : 0;
+    JsonArray bins = object.createNestedArray("bins");
+    for (uint8_t i = 0; i < USB_HOST_LATENCY_BINS; i++) {
+        bins.add(histogram.bins[i]);
+    }
+}
+
+std::string getUSBHostLatency()
+{
+    const size_t histogramSize = JSON_OBJECT_SIZE(4) + JSON_ARRAY_SIZE(USB_HOST_LATENCY_BINS);
+    const size_t deviceSize = JSON_OBJECT_SIZE(7) + 3 * histogramSize;
+    const size_t capacity = JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(USB_HOST_LATENCY_MAX_DEVICES) + USB_HOST_LATENCY_MAX_DEVICES * deviceSize;
+    DynamicJsonDocument doc(capacity);
+    USBHostLatency & latency = USBHostLatency::getInstance();
+
+    writeDoc(doc, "previousSession", latency.isPreviousSession());
+    JsonArray devices = doc.createNestedArray("devices");
+    for (uint8_t address = 1; address <= USB_HOST_LATENCY_MAX_DEVICES; address++) {
+        const USBHostLatencyDevice * device = latency.getDevice(address);
+        if (device == nullptr)
+            continue;
+
+        JsonObject entry = devices.createNestedObject();
+        entry["address"] = address;
+        entry["vid"] = device->vid;
+        entry["pid"] = device->pid;
+        entry["unchanged"] = device->unchanged;
+        writeLatencyHistogram(entry, "pollInterval", device->pollInterval);
+        writeLatencyHistogram(entry, "decode", device->decode);
+        writeLatencyHistogram(entry, "passthrough", device->passthrough);
+    }
+    return serialize_json(doc);
+}
+
 static bool _abortGetHeldPins = false;
 
 std::string getHeldPins()
@@ -2914,6 +3036,9 @@ DataAndStatusCode setConfig()
     {
         Storage::getInstance().getConfig() = *config.get();
         config.reset();
+        // the macro store overrides MacroOptions while it holds an image, drop it
+        // so the macros in the restored config are the ones that run
+        MacroStore::getInstance().reset();
         if (Storage::getInstance().save(true))
         {
             return DataAndStatusCode(getConfig(), HttpStatusCode::_200);
@@ -3058,6 +3183,69 @@ std:: string getJoystickCenter2() {
     return serialize_json(doc);
 }
 
+static void writeAnalogNoise(JsonObject & stick, const char * key, int32_t pin, AnalogNoise & noise)
+{
+    noise = {};
+    if (!isValidPin(pin))
+        return;
+
+    adc_gpio_init(pin);
+    AnalogInput::measureNoise(pin - 26, noise);
+
+    JsonObject axis = stick.createNestedObject(key);
+    axis["pin"] = pin;
+    axis["mean"] = noise.mean;
+    axis["deviation"] = noise.deviation;
+    axis["min"] = noise.minimum;
+    axis["max"] = noise.maximum;
+    JsonArray histogram = axis.createNestedArray("histogram");
+    for (uint32_t i = 0; i < ANALOG_NOISE_BINS; i++) {
+        histogram.add(noise.histogram[i]);
+    }
+}
+
+// Samples every configured stick axis at rest and suggests oversampling, smoothing and deadzone
+std::string getAnalogNoise()
+{
+    const size_t axisSize = JSON_OBJECT_SIZE(6) + JSON_ARRAY_SIZE(ANALOG_NOISE_BINS);
+    const size_t stickSize = JSON_OBJECT_SIZE(4) + 2 * axisSize + JSON_OBJECT_SIZE(3);
+    const size_t capacity = JSON_OBJECT_SIZE(3) + JSON_ARRAY_SIZE(2) + 2 * stickSize;
+    DynamicJsonDocument doc(capacity);
+    const AnalogOptions& analogOptions = Storage::getInstance().getAddonOptions().analogOptions;
+
+    if (!analogOptions.enabled) {
+        doc["success"] = false;
+        doc["error"] = "Analog input is not enabled";
+        return serialize_json(doc);
+    }
+
+    adc_init();
+    const int32_t pins[2][2] = {
+        { analogOptions.analogAdc1PinX, analogOptions.analogAdc1PinY },
+        { analogOptions.analogAdc2PinX, analogOptions.analogAdc2PinY },
+    };
+    doc["success"] = true;
+    doc["samples"] = ANALOG_NOISE_SAMPLES;
+    JsonArray sticks = doc.createNestedArray("sticks");
+    for (uint32_t i = 0; i < 2; i++) {
+        if (!isValidPin(pins[i][0]) && !isValidPin(pins[i][1]))
+            continue;
+
+        AnalogNoise x, y;
+        JsonObject stick = sticks.createNestedObject();
+        stick["stick"] = i + 1;
+        writeAnalogNoise(stick, "x", pins[i][0], x);
+        writeAnalogNoise(stick, "y", pins[i][1], y);
+
+        AnalogNoiseSuggestion suggestion = AnalogInput::suggestNoiseSettings(x, y);
+        JsonObject suggested = stick.createNestedObject("suggested");
+        suggested["oversample"] = suggestion.oversample;
+        suggested["smoothingFactor"] = suggestion.smoothing_factor;
+        suggested["innerDeadzone"] = suggestion.inner_deadzone;
+    }
+    return serialize_json(doc);
+}
+
 typedef std::string (*HandlerFuncPtr)();
 static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
 {
@@ -3117,12 +3305,14 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
     { "/api/getSplashImage", getSplashImage },
     { "/api/getFirmwareVersion", getFirmwareVersion },
     { "/api/getMemoryReport", getMemoryReport },
+    { "/api/getUSBHostLatency", getUSBHostLatency },
     { "/api/getHeldPins", getHeldPins },
     { "/api/abortGetHeldPins", abortGetHeldPins },
     { "/api/getUsedPins", getUsedPins },
     { "/api/getConfig", getConfig },
     { "/api/getJoystickCenter", getJoystickCenter },
     { "/api/getJoystickCenter2", getJoystickCenter2 },
+    { "/api/getAnalogNoise", getAnalogNoise },
 		{ "/api/getBootModeOptions", getBootModeOptions },
 		{ "/api/setBootModeOptions", setBootModeOptions },
 #if !defined(NDEBUG)
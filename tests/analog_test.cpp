@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+The fixed-point analog stick pipeline against the float one it replaced.
+
+Without smoothing the output only depends on the current reading, so every 12-bit X/Y pair
+is run through both with the default settings, and every third one for a spread of other
+deadzone, error rate, circularity, inversion and calibration settings. With smoothing on,
+random reading sequences are compared instead.
+
+The output has to match exactly, centered or not. Readings the fixed-point path can't settle
+within its error bound go through the float code, so this also checks that bound holds.
+Response curves have no float version, only the linear curve is compared.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+
+#include "addons/analog.h"
+#include "hardware/adc.h"
+#include "helper.h"
+#include "storagemanager.h"
+#include "drivermanager.h"
+
+namespace legacy {
+#include "legacy/analog.inc"
+}
+
+// left untouched by process() when the stick is centered
+#define STATE_UNSET 1
+
+//
+// ADC stubs
+//
+
+static uint16_t adcInputs[4];
+static unsigned int adcSelected = 0;
+
+void adc_gpio_init(unsigned int /*gpio*/) {}
+void adc_select_input(unsigned int input) { adcSelected = input; }
+uint16_t adc_read(void) { return adcInputs[adcSelected]; }
+void adc_fifo_setup(bool /*en*/, bool /*dreq_en*/, uint16_t /*dreq_thresh*/, bool /*err_in_fifo*/, bool /*byte_shift*/) {}
+void adc_run(bool /*run*/) {}
+uint16_t adc_fifo_get_blocking(void) { return adcInputs[adcSelected]; }
+void adc_fifo_drain(void) {}
+
+//
+// Comparison
+//
+
+struct AnalogConfig {
+    bool circularity;
+    uint32_t innerDeadzone;
+    uint32_t outerDeadzone;
+    uint32_t errorRate;
+    bool smoothing;
+    float smoothingFactor;
+    InvertMode invert;
+    uint16_t centerX;       // read at setup with auto calibration, 0 to leave it off
+    uint16_t centerY;
+    uint16_t step;          // between the readings compared without smoothing
+};
+
+static const AnalogConfig analogConfigs[] = {
+    { false, 5, 95, 1000, false, 0, INVERT_NONE, 0, 0, 1 },    // defaults
+    { true, 5, 95, 1000, false, 0, INVERT_NONE, 0, 0, 3 },
+    { false, 0, 100, 1000, false, 0, INVERT_NONE, 0, 0, 3 },
+    { true, 10, 80, 946, false, 0, INVERT_NONE, 0, 0, 3 },
+    { false, 20, 90, 890, false, 0, INVERT_NONE, 0, 0, 3 },
+    { true, 40, 45, 500, false, 0, INVERT_NONE, 0, 0, 3 },
+    { false, 5, 95, 1000, false, 0, INVERT_XY, 0, 0, 3 },
+    { true, 10, 90, 980, false, 0, INVERT_X, 1987, 2113, 3 },
+    { false, 5, 95, 1000, true, 5, INVERT_NONE, 0, 0, 0 },
+    { true, 3, 97, 969, true, 50, INVERT_Y, 2071, 2002, 0 },
+};
+
+static int failures = 0;
+
+static void loadConfig(const AnalogConfig & config) {
+    AnalogOptions & options = Storage::getInstance().getAddonOptions().analogOptions;
+    options = {};
+    options.enabled = true;
+    options.analogAdc1PinX = 26;
+    options.analogAdc1PinY = 27;
+    options.analogAdc1Mode = DPAD_MODE_LEFT_ANALOG;
+    options.analogAdc2PinX = -1;
+    options.analogAdc2PinY = -1;
+    options.forced_circularity = config.circularity;
+    options.inner_deadzone = config.innerDeadzone;
+    options.outer_deadzone = config.outerDeadzone;
+    options.analog_error = config.errorRate;
+    options.analog_smoothing = config.smoothing;
+    options.smoothing_factor = config.smoothingFactor;
+    options.analog_curve = ANALOG_CURVE_LINEAR;
+    options.analogAdc1Invert = config.invert;
+    options.auto_calibrate = (config.centerX != 0);
+}
+
+// whether both set the same axes, or both left the stick centered
+static bool compare(AnalogInput & fixed, legacy::AnalogInput & reference, uint16_t x, uint16_t y) {
+    GamepadState & state = Storage::getInstance().GetGamepad()->state;
+    adcInputs[0] = x;
+    adcInputs[1] = y;
+
+    state.lx = state.ly = STATE_UNSET;
+    reference.process();
+    uint16_t expectedX = state.lx;
+    uint16_t expectedY = state.ly;
+
+    state.lx = state.ly = STATE_UNSET;
+    fixed.process();
+    uint16_t actualX = state.lx;
+    uint16_t actualY = state.ly;
+
+    if ((expectedX == actualX) && (expectedY == actualY))
+        return true;
+    if (failures++ < 10)
+        printf("  x %u y %u: expected %u %u, got %u %u\n", x, y, expectedX, expectedY, actualX, actualY);
+    return false;
+}
+
+static void report(const AnalogConfig & config, uint32_t count, uint32_t differing) {
+    printf("circularity %d deadzone %u-%u error %u smoothing %d invert %d center %u/%u: %u of %u differ\n",
+        config.circularity, config.innerDeadzone, config.outerDeadzone, config.errorRate, config.smoothing,
+        config.invert, config.centerX, config.centerY, differing, count);
+}
+
+static void setupBoth(const AnalogConfig & config, AnalogInput & fixed, legacy::AnalogInput & reference) {
+    adcInputs[0] = config.centerX;
+    adcInputs[1] = config.centerY;
+    fixed.setup();
+    reference.setup();
+}
+
+static void testEveryReading(const AnalogConfig & config) {
+    AnalogInput fixed;
+    legacy::AnalogInput reference;
+    setupBoth(config, fixed, reference);
+
+    uint32_t count = 0;
+    uint32_t differing = 0;
+    for (uint16_t x = 0; x <= 4095; x += config.step) {
+        for (uint16_t y = 0; y <= 4095; y += config.step) {
+            count++;
+            if (!compare(fixed, reference, x, y))
+                differing++;
+        }
+    }
+    report(config, count, differing);
+}
+
+static void testSmoothing(const AnalogConfig & config) {
+    AnalogInput fixed;
+    legacy::AnalogInput reference;
+    setupBoth(config, fixed, reference);
+
+    const uint32_t count = 1 << 20;
+    uint32_t random = 1;
+    uint32_t differing = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        random = random * 1103515245 + 12345;
+        uint16_t x = (random >> 8) & 0xFFF;
+        uint16_t y = (random >> 20) & 0xFFF;
+        if (!compare(fixed, reference, x, y))
+            differing++;
+    }
+    report(config, count, differing);
+}
+
+int main() {
+    for (const AnalogConfig & config : analogConfigs) {
+        loadConfig(config);
+        if (config.smoothing)
+            testSmoothing(config);
+        else
+            testEveryReading(config);
+    }
+
+    if (failures != 0) {
+        printf("%d readings differ\n", failures);
+        return 1;
+    }
+    printf("The fixed-point analog pipeline matches the float one exactly\n");
+    return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+The descriptors built with descriptorbuilder.h against the hand-written arrays they replaced.
+
+Every device, HID report, HID class and configuration descriptor of the HID, Switch, Keyboard,
+XInput, PS4, Switch Pro and Xbox One drivers has to match the old array byte for byte, length
+included. The fixed strings are now stored as UTF-16 in flash, so each one is compared with what
+getStringDescriptor() made of the old 8-bit string at runtime. The XInput version string and the
+Xbox One serial (both index 3) are still generated from the board ID by the driver and left out.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "drivers/hid/HIDDescriptors.h"
+#include "drivers/switch/SwitchDescriptors.h"
+#include "drivers/keyboard/KeyboardDescriptors.h"
+#include "drivers/xinput/XInputDescriptors.h"
+#include "drivers/ps4/PS4Descriptors.h"
+#include "drivers/switchpro/SwitchProDescriptors.h"
+#include "drivers/xbone/XBOneDescriptors.h"
+#include "drivers/shared/driverhelper.h"
+
+namespace legacy {
+#include "legacy/descriptors.inc"
+}
+
+static int failures = 0;
+
+static void fail(const char * what, const uint8_t * expected, size_t expectedLength, const uint8_t * actual, size_t actualLength) {
+    if (failures++ >= 10)
+        return;
+    printf("%s:\n  expected %zu bytes", what, expectedLength);
+    for (size_t i = 0; i < expectedLength; i++)
+        printf(" %02x", expected[i]);
+    printf("\n  got      %zu bytes", actualLength);
+    for (size_t i = 0; i < actualLength; i++)
+        printf(" %02x", actual[i]);
+    printf("\n");
+}
+
+static void check(const char * what, const uint8_t * expected, size_t expectedLength, const uint8_t * actual, size_t actualLength) {
+    if ((expectedLength != actualLength) || (memcmp(expected, actual, actualLength) != 0))
+        fail(what, expected, expectedLength, actual, actualLength);
+}
+
+template <size_t N, typename Built>
+static void checkDescriptor(const char * what, const uint8_t (&expected)[N], const Built & actual) {
+    check(what, expected, N, actual, sizeof(actual));
+}
+
+// bLength of a string descriptor is the low byte of its first word
+static void checkStrings(const char * what, const uint8_t * const * expected, const uint16_t * const * actual,
+    size_t count, int skip = -1) {
+    for (size_t i = 0; i < count; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "%s string %zu", what, i);
+        if ((int)i == skip) {
+            if (actual[i] != nullptr)
+                fail(name, nullptr, 0, (const uint8_t *)actual[i], actual[i][0] & 0xFF);
+            continue;
+        }
+        uint16_t converted[128];
+        memcpy(converted, getStringDescriptor((const char *)expected[i], i), sizeof(converted));
+        if (actual[i] == nullptr) {
+            fail(name, (const uint8_t *)converted, converted[0] & 0xFF, nullptr, 0);
+            continue;
+        }
+        check(name, (const uint8_t *)converted, converted[0] & 0xFF, (const uint8_t *)actual[i], actual[i][0] & 0xFF);
+    }
+}
+
+#define STRING_COUNT(table) (sizeof(table) / sizeof(table[0]))
+
+static void testHID() {
+    checkDescriptor("hid device", legacy::hid_device_descriptor, hid_device_descriptor);
+    checkDescriptor("hid report", legacy::hid_report_descriptor, hid_report_descriptor);
+    checkDescriptor("hid configuration", legacy::hid_configuration_descriptor, hid_configuration_descriptor);
+    static_assert(STRING_COUNT(hid_string_descriptors) == STRING_COUNT(legacy::hid_string_descriptors));
+    checkStrings("hid", legacy::hid_string_descriptors, hid_string_descriptors, STRING_COUNT(hid_string_descriptors));
+}
+
+static void testSwitch() {
+    checkDescriptor("switch device", legacy::switch_device_descriptor, switch_device_descriptor);
+    checkDescriptor("switch report", legacy::switch_report_descriptor, switch_report_descriptor);
+    checkDescriptor("switch hid", legacy::switch_hid_descriptor, switch_hid_descriptor);
+    checkDescriptor("switch configuration", legacy::switch_configuration_descriptor, switch_configuration_descriptor);
+    static_assert(STRING_COUNT(switch_string_descriptors) == STRING_COUNT(legacy::switch_string_descriptors));
+    checkStrings("switch", legacy::switch_string_descriptors, switch_string_descriptors,
+        STRING_COUNT(switch_string_descriptors));
+}
+
+static void testKeyboard() {
+    checkDescriptor("keyboard device", legacy::keyboard_device_descriptor, keyboard_device_descriptor);
+    checkDescriptor("keyboard report", legacy::keyboard_report_descriptor, keyboard_report_descriptor);
+    checkDescriptor("keyboard hid", legacy::keyboard_hid_descriptor, keyboard_hid_descriptor);
+    checkDescriptor("keyboard configuration", legacy::keyboard_configuration_descriptor, keyboard_configuration_descriptor);
+    static_assert(STRING_COUNT(keyboard_string_descriptors) == STRING_COUNT(legacy::keyboard_string_descriptors));
+    checkStrings("keyboard", legacy::keyboard_string_descriptors, keyboard_string_descriptors,
+        STRING_COUNT(keyboard_string_descriptors));
+}
+
+static void testXInput() {
+    checkDescriptor("xinput device", legacy::xinput_device_descriptor, xinput_device_descriptor);
+    checkDescriptor("xinput configuration", legacy::xinput_configuration_descriptor, xinput_configuration_descriptor);
+    static_assert(STRING_COUNT(xinput_string_descriptors) == STRING_COUNT(legacy::xinput_string_descriptors));
+    checkStrings("xinput", legacy::xinput_string_descriptors, xinput_string_descriptors,
+        STRING_COUNT(xinput_string_descriptors), XINPUT_STRING_INDEX_VERSION);
+}
+
+static void testPS4() {
+    checkDescriptor("ps4 device", legacy::ps4_device_descriptor, ps4_device_descriptor);
+    checkDescriptor("ps4 report", legacy::ps4_report_descriptor, ps4_report_descriptor);
+    checkDescriptor("ps4 hid", legacy::ps4_hid_descriptor, ps4_hid_descriptor);
+    checkDescriptor("ps4 configuration", legacy::ps4_configuration_descriptor, ps4_configuration_descriptor);
+    static_assert(STRING_COUNT(ps4_string_descriptors) == STRING_COUNT(legacy::ps4_string_descriptors));
+    checkStrings("ps4", legacy::ps4_string_descriptors, ps4_string_descriptors, STRING_COUNT(ps4_string_descriptors));
+}
+
+static void testSwitchPro() {
+    checkDescriptor("switch pro device", legacy::switch_pro_device_descriptor, switch_pro_device_descriptor);
+    checkDescriptor("switch pro report", legacy::switch_pro_report_descriptor, switch_pro_report_descriptor);
+    checkDescriptor("switch pro hid", legacy::switch_pro_hid_descriptor, switch_pro_hid_descriptor);
+    checkDescriptor("switch pro configuration", legacy::switch_pro_configuration_descriptor,
+        switch_pro_configuration_descriptor);
+    static_assert(STRING_COUNT(switch_pro_string_descriptors) == STRING_COUNT(legacy::switch_pro_string_descriptors));
+    checkStrings("switch pro", legacy::switch_pro_string_descriptors, switch_pro_string_descriptors,
+        STRING_COUNT(switch_pro_string_descriptors));
+}
+
+// xbone_get_string_descriptor() served the security method and OS strings from outside its table
+static void testXBone() {
+    checkDescriptor("xbone qualifier", legacy::xbone_device_qualifier, xbone_device_qualifier);
+    checkDescriptor("xbone device", legacy::xbone_device_descriptor, xbone_device_descriptor);
+    checkDescriptor("xbone configuration", legacy::xbone_configuration_descriptor, xbone_configuration_descriptor);
+    const uint8_t * expected[] = {
+        legacy::xbone_string_descriptors[0],
+        legacy::xbone_string_descriptors[1],
+        legacy::xbone_string_descriptors[2],
+        nullptr,
+        legacy::xboxSecurityMethod
+    };
+    static_assert(STRING_COUNT(xbone_string_descriptors) == STRING_COUNT(expected));
+    checkStrings("xbone", expected, xbone_string_descriptors, STRING_COUNT(xbone_string_descriptors),
+        XBONE_STRING_INDEX_SERIAL);
+    uint16_t converted[128];
+    memcpy(converted, getStringDescriptor((const char *)legacy::xboxOSDescriptor, XBONE_STRING_INDEX_OS),
+        sizeof(converted));
+    const uint16_t * os = xbone_string_os;
+    check("xbone os string", (const uint8_t *)converted, converted[0] & 0xFF, (const uint8_t *)os, sizeof(xbone_string_os));
+}
+
+int main() {
+    testHID();
+    testSwitch();
+    testKeyboard();
+    testXInput();
+    testPS4();
+    testSwitchPro();
+    testXBone();
+
+    if (failures != 0) {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    printf("The built descriptors match the old HID, Switch, Keyboard, XInput, PS4, Switch Pro and Xbox One arrays\n");
+    return 0;
+}
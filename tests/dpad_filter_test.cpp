@@ -0,0 +1,119 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+DpadFilter against the function-static SOCD cleaner and 4-way filter it replaced.
+
+SOCD: every state the old cleaner can be in (last up/down and last left/right direction)
+is reached within two inputs, so running every sequence of four D-pad values from a
+neutral start covers every state against every one of the 16 inputs, for each mode.
+
+4-way: the old filter keeps the held directions in press order. Every order of up to
+four held directions is reached within four inputs, so every sequence of five D-pad
+values covers every held order against every input.
+*/
+
+#include <stdio.h>
+
+#include "GamepadState.h"
+
+namespace legacy {
+#include "legacy/GamepadState.inc"
+}
+
+static const SOCDMode socdModes[] = {
+    SOCD_MODE_UP_PRIORITY,
+    SOCD_MODE_NEUTRAL,
+    SOCD_MODE_SECOND_INPUT_PRIORITY,
+    SOCD_MODE_FIRST_INPUT_PRIORITY,
+    SOCD_MODE_BYPASS,
+};
+
+static int failures = 0;
+
+static void fail(const char * what, int mode, const uint8_t * sequence, int length, uint8_t expected, uint8_t actual) {
+    if (failures++ >= 10)
+        return;
+    printf("%s mode %d:", what, mode);
+    for (int i = 0; i < length; i++)
+        printf(" %x", sequence[i]);
+    printf(" -> expected %x, got %x\n", expected, actual);
+}
+
+static void testSOCD() {
+    const int length = 4;
+    for (SOCDMode mode : socdModes) {
+        for (uint32_t n = 0; n < (1u << (4 * length)); n++) {
+            uint8_t sequence[length];
+            for (int i = 0; i < length; i++)
+                sequence[i] = (n >> (4 * i)) & 0x0F;
+
+            // nothing held puts the old cleaner back to its neutral state, bypass leaves it alone
+            legacy::runSOCDCleaner(SOCD_MODE_NEUTRAL, 0);
+            DpadFilter filter;
+            for (int i = 0; i < length; i++) {
+                uint8_t expected = legacy::runSOCDCleaner(mode, sequence[i]);
+                uint8_t actual = filter.runSOCDCleaner(mode, sequence[i]);
+                if (expected != actual) {
+                    fail("socd", mode, sequence, i + 1, expected, actual);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void testFourWay() {
+    const int length = 5;
+    for (uint32_t n = 0; n < (1u << (4 * length)); n++) {
+        uint8_t sequence[length];
+        for (int i = 0; i < length; i++)
+            sequence[i] = (n >> (4 * i)) & 0x0F;
+
+        legacy::filterToFourWayMode(0);
+        DpadFilter filter;
+        for (int i = 0; i < length; i++) {
+            uint8_t expected = legacy::filterToFourWayMode(sequence[i]);
+            uint8_t actual = filter.filterToFourWayMode(sequence[i]);
+            if (expected != actual) {
+                fail("4-way", 0, sequence, i + 1, expected, actual);
+                // the old filter is left mid-sequence, start it over on the next one
+                break;
+            }
+        }
+    }
+}
+
+static void testReset() {
+    DpadFilter filter;
+    filter.runSOCDCleaner(SOCD_MODE_SECOND_INPUT_PRIORITY, GAMEPAD_MASK_UP | GAMEPAD_MASK_LEFT);
+    filter.filterToFourWayMode(GAMEPAD_MASK_DOWN | GAMEPAD_MASK_RIGHT);
+    filter.reset();
+
+    DpadFilter fresh;
+    const uint8_t both = GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN | GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT;
+    uint8_t sequence[1] = { both };
+    uint8_t expected = fresh.runSOCDCleaner(SOCD_MODE_SECOND_INPUT_PRIORITY, both);
+    uint8_t actual = filter.runSOCDCleaner(SOCD_MODE_SECOND_INPUT_PRIORITY, both);
+    if (expected != actual)
+        fail("reset socd", SOCD_MODE_SECOND_INPUT_PRIORITY, sequence, 1, expected, actual);
+    expected = fresh.filterToFourWayMode(both);
+    actual = filter.filterToFourWayMode(both);
+    if (expected != actual)
+        fail("reset 4-way", 0, sequence, 1, expected, actual);
+}
+
+int main() {
+    testSOCD();
+    testFourWay();
+    testReset();
+
+    if (failures != 0) {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+    printf("DpadFilter matches the old SOCD cleaner and 4-way filter\n");
+    return 0;
+}
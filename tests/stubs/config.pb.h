@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The part of the generated config that src/addons/analog.cpp reads
+
+#ifndef _TESTS_CONFIG_PB_H_
+#define _TESTS_CONFIG_PB_H_
+
+#include <stdint.h>
+
+#include "enums.pb.h"
+
+typedef struct _AnalogOptions {
+    bool enabled;
+    int32_t analogAdc1PinX;
+    int32_t analogAdc1PinY;
+    bool forced_circularity;
+    uint32_t inner_deadzone;
+    int32_t analogAdc2PinX;
+    int32_t analogAdc2PinY;
+    DpadMode analogAdc1Mode;
+    DpadMode analogAdc2Mode;
+    InvertMode analogAdc1Invert;
+    InvertMode analogAdc2Invert;
+    bool auto_calibrate;
+    uint32_t outer_deadzone;
+    bool analog_smoothing;
+    float smoothing_factor;
+    uint32_t analog_error;
+    bool analog_smoothing2;
+    float smoothing_factor2;
+    uint32_t analog_error2;
+    uint32_t inner_deadzone2;
+    uint32_t outer_deadzone2;
+    bool auto_calibrate2;
+    bool forced_circularity2;
+    uint32_t joystick_center_x;
+    uint32_t joystick_center_y;
+    uint32_t joystick_center_x2;
+    uint32_t joystick_center_y2;
+    AnalogResponseCurve analog_curve;
+    AnalogResponseCurve analog_curve2;
+    uint32_t analog_curve_points;
+    uint32_t analog_curve_points2;
+    uint32_t analog_oversample;
+    uint32_t analog_oversample2;
+} AnalogOptions;
+
+typedef struct _AddonOptions {
+    AnalogOptions analogOptions;
+} AddonOptions;
+
+#endif
@@ -0,0 +1,28 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The part of DriverManager that src/gamepad/GamepadState.cpp and src/addons/analog.cpp use,
+// with no driver running
+
+#ifndef _TESTS_DRIVERMANAGER_H_
+#define _TESTS_DRIVERMANAGER_H_
+
+#include <stdint.h>
+
+class GPDriver {
+public:
+    uint16_t GetJoystickMidValue() { return 0x7FFF; }
+};
+
+class DriverManager {
+public:
+    static DriverManager& getInstance() {
+        static DriverManager instance;
+        return instance;
+    }
+    GPDriver * getDriver() { return nullptr; }
+};
+
+#endif
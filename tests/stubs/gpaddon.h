@@ -0,0 +1,24 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _TESTS_GPADDON_H_
+#define _TESTS_GPADDON_H_
+
+#include <string>
+
+class GPAddon
+{
+public:
+    virtual ~GPAddon() { }
+    virtual bool available() = 0;
+    virtual void setup() = 0;
+    virtual void process() = 0;
+    virtual void preprocess() = 0;
+    virtual void postprocess(bool) = 0;
+    virtual std::string name() = 0;
+    virtual void reinit() = 0;
+};
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The ADC calls src/addons/analog.cpp makes, backed by analog_test.cpp
+
+#ifndef _TESTS_HARDWARE_ADC_H_
+#define _TESTS_HARDWARE_ADC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+void adc_gpio_init(unsigned int gpio);
+void adc_select_input(unsigned int input);
+uint16_t adc_read(void);
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_run(bool run);
+uint16_t adc_fifo_get_blocking(void);
+void adc_fifo_drain(void);
+
+#endif
@@ -0,0 +1,11 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _TESTS_HARDWARE_I2C_H_
+#define _TESTS_HARDWARE_I2C_H_
+
+typedef struct i2c_inst i2c_inst_t;
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+#ifndef _TESTS_HELPER_H_
+#define _TESTS_HELPER_H_
+
+#include <stdint.h>
+
+static inline bool isValidPin(int32_t pin) { return pin >= 0 && pin < 30; }
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The part of PeripheralI2C that lib/WiiExtension uses, backed by wii_extension_test.cpp
+
+#ifndef _TESTS_PERIPHERAL_I2C_H_
+#define _TESTS_PERIPHERAL_I2C_H_
+
+#include <stdint.h>
+
+typedef enum {
+    I2C_PRIORITY_INPUT = 0,
+    I2C_PRIORITY_DISPLAY,
+    I2C_PRIORITY_COUNT
+} I2CPriority;
+
+struct I2CTransaction;
+typedef void (*I2CCallback)(I2CTransaction* transaction);
+
+struct I2CTransaction {
+    uint8_t address = 0;
+    const uint8_t *tx = nullptr;
+    uint16_t txLen = 0;
+    uint8_t *rx = nullptr;
+    uint16_t rxLen = 0;
+    I2CPriority priority = I2C_PRIORITY_INPUT;
+    I2CCallback callback = nullptr;
+    void *context = nullptr;
+
+    volatile int16_t result = 0;
+    volatile bool done = true;
+
+    I2CTransaction *next = nullptr;
+};
+
+class PeripheralI2C {
+public:
+    int16_t read(uint8_t address, uint8_t *data, uint16_t len, bool isBlock=false);
+    int16_t write(uint8_t address, uint8_t *data, uint16_t len, bool isBlock=true);
+
+    // runs the transaction and its callback before returning
+    bool submit(I2CTransaction *transaction);
+    bool isAsync();
+
+    uint8_t test(uint8_t address);
+};
+
+#endif
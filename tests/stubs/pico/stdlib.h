@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The parts of the Pico SDK that lib/WiiExtension uses, backed by wii_extension_test.cpp.
+// analog_test.cpp only needs the header to exist for gamepad.h
+
+#ifndef _TESTS_PICO_STDLIB_H_
+#define _TESTS_PICO_STDLIB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PICO_ERROR_GENERIC -1
+
+#define __compiler_memory_barrier() __asm__ volatile ("" : : : "memory")
+
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+// queued, the test runs it when it wants the next transfer to start
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+
+typedef struct {
+    volatile uint32_t alarm[4];
+    volatile uint32_t timerawl;
+    volatile uint32_t intr;
+    volatile uint32_t inte;
+} timer_hw_t;
+
+extern timer_hw_t *timer_hw;
+
+static inline void hw_set_bits(volatile uint32_t *addr, uint32_t mask) { *addr |= mask; }
+static inline void hw_clear_bits(volatile uint32_t *addr, uint32_t mask) { *addr &= ~mask; }
+
+#define TIMER_IRQ_0 0
+
+typedef void (*irq_handler_t)(void);
+
+void irq_set_exclusive_handler(unsigned int num, irq_handler_t handler);
+// enabling the alarm IRQ fires it straight away, there is no time to wait out
+void irq_set_enabled(unsigned int num, bool enabled);
+
+#endif
@@ -0,0 +1,24 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The board ID the old XInput serial string was built from, never called by the tests
+
+#ifndef _TESTS_PICO_UNIQUE_ID_H_
+#define _TESTS_PICO_UNIQUE_ID_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct {
+    uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+} pico_unique_board_id_t;
+
+static inline void pico_get_unique_board_id(pico_unique_board_id_t *id_out) {
+    memset(id_out, 0, sizeof(*id_out));
+}
+
+#endif
@@ -0,0 +1,32 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The part of Storage that src/addons/analog.cpp uses, the test fills in the options
+
+#ifndef _TESTS_STORAGEMANAGER_H_
+#define _TESTS_STORAGEMANAGER_H_
+
+#include "config.pb.h"
+#include "GamepadState.h"
+
+class Gamepad {
+public:
+    GamepadState state;
+};
+
+class Storage {
+public:
+    static Storage& getInstance() {
+        static Storage instance;
+        return instance;
+    }
+    AddonOptions& getAddonOptions() { return addonOptions; }
+    Gamepad * GetGamepad() { return &gamepad; }
+
+    AddonOptions addonOptions = {};
+    Gamepad gamepad;
+};
+
+#endif
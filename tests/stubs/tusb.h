@@ -0,0 +1,66 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The TinyUSB definitions the descriptor headers use, as tusb_types.h, hid.h and usbd.h
+// define them
+
+#ifndef _TESTS_TUSB_H_
+#define _TESTS_TUSB_H_
+
+#include <stdint.h>
+
+#define TU_BIT(n)                   (1UL << (n))
+#define U16_TO_U8S_LE(_u16)         (uint8_t)((_u16) & 0xFF), (uint8_t)(((_u16) >> 8) & 0xFF)
+
+#define TUSB_DESC_DEVICE            0x01
+#define TUSB_DESC_CONFIGURATION     0x02
+#define TUSB_DESC_INTERFACE         0x04
+#define TUSB_DESC_ENDPOINT          0x05
+#define TUSB_CLASS_HID              3
+#define TUSB_DESC_CONFIG_ATT_REMOTE_WAKEUP TU_BIT(5)
+#define TUSB_XFER_INTERRUPT         3
+
+#define HID_SUBCLASS_BOOT           1
+#define HID_ITF_PROTOCOL_KEYBOARD   1
+#define HID_DESC_TYPE_HID           0x21
+#define HID_DESC_TYPE_REPORT        0x22
+#define HID_KEY_CONTROL_LEFT        0xE0
+
+#define CFG_TUD_HID_EP_BUFSIZE      64
+
+typedef struct __attribute__((packed)) {
+    uint8_t  bLength;
+    uint8_t  bDescriptorType;
+    uint16_t bcdUSB;
+    uint8_t  bDeviceClass;
+    uint8_t  bDeviceSubClass;
+    uint8_t  bDeviceProtocol;
+    uint8_t  bMaxPacketSize0;
+    uint16_t idVendor;
+    uint16_t idProduct;
+    uint16_t bcdDevice;
+    uint8_t  iManufacturer;
+    uint8_t  iProduct;
+    uint8_t  iSerialNumber;
+    uint8_t  bNumConfigurations;
+} tusb_desc_device_t;
+
+#define TUD_CONFIG_DESC_LEN         (9)
+#define TUD_HID_DESC_LEN            (9 + 9 + 7)
+
+// Config number, interface count, string index, total length, attribute, power in mA
+#define TUD_CONFIG_DESCRIPTOR(config_num, _itfcount, _stridx, _total_len, _attribute, _power_ma) \
+  9, TUSB_DESC_CONFIGURATION, U16_TO_U8S_LE(_total_len), _itfcount, config_num, _stridx, TU_BIT(7) | _attribute, (_power_ma)/2
+
+// Interface number, string index, protocol, report descriptor len, EP In address, size & polling interval
+#define TUD_HID_DESCRIPTOR(_itfnum, _stridx, _boot_protocol, _report_desc_len, _epin, _epsize, _ep_interval) \
+  /* Interface */\
+  9, TUSB_DESC_INTERFACE, _itfnum, 0, 1, TUSB_CLASS_HID, (uint8_t)((_boot_protocol) ? (uint8_t)HID_SUBCLASS_BOOT : 0), _boot_protocol, _stridx,\
+  /* HID descriptor */\
+  9, HID_DESC_TYPE_HID, U16_TO_U8S_LE(0x0111), 0, 1, HID_DESC_TYPE_REPORT, U16_TO_U8S_LE(_report_desc_len),\
+  /* Endpoint In */\
+  7, TUSB_DESC_ENDPOINT, _epin, TUSB_XFER_INTERRUPT, U16_TO_U8S_LE(_epsize), _ep_interval
+
+#endif
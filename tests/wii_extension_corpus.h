@@ -0,0 +1,187 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+Report sequences for each extension type WiiExtension::start() recognises, laid out the
+way the controllers send them after the unencrypted init (0xF0 0x55, 0xFB 0x00) and the
+0xFE data format write. Each one has an idle report, presses and releases, and reports
+sent twice in a row, which poll() no longer decodes.
+
+Calibration blocks are the 32 bytes read from 0x20. The Nunchuck block has a valid
+checksum, the others fall back to the extension defaults like a third party controller
+that leaves the block blank.
+*/
+
+#ifndef _TESTS_WII_EXTENSION_CORPUS_H_
+#define _TESTS_WII_EXTENSION_CORPUS_H_
+
+#include <stdint.h>
+
+#include "WiiExtension.h"
+
+#define WII_CORPUS_MAX_REPORTS 12
+
+struct WiiCorpus {
+    const char *name;
+    bool motionPlus;                // answers at 0x53 until 0xFE is written, then at 0x52
+    uint8_t id[6];                  // read from 0xFA
+    uint8_t calibration[32];        // read from 0x20
+    int8_t extensionType;
+    uint8_t frameLength;
+    uint8_t reportCount;
+    uint8_t reports[WII_CORPUS_MAX_REPORTS][WII_EXTENSION_FRAME_SIZE];
+};
+
+static const WiiCorpus wiiCorpus[] = {
+    {
+        "nunchuck", false,
+        { 0x00, 0x00, 0xA4, 0x20, 0x00, 0x00 },
+        {
+            0x80, 0x80, 0x80, 0x00, 0xB3, 0xB3, 0xB3, 0x00, 0xE0, 0x20, 0x80, 0xE0, 0x20, 0x80, 0xEE, 0x43,
+            0x80, 0x80, 0x80, 0x00, 0xB3, 0xB3, 0xB3, 0x00, 0xE0, 0x20, 0x80, 0xE0, 0x20, 0x80, 0xEE, 0x43,
+        },
+        WII_EXTENSION_NUNCHUCK, 6, 8,
+        {
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x93 },     // idle
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x93 },
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x92 },     // Z
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x92 },
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x90 },     // Z + C
+            { 0xE0, 0x80, 0x81, 0x80, 0xB3, 0x93 },     // stick right, accelerometer X moves
+            { 0xE0, 0x80, 0x81, 0x80, 0xB3, 0x93 },
+            { 0x80, 0x80, 0x80, 0x80, 0xB3, 0x93 },     // idle
+        },
+    },
+    {
+        "classic", false,
+        { 0x00, 0x00, 0xA4, 0x20, 0x03, 0x01 },
+        {},
+        WII_EXTENSION_CLASSIC, 8, 9,
+        {
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xFF },     // idle
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xFF },
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xEF },     // A
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xEF },
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xEE },     // A + up
+            { 0x80, 0x80, 0x80, 0x80, 0xF0, 0x10, 0xDF, 0xFF },     // L trigger all the way, L click
+            { 0x20, 0x80, 0x80, 0xE0, 0x10, 0x10, 0xFB, 0xFF },     // left stick left, right stick down, plus
+            { 0x20, 0x80, 0x80, 0xE0, 0x10, 0x10, 0xFB, 0xFF },
+            { 0x80, 0x80, 0x80, 0x80, 0x10, 0x10, 0xFF, 0xFF },     // idle
+        },
+    },
+    {
+        "guitar (Guitar Hero 3)", false,
+        { 0x00, 0x00, 0xA4, 0x20, 0x03, 0x03 },
+        {},
+        WII_EXTENSION_GUITAR, 8, 8,
+        {
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xFF, 0xFF },     // idle, bit 7 of the stick marks a GH3 guitar
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xFF, 0xEF },     // green
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xBF, 0xEF },     // green, strum down
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xBF, 0xEF },
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xFF, 0xEF },     // green
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x40, 0xFF, 0xFF },     // whammy
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x40, 0xFF, 0xFF },
+            { 0xA0, 0x80, 0x80, 0x80, 0x00, 0x00, 0xFF, 0xFF },     // idle
+        },
+    },
+    {
+        "guitar (World Tour)", false,
+        { 0x00, 0x00, 0xA4, 0x20, 0x03, 0x03 },
+        {},
+        WII_EXTENSION_GUITAR, 8, 7,
+        {
+            { 0x20, 0x20, 0x0F, 0x10, 0xFF, 0xFF, 0x00, 0x00 },     // idle, sends the 6 byte layout
+            { 0x20, 0x20, 0x0F, 0x10, 0xFF, 0xFF, 0x00, 0x00 },
+            { 0x20, 0x20, 0x04, 0x10, 0xFF, 0xFF, 0x00, 0x00 },     // touch bar on green
+            { 0x20, 0x20, 0x04, 0x10, 0xFF, 0xFF, 0x00, 0x00 },
+            { 0x20, 0x20, 0x0F, 0x10, 0xFF, 0xB7, 0x00, 0x00 },     // red + yellow
+            { 0x20, 0x20, 0x0F, 0x10, 0xFF, 0xB7, 0x00, 0x00 },
+            { 0x20, 0x20, 0x0F, 0x10, 0xFF, 0xFF, 0x00, 0x00 },     // idle
+        },
+    },
+    {
+        "drums", false,
+        { 0x01, 0x00, 0xA4, 0x20, 0x01, 0x03 },
+        {},
+        WII_EXTENSION_DRUMS, 6, 7,
+        {
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFF, 0xFF },     // idle
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFF, 0xBF },     // red
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFF, 0xBF },
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFF, 0xFB },     // pedal
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFB, 0xFF },     // plus
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFB, 0xFF },
+            { 0x20, 0x20, 0xFF, 0xFF, 0xFF, 0xFF },     // idle
+        },
+    },
+    {
+        "turntable", false,
+        { 0x03, 0x00, 0xA4, 0x20, 0x01, 0x03 },
+        {},
+        WII_EXTENSION_TURNTABLE, 6, 7,
+        {
+            { 0x20, 0x20, 0x10, 0x00, 0xFF, 0xFF },     // idle
+            { 0x20, 0x20, 0x10, 0x00, 0xFF, 0xEF },     // euphoria
+            { 0x20, 0x20, 0x10, 0x00, 0xFF, 0xEF },
+            { 0x20, 0x20, 0x10, 0x00, 0xDF, 0xF7 },     // left red + left green
+            { 0x20, 0x20, 0x10, 0x02, 0xFF, 0xFF },     // left table turning
+            { 0x20, 0x20, 0x10, 0x02, 0xFF, 0xFF },
+            { 0x20, 0x20, 0x10, 0x00, 0xFF, 0xFF },     // idle
+        },
+    },
+    {
+        "taiko", false,
+        { 0x00, 0x00, 0xA4, 0x20, 0x01, 0x11 },
+        {},
+        WII_EXTENSION_TAIKO, 6, 7,
+        {
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },     // idle
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF },     // don left
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF },
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xAF },     // don left + don right
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7 },     // kat right
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7 },
+            { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF },     // idle
+        },
+    },
+    {
+        "udraw", false,
+        { 0xFF, 0x00, 0xA4, 0x20, 0x01, 0x12 },
+        {},
+        WII_EXTENSION_UDRAW, 6, 7,
+        {
+            { 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFB },     // pen away from the tablet
+            { 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFB },
+            { 0x23, 0x56, 0x41, 0x08, 0xFF, 0xFB },     // hovering at 0x123, 0x456
+            { 0x23, 0x56, 0x41, 0x40, 0xFF, 0xFF },     // tip down
+            { 0x23, 0x56, 0x41, 0x40, 0xFF, 0xFF },
+            { 0x23, 0x56, 0x41, 0x08, 0xFF, 0xFA },     // lower side button
+            { 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFB },     // away
+        },
+    },
+    {
+        "motion plus (nunchuck passthrough)", true,
+        { 0x00, 0x00, 0xA4, 0x20, 0x05, 0x05 },
+        {},
+        WII_EXTENSION_MOTION_PLUS, 16, 11,
+        {
+            // gyro reports set bit 1 of byte 5, extension reports clear it and alternate with them
+            { 0x00, 0x00, 0x00, 0x43, 0x43, 0x42 },     // gyro spinning fast, below the resting range
+            { 0x80, 0x80, 0x80, 0x7F, 0x7F, 0x7E },     // gyro at rest, taken as the starting orientation
+            { 0x80, 0x80, 0x80, 0x7F, 0x7F, 0x7E },
+            { 0x80, 0x80, 0x80, 0x80, 0x81, 0x0C },     // nunchuck idle
+            { 0x80, 0x80, 0x80, 0x80, 0x81, 0x0C },
+            { 0x00, 0x80, 0x80, 0x83, 0x7F, 0x7E },     // gyro turning on yaw
+            { 0x00, 0x80, 0x80, 0x83, 0x7F, 0x7E },
+            { 0x80, 0x80, 0x80, 0x80, 0x81, 0x08 },     // nunchuck Z
+            { 0xE0, 0x80, 0x80, 0x80, 0x81, 0x08 },     // nunchuck Z, stick right
+            { 0x80, 0x80, 0x80, 0x7F, 0x7F, 0x7E },     // gyro back at rest
+            { 0x80, 0x80, 0x80, 0x7F, 0x7F, 0x7E },
+        },
+    },
+};
+
+#endif
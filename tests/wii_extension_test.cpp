@@ -0,0 +1,353 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+WiiExtension::poll() against decoding every report, for each type in wii_extension_corpus.h.
+
+A fake extension answers the init, ID and calibration reads the way the controller would and
+then hands out the corpus reports one at a time. A second decoder of the same type, set up
+with the same data type and calibration, runs update() on every report like poll() did
+before it skipped repeated ones. After each report both must hold the same buttons, analog
+and motion state, and poll() must say it decoded exactly the reports that differ from the
+one before. Both the blocking bus and the background polling steps are run.
+
+A few hand worked checks then make sure the decode itself is right for each type.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "WiiExtension.h"
+#include "wii_extension_corpus.h"
+
+//
+// Pico SDK stubs
+//
+
+static timer_hw_t timerRegisters;
+timer_hw_t *timer_hw = &timerRegisters;
+
+static irq_handler_t alarmHandler = nullptr;
+
+void irq_set_exclusive_handler(unsigned int /*num*/, irq_handler_t handler) {
+    alarmHandler = handler;
+}
+
+void irq_set_enabled(unsigned int /*num*/, bool enabled) {
+    if (enabled && alarmHandler)
+        alarmHandler();
+}
+
+static alarm_callback_t pendingAlarm = nullptr;
+static void *pendingAlarmData = nullptr;
+
+alarm_id_t add_alarm_in_us(uint64_t /*us*/, alarm_callback_t callback, void *user_data, bool /*fire_if_past*/) {
+    pendingAlarm = callback;
+    pendingAlarmData = user_data;
+    return 1;
+}
+
+static bool runAlarm() {
+    alarm_callback_t callback = pendingAlarm;
+    if (!callback)
+        return false;
+    pendingAlarm = nullptr;
+    callback(1, pendingAlarmData);
+    return true;
+}
+
+//
+// Fake extension on the bus
+//
+
+struct FakeExtension {
+    const WiiCorpus *corpus = nullptr;
+    bool motionPlusActive = false;
+    uint8_t reg = 0;
+    uint8_t report[WII_EXTENSION_FRAME_SIZE];
+    uint32_t reportReads = 0;
+
+    void load(const WiiCorpus *c) {
+        corpus = c;
+        motionPlusActive = false;
+        reg = 0;
+        reportReads = 0;
+        memset(report, 0, sizeof(report));
+    }
+
+    bool answers(uint8_t address) {
+        if (corpus->motionPlus && !motionPlusActive)
+            return (address == WII_MOTIONPLUS_I2C_ADDR);
+        return (address == WII_EXTENSION_I2C_ADDR);
+    }
+
+    int16_t read(uint8_t address, uint8_t *data, uint16_t len) {
+        if (!answers(address))
+            return PICO_ERROR_GENERIC;
+        for (uint16_t i = 0; i < len; i++) {
+            if (reg == 0xFA)
+                data[i] = (i < sizeof(corpus->id)) ? corpus->id[i] : 0;
+            else if (reg == 0x20)
+                data[i] = (i < sizeof(corpus->calibration)) ? corpus->calibration[i] : 0;
+            else if (reg == 0x00)
+                data[i] = (i < sizeof(report)) ? report[i] : 0;
+            else
+                data[i] = 0;
+        }
+        if (reg == 0x00)
+            reportReads++;
+        return len;
+    }
+
+    int16_t write(uint8_t address, const uint8_t *data, uint16_t len) {
+        if (!answers(address))
+            return PICO_ERROR_GENERIC;
+        if (len > 0)
+            reg = data[0];
+        // the Motion Plus moves to the extension address once it is switched on
+        if (corpus->motionPlus && (len == 2) && (data[0] == 0xFE))
+            motionPlusActive = true;
+        return len;
+    }
+};
+
+static FakeExtension device;
+static bool busAsync = false;
+
+int16_t PeripheralI2C::read(uint8_t address, uint8_t *data, uint16_t len, bool /*isBlock*/) {
+    return device.read(address, data, len);
+}
+
+int16_t PeripheralI2C::write(uint8_t address, uint8_t *data, uint16_t len, bool /*isBlock*/) {
+    return device.write(address, data, len);
+}
+
+bool PeripheralI2C::submit(I2CTransaction *transaction) {
+    int16_t result = 0;
+    if (transaction->txLen > 0)
+        result = device.write(transaction->address, transaction->tx, transaction->txLen);
+    if ((result >= 0) && (transaction->rxLen > 0))
+        result = device.read(transaction->address, transaction->rx, transaction->rxLen);
+    transaction->result = result;
+    if (transaction->callback)
+        transaction->callback(transaction);
+    transaction->done = true;
+    return true;
+}
+
+bool PeripheralI2C::isAsync() {
+    return busAsync;
+}
+
+uint8_t PeripheralI2C::test(uint8_t address) {
+    return device.answers(address);
+}
+
+//
+// Checks
+//
+
+static int failures = 0;
+
+static void fail(const WiiCorpus &corpus, bool async, int report, const char *what) {
+    if (failures++ >= 20)
+        return;
+    printf("%s (%s) report %d: %s\n", corpus.name, async ? "background" : "blocking", report, what);
+}
+
+static ExtensionBase *newController(int8_t extensionType) {
+    switch (extensionType) {
+        case WII_EXTENSION_NUNCHUCK: return new NunchuckExtension();
+        case WII_EXTENSION_CLASSIC: return new ClassicExtension();
+        case WII_EXTENSION_GUITAR: return new GuitarExtension();
+        case WII_EXTENSION_DRUMS: return new DrumExtension();
+        case WII_EXTENSION_TURNTABLE: return new TurntableExtension();
+        case WII_EXTENSION_TAIKO: return new TaikoExtension();
+        case WII_EXTENSION_UDRAW: return new UDrawExtension();
+        case WII_EXTENSION_MOTION_PLUS: return new MotionPlusExtension();
+        default: return nullptr;
+    }
+}
+
+static bool sameState(ExtensionBase *a, ExtensionBase *b) {
+    return (memcmp(a->buttons, b->buttons, sizeof(a->buttons)) == 0) &&
+        (memcmp(a->analogState, b->analogState, sizeof(a->analogState)) == 0) &&
+        (memcmp(a->motionState, b->motionState, sizeof(a->motionState)) == 0);
+}
+
+static void runCorpus(const WiiCorpus &corpus, bool async) {
+    device.load(&corpus);
+    busAsync = async;
+    pendingAlarm = nullptr;
+
+    PeripheralI2C bus;
+    WiiExtension extension(&bus, WII_EXTENSION_I2C_ADDR);
+    extension.begin();
+    extension.start();
+    if (!extension.isReady || (extension.extensionType != corpus.extensionType)) {
+        fail(corpus, async, -1, "not detected");
+        return;
+    }
+
+    ExtensionBase *reference = newController(corpus.extensionType);
+    reference->init(extension.dataType);
+    reference->setExtensionType(extension.extensionType);
+    uint8_t calibration[sizeof(corpus.calibration)];
+    memcpy(calibration, corpus.calibration, sizeof(calibration));
+    reference->calibrate(calibration);
+
+    for (int i = 0; i < corpus.reportCount; i++) {
+        memcpy(device.report, corpus.reports[i], sizeof(device.report));
+
+        // the first poll() starts the background reads itself
+        if (async && (i > 0)) {
+            uint32_t reads = device.reportReads;
+            for (int step = 0; (step < 8) && (device.reportReads == reads); step++)
+                runAlarm();
+            if (device.reportReads == reads) {
+                fail(corpus, async, i, "background polling stopped");
+                break;
+            }
+        }
+
+        bool decoded = extension.poll();
+        bool changed = (i == 0) || (memcmp(corpus.reports[i], corpus.reports[i - 1], corpus.frameLength) != 0);
+        if (decoded != changed)
+            fail(corpus, async, i, changed ? "changed report not decoded" : "repeated report decoded");
+
+        uint8_t report[WII_EXTENSION_FRAME_SIZE];
+        memcpy(report, corpus.reports[i], sizeof(report));
+        reference->update(report);
+
+        if (!sameState(extension.getController(), reference))
+            fail(corpus, async, i, "state differs from decoding every report");
+    }
+
+    delete reference;
+}
+
+//
+// Decode checks, worked out from the report layouts
+//
+
+enum WiiCheckKind { CHECK_BUTTON, CHECK_ANALOG, CHECK_MOTION };
+
+struct WiiDecodeCheck {
+    const char *corpus;
+    uint8_t report;
+    WiiCheckKind kind;
+    uint8_t index;
+    int32_t value;
+};
+
+static const WiiDecodeCheck decodeChecks[] = {
+    { "nunchuck", 0, CHECK_BUTTON, WII_BUTTON_Z, 0 },
+    { "nunchuck", 0, CHECK_BUTTON, WII_BUTTON_C, 0 },
+    { "nunchuck", 0, CHECK_MOTION, WII_ACCELEROMETER_X, (0x80 << 2) | 0 },
+    { "nunchuck", 0, CHECK_MOTION, WII_ACCELEROMETER_Z, (0xB3 << 2) | 2 },
+    { "nunchuck", 0, CHECK_ANALOG, WII_ANALOG_LEFT_X, 516 },        // centre of the calibrated 10..1023 range
+    { "nunchuck", 2, CHECK_BUTTON, WII_BUTTON_Z, 1 },
+    { "nunchuck", 4, CHECK_BUTTON, WII_BUTTON_C, 1 },
+    { "nunchuck", 5, CHECK_BUTTON, WII_BUTTON_Z, 0 },
+    { "nunchuck", 5, CHECK_MOTION, WII_ACCELEROMETER_X, (0x81 << 2) | 0 },
+    { "nunchuck", 5, CHECK_ANALOG, WII_ANALOG_LEFT_X, 1016 },       // calibrated maximum, one step in from the end
+    { "classic", 0, CHECK_BUTTON, WII_BUTTON_A, 0 },
+    { "classic", 2, CHECK_BUTTON, WII_BUTTON_A, 1 },
+    { "classic", 4, CHECK_BUTTON, WII_BUTTON_UP, 1 },
+    { "classic", 5, CHECK_BUTTON, WII_BUTTON_A, 0 },
+    { "classic", 5, CHECK_BUTTON, WII_BUTTON_L, 1 },
+    { "classic", 6, CHECK_BUTTON, WII_BUTTON_PLUS, 1 },
+    { "classic", 6, CHECK_BUTTON, WII_BUTTON_L, 0 },
+    { "guitar (Guitar Hero 3)", 1, CHECK_BUTTON, GUITAR_GREEN, 1 },
+    { "guitar (Guitar Hero 3)", 2, CHECK_BUTTON, WII_BUTTON_DOWN, 1 },
+    { "guitar (Guitar Hero 3)", 4, CHECK_BUTTON, WII_BUTTON_DOWN, 0 },
+    { "guitar (Guitar Hero 3)", 5, CHECK_BUTTON, GUITAR_GREEN, 0 },
+    { "guitar (World Tour)", 0, CHECK_BUTTON, GUITAR_GREEN, 0 },
+    { "guitar (World Tour)", 2, CHECK_BUTTON, GUITAR_GREEN, 1 },
+    { "guitar (World Tour)", 2, CHECK_BUTTON, WII_BUTTON_DOWN, 1 },   // touching the bar strums
+    { "guitar (World Tour)", 4, CHECK_BUTTON, GUITAR_GREEN, 0 },
+    { "guitar (World Tour)", 4, CHECK_BUTTON, GUITAR_RED, 1 },
+    { "guitar (World Tour)", 4, CHECK_BUTTON, GUITAR_YELLOW, 1 },
+    { "drums", 1, CHECK_BUTTON, DRUM_RED, 1 },
+    { "drums", 3, CHECK_BUTTON, DRUM_RED, 0 },
+    { "drums", 3, CHECK_BUTTON, DRUM_PEDAL, 1 },
+    { "drums", 4, CHECK_BUTTON, WII_BUTTON_PLUS, 1 },
+    { "turntable", 1, CHECK_BUTTON, TURNTABLE_EUPHORIA, 1 },
+    { "turntable", 3, CHECK_BUTTON, TURNTABLE_LEFT_RED, 1 },
+    { "turntable", 3, CHECK_BUTTON, TURNTABLE_LEFT_GREEN, 1 },
+    { "turntable", 3, CHECK_BUTTON, TURNTABLE_EUPHORIA, 0 },
+    { "taiko", 0, CHECK_BUTTON, TATA_DON_LEFT, 0 },
+    { "taiko", 1, CHECK_BUTTON, TATA_DON_LEFT, 1 },
+    { "taiko", 3, CHECK_BUTTON, TATA_DON_RIGHT, 1 },
+    { "taiko", 4, CHECK_BUTTON, TATA_DON_LEFT, 0 },
+    { "taiko", 4, CHECK_BUTTON, TATA_KAT_RIGHT, 1 },
+    { "udraw", 0, CHECK_MOTION, WII_TOUCH_PRESSED, 0 },
+    { "udraw", 2, CHECK_MOTION, WII_TOUCH_PRESSED, 1 },
+    { "udraw", 2, CHECK_MOTION, WII_TOUCH_X, 0x123 },
+    { "udraw", 2, CHECK_MOTION, WII_TOUCH_Z, 0x08 },
+    { "udraw", 3, CHECK_MOTION, WII_TOUCH_Z, 0x40 },
+    { "udraw", 3, CHECK_BUTTON, WII_BUTTON_A, 1 },
+    { "udraw", 5, CHECK_BUTTON, WII_BUTTON_A, 0 },
+    { "udraw", 5, CHECK_BUTTON, WII_BUTTON_R, 1 },
+    { "motion plus (nunchuck passthrough)", 0, CHECK_MOTION, WII_GYROSCOPE_YAW, 0x1000 },
+    { "motion plus (nunchuck passthrough)", 1, CHECK_MOTION, WII_GYROSCOPE_YAW, 0 },
+    { "motion plus (nunchuck passthrough)", 2, CHECK_MOTION, WII_GYROSCOPE_YAW, 0 },
+    { "motion plus (nunchuck passthrough)", 3, CHECK_BUTTON, WII_BUTTON_Z, 0 },
+    { "motion plus (nunchuck passthrough)", 5, CHECK_MOTION, WII_GYROSCOPE_YAW, 0x2000 - 0x1F80 },
+    { "motion plus (nunchuck passthrough)", 7, CHECK_BUTTON, WII_BUTTON_Z, 1 },
+    { "motion plus (nunchuck passthrough)", 10, CHECK_MOTION, WII_GYROSCOPE_YAW, 0 },
+};
+
+static void runDecodeChecks(const WiiCorpus &corpus) {
+    device.load(&corpus);
+    busAsync = false;
+
+    PeripheralI2C bus;
+    WiiExtension extension(&bus, WII_EXTENSION_I2C_ADDR);
+    extension.begin();
+    extension.start();
+    if (!extension.isReady)
+        return;
+
+    for (int i = 0; i < corpus.reportCount; i++) {
+        memcpy(device.report, corpus.reports[i], sizeof(device.report));
+        extension.poll();
+
+        ExtensionBase *controller = extension.getController();
+        for (const WiiDecodeCheck &check : decodeChecks) {
+            if ((strcmp(check.corpus, corpus.name) != 0) || (check.report != i))
+                continue;
+            int32_t actual;
+            if (check.kind == CHECK_BUTTON)
+                actual = controller->buttons[check.index];
+            else if (check.kind == CHECK_ANALOG)
+                actual = controller->analogState[check.index];
+            else
+                actual = controller->motionState[check.index];
+            if (actual != check.value) {
+                char what[64];
+                snprintf(what, sizeof(what), "%s %d expected %d, got %d",
+                    (check.kind == CHECK_BUTTON) ? "button" : (check.kind == CHECK_ANALOG) ? "analog" : "motion",
+                    check.index, check.value, actual);
+                fail(corpus, false, i, what);
+            }
+        }
+    }
+}
+
+int main() {
+    for (const WiiCorpus &corpus : wiiCorpus) {
+        runCorpus(corpus, false);
+        runCorpus(corpus, true);
+        runDecodeChecks(corpus);
+    }
+
+    if (failures != 0) {
+        printf("%d failures\n", failures);
+        return 1;
+    }
+    printf("WiiExtension decodes the same state as decoding every report\n");
+    return 0;
+}
@@ -0,0 +1,446 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+/*
+Throughput benchmark for the web config network stack, without a TAP device.
+
+The process forks into a device and a host. The device runs lib/rndis/rndis.c, lwIP and httpd
+exactly as the firmware does, with TinyUSB replaced by a SOCK_SEQPACKET socketpair that carries
+one Ethernet frame per packet. The host is a second lwIP instance with a static address that
+fetches pages over plain HTTP/1.0, like a browser on first load.
+
+TinyUSB has a single transmit buffer, so the device can only have one frame in flight. -r sets
+the rate that frame drains at, to approximate a full speed USB link (~8000 kbit/s in practice).
+
+  rndis_bench [-r kbit/s] [-n runs] [path...]
+
+With no paths, / is fetched and every /assets/ file it references is fetched after it.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <zlib.h>
+
+#include "tusb.h"
+#include "rndis.h"
+#include "fs.h"
+
+#include "lwip/init.h"
+#include "lwip/etharp.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/timeouts.h"
+#include "lwip/apps/httpd.h"
+#include "netif/ethernet.h"
+
+#define FETCH_TIMEOUT_MS 10000
+#define MAX_PATHS 64
+
+static int link_fd = -1;
+
+static uint64_t now_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+absolute_time_t get_absolute_time(void)
+{
+  return now_us();
+}
+
+/*
+device side: TinyUSB network class
+*/
+
+static uint8_t usb_rx_buffer[CFG_TUD_NET_MTU];
+static bool usb_rx_armed = true;
+static uint32_t usb_rate_kbps;
+static uint64_t usb_tx_busy_until;
+
+bool tud_ready(void)
+{
+  return true;
+}
+
+bool tud_network_can_xmit(uint16_t size)
+{
+  (void)size;
+  return now_us() >= usb_tx_busy_until;
+}
+
+void tud_network_xmit(void *ref, uint16_t arg)
+{
+  uint8_t frame[CFG_TUD_NET_MTU];
+  uint16_t len = tud_network_xmit_cb(frame, ref, arg);
+
+  send(link_fd, frame, len, 0);
+  if (usb_rate_kbps)
+    usb_tx_busy_until = now_us() + ((uint64_t)len * 8 * 1000) / usb_rate_kbps;
+}
+
+void tud_network_recv_renew(void)
+{
+  usb_rx_armed = true;
+}
+
+void tud_task(void)
+{
+  if (!usb_rx_armed)
+    return;
+
+  ssize_t len = recv(link_fd, usb_rx_buffer, sizeof(usb_rx_buffer), MSG_DONTWAIT);
+  if (len <= 0)
+    return;
+
+  /* like TinyUSB, renew on the application's behalf if it does not take the frame */
+  usb_rx_armed = false;
+  if (!tud_network_recv_cb(usb_rx_buffer, (uint16_t)len))
+    usb_rx_armed = true;
+}
+
+/* webconfig.cpp provides these in the firmware, the benchmark only serves fsdata */
+int fs_open_custom(struct fs_file *file, const char *name)
+{
+  (void)file;
+  (void)name;
+  return 0;
+}
+
+void fs_close_custom(struct fs_file *file)
+{
+  (void)file;
+}
+
+err_t httpd_post_begin(void *connection, const char *uri, const char *http_request,
+                       u16_t http_request_len, int content_len, char *response_uri,
+                       u16_t response_uri_len, u8_t *post_auto_wnd)
+{
+  return ERR_VAL;
+}
+
+err_t httpd_post_receive_data(void *connection, struct pbuf *p)
+{
+  pbuf_free(p);
+  return ERR_VAL;
+}
+
+void httpd_post_finished(void *connection, char *response_uri, u16_t response_uri_len)
+{
+}
+
+static void run_device(pid_t host)
+{
+  rndis_init("gp2040-bench");
+  tud_network_init_cb();
+
+  for (uint32_t i = 0;; i++)
+  {
+    rndis_task();
+    if ((i & 0xFFF) == 0 && waitpid(host, NULL, WNOHANG) == host)
+      return;
+  }
+}
+
+/*
+host side: a second lwIP instance fetching over HTTP
+*/
+
+static struct netif host_netif;
+
+typedef struct
+{
+  const char *path;
+  bool capture;
+  bool done;
+  bool failed;
+  size_t received;
+  uint8_t *data;
+  size_t data_len;
+} fetch_t;
+
+static err_t host_linkoutput(struct netif *netif, struct pbuf *p)
+{
+  uint8_t frame[CFG_TUD_NET_MTU];
+  (void)netif;
+
+  if (p->tot_len > sizeof(frame))
+    return ERR_MEM;
+  pbuf_copy_partial(p, frame, p->tot_len, 0);
+  send(link_fd, frame, p->tot_len, 0);
+  return ERR_OK;
+}
+
+static err_t host_netif_init(struct netif *netif)
+{
+  netif->mtu = CFG_TUD_NET_MTU - SIZEOF_ETH_HDR;
+  netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_LINK_UP | NETIF_FLAG_UP;
+  netif->name[0] = 'H';
+  netif->name[1] = 'O';
+  netif->linkoutput = host_linkoutput;
+  netif->output = etharp_output;
+  return ERR_OK;
+}
+
+static void host_poll(void)
+{
+  uint8_t frame[CFG_TUD_NET_MTU];
+  ssize_t len;
+
+  while ((len = recv(link_fd, frame, sizeof(frame), MSG_DONTWAIT)) > 0)
+  {
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)len, PBUF_POOL);
+    if (!p)
+      continue;
+    pbuf_take(p, frame, (u16_t)len);
+    if (host_netif.input(p, &host_netif) != ERR_OK)
+      pbuf_free(p);
+  }
+  sys_check_timeouts();
+}
+
+static err_t host_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+  fetch_t *fetch = (fetch_t *)arg;
+
+  if (!p)
+  {
+    fetch->done = true;
+    tcp_arg(pcb, NULL);
+    tcp_close(pcb);
+    return ERR_OK;
+  }
+
+  if (fetch->capture)
+  {
+    fetch->data = realloc(fetch->data, fetch->data_len + p->tot_len);
+    pbuf_copy_partial(p, fetch->data + fetch->data_len, p->tot_len, 0);
+    fetch->data_len += p->tot_len;
+  }
+  fetch->received += p->tot_len;
+  tcp_recved(pcb, p->tot_len);
+  pbuf_free(p);
+  return ERR_OK;
+}
+
+static void host_err(void *arg, err_t err)
+{
+  fetch_t *fetch = (fetch_t *)arg;
+  if (fetch)
+  {
+    fetch->failed = true;
+    fetch->done = true;
+  }
+}
+
+static err_t host_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+  fetch_t *fetch = (fetch_t *)arg;
+  char request[256];
+
+  int len = snprintf(request, sizeof(request),
+                     "GET %s HTTP/1.0\r\nHost: 192.168.7.1\r\nAccept-Encoding: gzip, deflate\r\n\r\n", fetch->path);
+  tcp_write(pcb, request, (u16_t)len, TCP_WRITE_FLAG_COPY);
+  tcp_output(pcb);
+  return ERR_OK;
+}
+
+static bool http_get(fetch_t *fetch)
+{
+  ip_addr_t device;
+  IP4_ADDR(ip_2_ip4(&device), 192, 168, 7, 1);
+
+  struct tcp_pcb *pcb = tcp_new();
+  if (!pcb)
+    return false;
+
+  tcp_arg(pcb, fetch);
+  tcp_recv(pcb, host_recv);
+  tcp_err(pcb, host_err);
+  if (tcp_connect(pcb, &device, 80, host_connected) != ERR_OK)
+  {
+    tcp_abort(pcb);
+    return false;
+  }
+
+  uint64_t deadline = now_us() + (uint64_t)FETCH_TIMEOUT_MS * 1000;
+  while (!fetch->done)
+  {
+    host_poll();
+    if (now_us() > deadline)
+    {
+      tcp_arg(pcb, NULL);
+      tcp_abort(pcb);
+      return false;
+    }
+  }
+  return !fetch->failed;
+}
+
+/* pull the /assets/ references out of the (gzipped) index page */
+static int find_assets(const fetch_t *index, char paths[][128], int max)
+{
+  const uint8_t *body = NULL;
+  for (size_t i = 0; i + 3 < index->data_len; i++)
+  {
+    if (memcmp(index->data + i, "\r\n\r\n", 4) == 0)
+    {
+      body = index->data + i + 4;
+      break;
+    }
+  }
+  if (!body)
+    return 0;
+
+  size_t body_len = index->data_len - (body - index->data);
+  size_t html_len = 1024 * 1024;
+  char *html = malloc(html_len + 1);
+
+  z_stream stream = { 0 };
+  stream.next_in = (Bytef *)body;
+  stream.avail_in = (uInt)body_len;
+  stream.next_out = (Bytef *)html;
+  stream.avail_out = (uInt)html_len;
+  if (inflateInit2(&stream, 15 + 32 /* zlib or gzip */) == Z_OK && inflate(&stream, Z_FINISH) == Z_STREAM_END)
+  {
+    html_len = stream.total_out;
+  }
+  else
+  {
+    /* not compressed */
+    html_len = body_len < html_len ? body_len : html_len;
+    memcpy(html, body, html_len);
+  }
+  inflateEnd(&stream);
+  html[html_len] = '\0';
+
+  int count = 0;
+  for (char *p = strstr(html, "/assets/"); p && count < max; p = strstr(p + 1, "/assets/"))
+  {
+    size_t len = strcspn(p, "\"' >");
+    if (len >= sizeof(paths[0]))
+      continue;
+    memcpy(paths[count], p, len);
+    paths[count][len] = '\0';
+    count++;
+  }
+
+  free(html);
+  return count;
+}
+
+static int run_host(int argc, char **argv, int runs)
+{
+  ip4_addr_t ipaddr, netmask, gateway;
+  IP4_ADDR(&ipaddr, 192, 168, 7, 2);
+  IP4_ADDR(&netmask, 255, 255, 255, 0);
+  IP4_ADDR(&gateway, 0, 0, 0, 0);
+
+  lwip_init();
+  static const uint8_t host_mac[6] = { 0x02, 0x02, 0x84, 0x6A, 0x96, 0x02 };
+  host_netif.hwaddr_len = sizeof(host_mac);
+  memcpy(host_netif.hwaddr, host_mac, sizeof(host_mac));
+  netif_add(&host_netif, &ipaddr, &netmask, &gateway, NULL, host_netif_init, ethernet_input);
+  netif_set_default(&host_netif);
+
+  char paths[MAX_PATHS][128];
+  int count = 0;
+  for (int i = 0; i < argc && count < MAX_PATHS; i++)
+  {
+    snprintf(paths[count++], sizeof(paths[0]), "%s", argv[i]);
+  }
+
+  if (count == 0)
+  {
+    fetch_t index = { .path = "/", .capture = true };
+    if (!http_get(&index))
+    {
+      fprintf(stderr, "fetching / failed\n");
+      return 1;
+    }
+    snprintf(paths[count++], sizeof(paths[0]), "/");
+    count += find_assets(&index, &paths[count], MAX_PATHS - count);
+    free(index.data);
+  }
+
+  for (int run = 0; run < runs; run++)
+  {
+    size_t total = 0;
+    uint64_t start = now_us();
+
+    for (int i = 0; i < count; i++)
+    {
+      fetch_t file = { .path = paths[i] };
+      uint64_t file_start = now_us();
+      bool ok = http_get(&file);
+      uint64_t elapsed = now_us() - file_start;
+
+      printf("%-48s %8zu bytes %8.1f ms %8.1f KB/s%s\n", paths[i], file.received, elapsed / 1000.0,
+             elapsed ? (file.received / 1024.0) / (elapsed / 1000000.0) : 0.0, ok ? "" : "  FAILED");
+      total += file.received;
+    }
+
+    uint64_t elapsed = now_us() - start;
+    printf("run %d: %zu bytes in %.1f ms, %.1f KB/s\n\n", run + 1, total, elapsed / 1000.0,
+           elapsed ? (total / 1024.0) / (elapsed / 1000000.0) : 0.0);
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  int runs = 1;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:n:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'r':
+        usb_rate_kbps = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'n':
+        runs = atoi(optarg);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-r kbit/s] [-n runs] [path...]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) != 0)
+  {
+    perror("socketpair");
+    return 1;
+  }
+
+  pid_t host = fork();
+  if (host < 0)
+  {
+    perror("fork");
+    return 1;
+  }
+
+  if (host == 0)
+  {
+    close(fds[0]);
+    link_fd = fds[1];
+    return run_host(argc - optind, argv + optind, runs);
+  }
+
+  close(fds[1]);
+  link_fd = fds[0];
+  run_device(host);
+  return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef _RNDIS_BENCH_PICO_RAND_H_
+#define _RNDIS_BENCH_PICO_RAND_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+
+static inline uint32_t get_rand_32(void) { return (uint32_t)random(); }
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * SPDX-License-Identifier: MIT
+ * SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+ */
+
+// The parts of TinyUSB and the Pico SDK that rndis.c uses, backed by bench.c
+
+#ifndef _RNDIS_BENCH_TUSB_H_
+#define _RNDIS_BENCH_TUSB_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define CFG_TUD_NET_MTU 1514
+#define TU_ARRAY_SIZE(_arr) (sizeof(_arr) / sizeof(_arr[0]))
+
+bool tud_ready(void);
+void tud_task(void);
+bool tud_network_can_xmit(uint16_t size);
+void tud_network_xmit(void *ref, uint16_t arg);
+void tud_network_recv_renew(void);
+
+// implemented by rndis.c
+bool tud_network_recv_cb(const uint8_t *src, uint16_t size);
+uint16_t tud_network_xmit_cb(uint8_t *dst, void *ref, uint16_t arg);
+void tud_network_init_cb(void);
+
+typedef uint64_t absolute_time_t;
+absolute_time_t get_absolute_time(void);
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+
+#endif
@@ -0,0 +1,182 @@
+#!/usr/bin/env python3
+#
+# SPDX-License-Identifier: MIT
+# SPDX-FileCopyrightText: Copyright (c) 2024 OpenStickCommunity (gp2040-ce.info)
+#
+# Reads the USB telemetry interface of a GP2040-CE build made with
+# GP2040_USB_TELEMETRY=1. See headers/usbtelemetry.h for the stream format.
+#
+# Requires pyusb (pip install pyusb). On Windows the telemetry interface
+# needs the WinUSB driver (e.g. bound with Zadig), the gamepad interface
+# keeps its normal driver.
+#
+
+import argparse
+import struct
+import sys
+import time
+
+import usb.core
+import usb.util
+
+TELEMETRY_CLASS = 0xFF
+TELEMETRY_SUBCLASS = 0x47
+TELEMETRY_PROTOCOL = 0x54
+
+FRAME_MAGIC = 0xA5
+FRAME_LOOP = 0x01
+FRAME_INPUT = 0x02
+FRAME_ADDONS = 0x03
+FRAME_ADDON_NAMES = 0x04
+
+HEADER = struct.Struct('<BBH')
+LOOP = struct.Struct('<IIII16H')
+INPUT = struct.Struct('<IIHBx')
+ADDON = struct.Struct('<B3xII')
+
+
+def find_interface(vid, pid):
+    kwargs = {}
+    if vid is not None:
+        kwargs['idVendor'] = vid
+    if pid is not None:
+        kwargs['idProduct'] = pid
+
+    for device in usb.core.find(find_all=True, **kwargs):
+        try:
+            config = device.get_active_configuration()
+        except usb.core.USBError:
+            continue
+        for interface in config:
+            if (interface.bInterfaceClass, interface.bInterfaceSubClass, interface.bInterfaceProtocol) == \
+                    (TELEMETRY_CLASS, TELEMETRY_SUBCLASS, TELEMETRY_PROTOCOL):
+                return device, interface
+    return None, None
+
+
+def percentile(bins, fraction):
+    total = sum(bins)
+    if total == 0:
+        return 0
+    target = total * fraction
+    seen = 0
+    for index, count in enumerate(bins):
+        seen += count
+        if seen >= target:
+            return 1 << index  # upper bound of the bin in us
+    return 1 << (len(bins) - 1)
+
+
+class Reader:
+    def __init__(self, args):
+        self.args = args
+        self.stream = bytearray()
+        self.names = {}
+        self.addons = {}
+        self.lastDropped = 0
+
+    def feed(self, data):
+        self.stream += data
+        while len(self.stream) >= HEADER.size:
+            magic, frameType, length = HEADER.unpack_from(self.stream)
+            if magic != FRAME_MAGIC:
+                # resync on the next magic byte
+                del self.stream[0]
+                continue
+            if len(self.stream) < HEADER.size + length:
+                break
+            payload = bytes(self.stream[HEADER.size:HEADER.size + length])
+            del self.stream[:HEADER.size + length]
+            self.frame(frameType, payload)
+
+    def frame(self, frameType, payload):
+        if frameType == FRAME_LOOP and len(payload) == LOOP.size:
+            self.loop(LOOP.unpack(payload))
+        elif frameType == FRAME_INPUT:
+            for offset in range(0, len(payload) - INPUT.size + 1, INPUT.size):
+                self.input(INPUT.unpack_from(payload, offset))
+        elif frameType == FRAME_ADDONS:
+            for offset in range(0, len(payload) - ADDON.size + 1, ADDON.size):
+                self.addon(ADDON.unpack_from(payload, offset))
+        elif frameType == FRAME_ADDON_NAMES:
+            offset = 0
+            while offset + 2 <= len(payload):
+                index, length = payload[offset], payload[offset + 1]
+                self.names[index] = payload[offset + 2:offset + 2 + length].decode('ascii', 'replace')
+                offset += 2 + length
+
+    def loop(self, values):
+        timestamp, loops, maxLoopUs, dropped = values[:4]
+        bins = values[4:]
+        if dropped != self.lastDropped:
+            print(f'{timestamp / 1e6:12.6f} dropped {dropped - self.lastDropped} frames')
+            self.lastDropped = dropped
+        if self.args.quiet_loop:
+            return
+        print(f'{timestamp / 1e6:12.6f} loop  n={loops:<6} p50<{percentile(bins, 0.5)}us '
+              f'p99<{percentile(bins, 0.99)}us max={maxLoopUs}us')
+        if self.args.histogram:
+            print('             ' + ' '.join(f'{count}' for count in bins))
+
+    def input(self, values):
+        if not self.args.inputs:
+            return
+        timestamp, buttons, aux, dpad = values
+        print(f'{timestamp / 1e6:12.6f} input buttons={buttons:06x} dpad={dpad:x} aux={aux:04x}')
+
+    def addon(self, values):
+        index, calls, busyUs = values
+        previous = self.addons.get(index)
+        self.addons[index] = (calls, busyUs)
+        if previous is None or not self.args.addons:
+            return
+        deltaCalls = (calls - previous[0]) & 0xFFFFFFFF
+        deltaBusy = (busyUs - previous[1]) & 0xFFFFFFFF
+        if deltaCalls == 0:
+            return
+        name = self.names.get(index, f'#{index}')
+        print(f'             addon {name:<24} {deltaBusy / deltaCalls:8.1f}us/loop {deltaBusy:8}us')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='GP2040-CE USB telemetry reader')
+    parser.add_argument('--vid', type=lambda value: int(value, 0), help='USB vendor ID to match')
+    parser.add_argument('--pid', type=lambda value: int(value, 0), help='USB product ID to match')
+    parser.add_argument('--inputs', action='store_true', help='print every input change')
+    parser.add_argument('--addons', action='store_true', help='print per add-on cost every period')
+    parser.add_argument('--histogram', action='store_true', help='print raw loop histogram bins')
+    parser.add_argument('--quiet-loop', action='store_true', help='do not print loop summaries')
+    args = parser.parse_args()
+
+    device, interface = find_interface(args.vid, args.pid)
+    if device is None:
+        print('No GP2040-CE telemetry interface found', file=sys.stderr)
+        return 1
+
+    number = interface.bInterfaceNumber
+    try:
+        if device.is_kernel_driver_active(number):
+            device.detach_kernel_driver(number)
+    except (NotImplementedError, usb.core.USBError):
+        pass
+    usb.util.claim_interface(device, number)
+
+    endpoint = usb.util.find_descriptor(interface, custom_match=lambda ep:
+        usb.util.endpoint_direction(ep.bEndpointAddress) == usb.util.ENDPOINT_IN)
+
+    reader = Reader(args)
+    try:
+        while True:
+            try:
+                reader.feed(endpoint.read(512, timeout=1000))
+            except usb.core.USBTimeoutError:
+                continue
+    except KeyboardInterrupt:
+        pass
+    finally:
+        usb.util.release_interface(device, number)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -54,6 +54,9 @@ const skipCompressionExtensions = new Set(['png', 'json']);
 
 const serverHeader = 'GP2040-CE';
 
+// Vite puts a content hash in every file name under assets/, so browsers can keep them
+const immutablePathPrefixes = ['/assets/'];
+
 const payloadAlignment = 4;
 const hexBytesPerLine = 16;
 
@@ -172,7 +175,7 @@ function makefsdata() {
 		let compressed = fileContent.buffer;
 		let isCompressed = false;
 		if (!skipCompressionExtensions.has(ext)) {
-			compressed = pako.deflate(fileContent, {
+			compressed = pako.gzip(fileContent, {
 				level: 9,
 				windowBits: 15,
 				memLevel: 9,
@@ -216,7 +219,13 @@ function makefsdata() {
 			true,
 		);
 		if (isCompressed) {
-			fsdata += createHexString('Content-Encoding: deflate\r\n', true);
+			fsdata += createHexString('Content-Encoding: gzip\r\n', true);
+		}
+		if (immutablePathPrefixes.some((prefix) => qualifiedName.startsWith(prefix))) {
+			fsdata += createHexString(
+				'Cache-Control: public, max-age=31536000, immutable\r\n',
+				true,
+			);
 		}
 		fsdata += createHexString(
 			`Content-Type: ${contentTypes.get(ext) ?? defaultContentType}\r\n\r\n`,
@@ -455,81 +455,113 @@ app.get('/api/getGamepadOptions', (req, res) => {
 			auxMask: 32768,
 			buttonsMask: 66304,
 			action: 4,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey02: {
 			auxMask: 0,
 			buttonsMask: 131840,
 			action: 1,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey03: {
 			auxMask: 0,
 			buttonsMask: 262912,
 			action: 2,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey04: {
 			auxMask: 0,
 			buttonsMask: 525056,
 			action: 3,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey05: {
 			auxMask: 0,
 			buttonsMask: 70144,
 			action: 6,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey06: {
 			auxMask: 0,
 			buttonsMask: 135680,
 			action: 7,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey07: {
 			auxMask: 0,
 			buttonsMask: 266752,
 			action: 8,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey08: {
 			auxMask: 0,
 			buttonsMask: 528896,
 			action: 10,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey09: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey10: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey11: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey12: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey13: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey14: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey15: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 		hotkey16: {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0,
+			holdDuration: 0,
+			ordered: false,
 		},
 	});
 });
@@ -681,6 +713,14 @@ app.get('/api/getAddonsOptions', (req, res) => {
 		turboPinLED: -1,
 		sliderModeZero: 0,
 		turboShotCount: 20,
+		turboShotCountB1: 0,
+		turboShotCountB2: 0,
+		turboShotCountB3: 0,
+		turboShotCountB4: 0,
+		turboShotCountL1: 0,
+		turboShotCountR1: 0,
+		turboShotCountL2: 0,
+		turboShotCountR2: 0,
 		reversePin: -1,
 		reversePinLED: -1,
 		reverseActionUp: 1,
@@ -732,6 +772,12 @@ app.get('/api/getAddonsOptions', (req, res) => {
 		smoothing_factor2: 5,
 		analog_error: 1000,
 		analog_error2: 1000,
+		analog_curve: 0,
+		analog_curve2: 0,
+		analog_curve_points: 0x4b3219,
+		analog_curve_points2: 0x4b3219,
+		analog_oversample: 1,
+		analog_oversample2: 1,
 		bootselButtonMap: 0,
 		buzzerPin: -1,
 		buzzerEnablePin: -1,
@@ -822,6 +868,7 @@ app.get('/api/getAddonsOptions', (req, res) => {
 		heTriggerSmoothingFactor: 5,
 		RotaryAddonEnabled: 1,
 		PCF8575AddonEnabled: 1,
+		PCF8575InterruptPin: -1,
 		DRV8833RumbleAddonEnabled: 1,
 		ReactiveLEDAddonEnabled: 1,
 		GamepadUSBHostAddonEnabled: 1,
@@ -1362,6 +1409,52 @@ app.get('/api/getMemoryReport', (req, res) => {
 	});
 });
 
+app.get('/api/getUSBHostLatency', (req, res) => {
+	const histogram = (bins, meanUs, maxUs) => ({
+		count: bins.reduce((total, bin) => total + bin, 0),
+		maxUs,
+		meanUs,
+		bins: [...bins, ...Array(16 - bins.length).fill(0)],
+	});
+	return res.send({
+		previousSession: 1,
+		devices: [
+			{
+				address: 1,
+				vid: 0x054c,
+				pid: 0x0ce6,
+				unchanged: 12,
+				pollInterval: histogram([0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 9000], 1000, 1650),
+				decode: histogram([0, 0, 0, 0, 0, 7000, 2000], 24, 61),
+				passthrough: histogram([0, 0, 0, 0, 0, 0, 0, 0, 2000, 5000, 1900, 100], 600, 1830),
+			},
+		],
+	});
+});
+
+app.get('/api/getAnalogNoise', (req, res) => {
+	const axis = (pin, mean, deviation, histogram) => ({
+		pin,
+		mean,
+		deviation,
+		min: Math.round(mean) - 5,
+		max: Math.round(mean) + 4,
+		histogram,
+	});
+	return res.send({
+		success: true,
+		samples: 1024,
+		sticks: [
+			{
+				stick: 1,
+				x: axis(26, 2051.4, 1.62, [0, 0, 0, 1, 6, 31, 92, 187, 261, 229, 139, 55, 17, 5, 1, 0, 0]),
+				y: axis(27, 2039.8, 1.35, [0, 0, 0, 0, 3, 19, 88, 213, 287, 240, 121, 41, 10, 2, 0, 0, 0]),
+				suggested: { oversample: 16, smoothingFactor: 0, innerDeadzone: 1 },
+			},
+		],
+	});
+});
+
 app.get('/api/getHeldPins', async (req, res) => {
 	await new Promise((resolve) => setTimeout(resolve, 2000));
 	return res.send({
@@ -1,6 +1,6 @@
 import { useContext, useState } from 'react';
 import { useTranslation } from 'react-i18next';
-import { FormCheck, Row, Tab, Tabs } from 'react-bootstrap';
+import { Button, FormCheck, Row, Tab, Tabs, Table } from 'react-bootstrap';
 import * as yup from 'yup';
 
 import Section from '../Components/Section';
@@ -23,6 +23,45 @@ const INVERT_MODES = [
 	{ label: 'X/Y Axis', value: 3 },
 ];
 
+const ANALOG_CURVES = [
+	{ label: 'Linear', value: 0 },
+	{ label: 'Aggressive', value: 1 },
+	{ label: 'Relaxed', value: 2 },
+	{ label: 'Custom', value: 3 },
+];
+
+const ANALOG_OVERSAMPLE_OPTIONS = [1, 2, 4, 8, 16];
+
+type AnalogNoiseAxis = {
+	pin: number;
+	mean: number;
+	deviation: number;
+	min: number;
+	max: number;
+	histogram: number[];
+};
+
+type AnalogNoiseStick = {
+	stick: number;
+	x?: AnalogNoiseAxis;
+	y?: AnalogNoiseAxis;
+	suggested: {
+		oversample: number;
+		smoothingFactor: number;
+		innerDeadzone: number;
+	};
+};
+
+// Custom curve output % at 25/50/75% deflection, one byte each
+const ANALOG_CURVE_POINTS = [25, 50, 75];
+
+const getCurvePoint = (points: number, index: number) =>
+	(points >> (index * 8)) & 0xff;
+
+const setCurvePoint = (points: number, index: number, value: number) =>
+	(points & ~(0xff << (index * 8))) |
+	((Math.min(Math.max(value, 0), 100) & 0xff) << (index * 8));
+
 const ANALOG_ERROR_RATES = [
 	{ label: '0%', value: 1000 },
 	{ label: '1%', value: 990 },
@@ -133,6 +172,24 @@ export const analogScheme = {
 		.number()
 		.label('Error Rate 2')
 		.validateSelectionWhenValue('AnalogInputEnabled', ANALOG_ERROR_RATES),
+	analog_curve: yup
+		.number()
+		.label('Response Curve')
+		.validateSelectionWhenValue('AnalogInputEnabled', ANALOG_CURVES),
+	analog_curve2: yup
+		.number()
+		.label('Response Curve 2')
+		.validateSelectionWhenValue('AnalogInputEnabled', ANALOG_CURVES),
+	analog_oversample: yup
+		.number()
+		.label('Oversampling')
+		.oneOf(ANALOG_OVERSAMPLE_OPTIONS),
+	analog_oversample2: yup
+		.number()
+		.label('Oversampling 2')
+		.oneOf(ANALOG_OVERSAMPLE_OPTIONS),
+	analog_curve_points: yup.number().label('Custom Curve Points'),
+	analog_curve_points2: yup.number().label('Custom Curve Points 2'),
 	joystickCenterX: yup
 		.number()
 		.label('Joystick Center X')
@@ -179,11 +236,19 @@ export const analogState = {
 	smoothing_factor2: 5,
 	analog_error: 1,
 	analog_error2: 1,
+	analog_curve: 0,
+	analog_curve2: 0,
+	analog_curve_points: 0x4b3219,
+	analog_curve_points2: 0x4b3219,
+	analog_oversample: 1,
+	analog_oversample2: 1,
 };
 
 const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }: AddonPropTypes) => {
 	const { usedPins } = useContext(AppContext);
 	const { t } = useTranslation();
+	const [noise, setNoise] = useState<AnalogNoiseStick[] | null>(null);
+	const [noiseError, setNoiseError] = useState('');
 	const availableAnalogPins = ANALOG_PINS.filter(
 		(pin) => !usedPins?.includes(pin),
 	);
@@ -336,6 +401,24 @@ const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }:
 										min={0}
 										max={100}
 									/>
+									<FormSelect
+										label={t('AddonsConfig:analog-oversample-label')}
+										name="analog_oversample"
+										className="form-select-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={values.analog_oversample}
+										error={errors.analog_oversample}
+										isInvalid={Boolean(errors.analog_oversample)}
+										onChange={(e) =>
+											setFieldValue('analog_oversample', Number(e.target.value))
+										}
+									>
+										{ANALOG_OVERSAMPLE_OPTIONS.map((samples) => (
+											<option key={`analog_oversample-option-${samples}`} value={samples}>
+												{samples}
+											</option>
+										))}
+									</FormSelect>
 								</Row>
 								<Row className="mb-3">
 									<FormCheck
@@ -366,6 +449,50 @@ const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }:
 										))}
 									</FormSelect>
 								</Row>
+								<Row className="mb-3">
+									<FormSelect
+										label={t('AddonsConfig:analog-curve-label')}
+										name="analog_curve"
+										className="form-control-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={values.analog_curve}
+										error={errors.analog_curve}
+										isInvalid={Boolean(errors.analog_curve)}
+										onChange={(e) =>
+											setFieldValue('analog_curve', Number(e.target.value))
+										}
+									>
+										{ANALOG_CURVES.map((o, i) => (
+											<option key={`analog_curve-option-${i}`} value={o.value}>
+												{o.label}
+											</option>
+										))}
+									</FormSelect>
+									{ANALOG_CURVE_POINTS.map((input, i) => (
+										<FormControl
+											key={`analog_curve_points-${i}`}
+											hidden={values.analog_curve !== 3}
+											type="number"
+											label={t('AddonsConfig:analog-curve-point-label', { input })}
+											name={`analog_curve_points_${i}`}
+											className="form-control-sm"
+											groupClassName="col-sm-2 mb-3"
+											value={getCurvePoint(values.analog_curve_points, i)}
+											onChange={(e) =>
+												setFieldValue(
+													'analog_curve_points',
+													setCurvePoint(
+														values.analog_curve_points,
+														i,
+														Number(e.target.value) || 0,
+													),
+												)
+											}
+											min={0}
+											max={100}
+										/>
+									))}
+								</Row>
 								<div className="d-flex align-items-center">
 									<FormCheck
 										label={t('AddonsConfig:analog-auto-calibrate')}
@@ -621,6 +748,24 @@ const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }:
 										min={0}
 										max={100}
 									/>
+									<FormSelect
+										label={t('AddonsConfig:analog-oversample-label')}
+										name="analog_oversample2"
+										className="form-select-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={values.analog_oversample2}
+										error={errors.analog_oversample2}
+										isInvalid={Boolean(errors.analog_oversample2)}
+										onChange={(e) =>
+											setFieldValue('analog_oversample2', Number(e.target.value))
+										}
+									>
+										{ANALOG_OVERSAMPLE_OPTIONS.map((samples) => (
+											<option key={`analog_oversample2-option-${samples}`} value={samples}>
+												{samples}
+											</option>
+										))}
+									</FormSelect>
 								</Row>
 								<Row className="mb-3">
 									<FormCheck
@@ -651,6 +796,50 @@ const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }:
 										))}
 									</FormSelect>
 								</Row>
+								<Row className="mb-3">
+									<FormSelect
+										label={t('AddonsConfig:analog-curve-label')}
+										name="analog_curve2"
+										className="form-control-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={values.analog_curve2}
+										error={errors.analog_curve2}
+										isInvalid={Boolean(errors.analog_curve2)}
+										onChange={(e) =>
+											setFieldValue('analog_curve2', Number(e.target.value))
+										}
+									>
+										{ANALOG_CURVES.map((o, i) => (
+											<option key={`analog_curve2-option-${i}`} value={o.value}>
+												{o.label}
+											</option>
+										))}
+									</FormSelect>
+									{ANALOG_CURVE_POINTS.map((input, i) => (
+										<FormControl
+											key={`analog_curve_points2-${i}`}
+											hidden={values.analog_curve2 !== 3}
+											type="number"
+											label={t('AddonsConfig:analog-curve-point-label', { input })}
+											name={`analog_curve_points2_${i}`}
+											className="form-control-sm"
+											groupClassName="col-sm-2 mb-3"
+											value={getCurvePoint(values.analog_curve_points2, i)}
+											onChange={(e) =>
+												setFieldValue(
+													'analog_curve_points2',
+													setCurvePoint(
+														values.analog_curve_points2,
+														i,
+														Number(e.target.value) || 0,
+													),
+												)
+											}
+											min={0}
+											max={100}
+										/>
+									))}
+								</Row>
 								<div className="d-flex align-items-center">
 									<FormCheck
 										label={t('AddonsConfig:analog-auto-calibrate')}
@@ -785,6 +974,83 @@ const Analog = ({ values, errors, handleChange, handleCheckbox, setFieldValue }:
 							</Row>
 						</Tab>
 					</Tabs>
+					<Row className="mb-3">
+						<div className="col-sm-12 ms-3">
+							<p className="mb-2">{t('AddonsConfig:analog-noise-description')}</p>
+							<Button
+								variant="outline-secondary"
+								size="sm"
+								onClick={async () => {
+									try {
+										const res = await fetch('/api/getAnalogNoise');
+										const data = await res.json();
+										if (!data.success) throw new Error(data.error);
+										setNoiseError('');
+										setNoise(data.sticks);
+									} catch (error) {
+										setNoise(null);
+										setNoiseError(String(error));
+									}
+								}}
+							>
+								{t('AddonsConfig:analog-noise-button')}
+							</Button>
+							{noiseError && <div className="text-danger mt-2">{noiseError}</div>}
+						</div>
+					</Row>
+					{noise?.map((stick) => {
+						const suffix = stick.stick === 2 ? '2' : '';
+						return (
+							<Row className="mb-3" key={`analog-noise-${stick.stick}`}>
+								<Table size="sm" bordered className="col-sm-12 ms-3">
+									<thead>
+										<tr>
+											<th>{t('AddonsConfig:analog-noise-stick', { stick: stick.stick })}</th>
+											<th>{t('AddonsConfig:analog-noise-mean')}</th>
+											<th>{t('AddonsConfig:analog-noise-deviation')}</th>
+											<th>{t('AddonsConfig:analog-noise-range')}</th>
+										</tr>
+									</thead>
+									<tbody>
+										{(['x', 'y'] as const).map((axis) => {
+											const data = stick[axis];
+											return (
+												data && (
+													<tr key={axis}>
+														<td>{`${axis.toUpperCase()} (GP${data.pin})`}</td>
+														<td>{data.mean.toFixed(1)}</td>
+														<td>{data.deviation.toFixed(2)}</td>
+														<td>{`${data.min} - ${data.max}`}</td>
+													</tr>
+												)
+											);
+										})}
+									</tbody>
+								</Table>
+								<div className="col-sm-12 ms-3">
+									{t('AddonsConfig:analog-noise-suggestion', {
+										oversample: stick.suggested.oversample,
+										smoothing: stick.suggested.smoothingFactor || t('AddonsConfig:analog-noise-smoothing-off'),
+										deadzone: stick.suggested.innerDeadzone,
+									})}
+									<Button
+										variant="outline-primary"
+										size="sm"
+										className="ms-2"
+										onClick={() => {
+											const { oversample, smoothingFactor, innerDeadzone } = stick.suggested;
+											setFieldValue(`analog_oversample${suffix}`, oversample);
+											setFieldValue(`analog_smoothing${suffix}`, smoothingFactor ? 1 : 0);
+											if (smoothingFactor) setFieldValue(`smoothing_factor${suffix}`, smoothingFactor);
+											setFieldValue(`inner_deadzone${suffix}`, innerDeadzone);
+										}}
+									>
+										{t('AddonsConfig:analog-noise-apply')}
+									</Button>
+								</div>
+							</Row>
+						);
+					})}
 			</div>
 			<FormCheck
 				label={t('Common:switch-enabled')}
@@ -18,6 +18,8 @@ const SHMUP_MIXED_MODES = [
 	{ label: 'Charge Priority', value: 1 },
 ];
 
+const TURBO_RATE_BUTTONS = ['B1', 'B2', 'B3', 'B4', 'L1', 'R1', 'L2', 'R2'];
+
 const TURBO_MASKS = [
 	{ label: 'None', value: 0 },
 	{ label: 'B1', value: 1 << 0 },
@@ -62,6 +64,15 @@ export const turboScheme = {
 		.number()
 		.label('Turbo Shot Count')
 		.validateRangeWhenValue('TurboInputEnabled', 2, 30),
+	...Object.fromEntries(
+		TURBO_RATE_BUTTONS.map((button) => [
+			`turboShotCount${button}`,
+			yup
+				.number()
+				.label(`${button} Turbo Shot Count`)
+				.validateRangeWhenValue('TurboInputEnabled', 0, 30),
+		]),
+	),
 	shmupMode: yup
 		.number()
 		.label('Shmup Mode Enabled')
@@ -124,6 +135,9 @@ export const turboState = {
 	TurboInputEnabled: 0,
 	turboPinLED: -1,
 	turboShotCount: 5,
+	...Object.fromEntries(
+		TURBO_RATE_BUTTONS.map((button) => [`turboShotCount${button}`, 0]),
+	),
 	turboLedType: 0,
 };
 
@@ -224,6 +238,27 @@ const Turbo = ({
 						<AnalogPinOptions />
 					</FormSelect>
 				</Row>
+				<Row className="mb-3">
+					{TURBO_RATE_BUTTONS.map((button) => (
+						<FormControl
+							key={`turboShotCount${button}`}
+							type="number"
+							label={t('AddonsConfig:turbo-button-shot-count-label', {
+								button,
+							})}
+							name={`turboShotCount${button}`}
+							className="form-control-sm"
+							groupClassName="col-sm-3 mb-3"
+							value={values[`turboShotCount${button}`]}
+							error={errors[`turboShotCount${button}`]}
+							isInvalid={Boolean(errors[`turboShotCount${button}`])}
+							onChange={handleChange}
+							min={0}
+							max={30}
+						/>
+					))}
+				</Row>
+				<p>{t('AddonsConfig:turbo-button-shot-count-description')}</p>
 				<Row className="mb-3">
 					<FormCheck
 						label={t('AddonsConfig:turbo-shmup-mode-label')}
@@ -1,6 +1,9 @@
 export default {
 	'header-text': 'PCF8575 IO Expander',
 	'block-label': 'I2C Block',
+	'interrupt-pin-label': 'Interrupt Pin',
+	'interrupt-pin-description':
+		'Connect the INT output of the expander to read it only when an input changes. Leave at -1 to read it every loop.',
 	'label-direction': {
 		input: 'Input',
 		output: 'Output',
@@ -60,12 +60,29 @@ export default {
 	'analog-smoothing': 'Analog Smoothing',
 	'smoothing-factor': 'Smoothing Factor',
 	'analog-error-label': 'Error Rate',
+	'analog-curve-label': 'Response Curve',
+	'analog-curve-point-label': 'Output at {{input}}%',
+	'analog-oversample-label': 'Oversampling',
+	'analog-noise-description':
+		'Leave the sticks at rest and measure their noise to get suggested oversampling, smoothing and deadzone settings.',
+	'analog-noise-button': 'Measure Noise',
+	'analog-noise-stick': 'Stick {{stick}}',
+	'analog-noise-mean': 'Mean',
+	'analog-noise-deviation': 'Std. Deviation',
+	'analog-noise-range': 'Range',
+	'analog-noise-suggestion':
+		'Suggested: {{oversample}}x oversampling, smoothing {{smoothing}}, inner deadzone {{deadzone}}%',
+	'analog-noise-smoothing-off': 'off',
+	'analog-noise-apply': 'Apply',
 	'turbo-header-text': 'Turbo',
 	'turbo-button-pin-label': 'Turbo GPIO Pin',
 	'turbo-led-pin-label': 'Turbo LED GPIO Pin',
 	'turbo-available-pins-text': 'Available ADC pins: {{pins}}',
 	'turbo-shmup-dial-pin-label': 'Turbo Dial (ADC ONLY)',
 	'turbo-shot-count-label': 'Turbo Shot Count',
+	'turbo-button-shot-count-label': '{{button}} Shot Count',
+	'turbo-button-shot-count-description':
+		'Shots per second for one button, 0 uses the Turbo Shot Count. Every on and off phase lasts whole USB frames, 60 divided by a whole number (30, 20, 15, 12, 10) lines up with 60 Hz games.',
 	'turbo-shmup-mode-label': 'SHMUP MODE',
 	'turbo-shmup-always-on-1-label': 'Turbo Always On 1',
 	'turbo-shmup-always-on-2-label': 'Turbo Always On 2',
@@ -13,5 +13,19 @@ export default {
 	'memory-static-allocations-text': 'Static Allocations',
 	'sub-header-text': 'Please select a menu option to proceed.',
 	'system-stats-header-text': 'System Stats',
+	'usb-host-latency-header-text': 'USB Host Latency',
+	'usb-host-latency-previous-session-text':
+		'Recorded during the last gamepad session before rebooting into web config.',
+	'usb-host-latency-live-text': 'Recording live.',
+	'usb-host-latency-device-text': 'Device',
+	'usb-host-latency-metric-text': 'Measurement',
+	'usb-host-latency-count-text': 'Samples',
+	'usb-host-latency-mean-text': 'Mean (ms)',
+	'usb-host-latency-p99-text': '99% (ms)',
+	'usb-host-latency-max-text': 'Max (ms)',
+	'usb-host-latency-pollInterval-text': 'Poll interval',
+	'usb-host-latency-decode-text': 'Decode',
+	'usb-host-latency-passthrough-text': 'Passthrough age',
+	'usb-host-latency-unchanged-text': '{{count}} did not change the report',
 	'version-text': 'Version',
 };
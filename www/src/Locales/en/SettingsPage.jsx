@@ -90,6 +90,11 @@ export default {
 		'The <strong>Fn</strong> slider provides a mappable Function button in the <link_pinmap>Pin Mapping</link_pinmap> page. By selecting the <strong>Fn</strong> slider option, the Function button must be held along with the selected hotkey settings. <br /> Additionally, select <strong>None</strong> from the dropdown to unassign any button.',
 	'hotkey-settings-warning':
 		'Function button is not mapped. The Fn slider will be disabled.',
+	'hotkey-hold-duration-label':
+		'Hold duration, 0 runs the action right away. When a longer hold shares the combination, the shorter one runs on release instead',
+	'hotkey-ordered-label': 'In order',
+	'hotkey-ordered-description':
+		'The directions, or the buttons after Fn, have to be pressed after the rest of the combination',
 	'hotkey-actions': {
 		'no-action': 'No Action',
 		'dpad-digital': 'Dpad Digital',
@@ -149,6 +154,7 @@ export default {
 		'menu-nav-back': 'Menu Back',
 		'menu-nav-toggle': 'Menu Toggle',
 		'focus-mode-toggle': 'Focus Mode Toggle',
+		'record-macro': 'Record Macro',
 		'turbo-count-up': 'Turbo Count Up',
 		'turbo-count-down': 'Turbo Count Down',
 		'ls-up': 'Left Stick Up',
@@ -1,10 +1,20 @@
 import { useEffect } from 'react';
 import { useTranslation } from 'react-i18next';
-import { ProgressBar } from 'react-bootstrap';
+import { ProgressBar, Table } from 'react-bootstrap';
 
 import useSystemStats from '../Store/useSystemStats';
 import Section from '../Components/Section';
 
+const toHex = (value: number) => value.toString(16).toUpperCase().padStart(4, '0');
+const toMs = (us: number) => (us / 1000).toFixed(2);
+
+// Upper edge of the bin holding the 99th percentile, bin n covers [2^(n-1), 2^n) us
+const percentile99 = (bins: number[], count: number) => {
+	let seen = 0;
+	const index = bins.findIndex((bin) => (seen += bin) >= count * 0.99);
+	return index < 0 ? 0 : 2 ** index;
+};
+
 export default function HomePage() {
 	const { t } = useTranslation('');
 	const {
@@ -14,6 +24,7 @@ export default function HomePage() {
 		boardConfigProperties,
 		memoryReport,
         stats,
+		usbHostLatency,
 		getSystemStats,
 		loading,
 	} = useSystemStats();
@@ -104,6 +115,58 @@ export default function HomePage() {
 					/>
 				</div>
 			</Section>
+			{usbHostLatency.devices.length > 0 && (
+				<Section title={t('HomePage:usb-host-latency-header-text')}>
+					<p>
+						{usbHostLatency.previousSession
+							? t('HomePage:usb-host-latency-previous-session-text')
+							: t('HomePage:usb-host-latency-live-text')}
+					</p>
+					<Table size="sm" striped>
+						<thead>
+							<tr>
+								<th>{t('HomePage:usb-host-latency-device-text')}</th>
+								<th>{t('HomePage:usb-host-latency-metric-text')}</th>
+								<th>{t('HomePage:usb-host-latency-count-text')}</th>
+								<th>{t('HomePage:usb-host-latency-mean-text')}</th>
+								<th>{t('HomePage:usb-host-latency-p99-text')}</th>
+								<th>{t('HomePage:usb-host-latency-max-text')}</th>
+							</tr>
+						</thead>
+						<tbody>
+							{usbHostLatency.devices.flatMap((device) =>
+								(['pollInterval', 'decode', 'passthrough'] as const).map(
+									(metric) => {
+										const histogram = device[metric];
+										return (
+											<tr key={`${device.address}-${metric}`}>
+												<td>
+													{`${device.address}: ${toHex(device.vid)}:${toHex(device.pid)}`}
+												</td>
+												<td>
+													{t(`HomePage:usb-host-latency-${metric}-text`)}
+													{metric === 'passthrough' &&
+														device.unchanged > 0 &&
+														` (${t('HomePage:usb-host-latency-unchanged-text', {
+															count: device.unchanged,
+														})})`}
+												</td>
+												<td>{histogram.count}</td>
+												<td>{toMs(histogram.meanUs)}</td>
+												<td>
+													{'< '}
+													{toMs(percentile99(histogram.bins, histogram.count))}
+												</td>
+												<td>{toMs(histogram.maxUs)}</td>
+											</tr>
+										);
+									},
+								),
+							)}
+						</tbody>
+					</Table>
+				</Section>
+			)}
 		</div>
 	);
 }
@@ -32,32 +32,44 @@ const MACRO_TYPES = [
 	{ label: 'InputMacroAddon:input-macro-type.hold-repeat', value: 2 },
 	{ label: 'InputMacroAddon:input-macro-type.toggle', value: 3 },
 ];
-const MACRO_INPUTS_MAX = 30;
+const MACRO_INPUTS_MAX = 128;
+const MACRO_INPUTS_TOTAL_MAX = 256;
 const MACRO_LIMIT = 6;
 
 const schema = yup.object().shape({
-	macroList: yup.array().of(
-		yup.object().shape({
-			macroType: yup.number(),
-			macroLabel: yup.string(),
-			enabled: yup.number(),
-			exclusive: yup.number(),
-			interruptible: yup.number(),
-			showFrames: yup.number(),
-			useMacroTriggerButton: yup.number(),
-			macroTriggerButton: yup.number(),
-			macroInputs: yup
-				.array()
-				.max(MACRO_INPUTS_MAX, 'Exceeded maximum inputs')
-				.of(
-					yup.object().shape({
-						buttonMask: yup.number().required(),
-						duration: yup.number().required(),
-						waitDuration: yup.number().required(),
-					}),
-				),
-		}),
-	),
+	macroList: yup
+		.array()
+		.test(
+			'total-inputs',
+			'Exceeded maximum inputs across all macros',
+			(macroList) =>
+				(macroList || []).reduce(
+					(total, macro) => total + (macro.macroInputs?.length || 0),
+					0,
+				) <= MACRO_INPUTS_TOTAL_MAX,
+		)
+		.of(
+			yup.object().shape({
+				macroType: yup.number(),
+				macroLabel: yup.string(),
+				enabled: yup.number(),
+				exclusive: yup.number(),
+				interruptible: yup.number(),
+				showFrames: yup.number(),
+				useMacroTriggerButton: yup.number(),
+				macroTriggerButton: yup.number(),
+				macroInputs: yup
+					.array()
+					.max(MACRO_INPUTS_MAX, 'Exceeded maximum inputs')
+					.of(
+						yup.object().shape({
+							buttonMask: yup.number().required(),
+							duration: yup.number().required(),
+							waitDuration: yup.number().required(),
+						}),
+					),
+			}),
+		),
 	macroBoardLedEnabled: yup.number(),
 });
 
@@ -1,5 +1,5 @@
 import { useContext, useEffect, useState } from 'react';
-import { Button, Form, Modal, Nav, Row, Col, Tab } from 'react-bootstrap';
+import { Button, Form, InputGroup, Modal, Nav, Row, Col, Tab } from 'react-bootstrap';
 import { Formik, useFormikContext } from 'formik';
 import { NavLink } from 'react-router-dom';
 import * as yup from 'yup';
@@ -270,6 +270,7 @@ const HOTKEY_ACTIONS = [
 	{ labelKey: 'hotkey-actions.menu-nav-back', value: 49 },
 	{ labelKey: 'hotkey-actions.menu-nav-toggle', value: 50 },
 	{ labelKey: 'hotkey-actions.focus-mode-toggle', value: 77 },
+	{ labelKey: 'hotkey-actions.record-macro', value: 88 },
 	{ labelKey: 'hotkey-actions.ls-up', value: 78 },
 	{ labelKey: 'hotkey-actions.ls-down', value: 79 },
 	{ labelKey: 'hotkey-actions.ls-left', value: 80 },
@@ -306,6 +307,8 @@ const hotkeySchema = {
 		.label('Hotkey Action'),
 	buttonsMask: yup.number().required().label('Button Mask'),
 	auxMask: yup.number().required().label('Function Key'),
+	holdDuration: yup.number().min(0).max(10000).label('Hold Duration'),
+	ordered: yup.boolean().label('Ordered'),
 };
 
 const hotkeyFields = Array(16)
@@ -321,7 +324,7 @@ const hotkeyFields = Array(16)
 				'Duplicate button combinations are not allowed',
 				function (currentValue) {
 					return !Object.entries(this.parent).some(
-						([key, { buttonsMask, auxMask }]) => {
+						([key, { buttonsMask, auxMask, holdDuration }]) => {
 							if (
 								!key.includes('hotkey') || // Skip non-hotkey rows
 								key === 'hotkey' + number || // Skip current hotkey
@@ -329,9 +332,11 @@ const hotkeyFields = Array(16)
 							) {
 								return false;
 							}
+							// the same combination can hold for different durations
 							return (
 								buttonsMask === currentValue.buttonsMask &&
-								auxMask === currentValue.auxMask
+								auxMask === currentValue.auxMask &&
+								(holdDuration || 0) === (currentValue.holdDuration || 0)
 							);
 						},
 					);
@@ -493,6 +498,8 @@ const FormContext = ({ setButtonLabels, setKeyMappings }) => {
 					action: parseInt(value.action),
 					buttonsMask: parseInt(value.buttonsMask),
 					auxMask: parseInt(value.auxMask),
+					holdDuration: parseInt(value.holdDuration) || 0,
+					ordered: Boolean(value.ordered),
 				};
 			}
 		});
@@ -1930,6 +1937,35 @@ export default function SettingsPage() {
 																			{errors[o] && errors[o]?.action}
 																		</Form.Control.Feedback>
 																	</Col>
+																	<Col sm="auto">
+																		<InputGroup size="sm">
+																			<Form.Control
+																				name={`${o}.holdDuration`}
+																				type="number"
+																				min={0}
+																				max={10000}
+																				style={{ width: '6em' }}
+																				title={t('SettingsPage:hotkey-hold-duration-label')}
+																				value={values[o]?.holdDuration || 0}
+																				onChange={handleChange}
+																				isInvalid={errors[o] && errors[o]?.holdDuration}
+																			/>
+																			<InputGroup.Text>ms</InputGroup.Text>
+																		</InputGroup>
+																	</Col>
+																	<Col sm="auto">
+																		<Form.Check
+																			id={`${o}-ordered`}
+																			name={`${o}.ordered`}
+																			type="switch"
+																			label={t('SettingsPage:hotkey-ordered-label')}
+																			title={t('SettingsPage:hotkey-ordered-description')}
+																			checked={Boolean(values[o]?.ordered)}
+																			onChange={(e) =>
+																				setFieldValue(`${o}.ordered`, e.target.checked)
+																			}
+																		/>
+																	</Col>
 																	{Boolean(
 																		values[o]?.buttonsMask || values[o]?.action,
 																	) && (
@@ -1939,6 +1975,8 @@ export default function SettingsPage() {
 																				onClick={() => {
 																					setFieldValue(`${o}.action`, 0);
 																					setFieldValue(`${o}.buttonsMask`, 0);
+																					setFieldValue(`${o}.holdDuration`, 0);
+																					setFieldValue(`${o}.ordered`, false);
 																				}}
 																			>
 																				{'✕'}
@@ -5,6 +5,23 @@ const percentage = (x: number, y: number): number =>
 	parseFloat(((x / y) * 100).toFixed(2));
 const toKB = (x: number): number => parseFloat((x / 1024).toFixed(2));
 
+type LatencyHistogram = {
+	count: number;
+	maxUs: number;
+	meanUs: number;
+	bins: number[];
+};
+
+export type USBHostLatencyDevice = {
+	address: number;
+	vid: number;
+	pid: number;
+	unchanged: number;
+	pollInterval: LatencyHistogram;
+	decode: LatencyHistogram;
+	passthrough: LatencyHistogram;
+};
+
 type State = {
 	latestVersion: string;
 	latestDownloadUrl: string;
@@ -28,6 +45,10 @@ type State = {
 		build: string;
 		buildType: string;
 	};
+	usbHostLatency: {
+		previousSession: boolean;
+		devices: USBHostLatencyDevice[];
+	};
 	loading: boolean;
 	error: boolean;
 };
@@ -59,6 +80,10 @@ const INITIAL_STATE: State = {
 		build: '',
 		buildType: '',
 	},
+	usbHostLatency: {
+		previousSession: false,
+		devices: [],
+	},
 	loading: false,
 	error: false,
 };
@@ -69,9 +94,10 @@ const useSystemStats = create<State & Actions>()((set) => ({
 		set({ loading: true });
 
 		try {
-			const [firmwareVersion, memoryReport, latestRelease] = await Promise.all([
+			const [firmwareVersion, memoryReport, usbHostLatency, latestRelease] = await Promise.all([
 				fetch(`${baseUrl}/api/getFirmwareVersion`).then((res) => res.json()),
 				fetch(`${baseUrl}/api/getMemoryReport`).then((res) => res.json()),
+				fetch(`${baseUrl}/api/getUSBHostLatency`).then((res) => res.json()),
 				fetch(
 					'https://api.github.com/repos/OpenStickCommunity/GP2040-CE/releases/latest',
 				).then((res) => res.json()),
@@ -115,6 +141,10 @@ const useSystemStats = create<State & Actions>()((set) => ({
 					build: firmwareVersion.boardBuild,
 					buildType: firmwareVersion.boardBuildType,
 				},
+				usbHostLatency: {
+					previousSession: Boolean(usbHostLatency.previousSession),
+					devices: usbHostLatency.devices,
+				},
 				loading: false,
 			});
 		} catch (error) {
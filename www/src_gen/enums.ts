@@ -397,7 +397,8 @@ export enum GamepadHotkey {
     HOTKEY_RS_LEFT = 84,
     HOTKEY_RS_RIGHT = 85,
     HOTKEY_REBOOT_WEBCONFIG = 86,
-    HOTKEY_REBOOT_USB = 87
+    HOTKEY_REBOOT_USB = 87,
+    HOTKEY_RECORD_MACRO = 88
 }
 
 export enum LEDFormat_Proto {
@@ -608,7 +609,9 @@ export enum GPEventType {
     GP_EVENT_STORAGE_SAVE = 12,
     GP_EVENT_SYSTEM_REBOOT = 13,
     GP_EVENT_MENU_NAVIGATE = 14,
-    GP_EVENT_SYSTEM_ERROR = 15
+    GP_EVENT_SYSTEM_ERROR = 15,
+    GP_EVENT_INPUT_MODE_CHANGE = 16,
+    GP_EVENT_MACRO_RECORD = 17
 }
 
 export enum MouseMovementMode {